@@ -37,6 +37,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "storage/storage_shared_media.h"
 #include "calls/calls_instance.h"
 #include "base/unixtime.h"
+#include "core/core_probes.h"
 #include "window/window_session_controller.h"
 #include "window/window_controller.h"
 #include "boxes/confirm_box.h"
@@ -48,6 +49,11 @@ namespace {
 
 constexpr auto kChannelGetDifferenceLimit = 100;
 
+constexpr auto kLogUpdatesBatchSize = 100;
+
+// After a sleep getDifference may report hundreds of channels at once.
+constexpr auto kMaxChannelDifferenceRequests = 8;
+
 // 1s wait after show channel history before sending getChannelDifference.
 constexpr auto kWaitForChannelGetDifference = crl::time(1000);
 
@@ -278,13 +284,23 @@ void Updates::checkLastUpdate(bool afterSleep) {
 void Updates::feedUpdateVector(
 		const MTPVector<MTPUpdate> &updates,
 		bool skipMessageIds) {
+	auto &owner = session().data();
+	const auto started = crl::now();
+	owner.holdChatListEntryRefreshes();
 	for (const auto &update : updates.v) {
 		if (skipMessageIds && update.type() == mtpc_updateMessageID) {
 			continue;
 		}
 		feedUpdate(update);
 	}
-	session().data().sendHistoryChangeNotifications();
+	owner.releaseChatListEntryRefreshes();
+	owner.sendHistoryChangeNotifications();
+
+	if (updates.v.size() >= kLogUpdatesBatchSize) {
+		DEBUG_LOG(("Updates: Applied %1 updates in %2 ms."
+			).arg(updates.v.size()
+			).arg(crl::now() - started));
+	}
 }
 
 void Updates::feedMessageIds(const MTPVector<MTPUpdate> &updates) {
@@ -331,6 +347,7 @@ void Updates::setState(int32 pts, int32 date, int32 qts, int32 seq) {
 void Updates::channelDifferenceDone(
 		not_null<ChannelData*> channel,
 		const MTPupdates_ChannelDifference &difference) {
+	_channelDifferenceRequests.remove(channel);
 	_channelFailDifferenceTimeout.remove(channel);
 
 	const auto timeout = difference.match([&](const auto &data) {
@@ -380,6 +397,7 @@ void Updates::channelDifferenceDone(
 			? (timeout * crl::time(1000))
 			: kWaitForChannelGetDifference);
 	}
+	sendQueuedChannelDifferences();
 }
 
 void Updates::feedChannelDifference(
@@ -403,7 +421,37 @@ void Updates::channelDifferenceFail(
 		).arg(error.code()
 		).arg(error.type()
 		).arg(error.description()));
+	_channelDifferenceRequests.remove(channel);
 	failDifferenceStartTimerFor(channel);
+	sendQueuedChannelDifferences();
+}
+
+void Updates::sendQueuedChannelDifferences() {
+	while (!_channelDifferenceQueue.empty()
+		&& (_channelDifferenceRequests.size()
+			< kMaxChannelDifferenceRequests)) {
+		const auto priority = [&](const auto &pair) {
+			return channelDifferencePriority(pair.first);
+		};
+		const auto i = ranges::max_element(
+			_channelDifferenceQueue,
+			ranges::less(),
+			priority);
+		const auto [next, from] = *i;
+		_channelDifferenceQueue.erase(i);
+		sendChannelDifference(next, from);
+	}
+}
+
+auto Updates::channelDifferencePriority(
+		not_null<ChannelData*> channel) const
+-> std::pair<bool, int> {
+	const auto active = ranges::contains(
+		_activeChats,
+		channel.get(),
+		[](const auto &pair) { return pair.second.peer; });
+	const auto history = session().data().historyLoaded(channel->id);
+	return { active, history ? history->unreadCount() : 0 };
 }
 
 void Updates::stateDone(const MTPupdates_State &state) {
@@ -663,6 +711,20 @@ void Updates::getChannelDifference(
 
 	channel->ptsSetRequesting(true);
 
+	if (_channelDifferenceRequests.size() >= kMaxChannelDifferenceRequests) {
+		// Sent when one of the running requests finishes, the most
+		// important channels first: opened ones, then by unread count.
+		_channelDifferenceQueue.emplace(channel, from);
+		return;
+	}
+	sendChannelDifference(channel, from);
+}
+
+void Updates::sendChannelDifference(
+		not_null<ChannelData*> channel,
+		ChannelDifferenceRequest from) {
+	_channelDifferenceRequests.emplace(channel);
+
 	auto filter = MTP_channelMessagesFilterEmpty();
 	auto flags = MTPupdates_GetChannelDifference::Flag::f_force | 0;
 	if (from != ChannelDifferenceRequest::PtsGapOrShortPoll) {
@@ -1357,6 +1419,9 @@ void Updates::applyUpdates(
 }
 
 void Updates::feedUpdate(const MTPUpdate &update) {
+	static auto probe = Core::Probe("updates.feed_us");
+	const auto timer = Core::ProbeTimer(probe);
+
 	switch (update.type()) {
 
 	// New messages.
@@ -1702,21 +1767,16 @@ void Updates::feedUpdate(const MTPUpdate &update) {
 	case mtpc_updateUserStatus: {
 		auto &d = update.c_updateUserStatus();
 		if (auto user = session().data().userLoaded(d.vuser_id().v)) {
-			switch (d.vstatus().type()) {
-			case mtpc_userStatusEmpty: user->onlineTill = 0; break;
-			case mtpc_userStatusRecently:
-				if (user->onlineTill > -10) { // don't modify pseudo-online
-					user->onlineTill = -2;
-				}
-			break;
-			case mtpc_userStatusLastWeek: user->onlineTill = -3; break;
-			case mtpc_userStatusLastMonth: user->onlineTill = -4; break;
-			case mtpc_userStatusOffline: user->onlineTill = d.vstatus().c_userStatusOffline().vwas_online().v; break;
-			case mtpc_userStatusOnline: user->onlineTill = d.vstatus().c_userStatusOnline().vexpires().v; break;
+			const auto oldOnlineTill = user->onlineTill;
+			const auto newOnlineTill = ApiWrap::OnlineTillFromStatus(
+				d.vstatus(),
+				oldOnlineTill);
+			if (oldOnlineTill != newOnlineTill) {
+				user->onlineTill = newOnlineTill;
+				session().changes().peerUpdated(
+					user,
+					Data::PeerUpdate::Flag::OnlineStatus);
 			}
-			session().changes().peerUpdated(
-				user,
-				Data::PeerUpdate::Flag::OnlineStatus);
 		}
 		if (d.vuser_id().v == session().userId()) {
 			if (d.vstatus().type() == mtpc_userStatusOffline
@@ -2096,12 +2156,14 @@ void Updates::feedUpdate(const MTPUpdate &update) {
 	////// Cloud sticker sets
 	case mtpc_updateNewStickerSet: {
 		const auto &d = update.c_updateNewStickerSet();
+		session().readStickersIfNeeded();
 		session().data().stickers().newSetReceived(d.vstickerset());
 	} break;
 
 	case mtpc_updateStickerSetsOrder: {
 		auto &d = update.c_updateStickerSetsOrder();
 		if (!d.is_masks()) {
+			session().readStickersIfNeeded();
 			const auto &order = d.vorder().v;
 			const auto &sets = session().data().stickers().sets();
 			Data::StickersSetsOrder result;
@@ -88,6 +88,12 @@ private:
 	void getChannelDifference(
 		not_null<ChannelData*> channel,
 		ChannelDifferenceRequest from = ChannelDifferenceRequest::Unknown);
+	void sendChannelDifference(
+		not_null<ChannelData*> channel,
+		ChannelDifferenceRequest from);
+	void sendQueuedChannelDifferences();
+	[[nodiscard]] std::pair<bool, int> channelDifferencePriority(
+		not_null<ChannelData*> channel) const;
 	void differenceDone(const MTPupdates_Difference &result);
 	void differenceFail(const RPCError &error);
 	void feedDifference(
@@ -158,6 +164,11 @@ private:
 		crl::time> _channelFailDifferenceTimeout;
 	base::Timer _failDifferenceTimer;
 
+	base::flat_set<not_null<ChannelData*>> _channelDifferenceRequests;
+	base::flat_map<
+		not_null<ChannelData*>,
+		ChannelDifferenceRequest> _channelDifferenceQueue;
+
 	base::flat_map<
 		not_null<ChannelData*>,
 		mtpRequestId> _rangeDifferenceRequests;
@@ -104,6 +104,7 @@ constexpr auto kUnreadMentionsPreloadIfLess = 5;
 constexpr auto kUnreadMentionsFirstRequestLimit = 10;
 constexpr auto kUnreadMentionsNextRequestLimit = 100;
 constexpr auto kSharedMediaLimit = 100;
+constexpr auto kForwardMessagesLimit = 100;
 //constexpr auto kFeedMessagesLimit = 50; // #feed
 constexpr auto kReadFeaturedSetsTimeout = crl::time(1000);
 constexpr auto kFileLoaderQueueStopTimeout = crl::time(5000);
@@ -113,11 +114,43 @@ constexpr auto kNotifySettingSaveTimeout = crl::time(1000);
 constexpr auto kDialogsFirstLoad = 20;
 constexpr auto kDialogsPerPage = 500;
 constexpr auto kBlockedFirstSlice = 16;
+constexpr auto kFileReferenceMessagesPerRequest = 100;
+constexpr auto kStickerSetRequestsLimit = 8;
 
 using PhotoFileLocationId = Data::PhotoFileLocationId;
 using DocumentFileLocationId = Data::DocumentFileLocationId;
 using UpdatedFileReferences = Data::UpdatedFileReferences;
 
+// The stored slice is shown only until the real one arrives. Channels
+// pts from it would initialize the updates state with an old value and
+// make every channel request a difference, and an old draft would
+// replace the current one, so both are dropped.
+[[nodiscard]] QVector<MTPDialog> StripStoredDialogsState(
+		const QVector<MTPDialog> &dialogs) {
+	using Flag = MTPDdialog::Flag;
+	auto result = QVector<MTPDialog>();
+	result.reserve(dialogs.size());
+	for (const auto &dialog : dialogs) {
+		dialog.match([&](const MTPDdialog &data) {
+			result.push_back(MTP_dialog(
+				MTP_flags(data.vflags().v & ~(Flag::f_pts | Flag::f_draft)),
+				data.vpeer(),
+				data.vtop_message(),
+				data.vread_inbox_max_id(),
+				data.vread_outbox_max_id(),
+				data.vunread_count(),
+				data.vunread_mentions_count(),
+				data.vnotify_settings(),
+				MTPint(),
+				MTPDraftMessage(),
+				MTP_int(data.vfolder_id().value_or_empty())));
+		}, [&](const MTPDdialogFolder &) {
+			result.push_back(dialog);
+		});
+	}
+	return result;
+}
+
 } // namespace
 
 MTPInputPrivacyKey ApiWrap::Privacy::Input(Key key) {
@@ -183,14 +216,19 @@ ApiWrap::ApiWrap(not_null<Main::Session*> session)
 : MTP::Sender(&session->account().mtp())
 , _session(session)
 , _messageDataResolveDelayed([=] { resolveMessageDatas(); })
+, _peerRequestsTimer([=] { sendPeerRequests(); })
 , _webPagesTimer([=] { resolveWebPages(); })
 , _draftsSaveTimer([=] { saveDraftsToCloud(); })
 , _featuredSetsReadTimer([=] { readFeaturedSets(); })
+, _sharedMediaCountsTimer([=] { sendSharedMediaCountRequests(); })
 , _dialogsLoadState(std::make_unique<DialogsLoadState>())
-, _fileLoader(std::make_unique<TaskQueue>(kFileLoaderQueueStopTimeout))
+, _fileLoader(std::make_unique<TaskQueue>(
+	kFileLoaderQueueStopTimeout,
+	std::max(QThread::idealThreadCount() - 1, 1)))
 //, _feedReadTimer([=] { readFeeds(); }) // #feed
 , _topPromotionTimer([=] { refreshTopPromotion(); })
 , _updateNotifySettingsTimer([=] { sendNotifySettingsUpdates(); })
+, _fileReferenceMessagesTimer([=] { requestFileReferenceMessages(); })
 , _authorizations(std::make_unique<Api::Authorizations>(this))
 , _attachedStickers(std::make_unique<Api::AttachedStickers>(this))
 , _selfDestruct(std::make_unique<Api::SelfDestruct>(this))
@@ -213,6 +251,7 @@ ApiWrap::ApiWrap(not_null<Main::Session*> session)
 		}, _session->lifetime());
 
 		setupSupportMode();
+		applyStoredDialogs();
 	});
 }
 
@@ -864,6 +903,12 @@ void ApiWrap::requestMoreDialogs(Data::Folder *folder) {
 				count);
 		});
 
+		if (!folder && firstLoad) {
+			removeStoredDialogs(result);
+			if (!_session->supportMode()) {
+				local().writeDialogsSlice(result);
+			}
+		}
 		if (!folder
 			&& (!_dialogsLoadState || !_dialogsLoadState->listReceived)) {
 			refreshDialogsLoadBlocked();
@@ -882,6 +927,61 @@ void ApiWrap::requestMoreDialogs(Data::Folder *folder) {
 	}
 }
 
+void ApiWrap::applyStoredDialogs() {
+	if (_session->supportMode()
+		|| !_dialogsLoadState
+		|| _dialogsLoadState->offsetDate
+		|| _dialogsLoadState->listReceived) {
+		return;
+	}
+	const auto slice = local().readDialogsSlice();
+	if (!slice) {
+		return;
+	}
+	slice->match([](const MTPDmessages_dialogsNotModified &) {
+	}, [&](const auto &data) {
+		_session->data().processUsers(data.vusers());
+		_session->data().processChats(data.vchats());
+		_session->data().applyDialogs(
+			nullptr,
+			data.vmessages().v,
+			StripStoredDialogsState(data.vdialogs().v),
+			std::nullopt);
+		for (const auto &dialog : data.vdialogs().v) {
+			dialog.match([&](const MTPDdialog &data) {
+				if (const auto peerId = peerFromMTP(data.vpeer())) {
+					_storedDialogs.emplace(_session->data().history(peerId));
+				}
+			}, [](const MTPDdialogFolder &) {
+			});
+		}
+	});
+	_session->data().chatsListChanged(nullptr);
+}
+
+void ApiWrap::removeStoredDialogs(const MTPmessages_Dialogs &received) {
+	auto stored = base::take(_storedDialogs);
+	received.match([](const MTPDmessages_dialogsNotModified &) {
+	}, [&](const auto &data) {
+		for (const auto &dialog : data.vdialogs().v) {
+			dialog.match([&](const MTPDdialog &data) {
+				if (const auto peerId = peerFromMTP(data.vpeer())) {
+					stored.remove(_session->data().history(peerId));
+				}
+			}, [](const MTPDdialogFolder &) {
+			});
+		}
+	});
+
+	// Chats that dropped out of the first slice will be added back
+	// by the next slices, if they are still in the chats list at all.
+	for (const auto history : stored) {
+		if (!history->isPinnedDialog(FilterId())) {
+			_session->data().removeChatListEntry(history);
+		}
+	}
+}
+
 void ApiWrap::refreshDialogsLoadBlocked() {
 	_dialogsLoadMayBlockByDate = _dialogsLoadState
 		&& !_dialogsLoadState->listReceived
@@ -1193,37 +1293,84 @@ void ApiWrap::requestPeer(not_null<PeerData*> peer) {
 		return;
 	}
 
-	const auto requestId = [&] {
-		const auto failHandler = [=](const RPCError &error) {
-			_peerRequests.remove(peer);
-		};
-		const auto chatHandler = [=](const MTPmessages_Chats &result) {
-			_peerRequests.remove(peer);
-			const auto &chats = result.match([](const auto &data) {
-				return data.vchats();
-			});
-			_session->data().applyMaximumChatVersions(chats);
-			_session->data().processChats(chats);
-		};
+	// Peers requested in one tick are sent together in sendPeerRequests().
+	_peerRequests.insert(peer, mtpRequestId(0));
+	if (!_peerRequestsTimer.isActive()) {
+		_peerRequestsTimer.callOnce(kSmallDelayMs);
+	}
+}
+
+void ApiWrap::sendPeerRequests() {
+	using Peers = std::vector<not_null<PeerData*>>;
+	auto users = QVector<MTPInputUser>();
+	auto chats = QVector<MTPint>();
+	auto channels = QVector<MTPInputChannel>();
+	auto usersPeers = Peers();
+	auto chatsPeers = Peers();
+	auto channelsPeers = Peers();
+	for (auto i = _peerRequests.begin(); i != _peerRequests.end(); ++i) {
+		if (i.value()) {
+			continue;
+		}
+		const auto peer = i.key();
 		if (const auto user = peer->asUser()) {
-			return request(MTPusers_GetUsers(
-				MTP_vector<MTPInputUser>(1, user->inputUser)
-			)).done([=](const MTPVector<MTPUser> &result) {
-				_peerRequests.remove(user);
-				_session->data().processUsers(result);
-			}).fail(failHandler).send();
+			users.push_back(user->inputUser);
+			usersPeers.push_back(user);
 		} else if (const auto chat = peer->asChat()) {
-			return request(MTPmessages_GetChats(
-				MTP_vector<MTPint>(1, chat->inputChat)
-			)).done(chatHandler).fail(failHandler).send();
+			chats.push_back(chat->inputChat);
+			chatsPeers.push_back(chat);
 		} else if (const auto channel = peer->asChannel()) {
-			return request(MTPchannels_GetChannels(
-				MTP_vector<MTPInputChannel>(1, channel->inputChannel)
-			)).done(chatHandler).fail(failHandler).send();
+			channels.push_back(channel->inputChannel);
+			channelsPeers.push_back(channel);
 		}
-		Unexpected("Peer type in requestPeer.");
-	}();
-	_peerRequests.insert(peer, requestId);
+	}
+	const auto finish = [=](const Peers &peers) {
+		for (const auto peer : peers) {
+			_peerRequests.remove(peer);
+		}
+	};
+	const auto started = [&](const Peers &peers, mtpRequestId requestId) {
+		for (const auto peer : peers) {
+			_peerRequests[peer] = requestId;
+		}
+	};
+	const auto chatHandler = [=](const MTPmessages_Chats &result) {
+		const auto &chats = result.match([](const auto &data) {
+			return data.vchats();
+		});
+		_session->data().applyMaximumChatVersions(chats);
+		_session->data().processChats(chats);
+	};
+	if (!users.isEmpty()) {
+		started(usersPeers, request(MTPusers_GetUsers(
+			MTP_vector<MTPInputUser>(users)
+		)).done([=](const MTPVector<MTPUser> &result) {
+			finish(usersPeers);
+			_session->data().processUsers(result);
+		}).fail([=](const RPCError &error) {
+			finish(usersPeers);
+		}).send());
+	}
+	if (!chats.isEmpty()) {
+		started(chatsPeers, request(MTPmessages_GetChats(
+			MTP_vector<MTPint>(chats)
+		)).done([=](const MTPmessages_Chats &result) {
+			finish(chatsPeers);
+			chatHandler(result);
+		}).fail([=](const RPCError &error) {
+			finish(chatsPeers);
+		}).send());
+	}
+	if (!channels.isEmpty()) {
+		started(channelsPeers, request(MTPchannels_GetChannels(
+			MTP_vector<MTPInputChannel>(channels)
+		)).done([=](const MTPmessages_Chats &result) {
+			finish(channelsPeers);
+			chatHandler(result);
+		}).fail([=](const RPCError &error) {
+			finish(channelsPeers);
+		}).send());
+	}
 }
 
 void ApiWrap::requestPeerSettings(not_null<PeerData*> peer) {
@@ -1392,48 +1539,11 @@ void ApiWrap::markMediaRead(not_null<HistoryItem*> item) {
 }
 
 void ApiWrap::requestPeers(const QList<PeerData*> &peers) {
-	QVector<MTPint> chats;
-	QVector<MTPInputChannel> channels;
-	QVector<MTPInputUser> users;
-	chats.reserve(peers.size());
-	channels.reserve(peers.size());
-	users.reserve(peers.size());
 	for (const auto peer : peers) {
-		if (!peer
-			|| _fullPeerRequests.contains(peer)
-			|| _peerRequests.contains(peer)) {
-			continue;
-		}
-		if (const auto user = peer->asUser()) {
-			users.push_back(user->inputUser);
-		} else if (const auto chat = peer->asChat()) {
-			chats.push_back(chat->inputChat);
-		} else if (const auto channel = peer->asChannel()) {
-			channels.push_back(channel->inputChannel);
+		if (peer) {
+			requestPeer(peer);
 		}
 	}
-	const auto handleChats = [=](const MTPmessages_Chats &result) {
-		_session->data().processChats(result.match([](const auto &data) {
-			return data.vchats();
-		}));
-	};
-	if (!chats.isEmpty()) {
-		request(MTPmessages_GetChats(
-			MTP_vector<MTPint>(chats)
-		)).done(handleChats).send();
-	}
-	if (!channels.isEmpty()) {
-		request(MTPchannels_GetChannels(
-			MTP_vector<MTPInputChannel>(channels)
-		)).done(handleChats).send();
-	}
-	if (!users.isEmpty()) {
-		request(MTPusers_GetUsers(
-			MTP_vector<MTPInputUser>(users)
-		)).done([=](const MTPVector<MTPUser> &result) {
-			_session->data().processUsers(result);
-		}).send();
-	}
 }
 
 void ApiWrap::requestLastParticipants(not_null<ChannelData*> channel) {
@@ -1846,15 +1956,28 @@ void ApiWrap::scheduleStickerSetRequest(uint64 setId, uint64 access) {
 }
 
 void ApiWrap::requestStickerSets() {
-	for (auto i = _stickerSetRequests.begin(), j = i, e = _stickerSetRequests.end(); i != e; i = j) {
-		++j;
-		if (i.value().second) continue;
-
-		auto waitMs = (j == e) ? 0 : kSmallDelayMs;
-		i.value().second = request(MTPmessages_GetStickerSet(MTP_inputStickerSetID(MTP_long(i.key()), MTP_long(i.value().first)))).done([this, setId = i.key()](const MTPmessages_StickerSet &result) {
+	// After a long break all the sets may need a refresh, send them
+	// a few at a time and continue when the previous ones are done.
+	auto sending = std::vector<uint64>();
+	auto inFlight = 0;
+	for (auto i = _stickerSetRequests.begin(), e = _stickerSetRequests.end(); i != e; ++i) {
+		if (i.value().second) {
+			++inFlight;
+		} else if (inFlight + int(sending.size()) < kStickerSetRequestsLimit) {
+			sending.push_back(i.key());
+		}
+	}
+	for (const auto setId : sending) {
+		auto &entry = _stickerSetRequests[setId];
+		const auto waitMs = (setId == sending.back()) ? 0 : kSmallDelayMs;
+		entry.second = request(MTPmessages_GetStickerSet(
+			MTP_inputStickerSetID(MTP_long(setId), MTP_long(entry.first))
+		)).done([=](const MTPmessages_StickerSet &result) {
 			gotStickerSet(setId, result);
-		}).fail([this, setId = i.key()](const RPCError &error) {
+			requestStickerSets();
+		}).fail([=](const RPCError &error) {
 			_stickerSetRequests.remove(setId);
+			requestStickerSets();
 		}).afterDelay(waitMs).send();
 	}
 }
@@ -2709,41 +2832,86 @@ void ApiWrap::requestFileReference(
 
 	request(std::move(data)).done([=](const auto &result) {
 		const auto parsed = Data::GetFileReferences(result);
-		for (const auto &p : parsed.data) {
-			// Unpack here the parsed pair by hand to workaround a GCC bug.
-			// See https://gcc.gnu.org/bugzilla/show_bug.cgi?id=87122
-			const auto &origin = p.first;
-			const auto &reference = p.second;
-			const auto documentId = std::get_if<DocumentFileLocationId>(
-				&origin);
-			if (documentId) {
-				_session->data().document(
-					documentId->id
-				)->refreshFileReference(reference);
-			}
-			const auto photoId = std::get_if<PhotoFileLocationId>(&origin);
-			if (photoId) {
-				_session->data().photo(
-					photoId->id
-				)->refreshFileReference(reference);
-			}
+		applyFileReferences(parsed);
+		finishFileReference(origin, parsed);
+	}).fail([=](const RPCError &error) {
+		finishFileReference(origin, UpdatedFileReferences());
+	}).send();
+}
+
+void ApiWrap::applyFileReferences(const UpdatedFileReferences &parsed) {
+	for (const auto &p : parsed.data) {
+		// Unpack here the parsed pair by hand to workaround a GCC bug.
+		// See https://gcc.gnu.org/bugzilla/show_bug.cgi?id=87122
+		const auto &origin = p.first;
+		const auto &reference = p.second;
+		const auto documentId = std::get_if<DocumentFileLocationId>(
+			&origin);
+		if (documentId) {
+			_session->data().document(
+				documentId->id
+			)->refreshFileReference(reference);
 		}
-		const auto i = _fileReferenceHandlers.find(origin);
-		Assert(i != end(_fileReferenceHandlers));
-		auto handlers = std::move(i->second);
-		_fileReferenceHandlers.erase(i);
-		for (auto &handler : handlers) {
-			handler(parsed);
+		const auto photoId = std::get_if<PhotoFileLocationId>(&origin);
+		if (photoId) {
+			_session->data().photo(
+				photoId->id
+			)->refreshFileReference(reference);
 		}
-	}).fail([=](const RPCError &error) {
-		const auto i = _fileReferenceHandlers.find(origin);
-		Assert(i != end(_fileReferenceHandlers));
-		auto handlers = std::move(i->second);
-		_fileReferenceHandlers.erase(i);
-		for (auto &handler : handlers) {
-			handler(UpdatedFileReferences());
+	}
+}
+
+void ApiWrap::finishFileReference(
+		Data::FileOrigin origin,
+		const UpdatedFileReferences &parsed) {
+	const auto i = _fileReferenceHandlers.find(origin);
+	Assert(i != end(_fileReferenceHandlers));
+	auto handlers = std::move(i->second);
+	_fileReferenceHandlers.erase(i);
+	for (auto &handler : handlers) {
+		handler(parsed);
+	}
+}
+
+void ApiWrap::requestFileReferenceMessages() {
+	for (const auto &[channel, ids] : base::take(_fileReferenceMessages)) {
+		for (auto from = begin(ids); from != end(ids);) {
+			const auto till = (end(ids) - from
+				> kFileReferenceMessagesPerRequest)
+				? (from + kFileReferenceMessagesPerRequest)
+				: end(ids);
+			const auto chunk = std::vector<FullMsgId>(from, till);
+			from = till;
+
+			auto inputs = QVector<MTPInputMessage>();
+			inputs.reserve(chunk.size());
+			for (const auto &id : chunk) {
+				inputs.push_back(MTP_inputMessageID(MTP_int(id.msg)));
+			}
+			const auto done = [=](const MTPmessages_Messages &result) {
+				const auto parsed = Data::GetFileReferences(result);
+				applyFileReferences(parsed);
+				for (const auto &id : chunk) {
+					finishFileReference(id, parsed);
+				}
+			};
+			const auto fail = [=](const RPCError &error) {
+				for (const auto &id : chunk) {
+					finishFileReference(id, UpdatedFileReferences());
+				}
+			};
+			if (channel) {
+				request(MTPchannels_GetMessages(
+					channel->inputChannel,
+					MTP_vector<MTPInputMessage>(inputs)
+				)).done(done).fail(fail).send();
+			} else {
+				request(MTPmessages_GetMessages(
+					MTP_vector<MTPInputMessage>(inputs)
+				)).done(done).fail(fail).send();
+			}
 		}
-	}).send();
+	}
 }
 
 void ApiWrap::refreshFileReference(
@@ -2788,17 +2956,23 @@ void ApiWrap::refreshFileReference(
 				request(MTPmessages_GetScheduledMessages(
 					item->history()->peer->input,
 					MTP_vector<MTPint>(1, MTP_int(realId))));
-			} else if (const auto channel = item->history()->peer->asChannel()) {
-				request(MTPchannels_GetMessages(
-					channel->inputChannel,
-					MTP_vector<MTPInputMessage>(
-						1,
-						MTP_inputMessageID(MTP_int(item->id)))));
 			} else {
-				request(MTPmessages_GetMessages(
-					MTP_vector<MTPInputMessage>(
-						1,
-						MTP_inputMessageID(MTP_int(item->id)))));
+				const auto i = _fileReferenceHandlers.find(origin);
+				if (i != end(_fileReferenceHandlers)) {
+					i->second.push_back(std::move(handler));
+					return;
+				}
+
+				// Messages are requested together, a chat with outdated
+				// references usually needs many of them at once.
+				auto handlers = std::vector<FileReferencesHandler>();
+				handlers.push_back(std::move(handler));
+				_fileReferenceHandlers.emplace(origin, std::move(handlers));
+				const auto channel = item->history()->peer->asChannel();
+				_fileReferenceMessages[channel].push_back(data);
+				if (!_fileReferenceMessagesTimer.isActive()) {
+					_fileReferenceMessagesTimer.callOnce(kSmallDelayMs);
+				}
 			}
 		} else {
 			fail();
@@ -2900,6 +3074,8 @@ void ApiWrap::stickersSaveOrder() {
 }
 
 void ApiWrap::updateStickers() {
+	_session->readStickersIfNeeded();
+
 	auto now = crl::now();
 	requestStickers(now);
 	requestRecentStickers(now);
@@ -3491,7 +3667,73 @@ void ApiWrap::addChatParticipants(
 void ApiWrap::requestSharedMediaCount(
 		not_null<PeerData*> peer,
 		Storage::SharedMediaType type) {
-	requestSharedMedia(peer, type, 0, SliceType::Before);
+	const auto key = std::make_tuple(peer, type, MsgId(0), SliceType::Before);
+	if (_sharedMediaRequests.contains(key)) {
+		return;
+	}
+
+	// Counters requested in one tick are sent in one request per peer.
+	_sharedMediaRequests.emplace(key);
+	_sharedMediaCountRequests[peer].emplace(type);
+	if (!_sharedMediaCountsTimer.isActive()) {
+		_sharedMediaCountsTimer.callOnce(kSmallDelayMs);
+	}
+}
+
+void ApiWrap::sendSharedMediaCountRequests() {
+	for (auto &[peer, types] : base::take(_sharedMediaCountRequests)) {
+		auto filters = QVector<MTPMessagesFilter>();
+		filters.reserve(types.size());
+		for (const auto type : types) {
+			const auto filter = Api::PrepareSearchFilter(type);
+			if (filter.type() != mtpc_inputMessagesFilterEmpty) {
+				filters.push_back(filter);
+			} else {
+				_sharedMediaRequests.remove(
+					std::make_tuple(peer, type, MsgId(0), SliceType::Before));
+			}
+		}
+		if (filters.isEmpty()) {
+			continue;
+		}
+		const auto finish = [=, types = std::move(types)] {
+			for (const auto type : types) {
+				_sharedMediaRequests.remove(
+					std::make_tuple(peer, type, MsgId(0), SliceType::Before));
+			}
+		};
+		request(MTPmessages_GetSearchCounters(
+			peer->input,
+			MTP_vector<MTPMessagesFilter>(filters)
+		)).done([=](const MTPVector<MTPmessages_SearchCounter> &result) {
+			finish();
+			sharedMediaCountsDone(peer, result);
+		}).fail([=](const RPCError &error) {
+			finish();
+		}).send();
+	}
+}
+
+void ApiWrap::sharedMediaCountsDone(
+		not_null<PeerData*> peer,
+		const MTPVector<MTPmessages_SearchCounter> &result) {
+	for (const auto &counter : result.v) {
+		counter.match([&](const MTPDmessages_searchCounter &data) {
+			const auto filter = data.vfilter().type();
+			for (auto i = 0; i != int(SharedMediaType::kCount); ++i) {
+				const auto type = SharedMediaType(i);
+				if (Api::PrepareSearchFilter(type).type() != filter) {
+					continue;
+				}
+				_session->storage().add(Storage::SharedMediaAddSlice(
+					peer->id,
+					type,
+					{},
+					MsgRange(),
+					data.vcount().v));
+			}
+		});
+	}
 }
 
 void ApiWrap::requestSharedMedia(
@@ -3499,6 +3741,10 @@ void ApiWrap::requestSharedMedia(
 		SharedMediaType type,
 		MsgId messageId,
 		SliceType slice) {
+	if (!messageId) {
+		requestSharedMediaCount(peer, type);
+		return;
+	}
 	const auto key = std::make_tuple(peer, type, messageId, slice);
 	if (_sharedMediaRequests.contains(key)) {
 		return;
@@ -4035,6 +4281,8 @@ void ApiWrap::forwardMessages(
 		if (forwardFrom != newFrom) {
 			sendAccumulated();
 			forwardFrom = newFrom;
+		} else if (ids.size() == kForwardMessagesLimit) {
+			sendAccumulated();
 		}
 		ids.push_back(MTP_int(item->id));
 		randomIds.push_back(MTP_long(randomId));
@@ -5360,6 +5608,9 @@ void ApiWrap::reloadPollResults(not_null<HistoryItem*> item) {
 		|| _pollReloadRequestIds.contains(itemId)) {
 		return;
 	}
+	if (!pollResultsReloadCollecting()) {
+		_pollReloadCollectStarted = crl::now();
+	}
 	const auto requestId = request(MTPmessages_GetPollResults(
 		item->history()->peer->input,
 		MTP_int(item->id)
@@ -5368,10 +5619,15 @@ void ApiWrap::reloadPollResults(not_null<HistoryItem*> item) {
 		applyUpdates(result);
 	}).fail([=](const RPCError &error) {
 		_pollReloadRequestIds.erase(itemId);
-	}).send();
+	}).afterDelay(kSmallDelayMs).send();
 	_pollReloadRequestIds.emplace(itemId, requestId);
 }
 
+bool ApiWrap::pollResultsReloadCollecting() const {
+	return _pollReloadCollectStarted
+		&& (crl::now() - _pollReloadCollectStarted <= kSmallDelayMs);
+}
+
 // // #feed
 //void ApiWrap::readFeed(
 //		not_null<Data::Feed*> feed,
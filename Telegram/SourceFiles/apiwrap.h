@@ -476,6 +476,7 @@ public:
 		const std::vector<QByteArray> &options);
 	void closePoll(not_null<HistoryItem*> item);
 	void reloadPollResults(not_null<HistoryItem*> item);
+	[[nodiscard]] bool pollResultsReloadCollecting() const;
 
 private:
 	struct MessageDataRequest {
@@ -504,6 +505,8 @@ private:
 	};
 
 	void setupSupportMode();
+	void applyStoredDialogs();
+	void removeStoredDialogs(const MTPmessages_Dialogs &received);
 	void refreshDialogsLoadBlocked();
 	void updateDialogsOffset(
 		Data::Folder *folder,
@@ -534,6 +537,7 @@ private:
 		not_null<UserData*> user,
 		const MTPUserFull &result,
 		mtpRequestId req);
+	void sendPeerRequests();
 	void applyLastParticipantsList(
 		not_null<ChannelData*> channel,
 		int availableCount,
@@ -583,6 +587,10 @@ private:
 		MsgId messageId,
 		SliceType slice,
 		const MTPmessages_Messages &result);
+	void sendSharedMediaCountRequests();
+	void sharedMediaCountsDone(
+		not_null<PeerData*> peer,
+		const MTPVector<MTPmessages_SearchCounter> &result);
 
 	void userPhotosDone(
 		not_null<UserData*> user,
@@ -648,6 +656,11 @@ private:
 		Data::FileOrigin origin,
 		FileReferencesHandler &&handler,
 		Request &&data);
+	void applyFileReferences(const UpdatedFileReferences &parsed);
+	void finishFileReference(
+		Data::FileOrigin origin,
+		const UpdatedFileReferences &parsed);
+	void requestFileReferenceMessages();
 
 	void photoUploadReady(const FullMsgId &msgId, const MTPInputFile &file);
 
@@ -673,6 +686,7 @@ private:
 	using PeerRequests = QMap<PeerData*, mtpRequestId>;
 	PeerRequests _fullPeerRequests;
 	PeerRequests _peerRequests;
+	base::Timer _peerRequestsTimer;
 	base::flat_set<not_null<PeerData*>> _requestedPeerSettings;
 
 	PeerRequests _participantsRequests;
@@ -734,6 +748,10 @@ private:
 		SharedMediaType,
 		MsgId,
 		SliceType>> _sharedMediaRequests;
+	base::flat_map<
+		not_null<PeerData*>,
+		base::flat_set<SharedMediaType>> _sharedMediaCountRequests;
+	base::Timer _sharedMediaCountsTimer;
 
 	base::flat_map<not_null<UserData*>, mtpRequestId> _userPhotosRequests;
 
@@ -755,6 +773,7 @@ private:
 	TimeId _dialogsLoadTill = 0;
 	rpl::variable<bool> _dialogsLoadMayBlockByDate = false;
 	rpl::variable<bool> _dialogsLoadBlockedByDate = false;
+	base::flat_set<not_null<History*>> _storedDialogs;
 
 	base::flat_map<
 		not_null<Data::Folder*>,
@@ -785,6 +804,10 @@ private:
 	std::map<
 		Data::FileOrigin,
 		std::vector<FileReferencesHandler>> _fileReferenceHandlers;
+	base::flat_map<
+		ChannelData*,
+		std::vector<FullMsgId>> _fileReferenceMessages;
+	base::Timer _fileReferenceMessagesTimer;
 
 	mtpRequestId _deepLinkInfoRequestId = 0;
 
@@ -833,6 +856,7 @@ private:
 	base::flat_map<FullMsgId, mtpRequestId> _pollVotesRequestIds;
 	base::flat_map<FullMsgId, mtpRequestId> _pollCloseRequestIds;
 	base::flat_map<FullMsgId, mtpRequestId> _pollReloadRequestIds;
+	crl::time _pollReloadCollectStarted = 0;
 
 	mtpRequestId _wallPaperRequestId = 0;
 	QString _wallPaperSlug;
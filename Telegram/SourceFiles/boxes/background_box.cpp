@@ -13,6 +13,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/ui_utility.h"
 #include "main/main_session.h"
 #include "apiwrap.h"
+#include "base/binary_guard.h"
 #include "mtproto/sender.h"
 #include "data/data_session.h"
 #include "data/data_file_origin.h"
@@ -84,6 +85,7 @@ private:
 		Data::WallPaper data;
 		mutable std::shared_ptr<Data::DocumentMedia> dataMedia;
 		mutable QPixmap thumbnail;
+		mutable base::binary_guard generating;
 	};
 	struct Selected {
 		int index = 0;
@@ -115,8 +117,8 @@ private:
 		Painter &p,
 		const Paper &paper,
 		int column,
-		int row) const;
-	void validatePaperThumbnail(const Paper &paper) const;
+		int row);
+	void validatePaperThumbnail(const Paper &paper);
 
 	const not_null<Main::Session*> _session;
 	MTP::Sender _api;
@@ -308,9 +310,8 @@ void BackgroundBox::Inner::paintEvent(QPaintEvent *e) {
 	}
 }
 
-void BackgroundBox::Inner::validatePaperThumbnail(
-		const Paper &paper) const {
-	if (!paper.thumbnail.isNull()) {
+void BackgroundBox::Inner::validatePaperThumbnail(const Paper &paper) {
+	if (!paper.thumbnail.isNull() || paper.generating.alive()) {
 		return;
 	}
 	const auto localThumbnail = paper.data.localThumbnail();
@@ -328,26 +329,50 @@ void BackgroundBox::Inner::validatePaperThumbnail(
 	const auto thumbnail = localThumbnail
 		? localThumbnail
 		: paper.dataMedia->thumbnail();
-	auto original = thumbnail->original();
-	if (paper.data.isPattern()) {
-		const auto color = *paper.data.backgroundColor();
-		original = Data::PreparePatternImage(
-			std::move(original),
-			color,
-			Data::PatternColor(color),
-			paper.data.patternIntensity());
-	}
-	paper.thumbnail = App::pixmapFromImageInPlace(TakeMiddleSample(
-		original,
-		st::backgroundSize));
-	paper.thumbnail.setDevicePixelRatio(cRetinaFactor());
+
+	// Patterns are colorized in full size, do it out of the paint event.
+	const auto id = paper.data.id();
+	const auto size = st::backgroundSize;
+	const auto pattern = paper.data.isPattern();
+	const auto color = pattern
+		? *paper.data.backgroundColor()
+		: QColor();
+	const auto intensity = paper.data.patternIntensity();
+	crl::async([
+		=,
+		original = thumbnail->original(),
+		guard = paper.generating.make_guard()
+	]() mutable {
+		if (pattern) {
+			original = Data::PreparePatternImage(
+				std::move(original),
+				color,
+				Data::PatternColor(color),
+				intensity);
+		}
+		crl::on_main(std::move(guard), [
+			=,
+			result = TakeMiddleSample(std::move(original), size)
+		]() mutable {
+			const auto i = ranges::find(
+				_papers,
+				id,
+				[](const Paper &paper) { return paper.data.id(); });
+			if (i == end(_papers)) {
+				return;
+			}
+			i->thumbnail = App::pixmapFromImageInPlace(std::move(result));
+			i->thumbnail.setDevicePixelRatio(cRetinaFactor());
+			repaintPaper(i - begin(_papers));
+		});
+	});
 }
 
 void BackgroundBox::Inner::paintPaper(
 		Painter &p,
 		const Paper &paper,
 		int column,
-		int row) const {
+		int row) {
 	const auto x = st::backgroundPadding + column * (st::backgroundSize.width() + st::backgroundPadding);
 	const auto y = st::backgroundPadding + row * (st::backgroundSize.height() + st::backgroundPadding);
 	validatePaperThumbnail(paper);
@@ -38,6 +38,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace {
 
 constexpr auto kSaveSettingsDelayedTimeout = crl::time(1000);
+constexpr auto kRecheckProxiesTimeout = 30 * crl::time(1000);
 
 using ProxyData = MTP::ProxyData;
 
@@ -1050,7 +1051,8 @@ void ProxyBox::addLabel(
 
 ProxiesBoxController::ProxiesBoxController(not_null<Main::Account*> account)
 : _account(account)
-, _saveTimer([] { Local::writeSettings(); }) {
+, _saveTimer([] { Local::writeSettings(); })
+, _recheckTimer([=] { recheckItems(); }) {
 	_list = ranges::view::all(
 		Global::ProxiesList()
 	) | ranges::view::transform([&](const ProxyData &proxy) {
@@ -1068,6 +1070,7 @@ ProxiesBoxController::ProxiesBoxController(not_null<Main::Account*> account)
 	for (auto &item : _list) {
 		refreshChecker(item);
 	}
+	_recheckTimer.callEach(kRecheckProxiesTimeout);
 }
 
 void ProxiesBoxController::ShowApplyConfirmation(
@@ -1184,6 +1187,22 @@ void ProxiesBoxController::refreshChecker(Item &item) {
 	}
 }
 
+void ProxiesBoxController::recheckItems() {
+	// Keep the last known state and ping shown while checking again.
+	for (auto &item : _list) {
+		if (item.deleted || item.checker || item.checkerv6) {
+			continue;
+		}
+		const auto was = item.state;
+		refreshChecker(item);
+		if (item.state == ItemState::Checking) {
+			item.state = was;
+		} else {
+			updateView(item);
+		}
+	}
+}
+
 void ProxiesBoxController::setupChecker(int id, const Checker &checker) {
 	using Connection = MTP::details::AbstractConnection;
 	const auto pointer = checker.get();
@@ -1192,11 +1211,9 @@ void ProxiesBoxController::setupChecker(int id, const Checker &checker) {
 		const auto pingTime = pointer->pingTime();
 		item->checker = nullptr;
 		item->checkerv6 = nullptr;
-		if (item->state == ItemState::Checking) {
-			item->state = ItemState::Available;
-			item->ping = pingTime;
-			updateView(*item);
-		}
+		item->state = ItemState::Available;
+		item->ping = pingTime;
+		updateView(*item);
 	});
 	const auto failed = [=] {
 		const auto item = findById(id);
@@ -1204,10 +1221,10 @@ void ProxiesBoxController::setupChecker(int id, const Checker &checker) {
 			item->checker = nullptr;
 		} else if (item->checkerv6 == pointer) {
 			item->checkerv6 = nullptr;
+		} else {
+			return;
 		}
-		if (!item->checker
-			&& !item->checkerv6
-			&& item->state == ItemState::Checking) {
+		if (!item->checker && !item->checkerv6) {
 			item->state = ItemState::Unavailable;
 			updateView(*item);
 		}
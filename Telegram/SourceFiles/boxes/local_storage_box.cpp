@@ -17,6 +17,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/text/format_values.h"
 #include "ui/emoji_config.h"
 #include "storage/storage_account.h"
+#include "storage/storage_memory_cache.h"
 #include "storage/cache/storage_cache_database.h"
 #include "data/data_session.h"
 #include "lang/lang_keys.h"
@@ -346,6 +347,7 @@ auto LocalStorageBox::summary() const -> Database::TaggedSummary {
 }
 
 void LocalStorageBox::clearByTag(uint16 tag) {
+	_session->data().cacheMemory().clear();
 	if (tag == kFakeMediaCacheTag) {
 		_dbBig->clear();
 	} else if (tag) {
@@ -811,6 +811,7 @@ void PeerListContent::addToSearchIndex(not_null<PeerListRow*> row) {
 	for (auto ch : row->nameFirstLetters()) {
 		_searchIndex[ch].push_back(row);
 	}
+	_searchIndexChanged = true;
 }
 
 void PeerListContent::removeFromSearchIndex(not_null<PeerListRow*> row) {
@@ -920,6 +921,7 @@ void PeerListContent::clearAllContent() {
 	_rowsByPeer.clear();
 	_filterResults.clear();
 	_searchIndex.clear();
+	_searchWords.clear();
 	_rows.clear();
 	_searchRows.clear();
 	_searchQuery
@@ -1537,35 +1539,49 @@ void PeerListContent::searchQueryChanged(QString query) {
 	const auto searchWordsList = TextUtilities::PrepareSearchWords(query);
 	const auto normalizedQuery = searchWordsList.join(' ');
 	if (_normalizedSearchQuery != normalizedQuery) {
+		// If each previous word is a start of some new word, every row
+		// matching the new query matched the previous one as well.
+		const auto narrowing = !_searchIndexChanged
+			&& !_searchWords.isEmpty()
+			&& ranges::all_of(_searchWords, [&](const QString &was) {
+				return ranges::any_of(searchWordsList, [&](
+						const QString &word) {
+					return word.startsWith(was);
+				});
+			});
+		auto previous = narrowing
+			? base::take(_filterResults)
+			: std::vector<not_null<PeerListRow*>>();
+
+		// Search result rows are destroyed in setSearchQuery().
+		previous.erase(
+			ranges::remove_if(previous, &PeerListRow::isSearchResult),
+			end(previous));
 		setSearchQuery(query, normalizedQuery);
+		_searchWords = searchWordsList;
+		_searchIndexChanged = false;
 		if (_controller->searchInLocal() && !searchWordsList.isEmpty()) {
-			auto minimalList = (const std::vector<not_null<PeerListRow*>>*)nullptr;
-			for (const auto &searchWord : searchWordsList) {
-				auto searchWordStart = searchWord[0].toLower();
-				auto it = _searchIndex.find(searchWordStart);
-				if (it == _searchIndex.cend()) {
-					// Some word can't be found in any row.
-					minimalList = nullptr;
-					break;
-				} else if (!minimalList || minimalList->size() > it->second.size()) {
-					minimalList = &it->second;
+			auto minimalList = narrowing
+				? &previous
+				: (const std::vector<not_null<PeerListRow*>>*)nullptr;
+			if (!narrowing) {
+				for (const auto &searchWord : searchWordsList) {
+					auto searchWordStart = searchWord[0].toLower();
+					auto it = _searchIndex.find(searchWordStart);
+					if (it == _searchIndex.cend()) {
+						// Some word can't be found in any row.
+						minimalList = nullptr;
+						break;
+					} else if (!minimalList || minimalList->size() > it->second.size()) {
+						minimalList = &it->second;
+					}
 				}
 			}
 			if (minimalList) {
-				auto searchWordInNames = [](
-						not_null<PeerData*> peer,
-						const QString &searchWord) {
-					for (auto &nameWord : peer->nameWords()) {
-						if (nameWord.startsWith(searchWord)) {
-							return true;
-						}
-					}
-					return false;
-				};
 				auto allSearchWordsInNames = [&](
 						not_null<PeerData*> peer) {
 					for (const auto &searchWord : searchWordsList) {
-						if (!searchWordInNames(peer, searchWord)) {
+						if (!peer->hasNameWordStartingWith(searchWord)) {
 							return false;
 						}
 					}
@@ -1758,6 +1774,13 @@ int PeerListContent::getRowTop(RowIndex index) const {
 	return -1;
 }
 
+bool PeerListContent::rowVisible(not_null<PeerListRow*> row) {
+	const auto top = getRowTop(findRowIndex(row));
+	return (top >= 0)
+		&& (top < _visibleBottom)
+		&& (top + _rowHeight > _visibleTop);
+}
+
 void PeerListContent::updateRow(not_null<PeerListRow*> row, RowIndex hint) {
 	updateRow(findRowIndex(row, hint));
 }
@@ -528,6 +528,7 @@ public:
 	void updateRow(not_null<PeerListRow*> row) {
 		updateRow(row, RowIndex());
 	}
+	[[nodiscard]] bool rowVisible(not_null<PeerListRow*> row);
 	void removeRow(not_null<PeerListRow*> row);
 	void convertRowToSearchResult(not_null<PeerListRow*> row);
 	int fullRowsCount() const;
@@ -703,6 +704,8 @@ private:
 	std::map<QChar, std::vector<not_null<PeerListRow*>>> _searchIndex;
 	QString _searchQuery;
 	QString _normalizedSearchQuery;
+	QStringList _searchWords;
+	bool _searchIndexChanged = false;
 	QString _mentionHighlight;
 	std::vector<not_null<PeerListRow*>> _filterResults;
 
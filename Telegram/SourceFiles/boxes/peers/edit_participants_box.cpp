@@ -997,7 +997,7 @@ auto ParticipantsBoxController::saveState() const
 	auto my = std::make_unique<SavedState>(_additional);
 	my->offset = _offset;
 	my->allLoaded = _allLoaded;
-	my->wasLoading = (_loadRequestId != 0);
+	my->wasLoading = _loadWaiting;
 	if (const auto search = searchController()) {
 		my->searchState = search->saveState();
 	}
@@ -1054,6 +1054,8 @@ void ParticipantsBoxController::restoreState(
 		if (const auto requestId = base::take(_loadRequestId)) {
 			_api.request(requestId).cancel();
 		}
+		_preloaded = std::nullopt;
+		_loadWaiting = false;
 
 		_additional = std::move(my->additional);
 		_offset = my->offset;
@@ -1257,15 +1259,31 @@ void ParticipantsBoxController::rebuildRowTypes() {
 void ParticipantsBoxController::loadMoreRows() {
 	if (searchController() && searchController()->loadMoreRows()) {
 		return;
-	} else if (!_peer->isChannel() || _loadRequestId || _allLoaded) {
+	} else if (!_peer->isChannel() || _allLoaded) {
 		return;
+	} else if (feedMegagroupLastParticipants()) {
+		return;
+	} else if (_preloaded) {
+		applyParticipants(*base::take(_preloaded));
+		preloadMoreRows();
+		return;
+	}
+	_loadWaiting = true;
+	if (!_loadRequestId) {
+		requestParticipants();
 	}
+}
 
-	const auto channel = _peer->asChannel();
-	if (feedMegagroupLastParticipants()) {
-		return;
+void ParticipantsBoxController::preloadMoreRows() {
+	// Keep one page ahead of the list, so that scrolling a large list
+	// doesn't wait for each page to be received.
+	if (!_allLoaded && !_loadRequestId && !_preloaded && _offset > 0) {
+		requestParticipants();
 	}
+}
 
+void ParticipantsBoxController::requestParticipants() {
+	const auto channel = _peer->asChannel();
 	const auto filter = [&] {
 		if (_role == Role::Members || _role == Role::Profile) {
 			return MTP_channelParticipantsRecent();
@@ -1290,53 +1308,64 @@ void ParticipantsBoxController::loadMoreRows() {
 		MTP_int(perPage),
 		MTP_int(participantsHash)
 	)).done([=](const MTPchannels_ChannelParticipants &result) {
-		const auto firstLoad = !_offset;
 		_loadRequestId = 0;
-
-		auto wasRecentRequest = firstLoad
-			&& (_role == Role::Members || _role == Role::Profile);
-		auto parseParticipants = [&](auto &&result, auto &&callback) {
-			if (wasRecentRequest) {
-				channel->session().api().parseRecentChannelParticipants(
-					channel,
-					result,
-					callback);
-			} else {
-				channel->session().api().parseChannelParticipants(
-					channel,
-					result,
-					callback);
-			}
-		};
-		parseParticipants(result, [&](
-				int availableCount,
-				const QVector<MTPChannelParticipant> &list) {
-			for (const auto &data : list) {
-				if (const auto user = _additional.applyParticipant(data)) {
-					appendRow(user);
-				}
-			}
-			if (const auto size = list.size()) {
-				_offset += size;
-			} else {
-				// To be sure - wait for a whole empty result list.
-				_allLoaded = true;
-			}
-		});
-
-		if (_allLoaded
-			|| (firstLoad && delegate()->peerListFullRowsCount() > 0)) {
-			refreshDescription();
-		}
-		if (_onlineSorter) {
-			_onlineSorter->sort();
+		if (base::take(_loadWaiting)) {
+			applyParticipants(result);
+			preloadMoreRows();
+		} else {
+			_preloaded = result;
 		}
-		delegate()->peerListRefreshRows();
 	}).fail([this](const RPCError &error) {
 		_loadRequestId = 0;
+		_loadWaiting = false;
 	}).send();
 }
 
+void ParticipantsBoxController::applyParticipants(
+		const MTPchannels_ChannelParticipants &result) {
+	const auto channel = _peer->asChannel();
+	const auto firstLoad = !_offset;
+	auto wasRecentRequest = firstLoad
+		&& (_role == Role::Members || _role == Role::Profile);
+	auto parseParticipants = [&](auto &&result, auto &&callback) {
+		if (wasRecentRequest) {
+			channel->session().api().parseRecentChannelParticipants(
+				channel,
+				result,
+				callback);
+		} else {
+			channel->session().api().parseChannelParticipants(
+				channel,
+				result,
+				callback);
+		}
+	};
+	parseParticipants(result, [&](
+			int availableCount,
+			const QVector<MTPChannelParticipant> &list) {
+		for (const auto &data : list) {
+			if (const auto user = _additional.applyParticipant(data)) {
+				appendRow(user);
+			}
+		}
+		if (const auto size = list.size()) {
+			_offset += size;
+		} else {
+			// To be sure - wait for a whole empty result list.
+			_allLoaded = true;
+		}
+	});
+
+	if (_allLoaded
+		|| (firstLoad && delegate()->peerListFullRowsCount() > 0)) {
+		refreshDescription();
+	}
+	if (_onlineSorter) {
+		_onlineSorter->sort();
+	}
+	delegate()->peerListRefreshRows();
+}
+
 void ParticipantsBoxController::refreshDescription() {
 	setDescriptionText((_role == Role::Kicked)
 		? ((_peer->isChat() || _peer->isMegagroup())
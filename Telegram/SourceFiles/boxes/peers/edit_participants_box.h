@@ -238,6 +238,9 @@ private:
 	bool removeRow(not_null<UserData*> user);
 	void refreshCustomStatus(not_null<PeerListRow*> row) const;
 	bool feedMegagroupLastParticipants();
+	void preloadMoreRows();
+	void requestParticipants();
+	void applyParticipants(const MTPchannels_ChannelParticipants &result);
 	Type computeType(not_null<UserData*> user) const;
 	void recomputeTypeFor(not_null<UserData*> user);
 
@@ -254,6 +257,8 @@ private:
 	Role _role = Role::Admins;
 	int _offset = 0;
 	mtpRequestId _loadRequestId = 0;
+	std::optional<MTPchannels_ChannelParticipants> _preloaded;
+	bool _loadWaiting = false;
 	bool _allLoaded = false;
 	ParticipantsAdditionalData _additional;
 	std::unique_ptr<ParticipantsOnlineSorter> _onlineSorter;
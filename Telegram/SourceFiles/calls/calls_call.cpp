@@ -440,6 +440,13 @@ QString Call::getDebugLog() const {
 		: QString();
 }
 
+void Call::logDebugInfo() const {
+	const auto info = getDebugLog();
+	if (!info.isEmpty()) {
+		LOG(("Call Stats: %1").arg(info));
+	}
+}
+
 void Call::startWaitingTrack() {
 	_waitingTrack = Media::Audio::Current().createTrack();
 	auto trackFileName = Core::App().settings().getSoundPath(
@@ -876,6 +883,7 @@ void Call::handleControllerStateChange(tgcalls::State state) {
 }
 
 void Call::handleControllerBarCountChange(int count) {
+	DEBUG_LOG(("Call Info: Signal bar count changed to %1.").arg(count));
 	setSignalBarCount(count);
 }
 
@@ -1099,6 +1107,9 @@ void Call::handleControllerError(const QString &error) {
 
 void Call::destroyController() {
 	if (_instance) {
+		if (Logs::DebugEnabled()) {
+			logDebugInfo();
+		}
 		_instance->stop([](tgcalls::FinalState) {
 		});
 
@@ -64,12 +64,7 @@ constexpr auto kPlayConnectingEach = crl::time(1056) + 2 * crl::time(1000);
 	if (!id || !call || call->id() != id) {
 		return nullptr;
 	}
-	const auto &participants = call->participants();
-	const auto i = ranges::find(
-		participants,
-		user,
-		&Data::GroupCall::Participant::user);
-	return (i != end(participants)) ? &*i : nullptr;
+	return call->participantByUser(user);
 }
 
 } // namespace
@@ -943,13 +938,9 @@ std::variant<int, not_null<UserData*>> GroupCall::inviteUsers(
 	}
 	const auto owner = &_peer->owner();
 	const auto &invited = owner->invitedToCallUsers(_id);
-	const auto &participants = real->participants();
 	auto &&toInvite = users | ranges::view::filter([&](
 			not_null<UserData*> user) {
-		return !invited.contains(user) && !ranges::contains(
-			participants,
-			user,
-			&Data::GroupCall::Participant::user);
+		return !invited.contains(user) && !real->participantByUser(user);
 	});
 
 	auto count = 0;
@@ -269,6 +269,8 @@ public:
 	[[nodiscard]] auto kickMemberRequests() const
 		-> rpl::producer<not_null<UserData*>>;
 
+	void setRowVisibleCheck(Fn<bool(not_null<PeerListRow*>)> check);
+
 	bool rowCanMuteMembers() override;
 	void rowUpdateRow(not_null<Row*> row) override;
 	void rowPaintIcon(
@@ -333,6 +335,7 @@ private:
 
 	base::flat_map<uint32, not_null<Row*>> _soundingRowBySsrc;
 	Ui::Animations::Basic _soundingAnimation;
+	Fn<bool(not_null<PeerListRow*>)> _rowVisibleCheck;
 
 	crl::time _soundingAnimationHideLastTime = 0;
 	bool _skipRowLevelUpdate = false;
@@ -809,12 +812,21 @@ MembersController::MembersController(
 		}
 		for (const auto [ssrc, row] : _soundingRowBySsrc) {
 			row->updateBlobAnimation(now);
-			delegate()->peerListUpdateRow(row);
+
+			// Off-screen rows keep their blobs state, but are not repainted.
+			if (!_rowVisibleCheck || _rowVisibleCheck(row)) {
+				delegate()->peerListUpdateRow(row);
+			}
 		}
 		return true;
 	});
 }
 
+void MembersController::setRowVisibleCheck(
+		Fn<bool(not_null<PeerListRow*>)> check) {
+	_rowVisibleCheck = std::move(check);
+}
+
 MembersController::~MembersController() {
 	base::take(_menu);
 }
@@ -1103,11 +1115,7 @@ void MembersController::prepareRows(not_null<Data::GroupCall*> real) {
 			++i;
 			continue;
 		}
-		const auto contains = ranges::contains(
-			participants,
-			not_null{ user },
-			&Data::GroupCall::Participant::user);
-		if (contains) {
+		if (real->participantByUser(user)) {
 			++fullCountMin;
 			++i;
 		} else {
@@ -1629,6 +1637,11 @@ void GroupMembers::setupList() {
 	_list = _scroll->setOwnedWidget(object_ptr<ListWidget>(
 		this,
 		_listController.get()));
+	static_cast<MembersController*>(
+		_listController.get()
+	)->setRowVisibleCheck([=](not_null<PeerListRow*> row) {
+		return _list->rowVisible(row);
+	});
 
 	_list->heightValue(
 	) | rpl::start_with_next([=] {
@@ -146,6 +146,11 @@ void DebugInfoBox::prepare() {
 	setTitle(rpl::single(qsl("Call Debug")));
 
 	addButton(tr::lng_close(), [this] { closeBox(); });
+	addLeftButton(rpl::single(qsl("Write to log")), [=] {
+		if (const auto call = _call.get()) {
+			call->logDebugInfo();
+		}
+	});
 	_text = setInnerWidget(
 		object_ptr<Ui::PaddingWrap<Ui::FlatLabel>>(
 			this,
@@ -130,9 +130,7 @@ void VideoBubble::paint() {
 		p.drawImage(
 			inner,
 			_frame,
-			QRect(
-				QPoint(_frame.width() - (inner.width() * factor), 0),
-				inner.size() * factor));
+			QRect(QPoint(), inner.size() * factor));
 	}
 	_track->markFrameShown();
 }
@@ -160,21 +158,22 @@ void VideoBubble::prepareFrame() {
 	}
 	Assert(_frame.width() >= frame.width()
 		&& _frame.height() >= frame.height());
-	const auto toPerLine = _frame.bytesPerLine();
-	const auto fromPerLine = frame.bytesPerLine();
-	const auto lineSize = frame.width() * 4;
-	auto to = _frame.bits();
-	auto from = frame.bits();
+	const auto toPerLine = _frame.bytesPerLine() / 4;
+	const auto fromPerLine = frame.bytesPerLine() / 4;
+	const auto lineSize = frame.width();
+	auto to = reinterpret_cast<uint32*>(_frame.bits());
+	auto from = reinterpret_cast<const uint32*>(frame.constBits());
 	const auto till = from + frame.height() * fromPerLine;
+
+	// Mirror the frame while copying it, without allocating a new image.
 	for (; from != till; from += fromPerLine, to += toPerLine) {
-		memcpy(to, from, lineSize);
+		std::reverse_copy(from, from + lineSize, to);
 	}
 	Images::prepareRound(
 		_frame,
 		ImageRoundRadius::Large,
 		RectPart::AllCorners,
 		QRect(QPoint(), size));
-	_frame = std::move(_frame).mirrored(true, false);
 }
 
 void VideoBubble::setState(Webrtc::VideoState state) {
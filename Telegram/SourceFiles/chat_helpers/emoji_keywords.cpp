@@ -116,7 +116,12 @@ void CreateCacheFilePath() {
 		if (size < 0 || stream.status() != QDataStream::Ok) {
 			return {};
 		}
-		auto &list = result.emoji[key];
+		// Keys are written sorted, so each one is inserted at the end.
+		auto &list = result.emoji.emplace_hint(
+			end(result.emoji),
+			key,
+			std::vector<LangPackEmoji>())->second;
+		list.reserve(size);
 		for (auto j = 0; j != size; ++j) {
 			auto text = QString();
 			stream >> text;
@@ -335,7 +340,7 @@ private:
 	not_null<Delegate*> _delegate;
 	QString _id;
 	State _state = State::ReadingCache;
-	LangPackData _data;
+	std::shared_ptr<LangPackData> _data;
 	crl::time _lastRefreshTime = 0;
 	mtpRequestId _requestId = 0;
 	base::binary_guard _guard;
@@ -346,7 +351,8 @@ EmojiKeywords::LangPack::LangPack(
 	not_null<Delegate*> delegate,
 	const QString &id)
 : _delegate(delegate)
-, _id(id) {
+, _id(id)
+, _data(std::make_shared<LangPackData>()) {
 	readLocalCache();
 }
 
@@ -404,10 +410,10 @@ void EmojiKeywords::LangPack::refresh() {
 			_lastRefreshTime = crl::now();
 		}).send();
 	};
-	_requestId = (_data.version > 0)
+	_requestId = (_data->version > 0)
 		? send(MTPmessages_GetEmojiKeywordsDifference(
 			MTP_string(_id),
-			MTP_int(_data.version)))
+			MTP_int(_data->version)))
 		: send(MTPmessages_GetEmojiKeywords(
 			MTP_string(_id)));
 }
@@ -422,22 +428,24 @@ void EmojiKeywords::LangPack::applyDifference(
 			LOG(("API Error: Bad lang_code for emoji keywords %1 -> %2"
 				).arg(_id
 				).arg(code));
-			_data.version = 0;
+			_data->version = 0;
 			_state = State::Refreshed;
 			return;
-		} else if (keywords.isEmpty() && _data.version >= version) {
+		} else if (keywords.isEmpty() && _data->version >= version) {
 			_state = State::Refreshed;
 			return;
 		}
 		const auto id = _id;
-		auto copy = _data;
+		const auto data = _data;
 		auto callback = crl::guard(_guard.make_guard(), [=](
 				LangPackData &&result) {
 			applyData(std::move(result));
 		});
-		crl::async([=,
-			copy = std::move(copy),
-			callback = std::move(callback)]() mutable {
+
+		// Queries keep using the current data while the copy is updated,
+		// so the copy itself is made off the main thread as well.
+		crl::async([=, callback = std::move(callback)]() mutable {
+			auto copy = *data;
 			ApplyDifference(copy, keywords, version);
 			WriteLocalCache(id, copy);
 			crl::on_main([
@@ -451,7 +459,7 @@ void EmojiKeywords::LangPack::applyDifference(
 }
 
 void EmojiKeywords::LangPack::applyData(LangPackData &&data) {
-	_data = std::move(data);
+	_data = std::make_shared<LangPackData>(std::move(data));
 	_state = State::Refreshed;
 	_delegate->langPackRefreshed();
 }
@@ -469,16 +477,16 @@ void EmojiKeywords::LangPack::apiChanged() {
 std::vector<Result> EmojiKeywords::LangPack::query(
 		const QString &normalized,
 		bool exact) const {
-	if (normalized.size() > _data.maxKeyLength
-		|| _data.emoji.empty()
+	if (normalized.size() > _data->maxKeyLength
+		|| _data->emoji.empty()
 		|| (exact && SkipExactKeyword(_id, normalized))) {
 		return {};
 	}
 
-	const auto from = _data.emoji.lower_bound(normalized);
+	const auto from = _data->emoji.lower_bound(normalized);
 	auto &&chosen = ranges::make_subrange(
 		from,
-		end(_data.emoji)
+		end(_data->emoji)
 	) | ranges::view::take_while([&](const auto &pair) {
 		const auto &key = pair.first;
 		return exact ? (key == normalized) : key.startsWith(normalized);
@@ -492,7 +500,7 @@ std::vector<Result> EmojiKeywords::LangPack::query(
 }
 
 int EmojiKeywords::LangPack::maxQueryLength() const {
-	return _data.maxKeyLength;
+	return _data->maxKeyLength;
 }
 
 EmojiKeywords::EmojiKeywords() {
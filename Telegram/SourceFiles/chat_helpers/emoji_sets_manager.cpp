@@ -91,9 +91,9 @@ private:
 	void updateStatusColorOverride();
 	void setupContent(const Set &set);
 	void setupLabels(const Set &set);
-	void setupPreview(const Set &set);
+	void setupPreview();
 	void setupAnimation();
-	void paintPreview(Painter &p) const;
+	void paintPreview(Painter &p);
 	void paintRadio(Painter &p);
 	void setupHandler();
 	void load();
@@ -105,6 +105,7 @@ private:
 	bool _switching = false;
 	rpl::variable<SetState> _state;
 	Ui::FlatLabel *_status = nullptr;
+	QString _previewPath;
 	std::array<QPixmap, 4> _preview;
 	Ui::Animations::Simple _toggled;
 	Ui::Animations::Simple _active;
@@ -241,7 +242,10 @@ void Row::paintEvent(QPaintEvent *e) {
 	paintRadio(p);
 }
 
-void Row::paintPreview(Painter &p) const {
+void Row::paintPreview(Painter &p) {
+	if (!_previewPath.isEmpty()) {
+		setupPreview();
+	}
 	const auto x = st::manageEmojiPreviewPadding.left();
 	const auto y = st::manageEmojiPreviewPadding.top();
 	const auto width = st::manageEmojiPreviewWidth;
@@ -378,7 +382,10 @@ void Row::setupContent(const Set &set) {
 	});
 
 	setupLabels(set);
-	setupPreview(set);
+
+	// Decoded on the first paint, so that rows scrolled out of view
+	// don't read and scale their preview images.
+	_previewPath = set.previewPath;
 	setupAnimation();
 
 	const auto height = st::manageEmojiPreviewPadding.top()
@@ -450,9 +457,9 @@ void Row::setupLabels(const Set &set) {
 	}, name->lifetime());
 }
 
-void Row::setupPreview(const Set &set) {
+void Row::setupPreview() {
 	const auto size = st::manageEmojiPreview * cIntRetinaFactor();
-	const auto original = QImage(set.previewPath);
+	const auto original = QImage(base::take(_previewPath));
 	const auto full = original.height();
 	auto &&preview = ranges::view::zip(_preview, ranges::view::ints(0, int(_preview.size())));
 	for (auto &&[pixmap, index] : preview) {
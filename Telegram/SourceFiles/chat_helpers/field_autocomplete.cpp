@@ -294,7 +294,7 @@ bool FieldAutocomplete::clearFilteredBotCommands() {
 namespace {
 template <typename T, typename U>
 inline int indexOfInFirstN(const T &v, const U &elem, int last) {
-	for (auto b = v.cbegin(), i = b, e = b + std::max(int(v.size()), last); i != e; ++i) {
+	for (auto b = v.cbegin(), i = b, e = b + std::min(int(v.size()), last); i != e; ++i) {
 		if (i->user == elem) {
 			return (i - b);
 		}
@@ -359,12 +359,12 @@ void FieldAutocomplete::updateFiltered(bool resetScroll) {
 			}
 			return true;
 		};
+		// Name words are stored lowercase.
+		const auto nameFilter = _filter.toLower();
 		auto filterNotPassedByName = [&](UserData *user) -> bool {
-			for (const auto &nameWord : user->nameWords()) {
-				if (nameWord.startsWith(_filter, Qt::CaseInsensitive)) {
-					auto exactUsername = (user->username.compare(_filter, Qt::CaseInsensitive) == 0);
-					return exactUsername;
-				}
+			if (user->hasNameWordStartingWith(nameFilter)) {
+				auto exactUsername = (user->username.compare(_filter, Qt::CaseInsensitive) == 0);
+				return exactUsername;
 			}
 			return filterNotPassedByUsername(user);
 		};
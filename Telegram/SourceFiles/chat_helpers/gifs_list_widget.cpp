@@ -43,6 +43,7 @@ namespace {
 constexpr auto kSearchRequestDelay = 400;
 constexpr auto kInlineItemsMaxPerRow = 5;
 constexpr auto kSearchBotUsername = "gif"_cs;
+constexpr auto kPreloadScreensAfter = 2;
 
 } // namespace
 
@@ -213,6 +214,7 @@ void GifsListWidget::visibleTopBottomUpdated(
 	Inner::visibleTopBottomUpdated(visibleTop, visibleBottom);
 	if (top != getVisibleTop()) {
 		_lastScrolled = crl::now();
+		preloadImages();
 	}
 	checkLoadMore();
 }
@@ -296,6 +298,7 @@ void GifsListWidget::inlineResultsDone(const MTPmessages_BotResults &result) {
 	if (!showInlineRows(!adding)) {
 		it->second->nextOffset = QString();
 	}
+	preloadImages();
 	checkLoadMore();
 }
 
@@ -539,7 +542,6 @@ bool GifsListWidget::inlineRowsAddItem(DocumentData *savedGif, InlineResult *res
 	}
 	if (!layout) return false;
 
-	layout->preload();
 	if (inlineRowFinalize(row, sumWidth, layout->isFullLine())) {
 		layout->setPosition(_rows.size() * MatrixRowShift);
 	}
@@ -598,9 +600,8 @@ void GifsListWidget::refreshSavedGifs() {
 
 	if (isVisible()) {
 		updateSelected();
-	} else {
-		preloadImages();
 	}
+	preloadImages();
 }
 
 void GifsListWidget::clearInlineRows(bool resultsDeleted) {
@@ -722,10 +723,27 @@ void GifsListWidget::layoutInlineRow(Row &row, int fullWidth) {
 }
 
 void GifsListWidget::preloadImages() {
+	// Thumbnails only for the rows around the visible area, the rest
+	// are requested while scrolling. Before the panel is shown the
+	// visible area is empty, so its largest possible height is used.
+	const auto visibleHeight = std::max(
+		getVisibleBottom() - getVisibleTop(),
+		st::emojiPanMaxHeight);
+	const auto from = getVisibleTop() - visibleHeight;
+	const auto till = getVisibleTop()
+		+ (kPreloadScreensAfter + 1) * visibleHeight;
+	auto top = st::stickerPanPadding;
 	for (auto row = 0, rows = _rows.size(); row != rows; ++row) {
-		for (auto col = 0, cols = _rows[row].items.size(); col != cols; ++col) {
-			_rows[row].items[col]->preload();
+		if (top >= till) {
+			break;
+		}
+		const auto &inlineRow = _rows[row];
+		if (top + inlineRow.height > from) {
+			for (const auto item : inlineRow.items) {
+				item->preload();
+			}
 		}
+		top += inlineRow.height;
 	}
 }
 
@@ -47,6 +47,9 @@ using EditLinkSelection = Ui::InputField::EditLinkSelection;
 
 constexpr auto kParseLinksTimeout = crl::time(1000);
 
+// Links in longer texts are not parsed again after each typed word.
+constexpr auto kParseLinksInstantMaxLength = 4096;
+
 // For mention tags save and validate userId, ignore tags for different userId.
 class FieldTagMimeProcessor : public Ui::InputField::TagMimeProcessor {
 public:
@@ -232,15 +235,14 @@ TextWithEntities StripSupportHashtag(TextWithEntities &&text) {
 	if (!length) {
 		return TextWithEntities();
 	}
-	for (auto i = text.entities.begin(); i != text.entities.end();) {
-		auto &entity = *i;
-		if (entity.offset() >= length) {
-			i = text.entities.erase(i);
-			continue;
-		} else if (entity.offset() + entity.length() > length) {
+	auto &entities = text.entities;
+	entities.erase(ranges::remove_if(entities, [&](const EntityInText &entity) {
+		return (entity.offset() >= length);
+	}), entities.end());
+	for (auto &entity : entities) {
+		if (entity.offset() + entity.length() > length) {
 			entity.shrinkFromRight(length - entity.offset());
 		}
-		++i;
 	}
 	return std::move(text);
 }
@@ -512,7 +514,11 @@ bool MessageLinksParser::eventFilter(QObject *object, QEvent *event) {
 					|| ch == '\r'
 					|| ch.isSpace()
 					|| ch == QChar::LineSeparator) {
-					_timer.callOnce(0);
+					if (_lastLength <= kParseLinksInstantMaxLength) {
+						_timer.callOnce(0);
+					} else if (!_timer.isActive()) {
+						_timer.callOnce(kParseLinksTimeout);
+					}
 				}
 			}
 		} else if (event->type() == QEvent::Drop) {
@@ -21,6 +21,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/effects/animations.h"
 #include "ui/effects/ripple_animation.h"
 #include "ui/image/image.h"
+#include "ui/image/image_prepare.h"
 #include "ui/cached_round_corners.h"
 #include "lottie/lottie_multi_player.h"
 #include "lottie/lottie_single_player.h"
@@ -35,6 +36,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "boxes/stickers_box.h"
 #include "boxes/confirm_box.h"
 #include "window/window_session_controller.h" // GifPauseReason.
+#include "core/core_probes.h"
 #include "main/main_session.h"
 #include "main/main_session_settings.h"
 #include "apiwrap.h"
@@ -1515,6 +1517,9 @@ QRect StickersListWidget::stickerRect(int section, int sel) {
 }
 
 void StickersListWidget::paintEvent(QPaintEvent *e) {
+	static auto probe = Core::Probe("paint.stickers_us");
+	const auto timer = Core::ProbeTimer(probe);
+
 	Painter p(this);
 	auto clip = e->rect();
 	p.fillRect(clip, st::emojiPanBg);
@@ -1902,23 +1907,18 @@ void StickersListWidget::paintSticker(Painter &p, Set &set, int y, int section,
 		}
 		set.lottiePlayer->unpause(sticker.animated);
 	} else {
-		const auto image = media->getStickerSmall();
-		const auto pixmap = !sticker.savedFrame.isNull()
-			? sticker.savedFrame
-			: image
-			? image->pixSingle(
-				w,
-				h,
-				w,
-				h,
-				ImageRoundRadius::None)
-			: QPixmap();
-		if (!pixmap.isNull()) {
-			p.drawPixmapLeft(ppos, width(), pixmap);
-			if (sticker.savedFrame.isNull()) {
-				sticker.savedFrame = pixmap;
+		if (sticker.savedFrame.isNull()) {
+			const auto i = _preparedFrames.find(document);
+			if (i != end(_preparedFrames)) {
+				sticker.savedFrame = std::move(i->second);
+				_preparedFrames.erase(i);
+			} else if (const auto image = media->getStickerSmall()) {
+				prepareSavedFrame(document, image, QSize(w, h));
 			}
 		}
+		if (!sticker.savedFrame.isNull()) {
+			p.drawPixmapLeft(ppos, width(), sticker.savedFrame);
+		}
 	}
 
 	if (selected && stickerHasDeleteButton(set, index)) {
@@ -1931,6 +1931,32 @@ void StickersListWidget::paintSticker(Painter &p, Set &set, int y, int section,
 	}
 }
 
+void StickersListWidget::prepareSavedFrame(
+		not_null<DocumentData*> document,
+		not_null<Image*> image,
+		QSize size) {
+	if (!_preparingFrames.emplace(document).second) {
+		return;
+	}
+	const auto factor = style::DevicePixelRatio();
+	crl::async([=, original = image->original()] {
+		auto result = Images::prepare(
+			original,
+			size.width() * factor,
+			size.height() * factor,
+			Images::Option::Smooth,
+			size.width(),
+			size.height());
+		crl::on_main(this, [=, result = std::move(result)]() mutable {
+			_preparingFrames.remove(document);
+			auto pixmap = App::pixmapFromImageInPlace(std::move(result));
+			pixmap.setDevicePixelRatio(factor);
+			_preparedFrames[document] = std::move(pixmap);
+			update();
+		});
+	});
+}
+
 int StickersListWidget::stickersRight() const {
 	return stickersLeft() + (_columnCount * _singleSize.width());
 }
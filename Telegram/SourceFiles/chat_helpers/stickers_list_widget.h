@@ -12,6 +12,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/variant.h"
 #include "base/timer.h"
 
+class Image;
+
 namespace Main {
 class Session;
 } // namespace Main
@@ -278,6 +280,10 @@ private:
 	void paintMegagroupEmptySet(Painter &p, int y, bool buttonSelected);
 	void paintSticker(Painter &p, Set &set, int y, int section, int index, bool selected, bool deleteSelected);
 	void paintEmptySearchResults(Painter &p);
+	void prepareSavedFrame(
+		not_null<DocumentData*> document,
+		not_null<Image*> image,
+		QSize size);
 
 	void ensureLottiePlayer(Set &set);
 	void setupLottie(Set &set, int section, int index);
@@ -342,6 +348,10 @@ private:
 	base::flat_set<uint64> _installedLocallySets;
 	std::vector<bool> _custom;
 	base::flat_set<not_null<DocumentData*>> _favedStickersMap;
+
+	// Static sticker frames are scaled in the background on first paint.
+	base::flat_set<not_null<DocumentData*>> _preparingFrames;
+	base::flat_map<not_null<DocumentData*>, QPixmap> _preparedFrames;
 	std::weak_ptr<Lottie::FrameRenderer> _lottieRenderer;
 
 	mtpRequestId _officialRequestId = 0;
@@ -22,6 +22,15 @@ namespace {
 
 constexpr auto kDontCacheLottieAfterArea = 512 * 512;
 
+using SharedPlayerKey = std::tuple<
+	not_null<DocumentData*>,
+	StickerLottieSize,
+	int,
+	int>;
+base::flat_map<
+	SharedPlayerKey,
+	std::weak_ptr<Lottie::SinglePlayer>> SharedPlayers;
+
 } // namespace
 
 template <typename Method>
@@ -117,6 +126,35 @@ std::unique_ptr<Lottie::SinglePlayer> LottiePlayerFromDocument(
 	return LottieFromDocument(method, media, uint8(keyShift), box);
 }
 
+std::shared_ptr<Lottie::SinglePlayer> SharedLottiePlayerFromDocument(
+		not_null<Data::DocumentMedia*> media,
+		StickerLottieSize sizeTag,
+		QSize box,
+		Lottie::Quality quality) {
+	const auto key = SharedPlayerKey{
+		media->owner(),
+		sizeTag,
+		box.width(),
+		box.height()
+	};
+	if (const auto i = SharedPlayers.find(key); i != end(SharedPlayers)) {
+		if (auto result = i->second.lock()) {
+			return result;
+		}
+	}
+	for (auto i = begin(SharedPlayers); i != end(SharedPlayers);) {
+		if (i->second.expired()) {
+			i = SharedPlayers.erase(i);
+		} else {
+			++i;
+		}
+	}
+	auto result = std::shared_ptr<Lottie::SinglePlayer>(
+		LottiePlayerFromDocument(media, sizeTag, box, quality));
+	SharedPlayers.emplace(key, result);
+	return result;
+}
+
 not_null<Lottie::Animation*> LottieAnimationFromDocument(
 		not_null<Lottie::MultiPlayer*> player,
 		not_null<Data::DocumentMedia*> media,
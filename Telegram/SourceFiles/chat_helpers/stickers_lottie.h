@@ -55,6 +55,15 @@ enum class StickerLottieSize : uchar {
 	QSize box,
 	Lottie::Quality quality = Lottie::Quality(),
 	std::shared_ptr<Lottie::FrameRenderer> renderer = nullptr);
+
+// Returns the player already created for the same document, size tag
+// and box if it is still alive, so identical stickers render frames once.
+[[nodiscard]] std::shared_ptr<Lottie::SinglePlayer> SharedLottiePlayerFromDocument(
+	not_null<Data::DocumentMedia*> media,
+	StickerLottieSize sizeTag,
+	QSize box,
+	Lottie::Quality quality = Lottie::Quality());
+
 [[nodiscard]] not_null<Lottie::Animation*> LottieAnimationFromDocument(
 	not_null<Lottie::MultiPlayer*> player,
 	not_null<Data::DocumentMedia*> media,
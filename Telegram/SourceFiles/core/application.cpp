@@ -88,6 +88,30 @@ namespace {
 constexpr auto kQuitPreventTimeoutMs = crl::time(1500);
 constexpr auto kAutoLockTimeoutLateMs = crl::time(3000);
 constexpr auto kClearEmojiImageSourceTimeout = 10 * crl::time(1000);
+constexpr auto kIdleTasksDelay = crl::time(1000);
+constexpr auto kIdleTasksBudget = crl::time(8);
+
+// Collects the durations of the startup phases for a single log line.
+class StartupTimeline final {
+public:
+	void phase(const QString &name) {
+		const auto now = crl::now();
+		_phases.push_back(qsl("%1 %2").arg(name).arg(now - _last));
+		_last = now;
+	}
+	void finish() {
+		phase(qsl("show"));
+		LOG(("Startup Info: %1 ms total (%2)."
+			).arg(_last - _started
+			).arg(_phases.join(qsl(", "))));
+	}
+
+private:
+	const crl::time _started = crl::now();
+	crl::time _last = _started;
+	QStringList _phases;
+
+};
 
 } // namespace
 
@@ -116,7 +140,8 @@ Application::Application(not_null<Launcher*> launcher)
 , _emojiKeywords(std::make_unique<ChatHelpers::EmojiKeywords>())
 , _logo(Window::LoadLogo())
 , _logoNoMargin(Window::LoadLogoNoMargin())
-, _autoLockTimer([=] { checkAutoLock(); }) {
+, _autoLockTimer([=] { checkAutoLock(); })
+, _idleTasksTimer([=] { runIdleTasks(); }) {
 	Expects(!_logo.isNull());
 	Expects(!_logoNoMargin.isNull());
 
@@ -181,6 +206,13 @@ Application::~Application() {
 }
 
 void Application::run() {
+	auto timeline = StartupTimeline();
+
+	// Create mime database, so it won't be slow later.
+	crl::async([] {
+		QMimeDatabase().mimeTypeForName(qsl("text/plain"));
+	});
+
 	style::internal::StartFonts();
 
 	ThirdParty::start();
@@ -191,8 +223,10 @@ void Application::run() {
 	// Depends on notifications settings.
 	_notifications = std::make_unique<Window::Notifications::System>();
 
+	timeline.phase(qsl("global"));
 	startLocalStorage();
 	ValidateScale();
+	timeline.phase(qsl("settings"));
 
 	if (Local::oldSettingsVersion() < AppVersion) {
 		psNewVersion();
@@ -210,6 +244,7 @@ void Application::run() {
 
 	Core::App().settings().setWindowControlsLayout(Platform::WindowControlsLayout());
 
+	timeline.phase(qsl("launch"));
 	_translator = std::make_unique<Lang::Translator>();
 	QCoreApplication::instance()->installTranslator(_translator.get());
 
@@ -219,6 +254,7 @@ void Application::run() {
 	startEmojiImageLoader();
 	startSystemDarkModeViewer();
 	Media::Player::start(_audio.get());
+	timeline.phase(qsl("style"));
 
 	style::ShortAnimationPlaying(
 	) | rpl::start_with_next([=](bool playing) {
@@ -235,10 +271,8 @@ void Application::run() {
 
 	DEBUG_LOG(("Application Info: starting app..."));
 
-	// Create mime database, so it won't be slow later.
-	QMimeDatabase().mimeTypeForName(qsl("text/plain"));
-
 	_window = std::make_unique<Window::Controller>();
+	timeline.phase(qsl("window"));
 
 	_domain->activeChanges(
 	) | rpl::start_with_next([=](not_null<Main::Account*> account) {
@@ -261,7 +295,9 @@ void Application::run() {
 	// Depend on activeWindow() for now :(
 	startShortcuts();
 	App::initMedia();
+	timeline.phase(qsl("media"));
 	startDomain();
+	timeline.phase(qsl("domain"));
 
 	_window->widget()->show();
 
@@ -277,6 +313,7 @@ void Application::run() {
 	}
 
 	_window->updateIsActiveFocus();
+	timeline.finish();
 
 	for (const auto &error : Shortcuts::Errors()) {
 		LOG(("Shortcuts Error: %1").arg(error));
@@ -831,6 +868,36 @@ crl::time Application::lastNonIdleTime() const {
 		_lastNonIdleTime);
 }
 
+void Application::postponeUntilIdle(FnMut<void()> &&callable) {
+	_idleTasks.push_back(std::move(callable));
+	if (!_idleTasksTimer.isActive()) {
+		_idleTasksTimer.callOnce(kIdleTasksDelay);
+	}
+}
+
+void Application::runIdleTasks() {
+	const auto now = crl::now();
+	const auto idle = now - lastNonIdleTime();
+	if (idle < kIdleTasksDelay) {
+		_idleTasksTimer.callOnce(kIdleTasksDelay - idle);
+		return;
+	}
+
+	// Run as many tasks as fit in the budget, leave the rest for later.
+	const auto till = now + kIdleTasksBudget;
+	while (!_idleTasks.empty()) {
+		auto callable = std::move(_idleTasks.front());
+		_idleTasks.pop_front();
+		callable();
+		if (crl::now() >= till) {
+			break;
+		}
+	}
+	if (!_idleTasks.empty()) {
+		_idleTasksTimer.callOnce(0);
+	}
+}
+
 rpl::producer<bool> Application::passcodeLockChanges() const {
 	return _passcodeLock.changes();
 }
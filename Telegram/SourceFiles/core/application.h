@@ -260,6 +260,9 @@ public:
 	[[nodiscard]] crl::time lastNonIdleTime() const;
 	void updateNonIdle();
 
+	// Deferrable work, done when there was no user input for a while.
+	void postponeUntilIdle(FnMut<void()> &&callable);
+
 	void registerLeaveSubscription(not_null<QWidget*> widget);
 	void unregisterLeaveSubscription(not_null<QWidget*> widget);
 
@@ -307,6 +310,7 @@ private:
 	[[nodiscard]] bool readyToQuit();
 
 	void clearPasscodeLock();
+	void runIdleTasks();
 
 	bool openCustomUrl(
 		const QString &protocol,
@@ -385,6 +389,9 @@ private:
 
 	crl::time _lastNonIdleTime = 0;
 
+	std::deque<FnMut<void()>> _idleTasks;
+	base::Timer _idleTasksTimer;
+
 };
 
 [[nodiscard]] bool IsAppLaunched();
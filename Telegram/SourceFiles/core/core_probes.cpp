@@ -0,0 +1,186 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "core/core_probes.h"
+
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+namespace Core {
+namespace {
+
+constexpr auto kMaxTraceEvents = 256 * 1024;
+
+struct TraceEvent {
+	const char *name = nullptr;
+	quintptr thread = 0;
+	int64 start = 0;
+	int64 duration = 0;
+};
+
+struct Tracing {
+	std::atomic<bool> started = false;
+	QMutex mutex;
+	std::chrono::steady_clock::time_point zero;
+	std::vector<TraceEvent> events;
+};
+
+struct Registry {
+	QMutex mutex;
+	std::vector<not_null<const Probe*>> probes;
+};
+
+[[nodiscard]] Registry &Probes() {
+	static auto result = Registry();
+	return result;
+}
+
+[[nodiscard]] Tracing &Trace() {
+	static auto result = Tracing();
+	return result;
+}
+
+[[nodiscard]] int64 Microseconds(std::chrono::steady_clock::duration value) {
+	using namespace std::chrono;
+	return duration_cast<microseconds>(value).count();
+}
+
+[[nodiscard]] int BucketIndex(int64 value) {
+	auto result = 0;
+	for (auto left = value - 1; left > 0; left >>= 1) {
+		if (++result + 1 == Probe::kBucketsCount) {
+			break;
+		}
+	}
+	return result;
+}
+
+} // namespace
+
+Probe::Probe(const char *name) : _name(name) {
+	auto &registry = Probes();
+	QMutexLocker lock(&registry.mutex);
+	registry.probes.push_back(this);
+}
+
+void Probe::add(int64 value) {
+	_count.fetch_add(1, std::memory_order_relaxed);
+	_total.fetch_add(value, std::memory_order_relaxed);
+	_buckets[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+
+	auto max = _max.load(std::memory_order_relaxed);
+	while (max < value
+		&& !_max.compare_exchange_weak(
+			max,
+			value,
+			std::memory_order_relaxed)) {
+	}
+}
+
+QString Probe::dump() const {
+	const auto count = _count.load(std::memory_order_relaxed);
+	const auto total = _total.load(std::memory_order_relaxed);
+	auto result = QString("%1: count %2, total %3, average %4, max %5"
+	).arg(_name
+	).arg(count
+	).arg(total
+	).arg(count ? (total / count) : 0
+	).arg(_max.load(std::memory_order_relaxed));
+	if (!count) {
+		return result;
+	}
+	auto buckets = QStringList();
+	for (auto i = 0; i != kBucketsCount; ++i) {
+		const auto value = _buckets[i].load(std::memory_order_relaxed);
+		if (value) {
+			buckets.push_back(QString("<=%1: %2"
+			).arg((i + 1 == kBucketsCount) ? "inf" : QString::number(1 << i)
+			).arg(value));
+		}
+	}
+	return result + "\n\t" + buckets.join(", ");
+}
+
+ProbeTimer::ProbeTimer(Probe &probe)
+: _probe(probe)
+, _started(Clock::now()) {
+}
+
+ProbeTimer::~ProbeTimer() {
+	const auto duration = Microseconds(Clock::now() - _started);
+	_probe.add(duration);
+
+	auto &trace = Trace();
+	if (!trace.started.load(std::memory_order_relaxed)) {
+		return;
+	}
+	QMutexLocker lock(&trace.mutex);
+	if (trace.started && trace.events.size() < kMaxTraceEvents) {
+		trace.events.push_back({
+			.name = _probe.name(),
+			.thread = quintptr(QThread::currentThreadId()),
+			.start = Microseconds(_started - trace.zero),
+			.duration = duration,
+		});
+	}
+}
+
+QString DumpProbes() {
+	auto &registry = Probes();
+	auto lines = QStringList();
+	{
+		QMutexLocker lock(&registry.mutex);
+		lines.reserve(registry.probes.size());
+		for (const auto probe : registry.probes) {
+			lines.push_back(probe->dump());
+		}
+	}
+	lines.sort();
+	return lines.join('\n');
+}
+
+bool TracingStarted() {
+	return Trace().started;
+}
+
+void StartTracing() {
+	auto &trace = Trace();
+	QMutexLocker lock(&trace.mutex);
+	trace.events.clear();
+	trace.zero = std::chrono::steady_clock::now();
+	trace.started = true;
+}
+
+QByteArray FinishTracing() {
+	auto &trace = Trace();
+	auto events = std::vector<TraceEvent>();
+	{
+		QMutexLocker lock(&trace.mutex);
+		trace.started = false;
+		events = base::take(trace.events);
+	}
+	auto list = QJsonArray();
+	for (const auto &event : events) {
+		auto object = QJsonObject();
+		object.insert("name", QString::fromLatin1(event.name));
+		object.insert("ph", "X");
+		object.insert("pid", 1);
+		object.insert("tid", double(event.thread));
+		object.insert("ts", double(event.start));
+		object.insert("dur", double(event.duration));
+		list.push_back(object);
+	}
+	auto result = QJsonObject();
+	result.insert("traceEvents", list);
+	result.insert("displayTimeUnit", "ms");
+	return QJsonDocument(result).toJson(QJsonDocument::Compact);
+}
+
+} // namespace Core
@@ -0,0 +1,74 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <chrono>
+
+namespace Core {
+
+// Process-wide counter for a hot path, cheap enough to stay compiled in.
+// Declare it as a function-local static, the values can be dumped with
+// the "probes" settings code.
+//
+//	static auto probe = Core::Probe("updates.feed");
+//	const auto timer = Core::ProbeTimer(probe);
+//
+class Probe final {
+public:
+	static constexpr auto kBucketsCount = 16;
+
+	explicit Probe(const char *name);
+	Probe(const Probe &other) = delete;
+	Probe &operator=(const Probe &other) = delete;
+
+	void add(int64 value);
+
+	[[nodiscard]] const char *name() const {
+		return _name;
+	}
+	[[nodiscard]] QString dump() const;
+
+private:
+	const char * const _name = nullptr;
+	std::atomic<int64> _count = 0;
+	std::atomic<int64> _total = 0;
+	std::atomic<int64> _max = 0;
+
+	// Values by powers of two: [0, 1], (1, 2], (2, 4], ..., (2^14, inf).
+	std::array<std::atomic<int64>, kBucketsCount> _buckets = {};
+
+};
+
+// Adds the lifetime of the object in microseconds to the probe.
+// While tracing is started it is also recorded as a trace event.
+class ProbeTimer final {
+public:
+	explicit ProbeTimer(Probe &probe);
+	ProbeTimer(const ProbeTimer &other) = delete;
+	ProbeTimer &operator=(const ProbeTimer &other) = delete;
+	~ProbeTimer();
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	Probe &_probe;
+	const Clock::time_point _started;
+
+};
+
+[[nodiscard]] QString DumpProbes();
+
+[[nodiscard]] bool TracingStarted();
+void StartTracing();
+
+// Returns recorded events in the Chrome trace JSON format.
+[[nodiscard]] QByteArray FinishTracing();
+
+} // namespace Core
@@ -115,7 +115,9 @@ QByteArray Settings::serialize() const {
 			<< _groupCallPushToTalkShortcut
 			<< qint64(_groupCallPushToTalkDelay)
 			<< qint32(0) // Call audio backend
-			<< qint32(_disableCalls ? 1 : 0);
+			<< qint32(_disableCalls ? 1 : 0)
+			<< qint32(_hardwareAcceleratedVideo ? 1 : 0)
+			<< qint32(_cacheMessagesPaint.current() ? 1 : 0);
 	}
 	return result;
 }
@@ -188,6 +190,8 @@ void Settings::addFromSerialized(const QByteArray &serialized) {
 	qint64 groupCallPushToTalkDelay = _groupCallPushToTalkDelay;
 	qint32 callAudioBackend = 0;
 	qint32 disableCalls = _disableCalls ? 1 : 0;
+	qint32 hardwareAcceleratedVideo = _hardwareAcceleratedVideo ? 1 : 0;
+	qint32 cacheMessagesPaint = _cacheMessagesPaint.current() ? 1 : 0;
 
 	stream >> themesAccentColors;
 	if (!stream.atEnd()) {
@@ -289,6 +293,12 @@ void Settings::addFromSerialized(const QByteArray &serialized) {
 	if (!stream.atEnd()) {
 		stream >> disableCalls;
 	}
+	if (!stream.atEnd()) {
+		stream >> hardwareAcceleratedVideo;
+	}
+	if (!stream.atEnd()) {
+		stream >> cacheMessagesPaint;
+	}
 	if (stream.status() != QDataStream::Ok) {
 		LOG(("App Error: "
 			"Bad data for Core::Settings::constructFromSerialized()"));
@@ -389,6 +399,8 @@ void Settings::addFromSerialized(const QByteArray &serialized) {
 	_groupCallPushToTalkShortcut = groupCallPushToTalkShortcut;
 	_groupCallPushToTalkDelay = groupCallPushToTalkDelay;
 	_disableCalls = (disableCalls == 1);
+	_hardwareAcceleratedVideo = (hardwareAcceleratedVideo == 1);
+	_cacheMessagesPaint = (cacheMessagesPaint == 1);
 }
 
 bool Settings::chatWide() const {
@@ -501,6 +513,9 @@ void Settings::resetOnLastLogout() {
 
 	_disableCalls = false;
 
+	_hardwareAcceleratedVideo = false;
+	_cacheMessagesPaint = true;
+
 	_groupCallPushToTalk = false;
 	_groupCallPushToTalkShortcut = QByteArray();
 	_groupCallPushToTalkDelay = 20;
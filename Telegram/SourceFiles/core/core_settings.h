@@ -231,6 +231,21 @@ public:
 	[[nodiscard]] bool disableCalls() const {
 		return _disableCalls;
 	}
+	void setHardwareAcceleratedVideo(bool value) {
+		_hardwareAcceleratedVideo = value;
+	}
+	[[nodiscard]] bool hardwareAcceleratedVideo() const {
+		return _hardwareAcceleratedVideo;
+	}
+	void setCacheMessagesPaint(bool value) {
+		_cacheMessagesPaint = value;
+	}
+	[[nodiscard]] bool cacheMessagesPaint() const {
+		return _cacheMessagesPaint.current();
+	}
+	[[nodiscard]] rpl::producer<bool> cacheMessagesPaintChanges() const {
+		return _cacheMessagesPaint.changes();
+	}
 	[[nodiscard]] bool groupCallPushToTalk() const {
 		return _groupCallPushToTalk;
 	}
@@ -546,6 +561,8 @@ private:
 	int _callInputVolume = 100;
 	bool _callAudioDuckingEnabled = true;
 	bool _disableCalls = false;
+	bool _hardwareAcceleratedVideo = false;
+	rpl::variable<bool> _cacheMessagesPaint = true;
 	bool _groupCallPushToTalk = false;
 	QByteArray _groupCallPushToTalkShortcut;
 	crl::time _groupCallPushToTalkDelay = 20;
@@ -19,6 +19,9 @@ namespace {
 
 constexpr auto kDefaultMaxSize = 8 * 1024 * 1024;
 constexpr auto kDefaultAutoPlaySize = 50 * 1024 * 1024;
+constexpr auto kBudgetPeriod = crl::time(3600 * 1000);
+constexpr auto kBudgetBytes = int64(256 * 1024 * 1024);
+constexpr auto kBudgetFreeSize = int64(512 * 1024);
 constexpr auto kVersion1 = char(1);
 constexpr auto kVersion = char(2);
 
@@ -255,6 +258,27 @@ Full Full::FullDisabled() {
 	return result;
 }
 
+bool Budget::consume(int64 size) {
+	if (size <= 0) {
+		return true;
+	}
+	const auto now = crl::now();
+	removeOld(now);
+	if (size > kBudgetFreeSize && _total + size > kBudgetBytes) {
+		return false;
+	}
+	_spent.emplace_back(now, size);
+	_total += size;
+	return true;
+}
+
+void Budget::removeOld(crl::time now) {
+	while (!_spent.empty() && _spent.front().first + kBudgetPeriod <= now) {
+		_total -= _spent.front().second;
+		_spent.pop_front();
+	}
+}
+
 bool Should(
 		const Full &data,
 		Source source,
@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #pragma once
 
 #include <array>
+#include <deque>
 
 namespace Data {
 namespace AutoDownload {
@@ -104,6 +105,20 @@ private:
 
 };
 
+// Bytes taken by automatic downloads during the last hour, so that
+// a busy channel can't take the whole connection for its media.
+class Budget final {
+public:
+	[[nodiscard]] bool consume(int64 size);
+
+private:
+	void removeOld(crl::time now);
+
+	std::deque<std::pair<crl::time, int64>> _spent;
+	int64 _total = 0;
+
+};
+
 [[nodiscard]] bool Should(
 	const Full &data,
 	not_null<PeerData*> peer,
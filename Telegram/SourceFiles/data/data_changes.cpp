@@ -10,6 +10,12 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "main/main_session.h"
 
 namespace Data {
+namespace {
+
+// Log the coalescing stats when at least that many updates were merged.
+constexpr auto kLogCoalescedUpdatesCount = 256;
+
+} // namespace
 
 template <typename DataType, typename UpdateType>
 void Changes::Manager<DataType, UpdateType>::updated(
@@ -25,7 +31,11 @@ void Changes::Manager<DataType, UpdateType>::updated(
 		}
 		_stream.fire({ data, flags });
 	} else {
-		_updates[data] |= flags;
+		const auto [i, inserted] = _updates.emplace(data, flags);
+		if (!inserted) {
+			i->second |= flags;
+			++_coalesced;
+		}
 	}
 }
 
@@ -78,6 +88,12 @@ rpl::producer<UpdateType> Changes::Manager<DataType, UpdateType>::flagsValue(
 
 template <typename DataType, typename UpdateType>
 void Changes::Manager<DataType, UpdateType>::sendNotifications() {
+	const auto coalesced = base::take(_coalesced);
+	if (coalesced >= kLogCoalescedUpdatesCount) {
+		DEBUG_LOG(("Changes Info: %1 updates coalesced into %2 notifications."
+			).arg(coalesced + _updates.size()
+			).arg(_updates.size()));
+	}
 	for (const auto [data, flags] : base::take(_updates)) {
 		_stream.fire({ data, flags });
 	}
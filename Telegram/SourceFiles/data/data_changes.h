@@ -265,7 +265,10 @@ private:
 		void sendRealtimeNotifications(not_null<DataType*> data, Flags flags);
 
 		std::array<rpl::event_stream<UpdateType>, kCount> _realtimeStreams;
-		base::flat_map<not_null<DataType*>, Flags> _updates;
+		// Large batches (like difference slices) schedule updates for
+		// thousands of objects at once, so we don't keep them sorted.
+		std::unordered_map<not_null<DataType*>, Flags> _updates;
+		int _coalesced = 0;
 		rpl::event_stream<UpdateType> _stream;
 
 	};
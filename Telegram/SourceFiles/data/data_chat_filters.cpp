@@ -563,7 +563,16 @@ bool ChatFilters::loadNextExceptions(bool chatsListLoaded) {
 }
 
 void ChatFilters::refreshHistory(not_null<History*> history) {
-	if (history->inChatList() && !list().empty()) {
+	if (!history->inChatList() || list().empty()) {
+		return;
+	}
+	// We're called when mute, unread or archived state changes, those
+	// don't affect the sort keys, so only membership changes matter.
+	const auto membershipChanged = ranges::any_of(list(), [&](
+			const ChatFilter &filter) {
+		return filter.contains(history) != history->inChatList(filter.id());
+	});
+	if (membershipChanged) {
 		_owner->refreshChatListEntry(history);
 	}
 }
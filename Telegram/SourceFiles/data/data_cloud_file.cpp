@@ -222,6 +222,8 @@ void LoadCloudFile(
 		}
 		if (file.loader->loadSize() < loadSize) {
 			file.loader->increaseLoadSize(loadSize, autoLoading);
+		} else if (!autoLoading) {
+			file.loader->stopAutoLoading();
 		}
 		return;
 	} else if ((file.flags & CloudFile::Flag::Failed)
@@ -55,7 +55,12 @@ QString CloudThemes::Format() {
 
 CloudThemes::CloudThemes(not_null<Main::Session*> session)
 : _session(session)
-, _reloadCurrentTimer([=] { reloadCurrent(); }) {
+, _reloadCurrentTimer([=] {
+	// Applying a changed theme repaints everything, wait for idle time.
+	Core::App().postponeUntilIdle(crl::guard(session, [=] {
+		reloadCurrent();
+	}));
+}) {
 	setupReload();
 }
 
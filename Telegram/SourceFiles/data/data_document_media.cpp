@@ -101,21 +101,6 @@ void VideoPreviewState::automaticLoad(Data::FileOrigin origin) const {
 	}
 }
 
-::Media::Clip::ReaderPointer VideoPreviewState::makeAnimation(
-		Fn<void(::Media::Clip::Notification)> callback) const {
-	Expects(_media != nullptr);
-	Expects(loaded());
-
-	return _usingThumbnail
-		? ::Media::Clip::MakeReader(
-			_media->videoThumbnailContent(),
-			std::move(callback))
-		: ::Media::Clip::MakeReader(
-			_media->owner()->location(),
-			_media->bytes(),
-			std::move(callback));
-}
-
 bool VideoPreviewState::usingThumbnail() const {
 	return _usingThumbnail;
 }
@@ -12,13 +12,6 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 class Image;
 class FileLoader;
 
-namespace Media {
-namespace Clip {
-enum Notification : int;
-class ReaderPointer;
-} // namespace Clip
-} // namespace Media
-
 namespace Data {
 
 class DocumentMedia;
@@ -28,8 +21,6 @@ public:
 	explicit VideoPreviewState(DocumentMedia *media);
 
 	void automaticLoad(Data::FileOrigin origin) const;
-	[[nodiscard]] ::Media::Clip::ReaderPointer makeAnimation(
-		Fn<void(::Media::Clip::Notification)> callback) const;
 	[[nodiscard]] bool usingThumbnail() const;
 	[[nodiscard]] bool loading() const;
 	[[nodiscard]] bool loaded() const;
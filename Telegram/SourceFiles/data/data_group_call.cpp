@@ -68,6 +68,40 @@ auto GroupCall::participants() const
 	return _participants;
 }
 
+auto GroupCall::participantByUser(not_null<UserData*> user) const
+-> const Participant* {
+	const auto i = _participantIndices.find(user);
+	return (i != end(_participantIndices))
+		? &_participants[i->second]
+		: nullptr;
+}
+
+auto GroupCall::findParticipant(not_null<UserData*> user)
+-> std::vector<Participant>::iterator {
+	const auto i = _participantIndices.find(user);
+	return (i != end(_participantIndices))
+		? (begin(_participants) + i->second)
+		: end(_participants);
+}
+
+void GroupCall::eraseParticipant(std::vector<Participant>::iterator i) {
+	const auto index = int(i - begin(_participants));
+	_participantIndices.remove(i->user);
+	for (auto &[user, position] : _participantIndices) {
+		if (position > index) {
+			--position;
+		}
+	}
+	_participants.erase(i);
+}
+
+void GroupCall::clearParticipants() {
+	_participants.clear();
+	_participantIndices.clear();
+	_speakingByActiveFinishes.clear();
+	_userBySsrc.clear();
+}
+
 void GroupCall::requestParticipants() {
 	if (_participantsRequestId || _reloadRequestId) {
 		return;
@@ -216,9 +250,7 @@ void GroupCall::reload() {
 	).done([=](const MTPphone_GroupCall &result) {
 		result.match([&](const MTPDphone_groupCall &data) {
 			_peer->owner().processUsers(data.vusers());
-			_participants.clear();
-			_speakingByActiveFinishes.clear();
-			_userBySsrc.clear();
+			clearParticipants();
 			applyParticipantsSlice(
 				data.vparticipants().v,
 				ApplySliceSource::SliceLoaded);
@@ -244,10 +276,7 @@ void GroupCall::applyParticipantsSlice(
 		participant.match([&](const MTPDgroupCallParticipant &data) {
 			const auto userId = data.vuser_id().v;
 			const auto user = _peer->owner().user(userId);
-			const auto i = ranges::find(
-				_participants,
-				user,
-				&Participant::user);
+			const auto i = findParticipant(user);
 			if (data.is_left()) {
 				if (i != end(_participants)) {
 					auto update = ParticipantUpdate{
@@ -255,7 +284,7 @@ void GroupCall::applyParticipantsSlice(
 					};
 					_userBySsrc.erase(i->ssrc);
 					_speakingByActiveFinishes.remove(user);
-					_participants.erase(i);
+					eraseParticipant(i);
 					if (sliceSource != ApplySliceSource::SliceLoaded) {
 						_participantUpdates.fire(std::move(update));
 					}
@@ -290,6 +319,7 @@ void GroupCall::applyParticipantsSlice(
 			};
 			if (i == end(_participants)) {
 				_userBySsrc.emplace(value.ssrc, user);
+				_participantIndices.emplace(user, int(_participants.size()));
 				_participants.push_back(value);
 				_peer->owner().unregisterInvitedToCallUser(_id, user);
 			} else {
@@ -326,7 +356,7 @@ void GroupCall::applyLastSpoke(
 		requestUnknownParticipants();
 		return;
 	}
-	const auto j = ranges::find(_participants, i->second, &Participant::user);
+	const auto j = findParticipant(i->second);
 	Assert(j != end(_participants));
 
 	_speakingByActiveFinishes.remove(j->user);
@@ -353,10 +383,7 @@ void GroupCall::applyActiveUpdate(
 		return;
 	}
 	const auto i = userLoaded
-		? ranges::find(
-			_participants,
-			not_null{ userLoaded },
-			&Participant::user)
+		? findParticipant(userLoaded)
 		: _participants.end();
 	if (i == end(_participants)) {
 		_unknownSpokenUids[userId] = when;
@@ -406,8 +433,8 @@ void GroupCall::checkFinishSpeakingByActive() {
 		}
 	}
 	for (const auto user : stop) {
-		const auto i = ranges::find(_participants, user, &Participant::user);
-		if (i->speaking) {
+		const auto i = findParticipant(user);
+		if (i != end(_participants) && i->speaking) {
 			const auto was = *i;
 			i->speaking = false;
 			_participantUpdates.fire({
@@ -486,11 +513,7 @@ void GroupCall::requestUnknownParticipants() {
 		}
 		for (const auto [userId, when] : uids) {
 			if (const auto user = _peer->owner().userLoaded(userId)) {
-				const auto isParticipant = ranges::contains(
-					_participants,
-					not_null{ user },
-					&Participant::user);
-				if (isParticipant) {
+				if (participantByUser(user)) {
 					applyActiveUpdate(userId, when, user);
 				}
 			}
@@ -53,6 +53,8 @@ public:
 
 	[[nodiscard]] auto participants() const
 		-> const std::vector<Participant> &;
+	[[nodiscard]] const Participant *participantByUser(
+		not_null<UserData*> user) const;
 	void requestParticipants();
 	[[nodiscard]] bool participantsLoaded() const;
 	[[nodiscard]] UserData *userBySsrc(uint32 ssrc) const;
@@ -93,6 +95,10 @@ private:
 	void applyParticipantsSlice(
 		const QVector<MTPGroupCallParticipant> &list,
 		ApplySliceSource sliceSource);
+	[[nodiscard]] auto findParticipant(not_null<UserData*> user)
+		-> std::vector<Participant>::iterator;
+	void eraseParticipant(std::vector<Participant>::iterator i);
+	void clearParticipants();
 	void requestUnknownParticipants();
 	void changePeerEmptyCallFlag();
 	void checkFinishSpeakingByActive();
@@ -106,6 +112,7 @@ private:
 	mtpRequestId _reloadRequestId = 0;
 
 	std::vector<Participant> _participants;
+	base::flat_map<not_null<UserData*>, int> _participantIndices;
 	base::flat_map<uint32, not_null<UserData*>> _userBySsrc;
 	base::flat_map<not_null<UserData*>, crl::time> _speakingByActiveFinishes;
 	base::Timer _speakingByActiveFinishTimer;
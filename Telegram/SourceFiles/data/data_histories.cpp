@@ -25,6 +25,12 @@ namespace {
 
 constexpr auto kReadRequestTimeout = 3 * crl::time(1000);
 
+// Marking a whole folder as read doesn't send hundreds of requests at once.
+constexpr auto kReadRequestsInFlightLimit = 8;
+
+// How many recently shown histories keep their blocks loaded.
+constexpr auto kKeepLoadedHistories = 8;
+
 } // namespace
 
 Histories::Histories(not_null<Session*> owner)
@@ -64,9 +70,25 @@ void Histories::unloadAll() {
 }
 
 void Histories::clearAll() {
+	_recentlyShown.clear();
 	_map.clear();
 }
 
+void Histories::historyShown(not_null<History*> history) {
+	const auto i = ranges::find(_recentlyShown, history);
+	if (i != end(_recentlyShown)) {
+		_recentlyShown.erase(i);
+	}
+	_recentlyShown.push_front(history);
+	while (_recentlyShown.size() > kKeepLoadedHistories) {
+		const auto unloading = _recentlyShown.back();
+		_recentlyShown.pop_back();
+		if (!unloading->isEmpty()) {
+			unloading->clear(History::ClearType::Unload);
+		}
+	}
+}
+
 void Histories::readInbox(not_null<History*> history) {
 	DEBUG_LOG(("Reading: readInbox called."));
 	if (history->lastServerMessageKnown()) {
@@ -456,13 +478,22 @@ void Histories::sendReadRequests() {
 	}
 	const auto now = crl::now();
 	auto next = std::optional<crl::time>();
+	auto inFlight = ranges::count_if(_states, [](const auto &pair) {
+		return pair.second.sentReadTill && !pair.second.sentReadDone;
+	});
 	for (auto &[history, state] : _states) {
 		if (!state.willReadTill) {
 			DEBUG_LOG(("Reading: skipping zero till."));
 			continue;
 		} else if (state.willReadWhen <= now) {
+			if (inFlight >= kReadRequestsInFlightLimit) {
+				// Will be sent when one of the requests in flight finishes.
+				DEBUG_LOG(("Reading: too many requests in flight."));
+				continue;
+			}
 			DEBUG_LOG(("Reading: sending with till %1."
 				).arg(state.willReadTill));
+			++inFlight;
 			sendReadRequest(history, state);
 		} else if (!next || *next > state.willReadWhen) {
 			DEBUG_LOG(("Reading: scheduling for later send."));
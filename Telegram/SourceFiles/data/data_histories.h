@@ -44,6 +44,9 @@ public:
 	void unloadAll();
 	void clearAll();
 
+	// Unloads blocks of the histories that were not shown recently.
+	void historyShown(not_null<History*> history);
+
 	void readInbox(not_null<History*> history);
 	void readInboxTill(not_null<HistoryItem*> item);
 	void readInboxTill(not_null<History*> history, MsgId tillId);
@@ -131,6 +134,8 @@ private:
 
 	base::flat_set<not_null<History*>> _fakeChatListRequests;
 
+	std::deque<not_null<History*>> _recentlyShown;
+
 };
 
 } // namespace Data
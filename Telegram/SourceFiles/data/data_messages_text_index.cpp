@@ -0,0 +1,147 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "data/data_messages_text_index.h"
+
+#include "data/data_session.h"
+#include "data/data_changes.h"
+#include "main/main_session.h"
+#include "history/history.h"
+#include "history/history_item.h"
+
+namespace Data {
+
+MessagesTextIndex::MessagesTextIndex(not_null<Session*> owner)
+: _owner(owner) {
+	_owner->session().changes().messageUpdates(
+		MessageUpdate::Flag::Edited
+	) | rpl::start_with_next([=](const MessageUpdate &update) {
+		add(update.item);
+	}, _lifetime);
+}
+
+void MessagesTextIndex::add(not_null<HistoryItem*> item) {
+	if (IsServerMsgId(item->id) && !item->isService()) {
+		_pending.emplace(item);
+	}
+}
+
+void MessagesTextIndex::remove(not_null<HistoryItem*> item) {
+	_pending.erase(item);
+	unindex(item);
+}
+
+void MessagesTextIndex::clear() {
+	_pending.clear();
+	_indexed.clear();
+	_words.clear();
+}
+
+std::vector<not_null<HistoryItem*>> MessagesTextIndex::search(
+		const QString &query,
+		History *history,
+		int limit) {
+	const auto words = TextUtilities::PrepareSearchWords(query);
+	if (words.isEmpty()) {
+		return {};
+	}
+	indexPending();
+
+	auto result = std::vector<not_null<HistoryItem*>>();
+	auto first = true;
+	for (const auto &word : words) {
+		auto found = std::vector<not_null<HistoryItem*>>();
+		for (auto i = _words.lower_bound(word)
+			; (i != end(_words)) && i->first.startsWith(word)
+			; ++i) {
+			auto &items = i->second;
+			for (auto j = begin(items); j != end(items);) {
+				const auto item = *j;
+				if (_indexed.find(item) == end(_indexed)) {
+					// Left from a removed item with an edited text.
+					j = items.erase(j);
+					continue;
+				} else if (!history || item->history() == history) {
+					found.push_back(item);
+				}
+				++j;
+			}
+		}
+		ranges::sort(found);
+		found.erase(ranges::unique(found), end(found));
+		if (first) {
+			result = std::move(found);
+			first = false;
+		} else {
+			auto both = std::vector<not_null<HistoryItem*>>();
+			ranges::set_intersection(result, found, ranges::back_inserter(both));
+			result = std::move(both);
+		}
+		if (result.empty()) {
+			return {};
+		}
+	}
+	result.erase(ranges::remove_if(result, [&](not_null<HistoryItem*> item) {
+		return !matches(item, words);
+	}), end(result));
+	ranges::sort(result, ranges::greater(), [](not_null<HistoryItem*> item) {
+		return std::make_pair(item->date(), item->id);
+	});
+	if (int(result.size()) > limit) {
+		result.resize(limit);
+	}
+	return result;
+}
+
+void MessagesTextIndex::indexPending() {
+	for (const auto item : base::take(_pending)) {
+		index(item);
+	}
+}
+
+void MessagesTextIndex::index(not_null<HistoryItem*> item) {
+	const auto words = TextUtilities::PrepareSearchWords(
+		item->originalText().text);
+	if (words.isEmpty()) {
+		return;
+	}
+	for (const auto &word : words) {
+		_words[word].emplace(item);
+	}
+	_indexed.emplace(item);
+}
+
+void MessagesTextIndex::unindex(not_null<HistoryItem*> item) {
+	if (!_indexed.erase(item)) {
+		return;
+	}
+	const auto words = TextUtilities::PrepareSearchWords(
+		item->originalText().text);
+	for (const auto &word : words) {
+		const auto i = _words.find(word);
+		if (i != end(_words)) {
+			i->second.erase(item);
+			if (i->second.empty()) {
+				_words.erase(i);
+			}
+		}
+	}
+}
+
+bool MessagesTextIndex::matches(
+		not_null<HistoryItem*> item,
+		const QStringList &words) const {
+	const auto text = TextUtilities::PrepareSearchWords(
+		item->originalText().text);
+	return ranges::all_of(words, [&](const QString &word) {
+		return ranges::any_of(text, [&](const QString &part) {
+			return part.startsWith(word);
+		});
+	});
+}
+
+} // namespace Data
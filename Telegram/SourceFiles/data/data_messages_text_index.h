@@ -0,0 +1,52 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+class History;
+class HistoryItem;
+
+namespace Data {
+
+class Session;
+
+// Words of the loaded messages texts, for showing local search results
+// while the server search request is running.
+class MessagesTextIndex final {
+public:
+	explicit MessagesTextIndex(not_null<Session*> owner);
+
+	void add(not_null<HistoryItem*> item);
+	void remove(not_null<HistoryItem*> item);
+	void clear();
+
+	[[nodiscard]] std::vector<not_null<HistoryItem*>> search(
+		const QString &query,
+		History *history,
+		int limit);
+
+private:
+	void indexPending();
+	void index(not_null<HistoryItem*> item);
+	void unindex(not_null<HistoryItem*> item);
+	[[nodiscard]] bool matches(
+		not_null<HistoryItem*> item,
+		const QStringList &words) const;
+
+	const not_null<Session*> _owner;
+
+	// Items are indexed lazily, so that nothing is done without a search.
+	// Words of edited texts are not removed, they're filtered in search().
+	std::unordered_set<not_null<HistoryItem*>> _pending;
+	std::unordered_set<not_null<HistoryItem*>> _indexed;
+	std::map<QString, std::unordered_set<not_null<HistoryItem*>>> _words;
+
+	rpl::lifetime _lifetime;
+
+};
+
+} // namespace Data
@@ -161,7 +161,7 @@ void PeerData::updateNameDelayed(
 		}
 	}
 	name = newName;
-	_nameText.setText(st::msgNameStyle, name, Ui::NameTextOptions());
+	_nameTextOutdated = true;
 	_userpicEmpty = nullptr;
 
 	auto flags = UpdateFlag::None | UpdateFlag::None;
@@ -567,6 +567,11 @@ void PeerData::fillNames() {
 	}
 }
 
+bool PeerData::hasNameWordStartingWith(const QString &word) const {
+	const auto i = ranges::lower_bound(_nameWords, word);
+	return (i != _nameWords.end()) && i->startsWith(word);
+}
+
 PeerData::~PeerData() = default;
 
 void PeerData::updateFull() {
@@ -699,16 +704,19 @@ const Ui::Text::String &PeerData::topBarNameText() const {
 	if (const auto to = migrateTo()) {
 		return to->topBarNameText();
 	} else if (const auto user = asUser()) {
-		if (!user->phoneText.isEmpty()) {
-			return user->phoneText;
+		if (!user->nameOrPhone.isEmpty()) {
+			return user->phoneText();
 		}
 	}
-	return _nameText;
+	return nameText();
 }
 
 const Ui::Text::String &PeerData::nameText() const {
 	if (const auto to = migrateTo()) {
 		return to->nameText();
+	} else if (_nameTextOutdated) {
+		_nameTextOutdated = false;
+		_nameText.setText(st::msgNameStyle, name, Ui::NameTextOptions());
 	}
 	return _nameText;
 }
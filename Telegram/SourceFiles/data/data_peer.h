@@ -245,6 +245,8 @@ public:
 	[[nodiscard]] const base::flat_set<QString> &nameWords() const {
 		return _nameWords;
 	}
+	// The word should be prepared the same way, like by PrepareSearchWords.
+	[[nodiscard]] bool hasNameWordStartingWith(const QString &word) const;
 	[[nodiscard]] const base::flat_set<QChar> &nameFirstLetters() const {
 		return _nameFirstLetters;
 	}
@@ -420,7 +422,11 @@ private:
 	mutable Data::CloudImage _userpic;
 	PhotoId _userpicPhotoId = kUnknownPhotoId;
 	mutable std::unique_ptr<Ui::EmptyUserpic> _userpicEmpty;
-	Ui::Text::String _nameText;
+
+	// Most of the known peers are never painted, so the name
+	// is laid out only when it is requested for the first time.
+	mutable Ui::Text::String _nameText;
+	mutable bool _nameTextOutdated = false;
 
 	Data::NotifySettings _notify;
 
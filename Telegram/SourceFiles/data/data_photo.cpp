@@ -309,6 +309,7 @@ void PhotoData::load(
 		}
 	};
 	const auto progress = [=] {
+		checkProgressivePartLoaded(valid);
 		if (validSize == PhotoSize::Large) {
 			_owner->photoLoadProgress(this);
 		}
@@ -331,6 +332,36 @@ void PhotoData::load(
 	}
 }
 
+void PhotoData::checkProgressivePartLoaded(int valid) {
+	const auto loader = _images[valid].loader.get();
+	const auto active = activeMediaView();
+	if (!loader || !active) {
+		return;
+	}
+
+	// Show the largest progressive scan that has arrived already,
+	// while the rest of the photo is still being loaded.
+	const auto loaded = loader->currentOffset();
+	for (auto i = valid; i != 0;) {
+		--i;
+		const auto required = _images[i].progressivePartSize;
+		if (!required || required > loaded) {
+			continue;
+		}
+		const auto goodFor = static_cast<PhotoSize>(i);
+		if (!active->image(goodFor)) {
+			auto image = loader->loadedPartImage(required);
+			if (!image.isNull()) {
+				active->set(
+					static_cast<PhotoSize>(valid),
+					goodFor,
+					std::move(image));
+			}
+		}
+		break;
+	}
+}
+
 std::shared_ptr<PhotoMedia> PhotoData::createMediaView() {
 	if (auto result = activeMediaView()) {
 		return result;
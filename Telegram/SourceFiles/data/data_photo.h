@@ -159,6 +159,8 @@ public:
 	std::unique_ptr<Data::UploadState> uploadingData;
 
 private:
+	void checkProgressivePartLoaded(int valid);
+
 	QByteArray _inlineThumbnailBytes;
 	std::array<Data::CloudFile, Data::kPhotoSizeCount> _images;
 	Data::CloudFile _video;
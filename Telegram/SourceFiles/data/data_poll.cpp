@@ -18,6 +18,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace {
 
 constexpr auto kShortPollTimeout = 30 * crl::time(1000);
+constexpr auto kShortPollJoinTimeout = 10 * crl::time(1000);
 constexpr auto kReloadAfterAutoCloseDelay = crl::time(1000);
 
 const PollAnswer *AnswerByOption(
@@ -177,14 +178,21 @@ bool PollData::applyResults(const MTPPollResults &results) {
 void PollData::checkResultsReload(
 		not_null<HistoryItem*> item,
 		crl::time now) {
-	if (_lastResultsUpdate > 0
-		&& _lastResultsUpdate + kShortPollTimeout > now) {
-		return;
-	} else if (closed() && _lastResultsUpdate >= 0) {
+	auto &api = _owner->session().api();
+	if (closed() && _lastResultsUpdate >= 0) {
 		return;
+	} else if (_lastResultsUpdate > 0) {
+		// Join the reloads of other polls painted right now if ours is
+		// going to be needed soon anyway, so they share one container.
+		const auto join = api.pollResultsReloadCollecting()
+			? kShortPollJoinTimeout
+			: crl::time(0);
+		if (_lastResultsUpdate + kShortPollTimeout > now + join) {
+			return;
+		}
 	}
 	_lastResultsUpdate = now;
-	_owner->session().api().reloadPollResults(item);
+	api.reloadPollResults(item);
 }
 
 PollAnswer *PollData::answerByOption(const QByteArray &option) {
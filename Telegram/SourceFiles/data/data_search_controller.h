@@ -30,6 +30,9 @@ struct SearchResult {
 	int fullCount = 0;
 };
 
+[[nodiscard]] MTPMessagesFilter PrepareSearchFilter(
+	Storage::SharedMediaType type);
+
 std::optional<MTPmessages_Search> PrepareSearchRequest(
 	not_null<PeerData*> peer,
 	Storage::SharedMediaType type,
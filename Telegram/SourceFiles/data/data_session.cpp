@@ -10,6 +10,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "main/main_session.h"
 #include "main/main_session_settings.h"
 #include "main/main_account.h"
+#include "main/main_domain.h" // Domain::activeSessionValue.
 #include "apiwrap.h"
 #include "mainwidget.h"
 #include "api/api_text_entities.h"
@@ -56,6 +57,11 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_streaming.h"
 #include "data/data_media_rotation.h"
 #include "data/data_histories.h"
+#include "data/data_messages_text_index.h"
+#include "data/data_auto_download.h"
+#include "data/data_photo_media.h"
+#include "data/data_document_media.h"
+#include "storage/storage_memory_cache.h"
 #include "base/platform/base_platform_info.h"
 #include "base/unixtime.h"
 #include "base/call_delayed.h"
@@ -69,6 +75,21 @@ namespace {
 
 constexpr auto kMaxNotifyCheckDelay = 24 * 3600 * crl::time(1000);
 constexpr auto kMaxWallpaperSize = 10 * 1024 * 1024;
+constexpr auto kCacheMemoryLimit = 32 * 1024 * 1024;
+constexpr auto kCacheHotKeysLimit = 512;
+constexpr auto kCacheHotKeysSaveDelay = 5 * 60 * crl::time(1000);
+
+// When more heavy view parts are loaded we unload the ones
+// that belong to sections other than the one painted last.
+constexpr auto kMaxHeavyViewParts = 256;
+constexpr auto kWebPagePreviewsLimit = 256;
+constexpr auto kWebPagePreviewTimeout = 10 * 60 * crl::time(1000);
+
+// Animation frames are repainted together once per tick, the tick interval
+// is doubled each time the main thread was too late for the previous one.
+constexpr auto kAnimationTickMin = crl::time(16);
+constexpr auto kAnimationTickMax = crl::time(64);
+constexpr auto kAnimationStatsPeriod = 60 * crl::time(1000);
 
 using ViewElement = HistoryView::Element;
 
@@ -214,6 +235,9 @@ Session::Session(not_null<Main::Session*> session)
 , _bigFileCache(Core::App().databases().get(
 	_session->local().cacheBigFilePath(),
 	_session->local().cacheBigFileSettings()))
+, _cacheMemory(std::make_unique<Storage::MemoryCache>(kCacheMemoryLimit))
+, _cacheHotKeysSaveTimer([=] { saveCacheHotKeys(); })
+, _autoDownloadBudget(std::make_unique<AutoDownload::Budget>())
 , _chatsList(
 	session,
 	FilterId(),
@@ -225,6 +249,8 @@ Session::Session(not_null<Main::Session*> session)
 	return sendActionsAnimationCallback(now);
 })
 , _pollsClosingTimer([=] { checkPollsClosings(); })
+, _animationRepaintsTimer([=] { flushAnimationRepaints(); })
+, _animationTickInterval(kAnimationTickMin)
 , _unmuteByFinishedTimer([=] { unmuteByFinished(); })
 , _groups(this)
 , _chatsFilters(std::make_unique<ChatFilters>(this))
@@ -233,9 +259,21 @@ Session::Session(not_null<Main::Session*> session)
 , _streaming(std::make_unique<Streaming>(this))
 , _mediaRotation(std::make_unique<MediaRotation>())
 , _histories(std::make_unique<Histories>(this))
+, _messagesTextIndex(std::make_unique<MessagesTextIndex>(this))
 , _stickers(std::make_unique<Stickers>(this)) {
 	_cache->open(_session->local().cacheKey());
 	_bigFileCache->open(_session->local().cacheBigFileKey());
+	_cacheHotKeysSaveTimer.callEach(kCacheHotKeysSaveDelay);
+
+	// Only the account the user is looking at gets its cache warmed up.
+	Core::App().domain().activeSessionValue(
+	) | rpl::filter([=](Main::Session *session) {
+		return (session == _session);
+	}) | rpl::take(1) | rpl::start_with_next([=] {
+		Core::App().postponeUntilIdle(crl::guard(_session, [=] {
+			warmUpCacheMemory();
+		}));
+	}, _lifetime);
 
 	if constexpr (Platform::IsLinux()) {
 		const auto wasVersion = _session->local().oldMapVersion();
@@ -271,6 +309,7 @@ void Session::clear() {
 	Core::App().notifications().clearFromSession(_session);
 
 	_sendActions.clear();
+	_messagesTextIndex->clear();
 
 	_histories->unloadAll();
 	_scheduledMessages = nullptr;
@@ -1094,6 +1133,112 @@ Storage::Cache::Database &Session::cache() {
 	return *_cache;
 }
 
+Storage::MemoryCache &Session::cacheMemory() {
+	return *_cacheMemory;
+}
+
+AutoDownload::Budget &Session::autoDownloadBudget() {
+	return *_autoDownloadBudget;
+}
+
+void Session::warmUpCacheMemory() {
+	const auto weak = base::make_weak(_session.get());
+	for (const auto &key : _session->local().readCacheHotKeys()) {
+		_cache->get(key, [=](QByteArray &&value) {
+			crl::on_main(weak, [=, value = std::move(value)] {
+				if (!value.startsWith("partial:")) {
+					_cacheMemory->warmUp(key, value);
+				}
+			});
+		});
+	}
+}
+
+void Session::saveCacheHotKeys() {
+	auto keys = _cacheMemory->hotKeys(kCacheHotKeysLimit);
+	if (!keys.empty()) {
+		_session->local().writeCacheHotKeys(keys);
+	}
+}
+
+QString Session::memoryReport() const {
+	const auto imageBytes = [](Image *image) {
+		if (!image || image->isNull()) {
+			return int64(0);
+		}
+		const auto original = image->original();
+		return int64(original.bytesPerLine()) * original.height();
+	};
+	auto histories = 0;
+	for (const auto &[peerId, peer] : _peers) {
+		if (historyLoaded(peerId)) {
+			++histories;
+		}
+	}
+	auto messages = int64(_messages.size());
+	for (const auto &[channelId, list] : _channelMessages) {
+		messages += list.size();
+	}
+	auto views = int64(0);
+	for (const auto &[item, list] : _views) {
+		views += list.size();
+	}
+	auto photoMedia = 0;
+	auto photoBytes = int64(0);
+	for (const auto &[id, photo] : _photos) {
+		if (const auto media = photo->activeMediaView()) {
+			++photoMedia;
+			photoBytes += imageBytes(media->thumbnailInline());
+			for (const auto size : {
+				PhotoSize::Small,
+				PhotoSize::Thumbnail,
+				PhotoSize::Large,
+			}) {
+				photoBytes += imageBytes(media->image(size));
+			}
+		}
+	}
+	auto documentMedia = 0;
+	auto documentBytes = int64(0);
+	for (const auto &[id, document] : _documents) {
+		if (const auto media = document->activeMediaView()) {
+			++documentMedia;
+			documentBytes += media->bytes().size()
+				+ media->videoThumbnailContent().size()
+				+ imageBytes(media->thumbnailInline())
+				+ imageBytes(media->thumbnail())
+				+ imageBytes(media->goodThumbnail());
+		}
+	}
+	const auto mb = [](int64 bytes) {
+		return QString::number(bytes / float64(1024 * 1024), 'f', 1) + "MB";
+	};
+	return QStringList{
+		QString("Peers: %1, histories: %2."
+		).arg(_peers.size()
+		).arg(histories),
+		QString("Messages: %1, views: %2, heavy view parts: %3."
+		).arg(messages
+		).arg(views
+		).arg(_heavyViewParts.size()),
+		QString("Photos: %1, with media: %2, images: %3."
+		).arg(_photos.size()
+		).arg(photoMedia
+		).arg(mb(photoBytes)),
+		QString("Documents: %1, with media: %2, bytes and images: %3."
+		).arg(_documents.size()
+		).arg(documentMedia
+		).arg(mb(documentBytes)),
+		QString("Web pages: %1, polls: %2, games: %3."
+		).arg(_webpages.size()
+		).arg(_polls.size()
+		).arg(_games.size()),
+		QString("Memory cache: %1 values, %2."
+		).arg(_cacheMemory->count()
+		).arg(mb(_cacheMemory->size())),
+	}.join('\n');
+}
+
 Storage::Cache::Database &Session::cacheBigFile() {
 	return *_bigFileCache;
 }
@@ -1434,6 +1579,60 @@ rpl::producer<not_null<const ViewElement*>> Session::viewRepaintRequest() const
 	return _viewRepaintRequest.events();
 }
 
+void Session::requestViewAnimationRepaint(not_null<const ViewElement*> view) {
+	_animationRepaints.emplace(view);
+	if (_animationRepaintsTimer.isActive()) {
+		return;
+	}
+	const auto now = crl::now();
+	_animationTickDue = std::max(
+		now,
+		_animationTickLast + _animationTickInterval);
+	_animationRepaintsTimer.callOnce(_animationTickDue - now);
+}
+
+void Session::flushAnimationRepaints() {
+	const auto now = crl::now();
+	const auto lateness = now - _animationTickDue;
+	if (lateness > _animationTickInterval) {
+		_animationTickInterval = std::min(
+			_animationTickInterval * 2,
+			kAnimationTickMax);
+		++_animationStatsLateTicks;
+	} else if (lateness < _animationTickInterval / 4) {
+		_animationTickInterval = std::max(
+			_animationTickInterval / 2,
+			kAnimationTickMin);
+	}
+	_animationTickLast = now;
+
+	if (!_animationStatsStart) {
+		_animationStatsStart = now;
+	}
+	++_animationStatsTicks;
+	_animationStatsLateness += lateness;
+	_animationStatsRepaints += int(_animationRepaints.size());
+	if (const auto passed = now - _animationStatsStart
+		; passed >= kAnimationStatsPeriod) {
+		DEBUG_LOG(("Animations Info: %1 ticks in %2ms, %3 late, "
+			"%4ms average lateness, %5 repaints per tick, %6ms interval."
+			).arg(_animationStatsTicks
+			).arg(passed
+			).arg(_animationStatsLateTicks
+			).arg(_animationStatsLateness / double(_animationStatsTicks), 0, 'f', 1
+			).arg(_animationStatsRepaints / double(_animationStatsTicks), 0, 'f', 1
+			).arg(_animationTickInterval));
+		_animationStatsStart = now;
+		_animationStatsLateness = 0;
+		_animationStatsTicks = _animationStatsLateTicks = 0;
+		_animationStatsRepaints = 0;
+	}
+
+	for (const auto view : base::take(_animationRepaints)) {
+		requestViewRepaint(view);
+	}
+}
+
 void Session::requestItemResize(not_null<const HistoryItem*> item) {
 	_itemResizeRequest.fire_copy(item);
 	enumerateItemViews(item, [&](not_null<ViewElement*> view) {
@@ -1554,7 +1753,35 @@ rpl::producer<> Session::pinnedDialogsOrderUpdated() const {
 }
 
 void Session::registerHeavyViewPart(not_null<ViewElement*> view) {
-	_heavyViewParts.emplace(view);
+	if (_heavyViewParts.emplace(view).second
+		&& _heavyViewParts.size() > kMaxHeavyViewParts
+		&& !_heavyViewPartsLimitCheckScheduled) {
+		_heavyViewPartsLimitCheckScheduled = true;
+
+		// The delegate is used only for comparison, never dereferenced.
+		const auto active = view->delegate().get();
+		crl::on_main(_session, [=] { checkHeavyViewPartsLimit(active); });
+	}
+}
+
+void Session::checkHeavyViewPartsLimit(
+		const HistoryView::ElementDelegate *active) {
+	_heavyViewPartsLimitCheckScheduled = false;
+	if (_heavyViewParts.size() <= kMaxHeavyViewParts) {
+		return;
+	}
+	auto remove = std::vector<not_null<ViewElement*>>();
+	for (const auto view : _heavyViewParts) {
+		if (view->delegate().get() != active) {
+			remove.push_back(view);
+		}
+	}
+	DEBUG_LOG(("Heavy Parts: %1 loaded, unloading %2 from other sections."
+		).arg(_heavyViewParts.size()
+		).arg(remove.size()));
+	for (const auto view : remove) {
+		view->unloadHeavyPart();
+	}
 }
 
 void Session::unregisterHeavyViewPart(not_null<ViewElement*> view) {
@@ -1943,6 +2170,7 @@ void Session::registerMessage(not_null<HistoryItem*> item) {
 		i->second->destroy();
 	}
 	list->emplace(itemId, item);
+	_messagesTextIndex->add(item);
 }
 
 void Session::processMessagesDeleted(
@@ -1994,6 +2222,7 @@ void Session::unregisterMessage(not_null<HistoryItem*> item) {
 		item,
 		Data::MessageUpdate::Flag::Destroyed);
 	groups().unregisterMessage(item);
+	_messagesTextIndex->remove(item);
 	removeDependencyMessage(item);
 	messagesListForInsert(peerToChannel(peerId))->erase(item->id);
 }
@@ -3546,6 +3775,33 @@ rpl::producer<not_null<WebPageData*>> Session::webPageUpdates() const {
 	return _webpageUpdates.events();
 }
 
+std::optional<WebPageId> Session::cachedWebPagePreview(
+		const QString &links) const {
+	const auto i = _webpagePreviews.find(links);
+	if (i == end(_webpagePreviews)
+		|| i->second.received + kWebPagePreviewTimeout <= crl::now()) {
+		return std::nullopt;
+	}
+	return i->second.id;
+}
+
+void Session::cacheWebPagePreview(const QString &links, WebPageId id) {
+	const auto now = crl::now();
+	if (_webpagePreviews.size() >= kWebPagePreviewsLimit) {
+		for (auto i = begin(_webpagePreviews); i != end(_webpagePreviews);) {
+			if (i->second.received + kWebPagePreviewTimeout <= now) {
+				i = _webpagePreviews.erase(i);
+			} else {
+				++i;
+			}
+		}
+		if (_webpagePreviews.size() >= kWebPagePreviewsLimit) {
+			_webpagePreviews.clear();
+		}
+	}
+	_webpagePreviews[links] = CachedWebPagePreview{ id, now };
+}
+
 void Session::channelDifferenceTooLong(not_null<ChannelData*> channel) {
 	_channelDifferenceTooLong.fire_copy(channel);
 }
@@ -3561,6 +3817,8 @@ void Session::registerItemView(not_null<ViewElement*> view) {
 void Session::unregisterItemView(not_null<ViewElement*> view) {
 	Expects(!_heavyViewParts.contains(view));
 
+	_animationRepaints.remove(view);
+
 	const auto i = _views.find(view->data());
 	if (i != end(_views)) {
 		auto &list = i->second;
@@ -3649,6 +3907,10 @@ void Session::refreshChatListEntry(Dialogs::Key key) {
 	using namespace Dialogs;
 
 	const auto entry = key.entry();
+	if (_chatListEntryRefreshesHolds && entry->inChatList()) {
+		_heldChatListEntryRefreshes.emplace(key);
+		return;
+	}
 	const auto history = key.history();
 	const auto mainList = chatsList(entry->folder());
 	auto event = ChatListEntryRefresh{ .key = key };
@@ -3694,6 +3956,23 @@ void Session::refreshChatListEntry(Dialogs::Key key) {
 	}
 }
 
+void Session::holdChatListEntryRefreshes() {
+	++_chatListEntryRefreshesHolds;
+}
+
+void Session::releaseChatListEntryRefreshes() {
+	Expects(_chatListEntryRefreshesHolds > 0);
+
+	if (--_chatListEntryRefreshesHolds) {
+		return;
+	}
+	for (const auto key : base::take(_heldChatListEntryRefreshes)) {
+		if (key.entry()->inChatList()) {
+			refreshChatListEntry(key);
+		}
+	}
+}
+
 void Session::removeChatListEntry(Dialogs::Key key) {
 	using namespace Dialogs;
 
@@ -4077,6 +4356,7 @@ int32 Session::wallpapersHash() const {
 }
 
 void Session::clearLocalStorage() {
+	_cacheMemory->clear();
 	_cache->close();
 	_cache->clear();
 	_bigFileCache->close();
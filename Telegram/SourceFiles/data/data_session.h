@@ -38,6 +38,10 @@ namespace Main {
 class Session;
 } // namespace Main
 
+namespace Storage {
+class MemoryCache;
+} // namespace Storage
+
 namespace Ui {
 class BoxContent;
 } // namespace Ui
@@ -57,11 +61,16 @@ class CloudThemes;
 class Streaming;
 class MediaRotation;
 class Histories;
+class MessagesTextIndex;
 class DocumentMedia;
 class PhotoMedia;
 class Stickers;
 class GroupCall;
 
+namespace AutoDownload {
+class Budget;
+} // namespace AutoDownload
+
 class Session final {
 public:
 	using ViewElement = HistoryView::Element;
@@ -102,6 +111,9 @@ public:
 	[[nodiscard]] Histories &histories() const {
 		return *_histories;
 	}
+	[[nodiscard]] MessagesTextIndex &messagesTextIndex() const {
+		return *_messagesTextIndex;
+	}
 	[[nodiscard]] Stickers &stickers() const {
 		return *_stickers;
 	}
@@ -126,6 +138,11 @@ public:
 
 	[[nodiscard]] Storage::Cache::Database &cache();
 	[[nodiscard]] Storage::Cache::Database &cacheBigFile();
+	[[nodiscard]] Storage::MemoryCache &cacheMemory();
+	[[nodiscard]] AutoDownload::Budget &autoDownloadBudget();
+
+	// Counts and approximate sizes of the loaded data, for debugging.
+	[[nodiscard]] QString memoryReport() const;
 
 	[[nodiscard]] not_null<PeerData*> peer(PeerId id);
 	[[nodiscard]] not_null<PeerData*> peer(UserId id) = delete;
@@ -239,6 +256,11 @@ public:
 	[[nodiscard]] rpl::producer<not_null<const HistoryItem*>> itemRepaintRequest() const;
 	void requestViewRepaint(not_null<const ViewElement*> view);
 	[[nodiscard]] rpl::producer<not_null<const ViewElement*>> viewRepaintRequest() const;
+
+	// Animated stickers ask for the repaint of a new frame here, all such
+	// repaints are done together once per animation tick. Streamed video
+	// frames use requestViewRepaint(), so that they keep their frame rate.
+	void requestViewAnimationRepaint(not_null<const ViewElement*> view);
 	void requestItemResize(not_null<const HistoryItem*> item);
 	[[nodiscard]] rpl::producer<not_null<const HistoryItem*>> itemResizeRequest() const;
 	void requestViewResize(not_null<ViewElement*> view);
@@ -590,6 +612,12 @@ public:
 	void sendWebPageGamePollNotifications();
 	[[nodiscard]] rpl::producer<not_null<WebPageData*>> webPageUpdates() const;
 
+	// Results of messages.getWebPagePreview by the links string, zero id
+	// for links without a preview. Shared by all the compose fields.
+	[[nodiscard]] std::optional<WebPageId> cachedWebPagePreview(
+		const QString &links) const;
+	void cacheWebPagePreview(const QString &links, WebPageId id);
+
 	void channelDifferenceTooLong(not_null<ChannelData*> channel);
 	[[nodiscard]] rpl::producer<not_null<ChannelData*>> channelDifferenceTooLong() const;
 
@@ -623,6 +651,11 @@ public:
 	};
 	void refreshChatListEntry(Dialogs::Key key);
 	void removeChatListEntry(Dialogs::Key key);
+
+	// While held, rows that are already in the chats list are moved
+	// only once, when the last hold is released.
+	void holdChatListEntryRefreshes();
+	void releaseChatListEntryRefreshes();
 	[[nodiscard]] auto chatListEntryRefreshes() const
 		-> rpl::producer<ChatListEntryRefresh>;
 
@@ -684,6 +717,10 @@ private:
 	void setupPeerNameViewer();
 	void setupUserIsContactViewer();
 
+	void flushAnimationRepaints();
+	void checkHeavyViewPartsLimit(
+		const HistoryView::ElementDelegate *active);
+
 	void checkSelfDestructItems();
 
 	int computeUnreadBadge(const Dialogs::UnreadState &state) const;
@@ -810,10 +847,16 @@ private:
 
 	void checkPollsClosings();
 
+	void warmUpCacheMemory();
+	void saveCacheHotKeys();
+
 	const not_null<Main::Session*> _session;
 
 	Storage::DatabasePointer _cache;
 	Storage::DatabasePointer _bigFileCache;
+	const std::unique_ptr<Storage::MemoryCache> _cacheMemory;
+	base::Timer _cacheHotKeysSaveTimer;
+	const std::unique_ptr<AutoDownload::Budget> _autoDownloadBudget;
 
 	TimeId _exportAvailableAt = 0;
 	QPointer<Ui::BoxContent> _exportSuggestion;
@@ -845,6 +888,8 @@ private:
 	rpl::event_stream<MegagroupParticipant> _megagroupParticipantAdded;
 	rpl::event_stream<DialogsRowReplacement> _dialogsRowReplacements;
 	rpl::event_stream<ChatListEntryRefresh> _chatListEntryRefreshes;
+	base::flat_set<Dialogs::Key> _heldChatListEntryRefreshes;
+	int _chatListEntryRefreshesHolds = 0;
 	rpl::event_stream<> _unreadBadgeChanges;
 
 	Dialogs::MainList _chatsList;
@@ -853,8 +898,8 @@ private:
 
 	MsgId _localMessageIdCounter = StartClientMsgId;
 	Messages _messages;
-	std::map<ChannelId, Messages> _channelMessages;
-	std::map<
+	std::unordered_map<ChannelId, Messages> _channelMessages;
+	std::unordered_map<
 		not_null<HistoryItem*>,
 		base::flat_set<not_null<HistoryItem*>>> _dependentMessages;
 
@@ -919,6 +964,12 @@ private:
 	base::flat_set<not_null<PollData*>> _pollsUpdated;
 
 	rpl::event_stream<not_null<WebPageData*>> _webpageUpdates;
+
+	struct CachedWebPagePreview {
+		WebPageId id = 0;
+		crl::time received = 0;
+	};
+	base::flat_map<QString, CachedWebPagePreview> _webpagePreviews;
 	rpl::event_stream<not_null<ChannelData*>> _channelDifferenceTooLong;
 
 	base::flat_multi_map<TimeId, not_null<PollData*>> _pollsClosings;
@@ -934,6 +985,18 @@ private:
 	rpl::event_stream<> _pinnedDialogsOrderUpdated;
 
 	base::flat_set<not_null<ViewElement*>> _heavyViewParts;
+	bool _heavyViewPartsLimitCheckScheduled = false;
+
+	base::flat_set<not_null<const ViewElement*>> _animationRepaints;
+	base::Timer _animationRepaintsTimer;
+	crl::time _animationTickInterval = 0;
+	crl::time _animationTickDue = 0;
+	crl::time _animationTickLast = 0;
+	crl::time _animationStatsStart = 0;
+	crl::time _animationStatsLateness = 0;
+	int _animationStatsTicks = 0;
+	int _animationStatsLateTicks = 0;
+	int _animationStatsRepaints = 0;
 
 	base::flat_map<uint64, not_null<GroupCall*>> _groupCalls;
 	rpl::event_stream<InviteToCall> _invitesToCalls;
@@ -972,6 +1035,7 @@ private:
 	std::unique_ptr<Streaming> _streaming;
 	std::unique_ptr<MediaRotation> _mediaRotation;
 	std::unique_ptr<Histories> _histories;
+	std::unique_ptr<MessagesTextIndex> _messagesTextIndex;
 	base::flat_map<
 		not_null<History*>,
 		base::flat_map<
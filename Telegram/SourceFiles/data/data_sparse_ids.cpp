@@ -205,11 +205,42 @@ bool SparseIdsSliceBuilder::applyUpdate(
 	auto skippedAfter = (update.range.till == ServerMaxMsgId)
 		? 0
 		: std::optional<int> {};
+	if (!needMergeMessages) {
+		mergeSliceData(
+			update.count,
+			base::flat_set<MsgId> {},
+			skippedBefore,
+			skippedAfter);
+		return true;
+	}
+
+	// The updated slice can hold all the shared media of a big channel,
+	// while sliceToLimits() keeps only the ids around _key anyway.
+	const auto &all = *update.messages;
+	const auto around = ranges::lower_bound(all, _key);
+	const auto from = around - std::min(
+		int(around - all.begin()),
+		_limitBefore);
+	const auto till = around + std::min(
+		int(all.end() - around),
+		_limitAfter + 1);
+	if (!_key || from == till || int(till - from) == int(all.size())) {
+		mergeSliceData(
+			update.count,
+			all,
+			skippedBefore,
+			skippedAfter);
+		return true;
+	}
+	if (skippedBefore) {
+		*skippedBefore += int(from - all.begin());
+	}
+	if (skippedAfter) {
+		*skippedAfter += int(all.end() - till);
+	}
 	mergeSliceData(
 		update.count,
-		needMergeMessages
-			? *update.messages
-			: base::flat_set<MsgId> {},
+		base::flat_set<MsgId>(from, till),
 		skippedBefore,
 		skippedAfter);
 	return true;
@@ -199,11 +199,19 @@ void UserData::setBotInfo(const MTPBotInfo &info) {
 void UserData::setNameOrPhone(const QString &newNameOrPhone) {
 	if (nameOrPhone != newNameOrPhone) {
 		nameOrPhone = newNameOrPhone;
-		phoneText.setText(
+		_phoneTextOutdated = true;
+	}
+}
+
+const Ui::Text::String &UserData::phoneText() const {
+	if (_phoneTextOutdated) {
+		_phoneTextOutdated = false;
+		_phoneText.setText(
 			st::msgNameStyle,
 			nameOrPhone,
 			Ui::NameTextOptions());
 	}
+	return _phoneText;
 }
 
 void UserData::madeAction(TimeId when) {
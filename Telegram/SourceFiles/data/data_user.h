@@ -169,7 +169,7 @@ public:
 		return _phone;
 	}
 	QString nameOrPhone;
-	Ui::Text::String phoneText;
+	[[nodiscard]] const Ui::Text::String &phoneText() const;
 	TimeId onlineTill = 0;
 
 	enum class ContactStatus : char {
@@ -216,6 +216,8 @@ private:
 
 	std::vector<Data::UnavailableReason> _unavailableReasons;
 	QString _phone;
+	mutable Ui::Text::String _phoneText;
+	mutable bool _phoneTextOutdated = false;
 	ContactStatus _contactStatus = ContactStatus::Unknown;
 	CallsStatus _callsStatus = CallsStatus::Unknown;
 	int _commonChatsCount = 0;
@@ -26,6 +26,7 @@ RowsByLetter IndexedList::addToEnd(Key key) {
 	}
 
 	auto result = RowsByLetter{ _list.addToEnd(key) };
+	indexWords(key.entry());
 	for (const auto ch : key.entry()->chatListFirstLetters()) {
 		auto j = _index.find(ch);
 		if (j == _index.cend()) {
@@ -42,6 +43,7 @@ Row *IndexedList::addByName(Key key) {
 	}
 
 	const auto result = _list.addByName(key);
+	indexWords(key.entry());
 	for (const auto ch : key.entry()->chatListFirstLetters()) {
 		auto j = _index.find(ch);
 		if (j == _index.cend()) {
@@ -119,6 +121,8 @@ void IndexedList::adjustByName(
 	const auto mainRow = _list.adjustByName(key);
 	if (!mainRow) return;
 
+	indexWords(key.entry());
+
 	auto toRemove = oldLetters;
 	auto toAdd = base::flat_set<QChar>();
 	for (const auto ch : key.entry()->chatListFirstLetters()) {
@@ -156,6 +160,8 @@ void IndexedList::adjustNames(
 	auto mainRow = _list.getRow(key);
 	if (!mainRow) return;
 
+	indexWords(key.entry());
+
 	auto toRemove = oldLetters;
 	auto toAdd = base::flat_set<QChar>();
 	for (const auto ch : key.entry()->chatListFirstLetters()) {
@@ -188,6 +194,7 @@ void IndexedList::adjustNames(
 
 void IndexedList::del(Key key, Row *replacedBy) {
 	if (_list.del(key, replacedBy)) {
+		unindexWords(key.entry());
 		for (const auto ch : key.entry()->chatListFirstLetters()) {
 			if (auto it = _index.find(ch); it != _index.cend()) {
 				it->second.del(key, replacedBy);
@@ -198,35 +205,86 @@ void IndexedList::del(Key key, Row *replacedBy) {
 
 void IndexedList::clear() {
 	_index.clear();
+	_words.clear();
+	_wordsByEntry.clear();
+}
+
+void IndexedList::indexWords(not_null<Entry*> entry) {
+	const auto &now = entry->chatListNameWords();
+	const auto i = _wordsByEntry.find(entry);
+	if (i != end(_wordsByEntry)) {
+		if (i->second == now) {
+			return;
+		}
+		unindexWords(entry);
+	}
+	for (const auto &word : now) {
+		_words.emplace(word, entry);
+	}
+	_wordsByEntry.emplace(entry, now);
+}
+
+void IndexedList::unindexWords(not_null<Entry*> entry) {
+	const auto i = _wordsByEntry.find(entry);
+	if (i == end(_wordsByEntry)) {
+		return;
+	}
+	for (const auto &word : i->second) {
+		auto [from, till] = _words.equal_range(word);
+		for (; from != till; ++from) {
+			if (from->second == entry) {
+				_words.erase(from);
+				break;
+			}
+		}
+	}
+	_wordsByEntry.erase(i);
 }
 
 std::vector<not_null<Row*>> IndexedList::filtered(
 		const QStringList &words) const {
-	const auto minimal = [&]() -> const Dialogs::List* {
-		if (empty()) {
-			return nullptr;
-		}
-		auto result = (const Dialogs::List*)nullptr;
-		for (const auto &word : words) {
-			if (word.isEmpty()) {
-				continue;
-			}
-			const auto found = filtered(word[0]);
-			if (!found || found->empty()) {
-				return nullptr;
-			} else if (!result || result->size() > found->size()) {
-				result = found;
-			}
+	using Iterator = decltype(_words)::const_iterator;
+
+	// Find the word with the least entries having a name with its prefix.
+	auto minimal = std::optional<std::pair<Iterator, Iterator>>();
+	auto minimalSize = 0;
+	for (const auto &word : words) {
+		if (word.isEmpty()) {
+			continue;
 		}
-		return result;
-	}();
+		const auto from = _words.lower_bound(word);
+		auto till = from;
+		auto size = 0;
+		while (till != _words.end()
+			&& till->first.startsWith(word)
+			&& (!minimal || size < minimalSize)) {
+			++till;
+			++size;
+		}
+		if (!size) {
+			return {};
+		} else if (!minimal || size < minimalSize) {
+			minimal = std::make_pair(from, till);
+			minimalSize = size;
+		}
+	}
 	auto result = std::vector<not_null<Row*>>();
-	if (!minimal || minimal->empty()) {
+	if (!minimal) {
 		return result;
 	}
-	result.reserve(minimal->size());
-	for (const auto row : *minimal) {
-		const auto &nameWords = row->entry()->chatListNameWords();
+	auto entries = std::vector<not_null<Entry*>>();
+	entries.reserve(minimalSize);
+	for (auto i = minimal->first; i != minimal->second; ++i) {
+		entries.push_back(i->second);
+	}
+
+	// Several name words of one entry may have the same prefix.
+	ranges::sort(entries);
+	entries.erase(ranges::unique(entries), end(entries));
+
+	result.reserve(entries.size());
+	for (const auto entry : entries) {
+		const auto &nameWords = entry->chatListNameWords();
 		const auto found = [&](const QString &word) {
 			for (const auto &name : nameWords) {
 				if (name.startsWith(word)) {
@@ -244,9 +302,14 @@ std::vector<not_null<Row*>> IndexedList::filtered(
 			return true;
 		}();
 		if (allFound) {
-			result.push_back(row);
+			if (const auto row = _list.getRow(entry)) {
+				result.push_back(row);
+			}
 		}
 	}
+	ranges::sort(result, std::less<>(), [](not_null<Row*> row) {
+		return row->pos();
+	});
 	return result;
 }
 
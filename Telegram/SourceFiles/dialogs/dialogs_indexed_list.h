@@ -80,11 +80,18 @@ private:
 		not_null<History*> history,
 		const base::flat_set<QChar> &oldChars);
 
+	void indexWords(not_null<Entry*> entry);
+	void unindexWords(not_null<Entry*> entry);
+
 	SortMode _sortMode = SortMode();
 	FilterId _filterId = 0;
 	List _list, _empty;
 	base::flat_map<QChar, List> _index;
 
+	// Sorted name words for prefix lookups in filtered(words).
+	std::multimap<QString, not_null<Entry*>> _words;
+	std::map<not_null<Entry*>, base::flat_set<QString>> _wordsByEntry;
+
 };
 
 } // namespace Dialogs
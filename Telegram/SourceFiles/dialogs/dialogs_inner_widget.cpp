@@ -16,6 +16,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/history_item.h"
 #include "core/shortcuts.h"
 #include "core/application.h"
+#include "core/core_probes.h"
 #include "ui/widgets/buttons.h"
 #include "ui/widgets/popup_menu.h"
 #include "ui/text/text_utilities.h"
@@ -242,9 +243,21 @@ InnerWidget::InnerWidget(
 		| UpdateFlag::Photo
 		| UpdateFlag::IsContact
 	) | rpl::start_with_next([=](const Data::PeerUpdate &update) {
-		if (update.flags & (UpdateFlag::Name | UpdateFlag::Photo)) {
+		if ((update.flags & UpdateFlag::Name)
+			|| ((update.flags & UpdateFlag::Photo)
+				&& _state != WidgetState::Default)) {
 			this->update();
 			_updated.fire({});
+		} else if (update.flags & UpdateFlag::Photo) {
+			// In the chats list the userpic is painted only in its own row.
+			const auto peer = update.peer;
+			if (const auto history = peer->owner().historyLoaded(peer)) {
+				updateDialogRow(
+					RowDescriptor(history, FullMsgId()),
+					QRect(),
+					UpdateRowSection::Default);
+			}
+			_updated.fire({});
 		}
 		if (update.flags & UpdateFlag::IsContact) {
 			// contactsNoChatsList could've changed.
@@ -411,6 +424,9 @@ void InnerWidget::changeOpenedFolder(Data::Folder *folder) {
 }
 
 void InnerWidget::paintEvent(QPaintEvent *e) {
+	static auto probe = Core::Probe("paint.dialogs_us");
+	const auto timer = Core::ProbeTimer(probe);
+
 	Painter p(this);
 
 	const auto r = e->rect();
@@ -659,6 +675,13 @@ void InnerWidget::paintEvent(QPaintEvent *e) {
 			auto to = ceilclamp(r.y() + r.height() - skip, st::dialogsRowHeight, 0, _searchResults.size());
 			p.translate(0, from * st::dialogsRowHeight);
 			if (from < _searchResults.size()) {
+				if (_searchResultsCachedFrom >= _searchResultsCachedTill) {
+					_searchResultsCachedFrom = from;
+					_searchResultsCachedTill = to;
+				} else {
+					accumulate_min(_searchResultsCachedFrom, from);
+					accumulate_max(_searchResultsCachedTill, to);
+				}
 				for (; from < to; ++from) {
 					const auto &result = _searchResults[from];
 					const auto active = isSearchResultActive(result.get(), activeEntry);
@@ -1032,7 +1055,7 @@ void InnerWidget::selectByMouse(QPoint globalPosition) {
 				updateSelectedRow();
 			}
 		}
-		if (!_waitingForSearch && !_searchResults.empty()) {
+		if (!_searchResults.empty()) {
 			auto skip = searchedOffset();
 			auto searchedSelected = (mouseY >= skip) ? ((mouseY - skip) / st::dialogsRowHeight) : -1;
 			if (searchedSelected < 0 || searchedSelected >= _searchResults.size()) {
@@ -1935,6 +1958,7 @@ InnerWidget::~InnerWidget() {
 void InnerWidget::clearSearchResults(bool clearPeerSearchResults) {
 	if (clearPeerSearchResults) _peerSearchResults.clear();
 	_searchResults.clear();
+	_searchResultsCachedFrom = _searchResultsCachedTill = 0;
 	_searchedCount = _searchedMigratedCount = 0;
 	_lastSearchDate = 0;
 	_lastSearchPeer = nullptr;
@@ -1985,6 +2009,7 @@ void InnerWidget::visibleTopBottomUpdated(
 	_visibleTop = visibleTop;
 	_visibleBottom = visibleBottom;
 	loadPeerPhotos();
+	releaseSearchResultsCaches();
 	if (_visibleTop + PreloadHeightsCount * (_visibleBottom - _visibleTop) >= height()) {
 		if (_loadMoreCallback) {
 			_loadMoreCallback();
@@ -1992,6 +2017,36 @@ void InnerWidget::visibleTopBottomUpdated(
 	}
 }
 
+void InnerWidget::releaseSearchResultsCaches() {
+	if (_state != WidgetState::Filtered || _searchResults.empty()) {
+		return;
+	}
+
+	// Keep text caches of the visible rows and one screen around them,
+	// rows outside [_searchResultsCachedFrom, _searchResultsCachedTill)
+	// were not painted since the last call and have no caches.
+	const auto count = int(_searchResults.size());
+	const auto skip = searchedOffset();
+	const auto rowHeight = st::dialogsRowHeight;
+	const auto around = (_visibleBottom - _visibleTop) / rowHeight + 1;
+	const auto from = std::clamp(
+		(_visibleTop - skip) / rowHeight - around,
+		0,
+		count);
+	const auto till = std::clamp(
+		(_visibleBottom - skip) / rowHeight + 1 + around,
+		0,
+		count);
+	const auto cachedTill = std::min(_searchResultsCachedTill, count);
+	for (auto i = _searchResultsCachedFrom; i < cachedTill; ++i) {
+		if (i < from || i >= till) {
+			_searchResults[i]->invalidateCache();
+		}
+	}
+	_searchResultsCachedFrom = from;
+	_searchResultsCachedTill = till;
+}
+
 void InnerWidget::itemRemoved(not_null<const HistoryItem*> item) {
 	int wasCount = _searchResults.size();
 	for (auto i = _searchResults.begin(); i != _searchResults.end();) {
@@ -2122,6 +2177,30 @@ bool InnerWidget::searchReceived(
 	return lastDateFound != 0;
 }
 
+void InnerWidget::searchLocalReceived(
+		const std::vector<not_null<HistoryItem*>> &items) {
+	if (_state != WidgetState::Filtered || !_waitingForSearch) {
+		return;
+	}
+
+	// While waiting for the server the shown results are the local ones
+	// or the ones for the previous query, replace them in both cases.
+	clearSearchResults(false);
+	_searchedSelected = _searchedPressed = -1;
+	const auto uniquePeers = uniqueSearchResults();
+	for (const auto item : items) {
+		if (!uniquePeers || !hasHistoryInResults(item->history())) {
+			_searchResults.push_back(
+				std::make_unique<FakeRow>(_searchInChat, item));
+		}
+	}
+
+	// Shown until the server results replace them, without clearing
+	// _waitingForSearch, so that the next page isn't requested after them.
+	_searchedCount = int(_searchResults.size());
+	refresh();
+}
+
 void InnerWidget::peerSearchReceived(
 		const QString &query,
 		const QVector<MTPPeer> &my,
@@ -73,6 +73,8 @@ public:
 		HistoryItem *inject,
 		SearchRequestType type,
 		int fullCount);
+	void searchLocalReceived(
+		const std::vector<not_null<HistoryItem*>> &items);
 	void peerSearchReceived(
 		const QString &query,
 		const QVector<MTPPeer> &my,
@@ -196,6 +198,7 @@ private:
 	void clearIrrelevantState();
 	void selectByMouse(QPoint globalPosition);
 	void loadPeerPhotos();
+	void releaseSearchResultsCaches();
 	void setCollapsedPressed(int pressed);
 	void setPressed(Row *pressed);
 	void setHashtagPressed(int pressed);
@@ -383,6 +386,8 @@ private:
 	int _peerSearchPressed = -1;
 
 	std::vector<std::unique_ptr<FakeRow>> _searchResults;
+	int _searchResultsCachedFrom = 0;
+	int _searchResultsCachedTill = 0;
 	int _searchedCount = 0;
 	int _searchedMigratedCount = 0;
 	int _searchedSelected = -1;
@@ -12,6 +12,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "dialogs/dialogs_key.h"
 #include "dialogs/dialogs_entry.h"
 #include "history/history.h"
+#include "history/history_item.h"
 //#include "history/feed/history_feed_section.h" // #feed
 #include "history/view/history_view_top_bar_widget.h"
 #include "ui/widgets/buttons.h"
@@ -42,6 +43,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_folder.h"
 #include "data/data_histories.h"
 #include "data/data_changes.h"
+#include "data/data_messages_text_index.h"
 #include "facades.h"
 #include "app.h"
 #include "styles/style_dialogs.h"
@@ -901,6 +903,7 @@ bool Widget::onSearchMessages(bool searchCache) {
 			}).send();
 			_searchQueries.emplace(_searchRequest, _searchQuery);
 		}
+		showLocalSearchResults();
 	}
 	const auto query = Api::ConvertPeerSearchQuery(q);
 	if (searchForPeersRequired(query)) {
@@ -1131,6 +1134,30 @@ void Widget::onSearchMore() {
 	}
 }
 
+void Widget::showLocalSearchResults() {
+	const auto history = _searchInChat.history();
+	if (!history && _searchInChat) {
+		return;
+	}
+	auto items = session().data().messagesTextIndex().search(
+		_searchQuery,
+		history,
+		SearchPerPage);
+
+	// Same filters as in the server request, so that the server results
+	// don't remove the shown ones. In a chat only the chat itself is
+	// searched first, the migrated history is requested after it.
+	const auto skipArchive = !history
+		&& session().settings().skipArchiveInSearch();
+	items.erase(ranges::remove_if(items, [&](not_null<HistoryItem*> item) {
+		const auto itemHistory = item->history();
+		return (_searchQueryFrom && item->from() != _searchQueryFrom)
+			|| (!history && itemHistory->peer->migrateTo())
+			|| (skipArchive && itemHistory->folder());
+	}), end(items));
+	_inner->searchLocalReceived(items);
+}
+
 void Widget::searchReceived(
 		SearchRequestType type,
 		const MTPmessages_Messages &result,
@@ -127,6 +127,7 @@ private:
 	};
 
 	void animationCallback();
+	void showLocalSearchResults();
 	void searchReceived(
 		SearchRequestType type,
 		const MTPmessages_Messages &result,
@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "export/export_settings.h"
 #include "export/data/export_data_types.h"
+#include "export/output/export_output_abstract.h"
 #include "export/output/export_output_result.h"
 #include "export/output/export_output_file.h"
 #include "mtproto/mtproto_rpc_sender.h"
@@ -17,6 +18,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include <set>
 #include <deque>
 
+#include <QtCore/QFileInfo>
+
 namespace Export {
 namespace {
 
@@ -24,6 +27,7 @@ constexpr auto kUserpicsSliceLimit = 100;
 constexpr auto kFileChunkSize = 128 * 1024;
 constexpr auto kFileRequestsCount = 2;
 constexpr auto kFileNextRequestDelay = crl::time(20);
+constexpr auto kMessageFilesInParallel = 4;
 constexpr auto kChatsSliceLimit = 100;
 constexpr auto kMessagesSliceLimit = 100;
 constexpr auto kTopPeerSliceLimit = 100;
@@ -37,6 +41,9 @@ struct LocationKey {
 	inline bool operator<(const LocationKey &other) const {
 		return std::tie(type, id) < std::tie(other.type, other.id);
 	}
+	inline bool operator==(const LocationKey &other) const {
+		return std::tie(type, id) == std::tie(other.type, other.id);
+	}
 };
 
 std::tuple<const uint64 &, const uint64 &> value_ordering_helper(const LocationKey &value) {
@@ -131,6 +138,31 @@ private:
 
 };
 
+class ApiWrap::LoadedFilesCheckpoint {
+public:
+	using Location = Data::FileLocation;
+
+	explicit LoadedFilesCheckpoint(const QString &folder);
+
+	void save(
+		const Location &location,
+		const QString &relativePath,
+		int size);
+	std::optional<QString> find(const Location &location) const;
+	void finish();
+
+private:
+	struct Entry {
+		QString relativePath;
+		int size = 0;
+	};
+
+	QString _folder;
+	QFile _file;
+	std::map<LocationKey, Entry> _map;
+
+};
+
 struct ApiWrap::StartProcess {
 	FnMut<void(StartInfo)> done;
 
@@ -174,13 +206,16 @@ struct ApiWrap::OtherDataProcess {
 struct ApiWrap::FileProcess {
 	FileProcess(const QString &path, Output::Stats *stats);
 
+	uint64 id = 0;
 	Output::File file;
 	QString relativePath;
 
 	Fn<bool(FileProgress)> progress;
 	FnMut<void(const QString &relativePath)> done;
+	std::vector<FnMut<void(const QString &relativePath)>> duplicates;
 
 	Data::FileLocation location;
+	LocationKey locationKey;
 	Data::FileOrigin origin;
 	int offset = 0;
 	int size = 0;
@@ -193,6 +228,7 @@ struct ApiWrap::FileProcess {
 };
 
 struct ApiWrap::FileProgress {
+	QString relativePath;
 	int ready = 0;
 	int total = 0;
 };
@@ -236,6 +272,12 @@ struct ApiWrap::ChatProcess {
 	std::optional<Data::MessagesSlice> slice;
 	bool lastSlice = false;
 	int fileIndex = 0;
+	bool thumbNext = false;
+	int filesLoading = 0;
+
+	std::optional<MTPmessages_Messages> nextSlice;
+	bool nextSliceRequested = false;
+	bool nextSliceWanted = false;
 };
 
 
@@ -347,6 +389,70 @@ std::optional<QString> ApiWrap::LoadedFileCache::find(
 	return std::nullopt;
 }
 
+ApiWrap::LoadedFilesCheckpoint::LoadedFilesCheckpoint(const QString &folder)
+: _folder(folder)
+, _file(Output::CheckpointPath(folder)) {
+	// Each line is "<type> <id> <size> <relative path>".
+	if (_file.open(QIODevice::ReadOnly)) {
+		while (!_file.atEnd()) {
+			const auto line = QString::fromUtf8(_file.readLine()).trimmed();
+			const auto type = line.section(' ', 0, 0).toULongLong();
+			const auto id = line.section(' ', 1, 1).toULongLong();
+			const auto size = line.section(' ', 2, 2).toInt();
+			const auto relativePath = line.section(' ', 3);
+			if (size > 0 && !relativePath.isEmpty()) {
+				_map[LocationKey{ type, id }] = { relativePath, size };
+			}
+		}
+		_file.close();
+		if (!_map.empty()) {
+			LOG(("Export Info: Resuming with %1 loaded files."
+				).arg(_map.size()));
+		}
+	}
+}
+
+void ApiWrap::LoadedFilesCheckpoint::save(
+		const Location &location,
+		const QString &relativePath,
+		int size) {
+	if (!location || size <= 0) {
+		return;
+	}
+	if (!_file.isOpen() && !_file.open(QIODevice::Append)) {
+		return;
+	}
+	const auto key = ComputeLocationKey(location);
+	_map[key] = { relativePath, size };
+	_file.write(QString("%1 %2 %3 %4\n"
+	).arg(key.type
+	).arg(key.id
+	).arg(size
+	).arg(relativePath).toUtf8());
+	_file.flush();
+}
+
+std::optional<QString> ApiWrap::LoadedFilesCheckpoint::find(
+		const Location &location) const {
+	if (!location) {
+		return std::nullopt;
+	}
+	const auto key = ComputeLocationKey(location);
+	const auto i = _map.find(key);
+	if (i == end(_map)
+		|| QFileInfo(_folder + i->second.relativePath).size()
+			!= i->second.size) {
+		return std::nullopt;
+	}
+	return i->second.relativePath;
+}
+
+void ApiWrap::LoadedFilesCheckpoint::finish() {
+	_file.close();
+	_file.remove();
+	_map.clear();
+}
+
 ApiWrap::FileProcess::FileProcess(const QString &path, Output::Stats *stats)
 : file(path, stats) {
 }
@@ -377,7 +483,10 @@ auto ApiWrap::splitRequest(int index, Request &&request) {
 		std::forward<Request>(request)));
 }
 
-auto ApiWrap::fileRequest(const Data::FileLocation &location, int offset) {
+auto ApiWrap::fileRequest(
+		uint64 processId,
+		const Data::FileLocation &location,
+		int offset) {
 	Expects(location.dcId != 0
 		|| location.data.type() == mtpc_inputTakeoutFileLocation);
 	Expects(_takeoutId.has_value());
@@ -393,6 +502,7 @@ auto ApiWrap::fileRequest(const Data::FileLocation &location, int offset) {
 		if (result.type() == qstr("TAKEOUT_FILE_EMPTY")
 			&& _otherDataProcess != nullptr) {
 			filePartDone(
+				processId,
 				0,
 				MTP_upload_file(
 					MTP_storage_filePartial(),
@@ -400,10 +510,10 @@ auto ApiWrap::fileRequest(const Data::FileLocation &location, int offset) {
 					MTP_bytes()));
 		} else if (result.type() == qstr("LOCATION_INVALID")
 			|| result.type() == qstr("VERSION_INVALID")) {
-			filePartUnavailable();
+			filePartUnavailable(processId);
 		} else if (result.code() == 400
 			&& result.type().startsWith(qstr("FILE_REFERENCE_"))) {
-			filePartRefreshReference(offset);
+			filePartRefreshReference(processId, offset);
 		} else {
 			error(std::move(result));
 		}
@@ -432,6 +542,7 @@ void ApiWrap::startExport(
 
 	_settings = std::make_unique<Settings>(settings);
 	_stats = stats;
+	_checkpoint = std::make_unique<LoadedFilesCheckpoint>(_settings->path);
 	_startProcess = std::make_unique<StartProcess>();
 	_startProcess->done = std::move(done);
 
@@ -842,7 +953,6 @@ void ApiWrap::finishUserpicsSlice() {
 }
 
 bool ApiWrap::loadUserpicProgress(FileProgress progress) {
-	Expects(_fileProcess != nullptr);
 	Expects(_userpicsProcess != nullptr);
 	Expects(_userpicsProcess->slice.has_value());
 	Expects((_userpicsProcess->fileIndex >= 0)
@@ -850,7 +960,7 @@ bool ApiWrap::loadUserpicProgress(FileProgress progress) {
 			< _userpicsProcess->slice->list.size()));
 
 	return _userpicsProcess->fileProgress(DownloadProgress{
-		_fileProcess->relativePath,
+		progress.relativePath,
 		_userpicsProcess->fileIndex,
 		progress.ready,
 		progress.total });
@@ -1053,6 +1163,10 @@ void ApiWrap::messagesCountLoaded(int localSplitIndex, int count) {
 void ApiWrap::finishExport(FnMut<void()> done) {
 	const auto guard = gsl::finally([&] { _takeoutId = std::nullopt; });
 
+	if (_checkpoint) {
+		_checkpoint->finish();
+	}
+
 	mainRequest(MTPaccount_FinishTakeoutSession(
 		MTP_flags(MTPaccount_FinishTakeoutSession::Flag::f_success)
 	)).done(std::move(done)).send();
@@ -1378,6 +1492,12 @@ void ApiWrap::requestMessagesSlice() {
 	if (!count) {
 		loadMessagesFiles({});
 		return;
+	} else if (_chatProcess->nextSlice) {
+		handleMessagesSlice(*base::take(_chatProcess->nextSlice));
+		return;
+	} else if (_chatProcess->nextSliceRequested) {
+		_chatProcess->nextSliceWanted = true;
+		return;
 	}
 	requestChatMessages(
 		_chatProcess->info.splits[_chatProcess->localSplitIndex],
@@ -1385,21 +1505,55 @@ void ApiWrap::requestMessagesSlice() {
 		-kMessagesSliceLimit,
 		kMessagesSliceLimit,
 		[=](const MTPmessages_Messages &result) {
+		handleMessagesSlice(result);
+	});
+}
+
+void ApiWrap::requestNextMessagesSlice(int32 largestIdPlusOne) {
+	Expects(_chatProcess != nullptr);
+	Expects(!_chatProcess->nextSlice.has_value());
+	Expects(!_chatProcess->nextSliceRequested);
+
+	_chatProcess->nextSliceRequested = true;
+	requestChatMessages(
+		_chatProcess->info.splits[_chatProcess->localSplitIndex],
+		largestIdPlusOne,
+		-kMessagesSliceLimit,
+		kMessagesSliceLimit,
+		[=](MTPmessages_Messages &&result) {
 		Expects(_chatProcess != nullptr);
 
-		result.match([&](const MTPDmessages_messagesNotModified &data) {
-			error("Unexpected messagesNotModified received.");
-		}, [&](const auto &data) {
-			if constexpr (MTPDmessages_messages::Is<decltype(data)>()) {
-				_chatProcess->lastSlice = true;
-			}
-			loadMessagesFiles(Data::ParseMessagesSlice(
-				_chatProcess->context,
-				data.vmessages(),
-				data.vusers(),
-				data.vchats(),
-				_chatProcess->info.relativePath));
-		});
+		_chatProcess->nextSliceRequested = false;
+		if (base::take(_chatProcess->nextSliceWanted)) {
+			handleMessagesSlice(result);
+		} else {
+			_chatProcess->nextSlice = std::move(result);
+		}
+	});
+}
+
+void ApiWrap::handleMessagesSlice(const MTPmessages_Messages &result) {
+	Expects(_chatProcess != nullptr);
+
+	result.match([&](const MTPDmessages_messagesNotModified &data) {
+		error("Unexpected messagesNotModified received.");
+	}, [&](const auto &data) {
+		if constexpr (MTPDmessages_messages::Is<decltype(data)>()) {
+			_chatProcess->lastSlice = true;
+		}
+		auto slice = Data::ParseMessagesSlice(
+			_chatProcess->context,
+			data.vmessages(),
+			data.vusers(),
+			data.vchats(),
+			_chatProcess->info.relativePath);
+
+		// Request the next slice of this split while the files of the
+		// current one are loaded and it is written by the output.
+		if (!_chatProcess->lastSlice && !slice.list.empty()) {
+			requestNextMessagesSlice(slice.list.back().id + 1);
+		}
+		loadMessagesFiles(std::move(slice));
 	});
 }
 
@@ -1484,25 +1638,26 @@ void ApiWrap::loadMessagesFiles(Data::MessagesSlice &&slice) {
 	}
 	_chatProcess->slice = std::move(slice);
 	_chatProcess->fileIndex = 0;
+	_chatProcess->thumbNext = false;
 
 	loadNextMessageFile();
 }
 
-Data::Message *ApiWrap::currentFileMessage() const {
+Data::Message *ApiWrap::fileMessage(int index) const {
 	Expects(_chatProcess != nullptr);
 	Expects(_chatProcess->slice.has_value());
 
-	return &_chatProcess->slice->list[_chatProcess->fileIndex];
+	return &_chatProcess->slice->list[index];
 }
 
-Data::FileOrigin ApiWrap::currentFileMessageOrigin() const {
+Data::FileOrigin ApiWrap::fileMessageOrigin(int index) const {
 	Expects(_chatProcess != nullptr);
 	Expects(_chatProcess->slice.has_value());
 
 	const auto splitIndex = _chatProcess->info.splits[
 		_chatProcess->localSplitIndex];
 	auto result = Data::FileOrigin();
-	result.messageId = currentFileMessage()->id;
+	result.messageId = fileMessage(index)->id;
 	result.split = (splitIndex >= 0)
 		? splitIndex
 		: (int(_splits.size()) + splitIndex);
@@ -1516,39 +1671,55 @@ void ApiWrap::loadNextMessageFile() {
 	Expects(_chatProcess != nullptr);
 	Expects(_chatProcess->slice.has_value());
 
-	for (auto &list = _chatProcess->slice->list
-		; _chatProcess->fileIndex < list.size()
-		; ++_chatProcess->fileIndex) {
-		const auto &message = list[_chatProcess->fileIndex];
+	// Files of one slice are loaded in parallel, the slice itself is
+	// handled only after all of them are loaded, so the output order
+	// doesn't depend on the order in which the files are finished.
+	auto &list = _chatProcess->slice->list;
+	while (_chatProcess->fileIndex < list.size()) {
+		if (_chatProcess->filesLoading >= kMessageFilesInParallel) {
+			return;
+		}
+		const auto index = _chatProcess->fileIndex;
+		auto &message = list[index];
 		if (Data::SkipMessageByDate(message, *_settings)) {
+			++_chatProcess->fileIndex;
 			continue;
 		}
-		const auto fileProgress = [=](FileProgress value) {
-			return loadMessageFileProgress(value);
-		};
-		const auto ready = processFileLoad(
-			list[_chatProcess->fileIndex].file(),
-			currentFileMessageOrigin(),
-			fileProgress,
-			[=](const QString &path) { loadMessageFileDone(path); },
-			currentFileMessage());
-		if (!ready) {
-			return;
+		if (!_chatProcess->thumbNext) {
+			_chatProcess->thumbNext = true;
+			const auto fileProgress = [=](FileProgress value) {
+				return loadMessageFileProgress(index, value);
+			};
+			const auto ready = processFileLoad(
+				message.file(),
+				fileMessageOrigin(index),
+				fileProgress,
+				[=](const QString &path) { loadMessageFileDone(index, path); },
+				&message);
+			if (!ready) {
+				++_chatProcess->filesLoading;
+				continue;
+			}
 		}
+		_chatProcess->thumbNext = false;
+		++_chatProcess->fileIndex;
+
 		const auto thumbProgress = [=](FileProgress value) {
-			return loadMessageThumbProgress(value);
+			return loadMessageThumbProgress(index, value);
 		};
 		const auto thumbReady = processFileLoad(
-			list[_chatProcess->fileIndex].thumb().file,
-			currentFileMessageOrigin(),
+			message.thumb().file,
+			fileMessageOrigin(index),
 			thumbProgress,
-			[=](const QString &path) { loadMessageThumbDone(path); },
-			currentFileMessage());
+			[=](const QString &path) { loadMessageThumbDone(index, path); },
+			&message);
 		if (!thumbReady) {
-			return;
+			++_chatProcess->filesLoading;
 		}
 	}
-	finishMessagesSlice();
+	if (!_chatProcess->filesLoading) {
+		finishMessagesSlice();
+	}
 }
 
 void ApiWrap::finishMessagesSlice() {
@@ -1580,51 +1751,49 @@ void ApiWrap::finishMessagesSlice() {
 	}
 }
 
-bool ApiWrap::loadMessageFileProgress(FileProgress progress) {
-	Expects(_fileProcess != nullptr);
+bool ApiWrap::loadMessageFileProgress(int index, FileProgress progress) {
 	Expects(_chatProcess != nullptr);
 	Expects(_chatProcess->slice.has_value());
-	Expects((_chatProcess->fileIndex >= 0)
-		&& (_chatProcess->fileIndex < _chatProcess->slice->list.size()));
+	Expects((index >= 0) && (index < _chatProcess->slice->list.size()));
 
 	return _chatProcess->fileProgress(DownloadProgress{
-		_fileProcess->relativePath,
-		_chatProcess->fileIndex,
+		progress.relativePath,
+		index,
 		progress.ready,
 		progress.total });
 }
 
-void ApiWrap::loadMessageFileDone(const QString &relativePath) {
+void ApiWrap::loadMessageFileDone(int index, const QString &relativePath) {
 	Expects(_chatProcess != nullptr);
 	Expects(_chatProcess->slice.has_value());
-	Expects((_chatProcess->fileIndex >= 0)
-		&& (_chatProcess->fileIndex < _chatProcess->slice->list.size()));
+	Expects((index >= 0) && (index < _chatProcess->slice->list.size()));
+	Expects(_chatProcess->filesLoading > 0);
 
-	const auto index = _chatProcess->fileIndex;
 	auto &file = _chatProcess->slice->list[index].file();
 	file.relativePath = relativePath;
 	if (relativePath.isEmpty()) {
 		file.skipReason = Data::File::SkipReason::Unavailable;
 	}
+	--_chatProcess->filesLoading;
 	loadNextMessageFile();
 }
 
-bool ApiWrap::loadMessageThumbProgress(FileProgress progress) {
-	return loadMessageFileProgress(progress);
+bool ApiWrap::loadMessageThumbProgress(int index, FileProgress progress) {
+	return loadMessageFileProgress(index, progress);
 }
 
-void ApiWrap::loadMessageThumbDone(const QString &relativePath) {
+void ApiWrap::loadMessageThumbDone(int index, const QString &relativePath) {
 	Expects(_chatProcess != nullptr);
 	Expects(_chatProcess->slice.has_value());
-	Expects((_chatProcess->fileIndex >= 0)
-		&& (_chatProcess->fileIndex < _chatProcess->slice->list.size()));
+	Expects((index >= 0) && (index < _chatProcess->slice->list.size()));
+	Expects(_chatProcess->filesLoading > 0);
 
-	const auto index = _chatProcess->fileIndex;
 	auto &file = _chatProcess->slice->list[index].thumb().file;
 	file.relativePath = relativePath;
 	if (relativePath.isEmpty()) {
 		file.skipReason = Data::File::SkipReason::Unavailable;
 	}
+	--_chatProcess->filesLoading;
 	loadNextMessageFile();
 }
 
@@ -1685,6 +1854,14 @@ bool ApiWrap::processFileLoad(
 		// Don't load thumbs for large files that we skip.
 		file.skipReason = SkipReason::FileSize;
 		return true;
+	} else if (const auto path = _checkpoint->find(file.location)) {
+		// Files from the interrupted export pass the current filters too.
+		file.relativePath = *path;
+		_fileCache->save(file.location, file.relativePath);
+		if (_stats) {
+			_stats->incrementReused(file.size);
+		}
+		return true;
 	}
 	loadFile(file, origin, std::move(progress), std::move(done));
 	return false;
@@ -1699,10 +1876,17 @@ bool ApiWrap::writePreloadedFile(
 
 	if (const auto path = _fileCache->find(file.location)) {
 		file.relativePath = *path;
+		if (_stats) {
+			_stats->incrementReused(file.size);
+		}
 		return true;
 	} else if (!file.content.isEmpty()) {
 		const auto process = prepareFileProcess(file, origin);
-		if (const auto result = process->file.writeBlock(file.content)) {
+		auto result = process->file.writeBlock(file.content);
+		if (result) {
+			result = process->file.flush();
+		}
+		if (result) {
 			file.relativePath = process->relativePath;
 			_fileCache->save(file.location, file.relativePath);
 		} else {
@@ -1718,25 +1902,49 @@ void ApiWrap::loadFile(
 		const Data::FileOrigin &origin,
 		Fn<bool(FileProgress)> progress,
 		FnMut<void(QString)> done) {
-	Expects(_fileProcess == nullptr);
 	Expects(file.location.dcId != 0
 		|| file.location.data.type() == mtpc_inputTakeoutFileLocation);
 
-	_fileProcess = prepareFileProcess(file, origin);
-	_fileProcess->progress = std::move(progress);
-	_fileProcess->done = std::move(done);
+	// The same file may be already loading for another message.
+	if (file.location) {
+		const auto key = ComputeLocationKey(file.location);
+		for (const auto &[id, process] : _fileProcesses) {
+			if (process->location && process->locationKey == key) {
+				process->duplicates.push_back(std::move(done));
+				if (_stats) {
+					_stats->incrementReused(file.size);
+				}
+				return;
+			}
+		}
+	}
+
+	auto owned = prepareFileProcess(file, origin);
+	const auto process = owned.get();
+	process->id = ++_fileProcessIdCounter;
+	process->progress = std::move(progress);
+	process->done = std::move(done);
+	_fileProcesses.emplace(process->id, std::move(owned));
+
+	// Create the file right away, so that other files loaded in parallel
+	// won't choose the same relative path for themselves.
+	if (const auto result = process->file.writeBlock({}); !result) {
+		ioError(result);
+		return;
+	}
 
-	if (_fileProcess->progress) {
+	if (process->progress) {
 		const auto progress = FileProgress{
-			_fileProcess->file.size(),
-			_fileProcess->size
+			process->relativePath,
+			process->file.size(),
+			process->size
 		};
-		if (!_fileProcess->progress(progress)) {
+		if (!process->progress(progress)) {
 			return;
 		}
 	}
 
-	loadFilePart();
+	loadFilePart(process);
 }
 
 auto ApiWrap::prepareFileProcess(
@@ -1753,31 +1961,56 @@ auto ApiWrap::prepareFileProcess(
 		_stats);
 	result->relativePath = relativePath;
 	result->location = file.location;
+	if (file.location) {
+		result->locationKey = ComputeLocationKey(file.location);
+	}
 	result->size = file.size;
 	result->origin = origin;
 	return result;
 }
 
-void ApiWrap::loadFilePart() {
-	if (!_fileProcess
-		|| _fileProcess->requests.size() >= kFileRequestsCount
-		|| (_fileProcess->size > 0
-			&& _fileProcess->offset >= _fileProcess->size)) {
+auto ApiWrap::fileProcess(uint64 id) const -> FileProcess* {
+	const auto i = _fileProcesses.find(id);
+	return (i != end(_fileProcesses)) ? i->second.get() : nullptr;
+}
+
+auto ApiWrap::takeFileProcess(uint64 id) -> std::unique_ptr<FileProcess> {
+	const auto i = _fileProcesses.find(id);
+	Assert(i != end(_fileProcesses));
+
+	auto result = std::move(i->second);
+	_fileProcesses.erase(i);
+	return result;
+}
+
+void ApiWrap::loadFilePart(not_null<FileProcess*> process) {
+	if (process->requests.size() >= kFileRequestsCount
+		|| (process->size > 0
+			&& process->offset >= process->size)) {
 		return;
 	}
 
-	const auto offset = _fileProcess->offset;
-	_fileProcess->requests.push_back({ offset });
+	const auto id = process->id;
+	const auto offset = process->offset;
+	process->requests.push_back({ offset });
+	if (_stats) {
+		auto inFlight = 0;
+		for (const auto &[processId, loading] : _fileProcesses) {
+			inFlight += int(loading->requests.size());
+		}
+		_stats->notePartsInFlight(inFlight);
+	}
 	fileRequest(
-		_fileProcess->location,
-		_fileProcess->offset
+		id,
+		process->location,
+		process->offset
 	).done([=](const MTPupload_File &result) {
-		filePartDone(offset, result);
+		filePartDone(id, offset, result);
 	}).send();
-	_fileProcess->offset += kFileChunkSize;
+	process->offset += kFileChunkSize;
 
-	if (_fileProcess->size > 0
-		&& _fileProcess->requests.size() < kFileRequestsCount) {
+	if (process->size > 0
+		&& process->requests.size() < kFileRequestsCount) {
 		//const auto runner = _runner;
 		//crl::on_main([=] {
 		//	QTimer::singleShot(kFileNextRequestDelay, [=] {
@@ -1789,9 +2022,15 @@ void ApiWrap::loadFilePart() {
 	}
 }
 
-void ApiWrap::filePartDone(int offset, const MTPupload_File &result) {
-	Expects(_fileProcess != nullptr);
-	Expects(!_fileProcess->requests.empty());
+void ApiWrap::filePartDone(
+		uint64 processId,
+		int offset,
+		const MTPupload_File &result) {
+	const auto process = fileProcess(processId);
+	if (!process) {
+		return;
+	}
+	Assert(!process->requests.empty());
 
 	if (result.type() == mtpc_upload_fileCdnRedirect) {
 		error("Cdn redirect is not supported.");
@@ -1799,18 +2038,18 @@ void ApiWrap::filePartDone(int offset, const MTPupload_File &result) {
 	}
 	const auto &data = result.c_upload_file();
 	if (data.vbytes().v.isEmpty()) {
-		if (_fileProcess->size > 0) {
+		if (process->size > 0) {
 			error("Empty bytes received in file part.");
 			return;
 		}
-		const auto result = _fileProcess->file.writeBlock({});
+		const auto result = process->file.writeBlock({});
 		if (!result) {
 			ioError(result);
 			return;
 		}
 	} else {
 		using Request = FileProcess::Request;
-		auto &requests = _fileProcess->requests;
+		auto &requests = process->requests;
 		const auto i = ranges::find(
 			requests,
 			offset,
@@ -1818,8 +2057,11 @@ void ApiWrap::filePartDone(int offset, const MTPupload_File &result) {
 		Assert(i != end(requests));
 
 		i->bytes = data.vbytes().v;
+		if (_stats) {
+			_stats->incrementLoaded(process->location.dcId, i->bytes.size());
+		}
 
-		auto &file = _fileProcess->file;
+		auto &file = process->file;
 		while (!requests.empty() && !requests.front().bytes.isEmpty()) {
 			const auto &bytes = requests.front().bytes;
 			if (const auto result = file.writeBlock(bytes); !result) {
@@ -1829,30 +2071,42 @@ void ApiWrap::filePartDone(int offset, const MTPupload_File &result) {
 			requests.pop_front();
 		}
 
-		if (_fileProcess->progress) {
-			_fileProcess->progress(FileProgress{
+		if (process->progress) {
+			process->progress(FileProgress{
+				process->relativePath,
 				file.size(),
-				_fileProcess->size });
+				process->size });
 		}
 
 		if (!requests.empty()
-			|| !_fileProcess->size
-			|| _fileProcess->size > _fileProcess->offset) {
-			loadFilePart();
+			|| !process->size
+			|| process->size > process->offset) {
+			loadFilePart(process);
 			return;
 		}
 	}
 
-	auto process = base::take(_fileProcess);
-	const auto relativePath = process->relativePath;
-	_fileCache->save(process->location, relativePath);
-	process->done(process->relativePath);
+	if (const auto result = process->file.flush(); !result) {
+		ioError(result);
+		return;
+	}
+	auto taken = takeFileProcess(processId);
+	const auto relativePath = taken->relativePath;
+	_fileCache->save(taken->location, relativePath);
+	_checkpoint->save(taken->location, relativePath, taken->file.size());
+	taken->done(relativePath);
+	for (auto &duplicate : taken->duplicates) {
+		duplicate(relativePath);
+	}
 }
 
-void ApiWrap::filePartRefreshReference(int offset) {
-	Expects(_fileProcess != nullptr);
+void ApiWrap::filePartRefreshReference(uint64 processId, int offset) {
+	const auto process = fileProcess(processId);
+	if (!process) {
+		return;
+	}
 
-	const auto &origin = _fileProcess->origin;
+	const auto &origin = process->origin;
 	if (!origin.messageId) {
 		error("FILE_REFERENCE error for non-message file.");
 		return;
@@ -1873,10 +2127,10 @@ void ApiWrap::filePartRefreshReference(int offset) {
 				1,
 				MTP_inputMessageID(MTP_int(origin.messageId)))
 		)).fail([=](const RPCError &error) {
-			filePartUnavailable();
+			filePartUnavailable(processId);
 			return true;
 		}).done([=](const MTPmessages_Messages &result) {
-			filePartExtractReference(offset, result);
+			filePartExtractReference(processId, offset, result);
 		}).send();
 	} else {
 		splitRequest(origin.split, MTPmessages_GetMessages(
@@ -1884,18 +2138,22 @@ void ApiWrap::filePartRefreshReference(int offset) {
 				1,
 				MTP_inputMessageID(MTP_int(origin.messageId)))
 		)).fail([=](const RPCError &error) {
-			filePartUnavailable();
+			filePartUnavailable(processId);
 			return true;
 		}).done([=](const MTPmessages_Messages &result) {
-			filePartExtractReference(offset, result);
+			filePartExtractReference(processId, offset, result);
 		}).send();
 	}
 }
 
 void ApiWrap::filePartExtractReference(
+		uint64 processId,
 		int offset,
 		const MTPmessages_Messages &result) {
-	Expects(_fileProcess != nullptr);
+	const auto process = fileProcess(processId);
+	if (!process) {
+		return;
+	}
 
 	result.match([&](const MTPDmessages_messagesNotModified &data) {
 		error("Unexpected messagesNotModified received.");
@@ -1911,35 +2169,52 @@ void ApiWrap::filePartExtractReference(
 			data.vchats(),
 			_chatProcess->info.relativePath);
 		for (const auto &message : messages.list) {
-			if (message.id == _fileProcess->origin.messageId) {
+			if (message.id == process->origin.messageId) {
 				const auto refresh1 = Data::RefreshFileReference(
-					_fileProcess->location,
+					process->location,
 					message.file().location);
 				const auto refresh2 = Data::RefreshFileReference(
-					_fileProcess->location,
+					process->location,
 					message.thumb().file.location);
 				if (refresh1 || refresh2) {
 					fileRequest(
-						_fileProcess->location,
+						processId,
+						process->location,
 						offset
 					).done([=](const MTPupload_File &result) {
-						filePartDone(offset, result);
+						filePartDone(processId, offset, result);
 					}).send();
 					return;
 				}
 			}
 		}
-		filePartUnavailable();
+		filePartUnavailable(processId);
 	});
 }
 
-void ApiWrap::filePartUnavailable() {
-	Expects(_fileProcess != nullptr);
-	Expects(!_fileProcess->requests.empty());
+void ApiWrap::filePartUnavailable(uint64 processId) {
+	const auto process = fileProcess(processId);
+	if (!process) {
+		return;
+	}
 
 	LOG(("Export Error: File unavailable."));
 
-	base::take(_fileProcess)->done(QString());
+	// Remove the file created in loadFile() after the process is closed.
+	const auto path = process->file.empty()
+		? (_settings->path + process->relativePath)
+		: QString();
+	auto taken = takeFileProcess(processId);
+	auto done = std::move(taken->done);
+	auto duplicates = std::move(taken->duplicates);
+	taken = nullptr;
+	if (!path.isEmpty()) {
+		QFile::remove(path);
+	}
+	done(QString());
+	for (auto &duplicate : duplicates) {
+		duplicate(QString());
+	}
 }
 
 void ApiWrap::error(RPCError &&error) {
@@ -89,6 +89,7 @@ public:
 
 private:
 	class LoadedFileCache;
+	class LoadedFilesCheckpoint;
 	struct StartProcess;
 	struct ContactsProcess;
 	struct UserpicsProcess;
@@ -147,6 +148,8 @@ private:
 	void checkFirstMessageDate(int localSplitIndex, int count);
 	void messagesCountLoaded(int localSplitIndex, int count);
 	void requestMessagesSlice();
+	void requestNextMessagesSlice(int32 largestIdPlusOne);
+	void handleMessagesSlice(const MTPmessages_Messages &result);
 	void requestChatMessages(
 		int splitIndex,
 		int offsetId,
@@ -155,15 +158,15 @@ private:
 		FnMut<void(MTPmessages_Messages&&)> done);
 	void loadMessagesFiles(Data::MessagesSlice &&slice);
 	void loadNextMessageFile();
-	bool loadMessageFileProgress(FileProgress value);
-	void loadMessageFileDone(const QString &relativePath);
-	bool loadMessageThumbProgress(FileProgress value);
-	void loadMessageThumbDone(const QString &relativePath);
+	bool loadMessageFileProgress(int index, FileProgress value);
+	void loadMessageFileDone(int index, const QString &relativePath);
+	bool loadMessageThumbProgress(int index, FileProgress value);
+	void loadMessageThumbDone(int index, const QString &relativePath);
 	void finishMessagesSlice();
 	void finishMessages();
 
-	[[nodiscard]] Data::Message *currentFileMessage() const;
-	[[nodiscard]] Data::FileOrigin currentFileMessageOrigin() const;
+	[[nodiscard]] Data::Message *fileMessage(int index) const;
+	[[nodiscard]] Data::FileOrigin fileMessageOrigin(int index) const;
 
 	bool processFileLoad(
 		Data::File &file,
@@ -182,11 +185,17 @@ private:
 		const Data::FileOrigin &origin,
 		Fn<bool(FileProgress)> progress,
 		FnMut<void(QString)> done);
-	void loadFilePart();
-	void filePartDone(int offset, const MTPupload_File &result);
-	void filePartUnavailable();
-	void filePartRefreshReference(int offset);
+	[[nodiscard]] FileProcess *fileProcess(uint64 id) const;
+	[[nodiscard]] std::unique_ptr<FileProcess> takeFileProcess(uint64 id);
+	void loadFilePart(not_null<FileProcess*> process);
+	void filePartDone(
+		uint64 processId,
+		int offset,
+		const MTPupload_File &result);
+	void filePartUnavailable(uint64 processId);
+	void filePartRefreshReference(uint64 processId, int offset);
 	void filePartExtractReference(
+		uint64 processId,
 		int offset,
 		const MTPmessages_Messages &result);
 
@@ -200,6 +209,7 @@ private:
 	[[nodiscard]] auto splitRequest(int index, Request &&request);
 
 	[[nodiscard]] auto fileRequest(
+		uint64 processId,
 		const Data::FileLocation &location,
 		int offset);
 
@@ -217,10 +227,12 @@ private:
 
 	std::unique_ptr<StartProcess> _startProcess;
 	std::unique_ptr<LoadedFileCache> _fileCache;
+	std::unique_ptr<LoadedFilesCheckpoint> _checkpoint;
 	std::unique_ptr<ContactsProcess> _contactsProcess;
 	std::unique_ptr<UserpicsProcess> _userpicsProcess;
 	std::unique_ptr<OtherDataProcess> _otherDataProcess;
-	std::unique_ptr<FileProcess> _fileProcess;
+	std::map<uint64, std::unique_ptr<FileProcess>> _fileProcesses;
+	uint64 _fileProcessIdCounter = 0;
 	std::unique_ptr<LeftChannelsProcess> _leftChannelsProcess;
 	std::unique_ptr<DialogsProcess> _dialogsProcess;
 	std::unique_ptr<ChatProcess> _chatProcess;
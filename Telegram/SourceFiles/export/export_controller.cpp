@@ -112,6 +112,8 @@ private:
 	int _userpicsWritten = 0;
 	int _userpicsCount = 0;
 
+	crl::time _startedAt = 0;
+
 	// rpl::variable<State> fails to compile in MSVC :(
 	State _state;
 	rpl::event_stream<State> _stateChanges;
@@ -241,6 +243,7 @@ void ControllerObject::startExport(
 
 	_settings.path = Output::NormalizePath(_settings);
 	_writer = Output::CreateWriter(_settings.format);
+	_startedAt = crl::now();
 	fillExportSteps();
 	exportNext();
 }
@@ -386,9 +389,11 @@ void ControllerObject::exportUserpics() {
 		setState(stateUserpics(progress));
 		return true;
 	}, [=](Data::UserpicsSlice &&slice) {
+		const auto started = crl::now();
 		if (ioCatchError(_writer->writeUserpicsSlice(slice))) {
 			return false;
 		}
+		_stats.addWritingTime(crl::now() - started);
 		_userpicsWritten += slice.list.size();
 		setState(stateUserpics(DownloadProgress()));
 		return true;
@@ -457,9 +462,11 @@ void ControllerObject::exportNextDialog() {
 			setState(stateDialogs(progress));
 			return true;
 		}, [=](Data::MessagesSlice &&result) {
+			const auto started = crl::now();
 			if (ioCatchError(_writer->writeDialogSlice(result))) {
 				return false;
 			}
+			_stats.addWritingTime(crl::now() - started);
 			_messagesWritten += result.list.size();
 			setState(stateDialogs(DownloadProgress()));
 			return true;
@@ -585,6 +592,13 @@ int ControllerObject::substepsInStep(Step step) const {
 }
 
 void ControllerObject::setFinishedState() {
+	LOG(("Export Info: %1."
+		).arg(_stats.throughputSummary(crl::now() - _startedAt)));
+	if (const auto reused = _stats.reusedFilesCount()) {
+		LOG(("Export Info: %1 files (%2 bytes) were reused, not loaded again."
+			).arg(reused
+			).arg(_stats.reusedBytesCount()));
+	}
 	setState(FinishedState{
 		_writer->mainFilePath(),
 		_stats.filesCount(),
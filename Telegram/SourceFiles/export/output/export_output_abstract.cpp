@@ -14,6 +14,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include <QtCore/QDir>
 #include <QtCore/QDate>
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
 
 namespace Export {
 namespace Output {
@@ -22,7 +25,9 @@ QString NormalizePath(const Settings &settings) {
 	QDir folder(settings.path);
 	const auto path = folder.absolutePath();
 	auto result = path.endsWith('/') ? path : (path + '/');
-	if (!folder.exists() && !settings.forceSubPath) {
+	if (QFile::exists(CheckpointPath(result))) {
+		return result;
+	} else if (!folder.exists() && !settings.forceSubPath) {
 		return result;
 	}
 	const auto mode = QDir::AllEntries | QDir::NoDotAndDotDot;
@@ -30,11 +35,33 @@ QString NormalizePath(const Settings &settings) {
 	if (list.isEmpty() && !settings.forceSubPath) {
 		return result;
 	}
+	const auto prefix = QString(settings.onlySinglePeer()
+		? "ChatExport_"
+		: "DataExport_");
+
+	// Resume an interrupted export in one of the existing subfolders.
+	auto resume = QString();
+	auto resumeModified = QDateTime();
+	for (const auto &info : list) {
+		if (!info.isDir() || !info.fileName().startsWith(prefix)) {
+			continue;
+		}
+		const auto subfolder = info.absoluteFilePath() + '/';
+		const auto checkpoint = QFileInfo(CheckpointPath(subfolder));
+		if (!checkpoint.exists()) {
+			continue;
+		}
+		const auto modified = checkpoint.lastModified();
+		if (resume.isEmpty() || modified > resumeModified) {
+			resume = subfolder;
+			resumeModified = modified;
+		}
+	}
+	if (!resume.isEmpty()) {
+		return resume;
+	}
 	const auto date = QDate::currentDate();
-	const auto base = QString(settings.onlySinglePeer()
-		? "ChatExport_%1"
-		: "DataExport_%1"
-	).arg(date.toString(Qt::ISODate));
+	const auto base = prefix + date.toString(Qt::ISODate);
 	const auto add = [&](int i) {
 		return base + (i ? " (" + QString::number(i) + ')' : QString());
 	};
@@ -46,6 +73,10 @@ QString NormalizePath(const Settings &settings) {
 	return result;
 }
 
+QString CheckpointPath(const QString &folder) {
+	return folder + ".export_checkpoint";
+}
+
 std::unique_ptr<AbstractWriter> CreateWriter(Format format) {
 	switch (format) {
 	case Format::Html: return std::make_unique<HtmlWriter>();
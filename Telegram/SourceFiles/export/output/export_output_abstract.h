@@ -29,6 +29,10 @@ namespace Output {
 
 QString NormalizePath(const Settings &settings);
 
+// The list of already loaded files of an unfinished export,
+// exporting to the same folder again continues from it.
+QString CheckpointPath(const QString &folder);
+
 struct Result;
 class Stats;
 
@@ -17,16 +17,26 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 namespace Export {
 namespace Output {
+namespace {
+
+// Small blocks are collected in memory and written to the disk together.
+constexpr auto kBufferSize = 256 * 1024;
+
+} // namespace
 
 File::File(const QString &path, Stats *stats) : _path(path), _stats(stats) {
 }
 
+File::~File() {
+	[[maybe_unused]] const auto result = flush();
+}
+
 int File::size() const {
-	return _offset;
+	return _offset + _buffer.size();
 }
 
 bool File::empty() const {
-	return !_offset;
+	return !size();
 }
 
 Result File::writeBlock(const QByteArray &block) {
@@ -37,23 +47,59 @@ Result File::writeBlock(const QByteArray &block) {
 	return result;
 }
 
+Result File::flush() {
+	const auto result = flushAttempt();
+	if (!result) {
+		_file.reset();
+	}
+	return result;
+}
+
 Result File::writeBlockAttempt(const QByteArray &block) {
 	if (_stats && !_inStats) {
 		_inStats = true;
 		_stats->incrementFiles();
 	}
-	if (const auto result = reopen(); !result) {
-		return result;
-	}
 	const auto size = block.size();
 	if (!size) {
+		return reopen();
+	}
+	if (_buffer.size() + size > kBufferSize) {
+		if (const auto result = flushAttempt(); !result) {
+			return result;
+		} else if (size >= kBufferSize) {
+			if (const auto result = writeToFile(block); !result) {
+				return result;
+			}
+		} else {
+			_buffer = block;
+		}
+	} else {
+		_buffer.append(block);
+	}
+	if (_stats) {
+		_stats->incrementBytes(size);
+	}
+	return Result::Success();
+}
+
+Result File::flushAttempt() {
+	if (_buffer.isEmpty()) {
 		return Result::Success();
+	} else if (const auto result = writeToFile(_buffer); !result) {
+		return result;
+	}
+	_buffer.clear();
+	return Result::Success();
+}
+
+Result File::writeToFile(const QByteArray &bytes) {
+	if (const auto result = reopen(); !result) {
+		return result;
 	}
-	if (_file->write(block) == size && _file->flush()) {
+	const auto size = bytes.size();
+	if (_file->write(bytes) == size && _file->flush()) {
 		_offset += size;
-		if (_stats) {
-			_stats->incrementBytes(size);
-		}
 		return Result::Success();
 	}
 	return error();
@@ -132,7 +178,11 @@ Result File::Copy(
 	if (bytes.size() != f.size()) {
 		return Result(Result::Type::FatalError, source);
 	}
-	return File(path, stats).writeBlock(bytes);
+	auto file = File(path, stats);
+	if (const auto result = file.writeBlock(bytes); !result) {
+		return result;
+	}
+	return file.flush();
 }
 
 } // namespace Output
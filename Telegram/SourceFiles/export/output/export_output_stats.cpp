@@ -12,7 +12,12 @@ namespace Output {
 
 Stats::Stats(const Stats &other)
 : _files(other._files.load())
-, _bytes(other._bytes.load()) {
+, _bytes(other._bytes.load())
+, _reusedFiles(other._reusedFiles.load())
+, _reusedBytes(other._reusedBytes.load())
+, _loadedPerDc(other._loadedPerDc)
+, _writingTime(other._writingTime)
+, _partsInFlightMax(other._partsInFlightMax) {
 }
 
 void Stats::incrementFiles() {
@@ -23,6 +28,23 @@ void Stats::incrementBytes(int count) {
 	_bytes += count;
 }
 
+void Stats::incrementReused(int64 bytes) {
+	++_reusedFiles;
+	_reusedBytes += bytes;
+}
+
+void Stats::incrementLoaded(int dcId, int bytes) {
+	_loadedPerDc[dcId] += bytes;
+}
+
+void Stats::notePartsInFlight(int count) {
+	_partsInFlightMax = std::max(_partsInFlightMax, count);
+}
+
+void Stats::addWritingTime(crl::time duration) {
+	_writingTime += duration;
+}
+
 int Stats::filesCount() const {
 	return _files;
 }
@@ -31,5 +53,28 @@ int64 Stats::bytesCount() const {
 	return _bytes;
 }
 
+int Stats::reusedFilesCount() const {
+	return _reusedFiles;
+}
+
+int64 Stats::reusedBytesCount() const {
+	return _reusedBytes;
+}
+
+QString Stats::throughputSummary(crl::time duration) const {
+	const auto seconds = std::max(duration, crl::time(1)) / 1000.;
+	auto result = QString("%1s total, %2s writing, up to %3 parts in flight"
+	).arg(seconds, 0, 'f', 1
+	).arg(_writingTime / 1000., 0, 'f', 1
+	).arg(_partsInFlightMax);
+	for (const auto &[dcId, bytes] : _loadedPerDc) {
+		result += QString(", DC%1: %2 MB at %3 KB/s"
+		).arg(dcId
+		).arg(bytes / (1024. * 1024.), 0, 'f', 1
+		).arg(bytes / 1024. / seconds, 0, 'f', 1);
+	}
+	return result;
+}
+
 } // namespace Output
 } // namespace Export
@@ -7,6 +7,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #pragma once
 
+#include "base/flat_map.h"
+
 #include <atomic>
 
 namespace Export {
@@ -20,12 +22,30 @@ public:
 	void incrementFiles();
 	void incrementBytes(int count);
 
+	// Files that were referenced again instead of being loaded once more.
+	void incrementReused(int64 bytes);
+
+	// Throughput counters, used only from the export queue.
+	void incrementLoaded(int dcId, int bytes);
+	void notePartsInFlight(int count);
+	void addWritingTime(crl::time duration);
+
 	int filesCount() const;
 	int64 bytesCount() const;
+	int reusedFilesCount() const;
+	int64 reusedBytesCount() const;
+
+	[[nodiscard]] QString throughputSummary(crl::time duration) const;
 
 private:
 	std::atomic<int> _files;
 	std::atomic<int64> _bytes;
+	std::atomic<int> _reusedFiles;
+	std::atomic<int64> _reusedBytes;
+
+	base::flat_map<int, int64> _loadedPerDc;
+	crl::time _writingTime = 0;
+	int _partsInFlightMax = 0;
 
 };
 
@@ -18,6 +18,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 extern "C" {
 #include <libavutil/opt.h>
+#include <libavutil/hwcontext.h>
 } // extern "C"
 
 namespace FFmpeg {
@@ -82,6 +83,82 @@ void PremultiplyLine(uchar *dst, const uchar *src, int intsCount) {
 #endif // Qt >= 5.12
 }
 
+[[nodiscard]] std::vector<AVHWDeviceType> PreferredHwDeviceTypes() {
+	return {
+#ifdef Q_OS_WIN
+		AV_HWDEVICE_TYPE_D3D11VA,
+		AV_HWDEVICE_TYPE_DXVA2,
+#elif defined Q_OS_MAC // Q_OS_WIN
+		AV_HWDEVICE_TYPE_VIDEOTOOLBOX,
+#else // Q_OS_WIN || Q_OS_MAC
+		AV_HWDEVICE_TYPE_VAAPI,
+#endif // Q_OS_WIN || Q_OS_MAC
+	};
+}
+
+[[nodiscard]] AVPixelFormat FindHwPixelFormat(
+		not_null<const AVCodec*> codec,
+		AVHWDeviceType type) {
+	for (auto i = 0;; ++i) {
+		const auto config = avcodec_get_hw_config(codec, i);
+		if (!config) {
+			return AV_PIX_FMT_NONE;
+		} else if ((config->methods & AV_CODEC_HW_CONFIG_METHOD_HW_DEVICE_CTX)
+			&& (config->device_type == type)) {
+			return config->pix_fmt;
+		}
+	}
+}
+
+AVPixelFormat GetHwFormat(
+		AVCodecContext *context,
+		const AVPixelFormat *formats) {
+	// We keep the hardware pixel format we've chosen in the opaque field.
+	const auto wanted = AVPixelFormat(
+		reinterpret_cast<intptr_t>(context->opaque));
+	for (auto i = formats; *i != AV_PIX_FMT_NONE; ++i) {
+		if (*i == wanted) {
+			return wanted;
+		}
+	}
+	LOG(("Streaming Info: "
+		"Hardware pixel format not offered, using software decoding."));
+	return avcodec_default_get_format(context, formats);
+}
+
+[[nodiscard]] bool InitHw(
+		not_null<AVCodecContext*> context,
+		not_null<const AVCodec*> codec) {
+	for (const auto type : PreferredHwDeviceTypes()) {
+		const auto format = FindHwPixelFormat(codec, type);
+		if (format == AV_PIX_FMT_NONE) {
+			continue;
+		}
+		auto device = (AVBufferRef*)nullptr;
+		const auto error = AvErrorWrap(av_hwdevice_ctx_create(
+			&device,
+			type,
+			nullptr,
+			nullptr,
+			0));
+		if (error || !device) {
+			LogError(qstr("av_hwdevice_ctx_create"), error);
+			continue;
+		}
+
+		// The codec context will own and free the device context.
+		context->hw_device_ctx = device;
+		context->opaque = reinterpret_cast<void*>(intptr_t(format));
+		context->get_format = GetHwFormat;
+		DEBUG_LOG(("Streaming Info: "
+			"Using \"%1\" hardware decoding for \"%2\"."
+			).arg(av_hwdevice_get_type_name(type)
+			).arg(codec->name));
+		return true;
+	}
+	return false;
+}
+
 } // namespace
 
 IOPointer MakeIOPointer(
@@ -160,9 +237,11 @@ void FormatDeleter::operator()(AVFormatContext *value) {
 	}
 }
 
-CodecPointer MakeCodecPointer(not_null<AVStream*> stream) {
+CodecPointer MakeCodecPointer(CodecDescriptor descriptor) {
 	auto error = AvErrorWrap();
 
+	const auto stream = descriptor.stream;
+
 	auto result = CodecPointer(avcodec_alloc_context3(nullptr));
 	const auto context = result.get();
 	if (!context) {
@@ -182,8 +261,15 @@ CodecPointer MakeCodecPointer(not_null<AVStream*> stream) {
 	if (!codec) {
 		LogError(qstr("avcodec_find_decoder"), context->codec_id);
 		return {};
-	} else if ((error = avcodec_open2(context, codec, nullptr))) {
+	}
+	const auto hw = descriptor.hwAllowed && InitHw(context, codec);
+	if ((error = avcodec_open2(context, codec, nullptr))) {
 		LogError(qstr("avcodec_open2"), error);
+		if (hw) {
+			// Try again without hardware acceleration.
+			descriptor.hwAllowed = false;
+			return MakeCodecPointer(descriptor);
+		}
 		return {};
 	}
 	return result;
@@ -209,6 +295,33 @@ void ClearFrameMemory(AVFrame *frame) {
 	}
 }
 
+AvErrorWrap TransferHwFrame(
+		not_null<AVFrame*> frame,
+		FramePointer &buffer) {
+	if (!frame->hw_frames_ctx) {
+		return AvErrorWrap();
+	} else if (!buffer && !(buffer = MakeFramePointer())) {
+		LogError(qstr("av_frame_alloc"));
+		return AvErrorWrap(AVERROR(ENOMEM));
+	}
+	auto error = AvErrorWrap(av_hwframe_transfer_data(
+		buffer.get(),
+		frame,
+		0));
+	if (error) {
+		LogError(qstr("av_hwframe_transfer_data"), error);
+		ClearFrameMemory(buffer.get());
+		return error;
+	} else if ((error = av_frame_copy_props(buffer.get(), frame))) {
+		LogError(qstr("av_frame_copy_props"), error);
+		ClearFrameMemory(buffer.get());
+		return error;
+	}
+	av_frame_unref(frame);
+	av_frame_move_ref(frame, buffer.get());
+	return error;
+}
+
 void FrameDeleter::operator()(AVFrame *value) {
 	av_frame_free(&value);
 }
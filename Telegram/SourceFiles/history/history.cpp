@@ -53,6 +53,13 @@ namespace {
 constexpr auto kNewBlockEachMessage = 50;
 constexpr auto kSkipCloudDraftsFor = TimeId(3);
 
+// After a width change only that many items above and below the scroll
+// anchor are resized right away, others are resized by resizeLazyItems().
+constexpr auto kResizeEagerItems = 100;
+
+// Remembered item heights are dropped when there are that many of them.
+constexpr auto kHeightsCacheLimit = 4096;
+
 using UpdateFlag = Data::HistoryUpdate::Flag;
 
 } // namespace
@@ -122,6 +129,72 @@ void History::setHasPendingResizedItems() {
 	_flags |= Flag::f_has_pending_resized_items;
 }
 
+bool History::hasLazyResizedItems() const {
+	return _flags & Flag::f_has_lazy_resized_items;
+}
+
+Element *History::lazyResizeAnchor() const {
+	if (scrollTopItem) {
+		return scrollTopItem;
+	} else if (blocks.empty()) {
+		return nullptr;
+	}
+	return blocks.back()->messages.back().get();
+}
+
+void History::resizeLazyItems(int limit) {
+	if (!hasLazyResizedItems()) {
+		return;
+	}
+	const auto anchor = lazyResizeAnchor();
+	if (!anchor) {
+		_flags &= ~Flag::f_has_lazy_resized_items;
+		return;
+	}
+
+	// Go from the anchor in both directions, so that the items
+	// closest to the visible area get their final heights first.
+	auto resized = 0;
+	const auto resize = [&](not_null<Element*> view) {
+		if (view->lazyResize()) {
+			view->setLazyResize(false);
+			view->resizeGetHeight(_width);
+			rememberHeight(view);
+			++resized;
+		}
+	};
+	const auto blocksCount = int(blocks.size());
+	auto downBlock = anchor->block()->indexInHistory();
+	auto downItem = anchor->indexInBlock();
+	auto upBlock = downBlock;
+	auto upItem = downItem;
+	while (resized < limit) {
+		const auto hasDown = (downBlock < blocksCount);
+		const auto hasUp = (upBlock > 0) || (upItem > 0);
+		if (!hasDown && !hasUp) {
+			_flags &= ~Flag::f_has_lazy_resized_items;
+			break;
+		}
+		if (hasDown) {
+			const auto &messages = blocks[downBlock]->messages;
+			resize(messages[downItem].get());
+			if (++downItem == int(messages.size())) {
+				++downBlock;
+				downItem = 0;
+			}
+		}
+		if (hasUp) {
+			if (!upItem) {
+				upItem = int(blocks[--upBlock]->messages.size());
+			}
+			resize(blocks[upBlock]->messages[--upItem].get());
+		}
+	}
+	if (resized > 0) {
+		setHasPendingResizedItems();
+	}
+}
+
 void History::itemRemoved(not_null<HistoryItem*> item) {
 	if (item == _joinedMessage) {
 		_joinedMessage = nullptr;
@@ -2728,15 +2801,59 @@ void History::resizeToWidth(int newWidth) {
 	}
 	_flags &= ~(Flag::f_has_pending_resized_items);
 
+	if (_heightsCacheScale != cScale()
+		|| (newWidth > 0 && _heightsCacheWidth != newWidth)) {
+		_heightsCacheScale = cScale();
+		_heightsCacheWidth = newWidth;
+		_heightsCache.clear();
+	}
+
+	auto eagerFrom = 0;
+	auto eagerTill = std::numeric_limits<int>::max();
+	if (const auto anchor = lazyResizeAnchor()) {
+		const auto anchorBlock = anchor->block()->indexInHistory();
+		auto anchorIndex = anchor->indexInBlock();
+		for (auto i = 0; i != anchorBlock; ++i) {
+			anchorIndex += int(blocks[i]->messages.size());
+		}
+		eagerFrom = anchorIndex - kResizeEagerItems;
+		eagerTill = anchorIndex + kResizeEagerItems;
+	}
+
 	_width = newWidth;
 	int y = 0;
+	int index = 0;
 	for (const auto &block : blocks) {
 		block->setY(y);
-		y += block->resizeGetHeight(newWidth, resizeAllItems);
+		y += block->resizeGetHeight(
+			newWidth,
+			resizeAllItems,
+			eagerFrom - index,
+			eagerTill - index);
+		index += int(block->messages.size());
 	}
 	_height = y;
 }
 
+void History::rememberHeight(not_null<Element*> view) {
+	const auto item = view->data();
+	if (!IsServerMsgId(item->id) || _width != _heightsCacheWidth) {
+		return;
+	} else if (_heightsCache.size() >= kHeightsCacheLimit
+		&& _heightsCache.find(item->id) == end(_heightsCache)) {
+		_heightsCache.clear();
+	}
+	_heightsCache[item->id] = view->height();
+}
+
+int History::cachedHeight(not_null<Element*> view) const {
+	if (_width != _heightsCacheWidth) {
+		return 0;
+	}
+	const auto i = _heightsCache.find(view->data()->id);
+	return (i != end(_heightsCache)) ? i->second : 0;
+}
+
 void History::forceFullResize() {
 	_width = 0;
 	_flags |= Flag::f_has_pending_resized_items;
@@ -3034,6 +3151,8 @@ void History::clear(ClearType type) {
 	if (type == ClearType::Unload) {
 		_loadedAtTop = _loadedAtBottom = false;
 	} else {
+		_heightsCache.clear();
+
 		// Leave the 'sending' messages in local messages.
 		auto local = base::flat_set<not_null<HistoryItem*>>();
 		for (const auto item : _localMessages) {
@@ -3143,13 +3262,34 @@ HistoryBlock::HistoryBlock(not_null<History*> history)
 : _history(history) {
 }
 
-int HistoryBlock::resizeGetHeight(int newWidth, bool resizeAllItems) {
+int HistoryBlock::resizeGetHeight(
+		int newWidth,
+		bool resizeAllItems,
+		int eagerFrom,
+		int eagerTill) {
 	auto y = 0;
-	for (const auto &message : messages) {
+	for (auto i = 0, count = int(messages.size()); i != count; ++i) {
+		const auto message = messages[i].get();
+		const auto eager = (i >= eagerFrom) && (i <= eagerTill);
+		const auto pending = message->pendingResize();
 		message->setY(y);
-		if (resizeAllItems || message->pendingResize()) {
+		if (eager && (resizeAllItems || pending)) {
+			message->setLazyResize(false);
+			y += message->resizeGetHeight(newWidth);
+			_history->rememberHeight(message);
+		} else if (message->lazyResize() || !(resizeAllItems || pending)) {
+			y += message->height();
+		} else if (const auto height = _history->cachedHeight(message)) {
+			message->applyCachedHeight(height);
+			message->setLazyResize(true);
+			_history->_flags |= History::Flag::f_has_lazy_resized_items;
+			y += height;
+		} else if (pending) {
 			y += message->resizeGetHeight(newWidth);
+			_history->rememberHeight(message);
 		} else {
+			message->setLazyResize(true);
+			_history->_flags |= History::Flag::f_has_lazy_resized_items;
 			y += message->height();
 		}
 	}
@@ -276,6 +276,11 @@ public:
 	bool hasPendingResizedItems() const;
 	void setHasPendingResizedItems();
 
+	// Items far from the scroll anchor keep their old heights after
+	// a width change until they're resized here, up to limit at a time.
+	[[nodiscard]] bool hasLazyResizedItems() const;
+	void resizeLazyItems(int limit);
+
 	[[nodiscard]] auto sendActionPainter()
 	-> not_null<HistoryView::SendActionPainter*> {
 		return &_sendActionPainter;
@@ -431,6 +436,7 @@ private:
 
 	enum class Flag {
 		f_has_pending_resized_items = (1 << 0),
+		f_has_lazy_resized_items = (1 << 1),
 	};
 	using Flags = base::flags<Flag>;
 	friend inline constexpr auto is_flag_type(Flag) {
@@ -446,6 +452,10 @@ private:
 	// helper method for countScrollState(int top)
 	[[nodiscard]] Element *findScrollTopItem(int top) const;
 
+	[[nodiscard]] Element *lazyResizeAnchor() const;
+	void rememberHeight(not_null<Element*> view);
+	[[nodiscard]] int cachedHeight(not_null<Element*> view) const;
+
 	// this method just removes a block from the blocks list
 	// when the last item from this block was detached and
 	// calls the required previousItemChanged()
@@ -578,6 +588,13 @@ private:
 	};
 	std::unique_ptr<BuildingBlock> _buildingFrontBlock;
 
+	// Heights of the laid out items survive unloading of the history,
+	// so that reopened items far from the scroll anchor are laid out lazily.
+	// All of them are computed for _heightsCacheWidth.
+	std::unordered_map<MsgId, int> _heightsCache;
+	int _heightsCacheWidth = 0;
+	int _heightsCacheScale = 0;
+
 	Data::HistoryDrafts _drafts;
 	std::optional<QString> _lastSentDraftText;
 	TimeId _lastSentDraftTime = 0;
@@ -606,7 +623,11 @@ public:
 	void remove(not_null<Element*> view);
 	void refreshView(not_null<Element*> view);
 
-	int resizeGetHeight(int newWidth, bool resizeAllItems);
+	int resizeGetHeight(
+		int newWidth,
+		bool resizeAllItems,
+		int eagerFrom,
+		int eagerTill);
 	int y() const {
 		return _y;
 	}
@@ -11,6 +11,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/file_utilities.h"
 #include "core/crash_reports.h"
 #include "core/click_handler_types.h"
+#include "core/core_probes.h"
 #include "history/history.h"
 #include "history/history_message.h"
 #include "history/view/media/history_view_media.h"
@@ -33,6 +34,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "window/window_peer_menu.h"
 #include "window/window_controller.h"
 #include "window/notifications_manager.h"
+#include "window/themes/window_theme.h"
 #include "boxes/confirm_box.h"
 #include "boxes/report_box.h"
 #include "boxes/sticker_set_box.h"
@@ -46,6 +48,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "main/main_session.h"
 #include "main/main_session_settings.h"
 #include "core/application.h"
+#include "core/core_settings.h"
 #include "apiwrap.h"
 #include "api/api_attached_stickers.h"
 #include "api/api_toggling_media.h"
@@ -77,6 +80,18 @@ constexpr auto kScrollDateHideTimeout = 1000;
 constexpr auto kUnloadHeavyPartsPages = 2;
 constexpr auto kClearUserpicsAfter = 50;
 
+// Rendered messages are cached for that many screens of the visible area.
+constexpr auto kViewsCacheScreens = 3;
+constexpr auto kViewsCacheMinLimit = int64(16 * 1024 * 1024);
+
+[[nodiscard]] bool HasReplyPreview(
+		not_null<const HistoryView::Element*> view) {
+	const auto reply = view->data()->Get<HistoryMessageReply>();
+	const auto to = reply ? reply->replyToMsg : nullptr;
+	const auto media = to ? to->media() : nullptr;
+	return media && media->hasReplyPreview();
+}
+
 // Helper binary search for an item in a list that is not completely
 // above the given top of the visible area or below the given bottom of the visible area
 // is applied once for blocks list in a history and once for items list in the found block.
@@ -169,9 +184,33 @@ HistoryInner::HistoryInner(
 	setMouseTracking(true);
 	subscribe(_controller->gifPauseLevelChanged(), [this] {
 		if (!_controller->isGifPausedAtLeastFor(Window::GifPauseReason::Any)) {
+			clearViewsCache();
 			update();
 		}
 	});
+	subscribe(Window::Theme::Background(), [=](
+			const Window::Theme::BackgroundUpdate &update) {
+		if (update.paletteChanged()) {
+			clearViewsCache();
+		}
+	});
+	session().downloaderTaskFinished(
+	) | rpl::start_with_next([=] {
+		// Only reply previews of the cached messages can be loaded.
+		for (auto i = begin(_viewsCache); i != end(_viewsCache);) {
+			if (HasReplyPreview(i->first)) {
+				_viewsCacheBytes -= int64(i->second.frame.sizeInBytes());
+				i = _viewsCache.erase(i);
+			} else {
+				++i;
+			}
+		}
+	}, lifetime());
+	Core::App().settings().cacheMessagesPaintChanges(
+	) | rpl::start_with_next([=] {
+		clearViewsCache();
+		update();
+	}, lifetime());
 	subscribe(_controller->widget()->dragFinished(), [this] {
 		mouseActionUpdate(QCursor::pos());
 	});
@@ -205,6 +244,7 @@ HistoryInner::HistoryInner(
 		_history,
 		Data::HistoryUpdate::Flag::OutboxRead
 	) | rpl::start_with_next([=] {
+		clearViewsCache();
 		update();
 	}, lifetime());
 }
@@ -251,6 +291,9 @@ void HistoryInner::repaintItem(const HistoryItem *item) {
 }
 
 void HistoryInner::repaintItem(const Element *view) {
+	if (view) {
+		clearViewCache(view);
+	}
 	if (_widget->skipItemRepaint()) {
 		return;
 	}
@@ -523,6 +566,91 @@ TextSelection HistoryInner::itemRenderSelection(
 	return TextSelection();
 }
 
+bool HistoryInner::viewCacheAllowed(not_null<const Element*> view) const {
+	// Media may be animated or loaded without a repaint request
+	// for the view, so only plain text messages are cached.
+	// Highlighted messages are repainted each animation frame.
+	const auto item = view->data();
+	return Core::App().settings().cacheMessagesPaint()
+		&& !view->media()
+		&& !item->isSending()
+		&& !item->hasFailed()
+		&& !_widget->highlightStartTime(item);
+}
+
+void HistoryInner::paintView(
+		Painter &p,
+		not_null<Element*> view,
+		QRect clip,
+		TextSelection selection,
+		crl::time ms) {
+	if (!viewCacheAllowed(view)) {
+		clearViewCache(view);
+		view->draw(p, clip, selection, ms);
+		return;
+	}
+	const auto size = QSize(view->width(), view->height());
+	auto i = _viewsCache.find(view);
+	if (i != end(_viewsCache)
+		&& (i->second.size != size || i->second.selection != selection)) {
+		clearViewCache(view);
+		i = end(_viewsCache);
+	}
+	if (i == end(_viewsCache)) {
+		if (size.isEmpty()) {
+			return;
+		}
+		auto frame = QImage(
+			size * cIntRetinaFactor(),
+			QImage::Format_ARGB32_Premultiplied);
+		frame.setDevicePixelRatio(cRetinaFactor());
+		frame.fill(Qt::transparent);
+		{
+			Painter q(&frame);
+			view->draw(q, QRect(QPoint(), size), selection, ms);
+		}
+		const auto bytes = int64(frame.sizeInBytes());
+		if (_viewsCacheBytes + bytes > viewsCacheLimit()) {
+			clearViewsCache();
+		}
+		_viewsCacheBytes += bytes;
+		i = _viewsCache.emplace(
+			view,
+			CachedView{ std::move(frame), size, selection }).first;
+	}
+	const auto part = clip.intersected(QRect(QPoint(), size));
+	if (!part.isEmpty()) {
+		const auto ratio = cIntRetinaFactor();
+		p.drawImage(
+			part.topLeft(),
+			i->second.frame,
+			QRect(part.topLeft() * ratio, part.size() * ratio));
+	}
+}
+
+int64 HistoryInner::viewsCacheLimit() const {
+	const auto ratio = int64(cIntRetinaFactor());
+	const auto screen = int64(width())
+		* std::max(_visibleAreaBottom - _visibleAreaTop, 0)
+		* ratio
+		* ratio
+		* 4;
+	return std::max(screen * kViewsCacheScreens, kViewsCacheMinLimit);
+}
+
+void HistoryInner::clearViewsCache() {
+	_viewsCache.clear();
+	_viewsCacheBytes = 0;
+}
+
+void HistoryInner::clearViewCache(not_null<const Element*> view) {
+	const auto i = _viewsCache.find(view);
+	if (i != end(_viewsCache)) {
+		_viewsCacheBytes -= int64(i->second.frame.sizeInBytes());
+		_viewsCache.erase(i);
+	}
+}
+
 void HistoryInner::paintEmpty(Painter &p, int width, int height) {
 	if (!_emptyPainter) {
 		_emptyPainter = std::make_unique<HistoryView::EmptyPainter>(
@@ -535,6 +663,8 @@ void HistoryInner::paintEvent(QPaintEvent *e) {
 	if (Ui::skipPaintEvent(this, e)) {
 		return;
 	}
+	static auto probe = Core::Probe("paint.history_us");
+	const auto timer = Core::ProbeTimer(probe);
 	if (hasPendingResizedItems()) {
 		return;
 	}
@@ -606,7 +736,7 @@ void HistoryInner::paintEvent(QPaintEvent *e) {
 					view,
 					selfromy - mtop,
 					seltoy - mtop);
-				view->draw(p, clip.translated(0, -y), selection, ms);
+				paintView(p, view, clip.translated(0, -y), selection, ms);
 
 				if (item->hasViews()) {
 					_controller->content()->scheduleViewIncrement(item);
@@ -652,7 +782,12 @@ void HistoryInner::paintEvent(QPaintEvent *e) {
 						view,
 						selfromy - htop,
 						seltoy - htop);
-					view->draw(p, hclip.translated(0, -y), selection, ms);
+					paintView(
+						p,
+						view,
+						hclip.translated(0, -y),
+						selection,
+						ms);
 
 					const auto middle = y + h / 2;
 					const auto bottom = y + h;
@@ -796,6 +931,8 @@ bool HistoryInner::eventHook(QEvent *e) {
 			touchEvent(ev);
 			return true;
 		}
+	} else if (e->type() == QEvent::Hide) {
+		clearViewsCache();
 	}
 	return RpWidget::eventHook(e);
 }
@@ -1305,6 +1442,7 @@ void HistoryInner::viewRemoved(not_null<const Element*> view) {
 	refresh(_dragSelFrom);
 	refresh(_dragSelTo);
 	refresh(_scrollDateLastItem);
+	clearViewCache(view);
 }
 
 void HistoryInner::mouseActionFinish(
@@ -2437,12 +2575,15 @@ void HistoryInner::adjustCurrent(int32 y, History *history) const {
 		_curBlock = history->blocks.size() - 1;
 		_curItem = 0;
 	}
-	while (history->blocks[_curBlock]->y() > y && _curBlock > 0) {
-		--_curBlock;
-		_curItem = 0;
-	}
-	while (history->blocks[_curBlock]->y() + history->blocks[_curBlock]->height() <= y && _curBlock + 1 < history->blocks.size()) {
-		++_curBlock;
+	const auto contains = [&](const auto &entry, int top) {
+		return (entry->y() + top <= y)
+			&& (entry->y() + entry->height() + top > y);
+	};
+
+	// Mouse moves and paints mostly hit the same block again,
+	// otherwise find the block and the item by binary search.
+	if (!contains(history->blocks[_curBlock], 0)) {
+		_curBlock = BinarySearchBlocksOrItems<true>(history->blocks, y);
 		_curItem = 0;
 	}
 	auto block = history->blocks[_curBlock].get();
@@ -2450,11 +2591,8 @@ void HistoryInner::adjustCurrent(int32 y, History *history) const {
 		_curItem = block->messages.size() - 1;
 	}
 	auto by = block->y();
-	while (block->messages[_curItem]->y() + by > y && _curItem > 0) {
-		--_curItem;
-	}
-	while (block->messages[_curItem]->y() + block->messages[_curItem]->height() + by <= y && _curItem + 1 < block->messages.size()) {
-		++_curItem;
+	if (!contains(block->messages[_curItem], by)) {
+		_curItem = BinarySearchBlocksOrItems<true>(block->messages, y - by);
 	}
 }
 
@@ -3198,6 +3336,18 @@ bool HistoryInner::hasPendingResizedItems() const {
 		|| (_migrated && _migrated->hasPendingResizedItems());
 }
 
+bool HistoryInner::hasVisibleLazyResizedItems() {
+	auto result = false;
+	enumerateItems<EnumItemsDirection::TopToBottom>([&](
+			not_null<Element*> view,
+			int itemtop,
+			int itembottom) {
+		result = view->lazyResize();
+		return !result;
+	});
+	return result;
+}
+
 void HistoryInner::deleteAsGroup(FullMsgId itemId) {
 	if (const auto item = session().data().message(itemId)) {
 		const auto group = session().data().groups().find(item);
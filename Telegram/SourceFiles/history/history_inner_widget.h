@@ -65,6 +65,7 @@ public:
 
 	void checkHistoryActivation();
 	void recountHistoryGeometry();
+	[[nodiscard]] bool hasVisibleLazyResizedItems();
 	void updateSize();
 
 	void repaintItem(const HistoryItem *item);
@@ -226,6 +227,16 @@ private:
 	void performDrag();
 
 	void paintEmpty(Painter &p, int width, int height);
+	void paintView(
+		Painter &p,
+		not_null<Element*> view,
+		QRect clip,
+		TextSelection selection,
+		crl::time ms);
+	[[nodiscard]] bool viewCacheAllowed(not_null<const Element*> view) const;
+	[[nodiscard]] int64 viewsCacheLimit() const;
+	void clearViewsCache();
+	void clearViewCache(not_null<const Element*> view);
 
 	QPoint mapPointToItem(QPoint p, const Element *view) const;
 	QPoint mapPointToItem(QPoint p, const HistoryItem *item) const;
@@ -356,6 +367,14 @@ private:
 		not_null<PeerData*>,
 		std::shared_ptr<Data::CloudImageView>> _userpics, _userpicsCache;
 
+	struct CachedView {
+		QImage frame;
+		QSize size;
+		TextSelection selection;
+	};
+	base::flat_map<not_null<const Element*>, CachedView> _viewsCache;
+	int64 _viewsCacheBytes = 0;
+
 	MouseAction _mouseAction = MouseAction::None;
 	TextSelectType _mouseSelectType = TextSelectType::Letters;
 	QPoint _dragStartPosition;
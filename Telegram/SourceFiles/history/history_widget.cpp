@@ -140,9 +140,15 @@ namespace {
 
 constexpr auto kMessagesPerPageFirst = 30;
 constexpr auto kMessagesPerPage = 50;
+constexpr auto kMessagesPerPageFast = 100;
 constexpr auto kPreloadHeightsCount = 3; // when 3 screens to scroll left make a preload request
+constexpr auto kPreloadMaxHeightsCount = 12;
+constexpr auto kPreloadDefaultLatency = crl::time(300);
+constexpr auto kScrollSpeedTimeout = crl::time(200);
 constexpr auto kScrollToVoiceAfterScrolledMs = 1000;
 constexpr auto kSkipRepaintWhileScrollMs = 100;
+constexpr auto kLazyResizeDelay = crl::time(100);
+constexpr auto kLazyResizeItemsPerStep = 500;
 constexpr auto kShowMembersDropdownTimeoutMs = 300;
 constexpr auto kDisplayEditTimeWarningMs = 300 * 1000;
 constexpr auto kFullDayInMs = 86400 * 1000;
@@ -177,6 +183,7 @@ HistoryWidget::HistoryWidget(
 , _topBar(this, controller)
 , _scroll(this, st::historyScroll, false)
 , _updateHistoryItems([=] { updateHistoryItemsByTimer(); })
+, _lazyResizeTimer([=] { resizeLazyItems(); })
 , _historyDown(_scroll, st::historyToDown)
 , _unreadMentions(_scroll, st::historyUnreadMentions)
 , _fieldAutocomplete(this, controller)
@@ -1825,7 +1832,6 @@ void HistoryWidget::showHistory(
 	_replyEditMsg = nullptr;
 	_editMsgId = _replyToId = 0;
 	_previewData = nullptr;
-	_previewCache.clear();
 	_fieldBarCancel->hide();
 
 	_membersDropdownShowTimer.cancel();
@@ -1881,6 +1887,10 @@ void HistoryWidget::showHistory(
 			&& (!_history->loadedAtTop() || !_migrated->loadedAtBottom())) {
 			_migrated->clear(History::ClearType::Unload);
 		}
+		if (_migrated) {
+			session().data().histories().historyShown(_migrated);
+		}
+		session().data().histories().historyShown(_history);
 		_history->setFakeUnreadWhileOpened(true);
 
 		refreshTopBarActiveChat();
@@ -1912,6 +1922,7 @@ void HistoryWidget::showHistory(
 		_list->show();
 
 		_updateHistoryItems.cancel();
+		_lazyResizeTimer.cancel();
 
 		setupPinnedTracker();
 		setupGroupCallTracker();
@@ -2017,6 +2028,8 @@ void HistoryWidget::clearAllLoadRequests() {
 		histories.cancelRequest(_preloadDownRequest);
 		_preloadDownRequest = 0;
 	}
+	_scrollSpeed = 0.;
+	_scrollSpeedTime = 0;
 }
 
 void HistoryWidget::updateFieldSubmitSettings() {
@@ -2665,9 +2678,11 @@ void HistoryWidget::loadMessages() {
 
 	auto offsetId = from->minMsgId();
 	auto addOffset = 0;
-	auto loadCount = offsetId
-		? kMessagesPerPage
-		: kMessagesPerPageFirst;
+	auto loadCount = !offsetId
+		? kMessagesPerPageFirst
+		: (_scrollSpeed < 0. && scrollingFast())
+		? kMessagesPerPageFast
+		: kMessagesPerPage;
 	auto offsetDate = 0;
 	auto maxId = 0;
 	auto minId = 0;
@@ -2677,6 +2692,7 @@ void HistoryWidget::loadMessages() {
 	const auto type = Data::Histories::RequestType::History;
 	auto &histories = history->owner().histories();
 	_preloadRequest = histories.sendRequest(history, type, [=](Fn<void()> finish) {
+		const auto sent = crl::now();
 		return history->session().api().request(MTPmessages_GetHistory(
 			history->peer->input,
 			MTP_int(offsetId),
@@ -2687,6 +2703,7 @@ void HistoryWidget::loadMessages() {
 			MTP_int(minId),
 			MTP_int(historyHash)
 		)).done([=](const MTPmessages_Messages &result) {
+			updatePreloadLatency(crl::now() - sent);
 			messagesReceived(history->peer, result, _preloadRequest);
 			finish();
 		}).fail([=](const RPCError &error) {
@@ -2711,7 +2728,9 @@ void HistoryWidget::loadMessagesDown() {
 		return;
 	}
 
-	auto loadCount = kMessagesPerPage;
+	auto loadCount = (_scrollSpeed > 0. && scrollingFast())
+		? kMessagesPerPageFast
+		: kMessagesPerPage;
 	auto addOffset = -loadCount;
 	auto offsetId = from->maxMsgId();
 	if (!offsetId) {
@@ -2728,6 +2747,7 @@ void HistoryWidget::loadMessagesDown() {
 	const auto type = Data::Histories::RequestType::History;
 	auto &histories = history->owner().histories();
 	_preloadDownRequest = histories.sendRequest(history, type, [=](Fn<void()> finish) {
+		const auto sent = crl::now();
 		return history->session().api().request(MTPmessages_GetHistory(
 			history->peer->input,
 			MTP_int(offsetId + 1),
@@ -2738,6 +2758,7 @@ void HistoryWidget::loadMessagesDown() {
 			MTP_int(minId),
 			MTP_int(historyHash)
 		)).done([=](const MTPmessages_Messages &result) {
+			updatePreloadLatency(crl::now() - sent);
 			messagesReceived(history->peer, result, _preloadDownRequest);
 			finish();
 		}).fail([=](const RPCError &error) {
@@ -2850,6 +2871,11 @@ void HistoryWidget::visibleAreaUpdated() {
 		const auto scrollBottom = scrollTop + _scroll->height();
 		_list->visibleAreaUpdated(scrollTop, scrollBottom);
 		controller()->floatPlayerAreaUpdated();
+
+		// Items are painted only after they were laid out.
+		if (hasLazyResizedItems() && _list->hasVisibleLazyResizedItems()) {
+			resizeLazyItems();
+		}
 	}
 }
 
@@ -2882,14 +2908,53 @@ void HistoryWidget::preloadHistoryByScroll() {
 	auto scrollTop = _scroll->scrollTop();
 	auto scrollTopMax = _scroll->scrollTopMax();
 	auto scrollHeight = _scroll->height();
-	if (scrollTop + kPreloadHeightsCount * scrollHeight >= scrollTopMax) {
+	updateScrollSpeed(scrollTop);
+
+	// While scrolling fast preload also the distance that will be
+	// scrolled while the request is running, in the scroll direction.
+	const auto preloadHeight = kPreloadHeightsCount * scrollHeight;
+	const auto ahead = std::min(
+		int(std::abs(_scrollSpeed) * preloadLatency() * 2),
+		(kPreloadMaxHeightsCount - kPreloadHeightsCount) * scrollHeight);
+	const auto preloadDown = preloadHeight + ((_scrollSpeed > 0.) ? ahead : 0);
+	const auto preloadUp = preloadHeight + ((_scrollSpeed < 0.) ? ahead : 0);
+	if (scrollTop + preloadDown >= scrollTopMax) {
 		loadMessagesDown();
 	}
-	if (scrollTop <= kPreloadHeightsCount * scrollHeight) {
+	if (scrollTop <= preloadUp) {
 		loadMessages();
 	}
 }
 
+void HistoryWidget::updateScrollSpeed(int scrollTop) {
+	const auto now = crl::now();
+	const auto elapsed = now - _scrollSpeedTime;
+	if (_scrollSpeedTime && elapsed >= kScrollSpeedTimeout) {
+		_scrollSpeed = 0.;
+	} else if (_scrollSpeedTime && elapsed > 0) {
+		const auto speed = (scrollTop - _scrollSpeedTop) / float64(elapsed);
+		_scrollSpeed = (_scrollSpeed + speed) / 2.;
+	} else if (_scrollSpeedTime) {
+		return;
+	}
+	_scrollSpeedTop = scrollTop;
+	_scrollSpeedTime = now;
+}
+
+bool HistoryWidget::scrollingFast() const {
+	return (std::abs(_scrollSpeed) * preloadLatency() >= _scroll->height());
+}
+
+crl::time HistoryWidget::preloadLatency() const {
+	return _preloadLatency ? _preloadLatency : kPreloadDefaultLatency;
+}
+
+void HistoryWidget::updatePreloadLatency(crl::time latency) {
+	_preloadLatency = _preloadLatency
+		? ((_preloadLatency * 3 + latency) / 4)
+		: std::max(latency, crl::time(1));
+}
+
 void HistoryWidget::checkReplyReturns() {
 	if (_firstLoadRequest
 		|| _scroll->isHidden()
@@ -4432,6 +4497,17 @@ void HistoryWidget::updateHistoryItemsByTimer() {
 	}
 }
 
+void HistoryWidget::resizeLazyItems() {
+	if (!_list) {
+		return;
+	}
+	_history->resizeLazyItems(kLazyResizeItemsPerStep);
+	if (_migrated) {
+		_migrated->resizeLazyItems(kLazyResizeItemsPerStep);
+	}
+	handlePendingHistoryUpdate();
+}
+
 PeerData *HistoryWidget::ui_getPeerForMouseAction() {
 	return _peer;
 }
@@ -4625,6 +4701,9 @@ void HistoryWidget::updateHistoryGeometry(
 		return; // scrollTopMax etc are not working after recountHistoryGeometry()
 	}
 
+	// Scroll top changes caused by the layout are not counted in speed.
+	_scrollSpeedTime = 0;
+
 	auto newScrollHeight = height() - _topBar->height();
 	if (_pinnedBar) {
 		newScrollHeight -= _pinnedBar->height();
@@ -4719,6 +4798,10 @@ void HistoryWidget::updateListSize() {
 		_scroll->hide();
 	}
 	_updateHistoryGeometryRequired = true;
+
+	if (hasLazyResizedItems()) {
+		_lazyResizeTimer.callOnce(kLazyResizeDelay);
+	}
 }
 
 bool HistoryWidget::hasPendingResizedItems() const {
@@ -4726,6 +4809,11 @@ bool HistoryWidget::hasPendingResizedItems() const {
 		|| (_migrated && _migrated->hasPendingResizedItems());
 }
 
+bool HistoryWidget::hasLazyResizedItems() const {
+	return (_history && _history->hasLazyResizedItems())
+		|| (_migrated && _migrated->hasLazyResizedItems());
+}
+
 std::optional<int> HistoryWidget::unreadBarTop() const {
 	const auto bar = [&]() -> HistoryView::Element* {
 		if (const auto bar = _migrated ? _migrated->unreadBar() : nullptr) {
@@ -5894,8 +5982,8 @@ void HistoryWidget::checkPreview() {
 				previewCancel();
 			}
 		} else {
-			const auto i = _previewCache.constFind(links);
-			if (i == _previewCache.cend()) {
+			const auto cached = session().data().cachedWebPagePreview(links);
+			if (!cached) {
 				_previewRequest = _api.request(MTPmessages_GetWebPagePreview(
 					MTP_flags(0),
 					MTP_string(links),
@@ -5903,8 +5991,8 @@ void HistoryWidget::checkPreview() {
 				)).done([=](const MTPMessageMedia &result, mtpRequestId requestId) {
 					gotPreview(links, result, requestId);
 				}).send();
-			} else if (i.value()) {
-				_previewData = session().data().webpage(i.value());
+			} else if (*cached) {
+				_previewData = session().data().webpage(*cached);
 				updatePreview();
 			} else if (_previewData && _previewData->pendingTill >= 0) {
 				previewCancel();
@@ -5936,7 +6024,7 @@ void HistoryWidget::gotPreview(QString links, const MTPMessageMedia &result, mtp
 	if (result.type() == mtpc_messageMediaWebPage) {
 		const auto &data = result.c_messageMediaWebPage().vwebpage();
 		const auto page = session().data().processWebpage(data);
-		_previewCache.insert(links, page->id);
+		session().data().cacheWebPagePreview(links, page->id);
 		if (page->pendingTill > 0 && page->pendingTill <= base::unixtime::now()) {
 			page->pendingTill = -1;
 		}
@@ -5948,7 +6036,7 @@ void HistoryWidget::gotPreview(QString links, const MTPMessageMedia &result, mtp
 		}
 		session().data().sendWebPageGamePollNotifications();
 	} else if (result.type() == mtpc_messageMediaEmpty) {
-		_previewCache.insert(links, 0);
+		session().data().cacheWebPagePreview(links, 0);
 		if (links == _previewLinks && !_previewCancelled) {
 			_previewData = nullptr;
 			updatePreview();
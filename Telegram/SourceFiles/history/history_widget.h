@@ -345,6 +345,7 @@ private:
 	void handleScroll();
 	void scrollByTimer();
 	void updateHistoryItemsByTimer();
+	void resizeLazyItems();
 
 	[[nodiscard]] Dialogs::EntryState computeDialogsEntryState() const;
 	void refreshTopBarActiveChat();
@@ -516,6 +517,7 @@ private:
 
 	// Does any of the shown histories has this flag set.
 	bool hasPendingResizedItems() const;
+	bool hasLazyResizedItems() const;
 
 	// Counts scrollTop for placing the scroll right at the unread
 	// messages bar, choosing from _history and _migrated unreadBar.
@@ -549,6 +551,10 @@ private:
 	int countInitialScrollTop();
 	int countAutomaticScrollTop();
 	void preloadHistoryByScroll();
+	void updateScrollSpeed(int scrollTop);
+	[[nodiscard]] bool scrollingFast() const;
+	[[nodiscard]] crl::time preloadLatency() const;
+	void updatePreloadLatency(crl::time latency);
 	void checkReplyReturns();
 	void scrollToAnimationCallback(FullMsgId attachToId, int relativeTo);
 
@@ -611,8 +617,6 @@ private:
 	QStringList _parsedLinks;
 	QString _previewLinks;
 	WebPageData *_previewData = nullptr;
-	typedef QMap<QString, WebPageId> PreviewCache;
-	PreviewCache _previewCache;
 	mtpRequestId _previewRequest = 0;
 	Ui::Text::String _previewTitle;
 	Ui::Text::String _previewDescription;
@@ -633,6 +637,12 @@ private:
 	int _firstLoadRequest = 0; // Not real mtpRequestId.
 	int _preloadRequest = 0; // Not real mtpRequestId.
 	int _preloadDownRequest = 0; // Not real mtpRequestId.
+	crl::time _preloadLatency = 0;
+
+	// Pixels per millisecond, positive while scrolling down.
+	float64 _scrollSpeed = 0.;
+	int _scrollSpeedTop = 0;
+	crl::time _scrollSpeedTime = 0;
 
 	MsgId _delayedShowAtMsgId = -1;
 	int _delayedShowAtRequest = 0; // Not real mtpRequestId.
@@ -651,6 +661,7 @@ private:
 	int _lastScrollTop = 0; // gifs optimization
 	crl::time _lastScrolled = 0;
 	base::Timer _updateHistoryItems;
+	base::Timer _lazyResizeTimer;
 
 	crl::time _lastUserScrolled = 0;
 	bool _synteticScrollEvent = false;
@@ -397,6 +397,22 @@ bool Element::pendingResize() const {
 	return _flags & Flag::NeedsResize;
 }
 
+void Element::setLazyResize(bool lazy) {
+	if (lazy) {
+		_flags |= Flag::LazyResize;
+	} else {
+		_flags &= ~Flag::LazyResize;
+	}
+}
+
+bool Element::lazyResize() const {
+	return _flags & Flag::LazyResize;
+}
+
+void Element::applyCachedHeight(int height) {
+	setCurrentSize(QSize(width(), height));
+}
+
 bool Element::isAttachedToPrevious() const {
 	return _flags & Flag::AttachedToPrevious;
 }
@@ -172,6 +172,7 @@ public:
 		AttachedToPrevious = 0x02,
 		AttachedToNext     = 0x04,
 		HiddenByGroup      = 0x08,
+		LazyResize         = 0x10,
 	};
 	using Flags = base::flags<Flag>;
 	friend inline constexpr auto is_flag_type(Flag) { return true; }
@@ -193,6 +194,11 @@ public:
 
 	void setPendingResize();
 	bool pendingResize() const;
+	void setLazyResize(bool lazy);
+	[[nodiscard]] bool lazyResize() const;
+
+	// Estimated height, until the lazy resize lays the element out.
+	void applyCachedHeight(int height);
 	bool isUnderCursor() const;
 
 	bool isLastAndSelfMessage() const;
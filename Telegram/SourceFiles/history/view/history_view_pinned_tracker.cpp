@@ -22,8 +22,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace HistoryView {
 namespace{
 
-constexpr auto kLoadedLimit = 5;
-constexpr auto kChangeViewerLimit = 2;
+constexpr auto kLoadedLimit = 50;
+constexpr auto kChangeViewerLimit = 10;
 
 } // namespace
 
@@ -112,6 +112,9 @@ void PinnedTracker::refreshCurrentFromSlice() {
 	const auto proj2 = [](FullMsgId id) {
 		return id.msg;
 	};
+	const auto universal = [&](FullMsgId id) {
+		return _migratedPeer ? proj1(id) : proj2(id);
+	};
 	const auto i = _migratedPeer
 		? ranges::lower_bound(_slice.ids, _aroundId, ranges::less(), proj1)
 		: ranges::lower_bound(_slice.ids, _aroundId, ranges::less(), proj2);
@@ -141,13 +144,24 @@ void PinnedTracker::refreshCurrentFromSlice() {
 		}
 	}
 	if (nearEnd) {
+		_currentAfter = _currentTill = 0;
 		refreshViewer();
+	} else {
+		// Any _aroundId in (_currentAfter, _currentTill] gives the same result.
+		using Limits = std::numeric_limits<UniversalMsgId>;
+		_currentAfter = (i != begin(_slice.ids))
+			? universal(*(i - 1))
+			: Limits::min();
+		_currentTill = (i != end(_slice.ids))
+			? universal(*i)
+			: Limits::max();
 	}
 }
 
 void PinnedTracker::clear() {
 	_dataLifetime.destroy();
 	_viewerAroundId = 0;
+	_currentAfter = _currentTill = 0;
 	_current = PinnedId();
 }
 
@@ -158,6 +172,8 @@ void PinnedTracker::trackAround(MsgId messageId) {
 	_aroundId = messageId;
 	if (!_aroundId) {
 		clear();
+	} else if (_aroundId > _currentAfter && _aroundId <= _currentTill) {
+		return;
 	} else {
 		refreshCurrentFromSlice();
 	}
@@ -52,6 +52,8 @@ private:
 
 	UniversalMsgId _aroundId = 0;
 	UniversalMsgId _viewerAroundId = 0;
+	UniversalMsgId _currentAfter = 0;
+	UniversalMsgId _currentTill = 0;
 	Slice _slice;
 
 	rpl::lifetime _lifetime;
@@ -51,13 +51,24 @@ bool SendActionPainter::updateNeedsAnimating(
 	}
 
 	const auto now = crl::now();
+
+	// In large groups most of the events only prolong an action already
+	// shown, the text is rebuilt only when the set of actions changes.
+	auto changed = false;
 	const auto emplaceAction = [&](
 			Type type,
 			crl::time duration,
 			int progress = 0) {
+		const auto i = _sendActions.find(user);
+		if (i == end(_sendActions) || i->second.type != type) {
+			changed = true;
+		}
 		_sendActions.emplace_or_assign(user, type, now + duration, progress);
 	};
 	action.match([&](const MTPDsendMessageTypingAction &) {
+		if (!_typing.contains(user)) {
+			changed = true;
+		}
 		_typing.emplace_or_assign(user, now + kStatusShowClientsideTyping);
 	}, [&](const MTPDsendMessageRecordVideoAction &) {
 		emplaceAction(Type::RecordVideo, kStatusShowClientsideRecordVideo);
@@ -102,6 +113,9 @@ bool SendActionPainter::updateNeedsAnimating(
 			emplaceAction(Type::PlayGame, kStatusShowClientsidePlayGame);
 		}
 	}, [&](const MTPDspeakingInGroupCallAction &) {
+		if (!_speaking.contains(user)) {
+			changed = true;
+		}
 		_speaking.emplace_or_assign(
 			user,
 			now + kStatusShowClientsideSpeaking);
@@ -109,7 +123,7 @@ bool SendActionPainter::updateNeedsAnimating(
 	}, [&](const MTPDsendMessageCancelAction &) {
 		Unexpected("CancelAction here.");
 	});
-	return updateNeedsAnimating(now, true);
+	return updateNeedsAnimating(now, changed);
 }
 
 bool SendActionPainter::paint(
@@ -158,9 +158,12 @@ void Sticker::draw(Painter &p, const QRect &r, bool selected) {
 }
 
 void Sticker::paintLottie(Painter &p, const QRect &r, bool selected) {
+	// A player shared with other views keeps one frame request for all,
+	// so the selection overlay is applied here for its frames.
+	const auto shared = (_lottie.use_count() > 1);
 	auto request = Lottie::FrameRequest();
 	request.box = _size * cIntRetinaFactor();
-	if (selected && !_nextLastDiceFrame) {
+	if (selected && !_nextLastDiceFrame && !shared) {
 		request.colored = st::msgStickerOverlay->c;
 	}
 	const auto frame = _lottie
@@ -173,7 +176,7 @@ void Sticker::paintLottie(Painter &p, const QRect &r, bool selected) {
 	const auto &image = _lastDiceFrame.isNull()
 		? frame.image
 		: _lastDiceFrame;
-	const auto prepared = (!_lastDiceFrame.isNull() && selected)
+	const auto prepared = ((!_lastDiceFrame.isNull() || shared) && selected)
 		? Images::prepareColored(st::msgStickerOverlay->c, image)
 		: image;
 	const auto size = prepared.size() / cIntRetinaFactor();
@@ -300,12 +303,23 @@ void Sticker::setDiceIndex(const QString &emoji, int index) {
 void Sticker::setupLottie() {
 	Expects(_dataMedia != nullptr);
 
-	_lottie = ChatHelpers::LottiePlayerFromDocument(
-		_dataMedia.get(),
-		_replacements,
-		ChatHelpers::StickerLottieSize::MessageHistory,
-		size() * cIntRetinaFactor(),
-		Lottie::Quality::High);
+	// Looped stickers show the same frames in all views of the document.
+	const auto shared = (_diceIndex < 0)
+		&& !_replacements
+		&& !isEmojiSticker()
+		&& Core::App().settings().loopAnimatedStickers();
+	_lottie = shared
+		? ChatHelpers::SharedLottiePlayerFromDocument(
+			_dataMedia.get(),
+			ChatHelpers::StickerLottieSize::MessageHistory,
+			size() * cIntRetinaFactor(),
+			Lottie::Quality::High)
+		: ChatHelpers::LottiePlayerFromDocument(
+			_dataMedia.get(),
+			_replacements,
+			ChatHelpers::StickerLottieSize::MessageHistory,
+			size() * cIntRetinaFactor(),
+			Lottie::Quality::High);
 	lottieCreated();
 }
 
@@ -314,14 +328,15 @@ void Sticker::lottieCreated() {
 
 	_parent->history()->owner().registerHeavyViewPart(_parent);
 
+	_lottieLifetime.destroy();
 	_lottie->updates(
 	) | rpl::start_with_next([=](Lottie::Update update) {
 		v::match(update.data, [&](const Lottie::Information &information) {
 			_parent->history()->owner().requestViewResize(_parent);
 		}, [&](const Lottie::DisplayFrameRequest &request) {
-			_parent->history()->owner().requestViewRepaint(_parent);
+			_parent->history()->owner().requestViewAnimationRepaint(_parent);
 		});
-	}, _lifetime);
+	}, _lottieLifetime);
 }
 
 bool Sticker::hasHeavyPart() const {
@@ -341,16 +356,19 @@ void Sticker::unloadLottie() {
 		_nextLastDiceFrame = false;
 		_lottieOncePlayed = false;
 	}
+	_lottieLifetime.destroy();
 	_lottie = nullptr;
 	_parent->checkHeavyPart();
 }
 
-std::unique_ptr<Lottie::SinglePlayer> Sticker::stickerTakeLottie(
+std::shared_ptr<Lottie::SinglePlayer> Sticker::stickerTakeLottie(
 		not_null<DocumentData*> data,
 		const Lottie::ColorReplacements *replacements) {
-	return (data == _data && replacements == _replacements)
-		? std::move(_lottie)
-		: nullptr;
+	if (data != _data || replacements != _replacements) {
+		return nullptr;
+	}
+	_lottieLifetime.destroy();
+	return std::move(_lottie);
 }
 
 } // namespace HistoryView
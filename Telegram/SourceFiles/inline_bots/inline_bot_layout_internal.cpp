@@ -10,6 +10,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_photo.h"
 #include "data/data_document.h"
 #include "data/data_session.h"
+#include "data/data_streaming.h"
 #include "data/data_file_origin.h"
 #include "data/data_photo_media.h"
 #include "data/data_document_media.h"
@@ -21,6 +22,10 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "media/audio/media_audio.h"
 #include "media/clip/media_clip_reader.h"
 #include "media/player/media_player_instance.h"
+#include "media/streaming/media_streaming_instance.h"
+#include "media/streaming/media_streaming_player.h"
+#include "media/streaming/media_streaming_document.h"
+#include "media/streaming/media_streaming_loader_local.h"
 #include "history/history_location_manager.h"
 #include "history/view/history_view_cursor_state.h"
 #include "history/view/media/history_view_document.h" // DrawThumbnailAsSongCover
@@ -108,6 +113,8 @@ Gif::Gif(
 	}
 }
 
+Gif::~Gif() = default;
+
 void Gif::initDimensions() {
 	int32 w = content_width(), h = content_height();
 	if (w <= 0 || h <= 0) {
@@ -122,7 +129,7 @@ void Gif::initDimensions() {
 void Gif::setPosition(int32 position) {
 	ItemBase::setPosition(position);
 	if (_position < 0) {
-		_gif.reset();
+		_streamed = nullptr;
 	}
 }
 
@@ -146,18 +153,13 @@ void Gif::paint(Painter &p, const QRect &clip, const PaintContext *context) cons
 		&& document->displayLoading();
 	const auto loaded = preview.loaded();
 	const auto loading = preview.loading();
-	if (loaded
-		&& !_gif
-		&& !_gif.isBad()
-		&& CanPlayInline(document)) {
-		auto that = const_cast<Gif*>(this);
-		that->_gif = preview.makeAnimation([=](
-				Media::Clip::Notification notification) {
-			that->clipCallback(notification);
-		});
+	if (loaded && !_streamed && CanPlayInline(document)) {
+		const_cast<Gif*>(this)->createStreamed(preview);
 	}
 
-	const auto animating = (_gif && _gif->started());
+	const auto animating = _streamed
+		&& _streamed->ready()
+		&& !_streamed->failed();
 	if (displayLoading) {
 		ensureAnimation();
 		if (!_animation->radial.animating()) {
@@ -171,12 +173,19 @@ void Gif::paint(Painter &p, const QRect &clip, const PaintContext *context) cons
 
 	QRect r(0, 0, _width, height);
 	if (animating) {
-		const auto pixmap = _gif->current(frame.width(), frame.height(), _width, height, ImageRoundRadius::None, RectPart::None, context->paused ? 0 : context->ms);
+		auto request = Media::Streaming::FrameRequest();
+		request.resize = frame * cIntRetinaFactor();
+		request.outer = r.size() * cIntRetinaFactor();
+		const auto image = _streamed->frame(request);
 		if (_thumb.isNull()) {
-			_thumb = pixmap;
+			_thumb = App::pixmapFromImageInPlace(base::duplicate(image));
+			_thumb.setDevicePixelRatio(cRetinaFactor());
 			_thumbGood = true;
 		}
-		p.drawPixmap(r.topLeft(), pixmap);
+		p.drawImage(r, image);
+		if (!context->paused) {
+			_streamed->markFrameShown();
+		}
 	} else {
 		prepareThumbnail({ _width, height }, frame);
 		if (_thumb.isNull()) {
@@ -186,9 +195,10 @@ void Gif::paint(Painter &p, const QRect &clip, const PaintContext *context) cons
 		}
 	}
 
+	const auto failed = _streamed && _streamed->failed();
 	if (radial
-		|| _gif.isBad()
-		|| (!_gif && !loaded && !loading && !preview.usingThumbnail())) {
+		|| failed
+		|| (!_streamed && !loaded && !loading && !preview.usingThumbnail())) {
 		auto radialOpacity = (radial && loaded) ? _animation->radial.opacity() : 1.;
 		if (_animation && _animation->_a_over.animating()) {
 			auto over = _animation->_a_over.value(1.);
@@ -278,8 +288,13 @@ void Gif::clickHandlerActiveChanged(const ClickHandlerPtr &p, bool active) {
 }
 
 QSize Gif::countFrameSize() const {
-	bool animating = (_gif && _gif->ready());
-	int32 framew = animating ? _gif->width() : content_width(), frameh = animating ? _gif->height() : content_height(), height = st::inlineMediaHeight;
+	const auto animating = _streamed
+		&& _streamed->ready()
+		&& !_streamed->info().video.size.isEmpty();
+	const auto size = animating
+		? _streamed->info().video.size
+		: QSize(content_width(), content_height());
+	int32 framew = size.width(), frameh = size.height(), height = st::inlineMediaHeight;
 	if (framew * height > frameh * _width) {
 		if (framew < st::maxStickerSize || frameh > height) {
 			if (frameh > height || (framew * height / frameh) <= st::maxStickerSize) {
@@ -384,41 +399,92 @@ void Gif::radialAnimationCallback(crl::time now) const {
 }
 
 void Gif::unloadHeavyPart() {
-	_gif.reset();
+	_streamed = nullptr;
 	_dataMedia = nullptr;
 }
 
-void Gif::clipCallback(Media::Clip::Notification notification) {
-	using namespace Media::Clip;
-	switch (notification) {
-	case NotificationReinit: {
-		if (_gif) {
-			if (_gif->state() == State::Error) {
-				_gif.setBad();
-			} else if (_gif->ready() && !_gif->started()) {
-				if (_gif->width() * _gif->height() > kMaxInlineArea) {
-					getShownDocument()->dimensions = QSize(
-						_gif->width(),
-						_gif->height());
-					_gif.reset();
-				} else {
-					auto height = st::inlineMediaHeight;
-					auto frame = countFrameSize();
-					_gif->start(frame.width(), frame.height(), _width, height, ImageRoundRadius::None, RectPart::None);
-				}
-			} else if (_gif->autoPausedGif() && !context()->inlineItemVisible(this)) {
-				unloadHeavyPart();
-			}
+void Gif::createStreamed(const Data::VideoPreviewState &preview) {
+	using namespace Media::Streaming;
+
+	const auto document = getShownDocument();
+
+	// The same decoder is used if this GIF is also playing in a chat.
+	auto shared = preview.usingThumbnail()
+		? std::make_shared<Document>(
+			MakeBytesLoader(_dataMedia->videoThumbnailContent()))
+		: document->owner().streaming().sharedDocument(
+			document,
+			fileOrigin());
+	if (!shared) {
+		return;
+	}
+	_streamed = std::make_unique<Instance>(
+		std::move(shared),
+		[=] { update(); });
+	_streamed->player().updates(
+	) | rpl::start_with_next_error([=](Update &&update) {
+		handleStreamingUpdate(std::move(update));
+	}, [=](Error &&error) {
+		handleStreamingError(std::move(error));
+	}, _streamed->lifetime());
+
+	if (_streamed->ready()) {
+		streamingReady(base::duplicate(_streamed->info()));
+		if (!_streamed) {
+			return;
 		}
+	}
+	if (!_streamed->active() && !_streamed->failed()) {
+		auto options = PlaybackOptions();
+		options.mode = Mode::Video;
+		options.waitForMarkAsShown = true;
+		options.loop = true;
+		_streamed->play(options);
+	} else if (_streamed->paused()) {
+		_streamed->resume();
+	}
+}
 
-		update();
-	} break;
+void Gif::handleStreamingUpdate(Media::Streaming::Update &&update) {
+	using namespace Media::Streaming;
 
-	case NotificationRepaint: {
-		if (_gif && !_gif->currentDisplayed()) {
-			update();
+	v::match(update.data, [&](Information &update) {
+		streamingReady(std::move(update));
+	}, [&](const PreloadedVideo &update) {
+	}, [&](const UpdateVideo &update) {
+		if (!context()->inlineItemVisible(this)) {
+			clearStreamedLater();
+			unloadHeavyPart();
 		}
-	} break;
+		this->update();
+	}, [&](const PreloadedAudio &update) {
+	}, [&](const UpdateAudio &update) {
+	}, [&](const WaitingForData &update) {
+	}, [&](MutedByOther) {
+	}, [&](Finished) {
+	});
+}
+
+void Gif::handleStreamingError(Media::Streaming::Error &&error) {
+	update();
+}
+
+void Gif::streamingReady(Media::Streaming::Information &&info) {
+	if (info.video.size.width() * info.video.size.height()
+		> kMaxInlineArea) {
+		getShownDocument()->dimensions = info.video.size;
+		clearStreamedLater();
+	}
+	update();
+}
+
+void Gif::clearStreamedLater() {
+	// We can be inside the player updates handler, don't destroy it here.
+	auto streamed = std::shared_ptr<Media::Streaming::Instance>(
+		base::take(_streamed));
+	if (streamed) {
+		streamed->lifetime().destroy();
+		crl::on_main([streamed = std::move(streamed)] {});
 	}
 }
 
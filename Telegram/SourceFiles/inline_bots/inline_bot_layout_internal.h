@@ -21,8 +21,18 @@ class SinglePlayer;
 namespace Data {
 class PhotoMedia;
 class DocumentMedia;
+class VideoPreviewState;
 } // namespace Data
 
+namespace Media {
+namespace Streaming {
+class Instance;
+struct Update;
+enum class Error;
+struct Information;
+} // namespace Streaming
+} // namespace Media
+
 namespace InlineBots {
 namespace Layout {
 namespace internal {
@@ -63,6 +73,7 @@ public:
 		not_null<Context*> context,
 		not_null<DocumentData*> document,
 		bool hasDeleteButton);
+	~Gif();
 
 	void setPosition(int32 position) override;
 	void initDimensions() override;
@@ -118,11 +129,15 @@ private:
 	bool isRadialAnimation() const;
 	void radialAnimationCallback(crl::time now) const;
 
-	void clipCallback(Media::Clip::Notification notification);
+	void createStreamed(const Data::VideoPreviewState &preview);
+	void handleStreamingUpdate(Media::Streaming::Update &&update);
+	void handleStreamingError(Media::Streaming::Error &&error);
+	void streamingReady(Media::Streaming::Information &&info);
+	void clearStreamedLater();
 
 	StateFlags _state;
 
-	Media::Clip::ReaderPointer _gif;
+	std::unique_ptr<Media::Streaming::Instance> _streamed;
 	ClickHandlerPtr _delete;
 	mutable QPixmap _thumb;
 	mutable bool _thumbGood = false;
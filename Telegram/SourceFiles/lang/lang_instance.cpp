@@ -254,6 +254,7 @@ Instance::Instance(not_null<Instance*> derived, const PrivateTag &)
 void Instance::switchToId(const Language &data) {
 	reset(data);
 	if (_id == qstr("#TEST_X") || _id == qstr("#TEST_0")) {
+		parseAllValues();
 		for (auto &value : _values) {
 			value = PrepareTestValue(value, _id[5]);
 		}
@@ -302,6 +303,7 @@ void Instance::reset(const Language &data) {
 	for (auto i = 0, count = int(_values.size()); i != count; ++i) {
 		_values[i] = GetOriginalValue(ushort(i));
 	}
+	_unparsedValues.clear();
 	ranges::fill(_nonDefaultSet, 0);
 
 	_idChanges.fire_copy(_id);
@@ -702,14 +704,48 @@ QString Instance::getNonDefaultValue(const QByteArray &key) const {
 
 void Instance::applyValue(const QByteArray &key, const QByteArray &value) {
 	_nonDefaultValues[key] = value;
-	ParseKeyValue(key, value, [&](ushort key, QString &&value) {
-		_nonDefaultSet[key] = 1;
-		if (!_derived) {
-			_values[key] = std::move(value);
-		} else if (!_derived->_nonDefaultSet[key]) {
-			_derived->_values[key] = std::move(value);
+	const auto index = GetKeyIndex(QLatin1String(key));
+	if (index == kKeysCount) {
+		if (!key.startsWith("cloud_")) {
+			DEBUG_LOG(("Lang Warning: Unknown key '%1'"
+				).arg(QString::fromLatin1(key)));
 		}
-	});
+		return;
+	}
+	_nonDefaultSet[index] = 1;
+	if (!_derived) {
+		setUnparsedValue(index, key, value);
+	} else if (!_derived->_nonDefaultSet[index]) {
+		_derived->setUnparsedValue(index, key, value);
+	}
+}
+
+void Instance::setUnparsedValue(
+		ushort index,
+		const QByteArray &key,
+		const QByteArray &value) {
+	Expects(!_derived);
+
+	if (_unparsedValues.empty()) {
+		_unparsedValues.resize(kKeysCount);
+	}
+	_unparsedValues[index] = UnparsedValue{ key, value };
+}
+
+void Instance::parseValue(ushort key) const {
+	const auto unparsed = base::take(_unparsedValues[key]);
+	auto parser = ValueParser(unparsed.key, key, unparsed.value);
+	if (parser.parse()) {
+		_values[key] = parser.takeResult();
+	}
+}
+
+void Instance::parseAllValues() const {
+	for (auto i = 0, count = int(_unparsedValues.size()); i != count; ++i) {
+		if (!_unparsedValues[i].key.isEmpty()) {
+			parseValue(ushort(i));
+		}
+	}
 }
 
 void Instance::updatePluralRules() {
@@ -730,6 +766,9 @@ void Instance::resetValue(const QByteArray &key) {
 	if (keyIndex != kKeysCount) {
 		_nonDefaultSet[keyIndex] = 0;
 		if (!_derived) {
+			if (!_unparsedValues.empty()) {
+				_unparsedValues[keyIndex] = UnparsedValue();
+			}
 			const auto base = _base
 				? _base->getNonDefaultValue(key)
 				: QString();
@@ -737,6 +776,9 @@ void Instance::resetValue(const QByteArray &key) {
 				? base
 				: GetOriginalValue(keyIndex);
 		} else if (!_derived->_nonDefaultSet[keyIndex]) {
+			if (!_derived->_unparsedValues.empty()) {
+				_derived->_unparsedValues[keyIndex] = UnparsedValue();
+			}
 			_derived->_values[keyIndex] = GetOriginalValue(keyIndex);
 		}
 	}
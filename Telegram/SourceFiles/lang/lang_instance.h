@@ -87,6 +87,9 @@ public:
 	QString getValue(ushort key) const {
 		Expects(key < _values.size());
 
+		if (!_unparsedValues.empty() && !_unparsedValues[key].key.isEmpty()) {
+			parseValue(key);
+		}
 		return _values[key];
 	}
 	QString getNonDefaultValue(const QByteArray &key) const;
@@ -103,10 +106,21 @@ public:
 	}
 
 private:
+	struct UnparsedValue {
+		QByteArray key;
+		QByteArray value;
+	};
+
 	void setBaseId(const QString &baseId, const QString &pluralId);
 
 	void applyDifferenceToMe(const MTPDlangPackDifference &difference);
 	void applyValue(const QByteArray &key, const QByteArray &value);
+	void setUnparsedValue(
+		ushort index,
+		const QByteArray &key,
+		const QByteArray &value);
+	void parseValue(ushort key) const;
+	void parseAllValues() const;
 	void resetValue(const QByteArray &key);
 	void reset(const Language &language);
 	void fillFromCustomContent(
@@ -134,7 +148,10 @@ private:
 
 	mutable QString _systemLanguage;
 
-	std::vector<QString> _values;
+	mutable std::vector<QString> _values;
+
+	// Values are parsed on the first access, most of them are never shown.
+	mutable std::vector<UnparsedValue> _unparsedValues;
 	std::vector<uchar> _nonDefaultSet;
 	std::map<QByteArray, QByteArray> _nonDefaultValues;
 
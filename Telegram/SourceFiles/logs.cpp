@@ -11,9 +11,18 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/crash_reports.h"
 #include "core/launcher.h"
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 namespace {
 
 std::atomic<int> ThreadCounter/* = 0*/;
+std::atomic<int> EntryCounter/* = 0*/;
+
+// Debug logs can be very chatty, so they are not flushed on each line,
+// a flusher thread writes out their tail at least this often.
+constexpr auto kDebugFlushTimeout = crl::time(1000);
 
 } // namespace
 
@@ -51,11 +60,11 @@ QString _logsFilePath(LogDataType type, const QString &postfix = QString()) {
 int32 LogsStartIndexChosen = -1;
 QString _logsEntryStart() {
 	static thread_local auto threadId = ThreadCounter++;
-	static auto index = 0;
+	const auto index = ++EntryCounter;
 
 	const auto tm = QDateTime::currentDateTime();
 
-	return QString("[%1 %2-%3]").arg(tm.toString("hh:mm:ss.zzz")).arg(QString("%1").arg(threadId, 2, 10, QChar('0'))).arg(++index, 7, 10, QChar('0'));
+	return QString("[%1 %2-%3]").arg(tm.toString("hh:mm:ss.zzz")).arg(QString("%1").arg(threadId, 2, 10, QChar('0'))).arg(index, 7, 10, QChar('0'));
 }
 
 class LogsDataFields {
@@ -67,6 +76,17 @@ public:
 		}
 	}
 
+	~LogsDataFields() {
+		if (flusher.joinable()) {
+			{
+				std::lock_guard<std::mutex> lock(flusherMutex);
+				flusherStopped = true;
+			}
+			flusherCondition.notify_one();
+			flusher.join();
+		}
+	}
+
 	bool openMain() {
 		return reopen(LogDataMain, 0, qsl("start"));
 	}
@@ -97,6 +117,7 @@ public:
 	}
 
 	void write(LogDataType type, const QString &msg) {
+		const auto bytes = msg.toUtf8();
 		QMutexLocker lock(_logsMutex(type));
 		if (type != LogDataMain) {
 			reopenDebug();
@@ -105,12 +126,54 @@ public:
 		if (!file || !file->isOpen()) {
 			return;
 		}
-		file->write(msg.toUtf8());
-		file->flush();
+		file->write(bytes);
+		const auto now = crl::now();
+		if (type == LogDataMain || now >= flushed[type] + kDebugFlushTimeout) {
+			file->flush();
+			flushed[type] = now;
+			unflushed[type] = false;
+		} else {
+			unflushed[type] = true;
+			std::call_once(flusherStarted, [=] {
+				flusher = std::thread([=] { runFlusher(); });
+			});
+		}
 	}
 
 private:
+	void runFlusher() {
+		const auto timeout = std::chrono::milliseconds(kDebugFlushTimeout);
+		auto lock = std::unique_lock<std::mutex>(flusherMutex);
+		while (!flusherCondition.wait_for(lock, timeout, [=] {
+			return flusherStopped;
+		})) {
+			for (auto type = 0; type != LogDataCount; ++type) {
+				if (type != LogDataMain) {
+					flushPending(LogDataType(type));
+				}
+			}
+		}
+	}
+
+	void flushPending(LogDataType type) {
+		QMutexLocker lock(_logsMutex(type));
+		const auto file = files[type].get();
+		if (unflushed[type] && file && file->isOpen()) {
+			file->flush();
+			flushed[type] = crl::now();
+		}
+		unflushed[type] = false;
+	}
+
 	std::unique_ptr<QFile> files[LogDataCount];
+	crl::time flushed[LogDataCount] = { 0 };
+	bool unflushed[LogDataCount] = { false };
+
+	std::once_flag flusherStarted;
+	std::thread flusher;
+	std::mutex flusherMutex;
+	std::condition_variable flusherCondition;
+	bool flusherStopped = false;
 
 	int32 part = -1;
 
@@ -135,26 +135,41 @@ Session::Session(
 			saveSettingsDelayed();
 		}
 
-		// Storage::Account uses Main::Account::session() in those methods.
-		// So they can't be called during Main::Session construction.
-		local().readInstalledStickers();
-		local().readFeaturedStickers();
-		local().readRecentStickers();
-		local().readFavedStickers();
-		local().readSavedGifs();
-		data().stickers().notifyUpdated();
-		data().stickers().notifySavedGifsUpdated();
-	});
-
+		// Inactive accounts don't show any message fields or stickers,
+		// so with many accounts those are not loaded for each of them.
+		Core::App().domain().activeSessionValue(
+		) | rpl::filter([=](Session *session) {
+			return (session == this);
+		}) | rpl::take(1) | rpl::start_with_next([=] {
+			readStickersIfNeeded();
 #ifndef TDESKTOP_DISABLE_SPELLCHECK
-	Spellchecker::Start(this);
+			Spellchecker::Start(this);
 #endif // TDESKTOP_DISABLE_SPELLCHECK
+		}, _lifetime);
+	});
 
 	_api->requestNotifySettings(MTP_inputNotifyUsers());
 	_api->requestNotifySettings(MTP_inputNotifyChats());
 	_api->requestNotifySettings(MTP_inputNotifyBroadcasts());
 }
 
+void Session::readStickersIfNeeded() {
+	if (_stickersRead) {
+		return;
+	}
+	_stickersRead = true;
+
+	// Storage::Account uses Main::Account::session() in those methods.
+	// So they can't be called during Main::Session construction.
+	local().readInstalledStickers();
+	local().readFeaturedStickers();
+	local().readRecentStickers();
+	local().readFavedStickers();
+	local().readSavedGifs();
+	data().stickers().notifyUpdated();
+	data().stickers().notifySavedGifsUpdated();
+}
+
 // Can be called only right before ~Session.
 void Session::finishLogout() {
 	updates().updateOnline();
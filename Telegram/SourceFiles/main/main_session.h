@@ -120,6 +120,10 @@ public:
 	void saveSettingsDelayed(crl::time delay = kDefaultSaveDelay);
 	void saveSettingsNowIfNeeded();
 
+	// Stickers and saved GIFs are read only when the session is shown
+	// or when a stickers update is received for it.
+	void readStickersIfNeeded();
+
 	void addWindow(not_null<Window::SessionController*> controller);
 	[[nodiscard]] auto windows() const
 		-> const base::flat_set<not_null<Window::SessionController*>> &;
@@ -189,6 +193,7 @@ private:
 
 	base::flat_set<not_null<Window::SessionController*>> _windows;
 	base::Timer _saveSettingsTimer;
+	bool _stickersRead = false;
 
 	rpl::lifetime _lifetime;
 
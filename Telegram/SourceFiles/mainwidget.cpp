@@ -92,6 +92,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/shortcuts.h"
 #include "core/application.h"
 #include "core/changelogs.h"
+#include "core/core_probes.h"
 #include "base/unixtime.h"
 #include "calls/calls_instance.h"
 #include "calls/calls_top_bar.h"
@@ -120,8 +121,57 @@ namespace {
 // Send channel views each second.
 constexpr auto kSendViewsTimeout = crl::time(1000);
 
-// Cache background scaled image after 3s.
-constexpr auto kCacheBackgroundTimeout = 3000;
+// Cache background scaled image after 300ms.
+constexpr auto kCacheBackgroundTimeout = 300;
+
+// Keep scaled backgrounds for that many different section sizes.
+constexpr auto kCachedBackgroundsCount = 3;
+
+struct PreparedBackground {
+	QImage image;
+	int x = 0;
+	int y = 0;
+};
+
+[[nodiscard]] PreparedBackground PrepareBackground(
+		QImage background,
+		bool tile,
+		QRect forRect,
+		int ratio) {
+	auto result = PreparedBackground();
+	if (tile) {
+		result.image = QImage(
+			forRect.size() * ratio,
+			QImage::Format_RGB32);
+		result.image.setDevicePixelRatio(ratio);
+		QPainter p(&result.image);
+		const auto w = background.width() / ratio;
+		const auto h = background.height() / ratio;
+		const auto cx = qCeil(forRect.width() / float64(w));
+		const auto cy = qCeil(forRect.height() / float64(h));
+		background.setDevicePixelRatio(ratio);
+		for (auto i = 0; i < cx; ++i) {
+			for (auto j = 0; j < cy; ++j) {
+				p.drawImage(QPoint(i * w, j * h), background);
+			}
+		}
+	} else {
+		QRect to, from;
+		Window::Theme::ComputeBackgroundRects(
+			forRect,
+			background.size(),
+			to,
+			from);
+		result.x = to.x();
+		result.y = to.y();
+		result.image = background.copy(from).scaled(
+			to.size() * ratio,
+			Qt::IgnoreAspectRatio,
+			Qt::SmoothTransformation);
+		result.image.setDevicePixelRatio(ratio);
+	}
+	return result;
+}
 
 } // namespace
 
@@ -790,45 +840,51 @@ bool MainWidget::selectingPeer() const {
 }
 
 void MainWidget::cacheBackground() {
-	if (Window::Theme::Background()->colorForFill()) {
+	const auto background = Window::Theme::Background();
+	if (background->colorForFill()) {
 		return;
-	} else if (Window::Theme::Background()->tile()) {
-		auto &bg = Window::Theme::Background()->pixmapForTiled();
-
-		auto result = QImage(_willCacheFor.width() * cIntRetinaFactor(), _willCacheFor.height() * cIntRetinaFactor(), QImage::Format_RGB32);
-		result.setDevicePixelRatio(cRetinaFactor());
-		{
-			QPainter p(&result);
-			auto left = 0;
-			auto top = 0;
-			auto right = _willCacheFor.width();
-			auto bottom = _willCacheFor.height();
-			auto w = bg.width() / cRetinaFactor();
-			auto h = bg.height() / cRetinaFactor();
-			auto sx = 0;
-			auto sy = 0;
-			auto cx = qCeil(_willCacheFor.width() / w);
-			auto cy = qCeil(_willCacheFor.height() / h);
-			for (int i = sx; i < cx; ++i) {
-				for (int j = sy; j < cy; ++j) {
-					p.drawPixmap(QPointF(i * w, j * h), bg);
-				}
-			}
-		}
-		_cachedX = 0;
-		_cachedY = 0;
-		_cachedBackground = App::pixmapFromImageInPlace(std::move(result));
-	} else {
-		auto &bg = Window::Theme::Background()->pixmap();
-
-		QRect to, from;
-		Window::Theme::ComputeBackgroundRects(_willCacheFor, bg.size(), to, from);
-		_cachedX = to.x();
-		_cachedY = to.y();
-		_cachedBackground = App::pixmapFromImageInPlace(bg.toImage().copy(from).scaled(to.width() * cIntRetinaFactor(), to.height() * cIntRetinaFactor(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
-		_cachedBackground.setDevicePixelRatio(cRetinaFactor());
 	}
-	_cachedFor = _willCacheFor;
+	const auto tile = background->tile();
+	const auto forRect = _willCacheFor;
+	const auto generation = _cachedBackgroundsGeneration;
+	const auto ratio = cIntRetinaFactor();
+	auto image = (tile
+		? background->pixmapForTiled()
+		: background->pixmap()).toImage();
+	_cachingFor = forRect;
+
+	// Scaling a large wallpaper takes a while, do it off the main thread.
+	crl::async([=, image = std::move(image)]() mutable {
+		auto prepared = PrepareBackground(
+			std::move(image),
+			tile,
+			forRect,
+			ratio);
+		crl::on_main(this, [=, prepared = std::move(prepared)]() mutable {
+			if (generation != _cachedBackgroundsGeneration) {
+				return;
+			}
+			if (_cachingFor == forRect) {
+				_cachingFor = QRect();
+			}
+			const auto i = ranges::find(
+				_cachedBackgrounds,
+				forRect,
+				&CachedBackground::forRect);
+			if (i != end(_cachedBackgrounds)) {
+				_cachedBackgrounds.erase(i);
+			} else if (_cachedBackgrounds.size() >= kCachedBackgroundsCount) {
+				_cachedBackgrounds.erase(begin(_cachedBackgrounds));
+			}
+			_cachedBackgrounds.push_back({
+				.pixmap = App::pixmapFromImageInPlace(
+					std::move(prepared.image)),
+				.forRect = forRect,
+				.x = prepared.x,
+				.y = prepared.y,
+			});
+		});
+	});
 }
 
 crl::time MainWidget::highlightStartTime(not_null<const HistoryItem*> item) const {
@@ -1147,16 +1203,25 @@ void MainWidget::dialogsCancelled() {
 }
 
 void MainWidget::clearCachedBackground() {
-	_cachedBackground = QPixmap();
+	_cachedBackgrounds.clear();
+	_cachingFor = QRect();
+	++_cachedBackgroundsGeneration;
 	_cacheBackgroundTimer.cancel();
 	update();
 }
 
 QPixmap MainWidget::cachedBackground(const QRect &forRect, int &x, int &y) {
-	if (!_cachedBackground.isNull() && forRect == _cachedFor) {
-		x = _cachedX;
-		y = _cachedY;
-		return _cachedBackground;
+	const auto i = ranges::find(
+		_cachedBackgrounds,
+		forRect,
+		&CachedBackground::forRect);
+	if (i != end(_cachedBackgrounds)) {
+		x = i->x;
+		y = i->y;
+		return i->pixmap;
+	}
+	if (_cachingFor == forRect) {
+		return QPixmap();
 	}
 	if (_willCacheFor != forRect || !_cacheBackgroundTimer.isActive()) {
 		_willCacheFor = forRect;
@@ -1497,6 +1562,7 @@ void MainWidget::ui_showPeerHistory(
 	auto animatedShow = [&] {
 		if (_a_show.animating()
 			|| Core::App().passcodeLocked()
+			|| anim::Disabled()
 			|| (params.animated == anim::type::instant)) {
 			return false;
 		}
@@ -1669,6 +1735,9 @@ Window::SectionSlideParams MainWidget::prepareThirdSectionAnimation(Window::Sect
 
 Window::SectionSlideParams MainWidget::prepareShowAnimation(
 		bool willHaveTopBarShadow) {
+	static auto probe = Core::Probe("window.section_grab_us");
+	const auto timer = Core::ProbeTimer(probe);
+
 	Window::SectionSlideParams result;
 	result.withTopBarShadow = willHaveTopBarShadow;
 	if (selectingPeer() && Adaptive::OneColumn()) {
@@ -1796,6 +1865,7 @@ void MainWidget::showNewSection(
 	auto animatedShow = [&] {
 		if (_a_show.animating()
 			|| Core::App().passcodeLocked()
+			|| anim::Disabled()
 			|| (params.animated == anim::type::instant)
 			|| memento->instant()) {
 			return false;
@@ -380,10 +380,15 @@ private:
 	int _exportTopBarHeight = 0;
 	int _contentScrollAddToY = 0;
 
-	QPixmap _cachedBackground;
-	QRect _cachedFor, _willCacheFor;
-	int _cachedX = 0;
-	int _cachedY = 0;
+	struct CachedBackground {
+		QPixmap pixmap;
+		QRect forRect;
+		int x = 0;
+		int y = 0;
+	};
+	std::vector<CachedBackground> _cachedBackgrounds;
+	QRect _willCacheFor, _cachingFor;
+	int _cachedBackgroundsGeneration = 0;
 	base::Timer _cacheBackgroundTimer;
 
 	PhotoData *_deletingPhoto = nullptr;
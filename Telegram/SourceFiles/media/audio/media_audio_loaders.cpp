@@ -201,10 +201,16 @@ void Loaders::loadData(AudioMsgId audio, crl::time positionMs) {
 			break;
 		}
 
-		QMutexLocker lock(internal::audioPlayerMutex());
-		if (!checkLoader(type)) {
-			clear(type);
-			return;
+		// Don't wait for the fader here, the track is checked once more
+		// under the lock before the decoded samples are queued.
+		const auto mutex = internal::audioPlayerMutex();
+		if (mutex->tryLock()) {
+			const auto valid = (checkLoader(type) != nullptr);
+			mutex->unlock();
+			if (!valid) {
+				clear(type);
+				return;
+			}
 		}
 	}
 
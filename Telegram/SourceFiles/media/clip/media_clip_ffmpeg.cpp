@@ -19,6 +19,11 @@ constexpr auto kSkipInvalidDataPackets = 10;
 constexpr auto kMaxInlineArea = 1280 * 720;
 constexpr auto kMaxSendingArea = 3840 * 2160; // usual 4K
 
+// When inspecting a file for sending we need only the first frame,
+// so don't let avformat_find_stream_info read several megabytes.
+constexpr auto kInspectingProbeSize = 1024 * 1024;
+constexpr auto kInspectingAnalyzeDuration = AV_TIME_BASE;
+
 // See https://github.com/telegramdesktop/tdesktop/issues/7225
 constexpr auto kAlignImageBy = 64;
 
@@ -271,6 +276,10 @@ bool FFMpegReaderImplementation::start(Mode mode, crl::time &positionMs) {
 		return false;
 	}
 	_fmtContext->pb = _ioContext;
+	if (_mode == Mode::Inspecting) {
+		_fmtContext->probesize = kInspectingProbeSize;
+		_fmtContext->max_analyze_duration = kInspectingAnalyzeDuration;
+	}
 
 	int res = 0;
 	char err[AV_ERROR_MAX_STRING_SIZE] = { 0 };
@@ -31,10 +31,21 @@ namespace Media {
 namespace Clip {
 namespace {
 
-constexpr auto kClipThreadsCount = 8;
+constexpr auto kMaxClipThreadsCount = 8;
 constexpr auto kAverageGifSize = 320 * 240;
 constexpr auto kWaitBeforeGifPause = crl::time(200);
 
+// Decoding time share is measured in this window, in permille.
+constexpr auto kBusyLevelWindow = crl::time(1000);
+
+[[nodiscard]] int ClipThreadsCount() {
+	static const auto result = std::clamp(
+		QThread::idealThreadCount() - 1,
+		1,
+		kMaxClipThreadsCount);
+	return result;
+}
+
 QVector<QThread*> threads;
 QVector<Manager*> managers;
 
@@ -109,19 +120,26 @@ Reader::Reader(const QByteArray &data, Callback &&callback)
 }
 
 void Reader::init(const Core::FileLocation &location, const QByteArray &data) {
-	if (threads.size() < kClipThreadsCount) {
+	if (threads.size() < ClipThreadsCount()) {
 		_threadIndex = threads.size();
 		threads.push_back(new QThread());
 		managers.push_back(new Manager(threads.back()));
 		threads.back()->start();
 	} else {
+		// Prefer the thread that spent least time decoding recently,
+		// the frame area sum only breaks the ties.
 		_threadIndex = int32(openssl::RandomValue<uint32>() % threads.size());
-		int32 loadLevel = 0x7FFFFFFF;
+		auto level = std::make_pair(
+			std::numeric_limits<int>::max(),
+			std::numeric_limits<int>::max());
 		for (int32 i = 0, l = threads.size(); i < l; ++i) {
-			int32 level = managers.at(i)->loadLevel();
-			if (level < loadLevel) {
+			const auto manager = managers.at(i);
+			const auto current = std::make_pair(
+				manager->busyLevel(),
+				manager->loadLevel());
+			if (current < level) {
 				_threadIndex = i;
-				loadLevel = level;
+				level = current;
 			}
 		}
 	}
@@ -736,6 +754,7 @@ void Manager::process() {
 
 	bool checkAllReaders = false;
 	auto ms = crl::now(), minms = ms + 86400 * crl::time(1000);
+	const auto processStarted = ms;
 	{
 		QMutexLocker lock(&_readerPointersMutex);
 		for (auto it = _readerPointers.begin(), e = _readerPointers.end(); it != e; ++it) {
@@ -762,25 +781,13 @@ void Manager::process() {
 		checkAllReaders = (_readers.size() > _readerPointers.size());
 	}
 
+	auto due = std::vector<std::pair<crl::time, ReaderPrivate*>>();
 	for (auto i = _readers.begin(), e = _readers.end(); i != e;) {
 		ReaderPrivate *reader = i.key();
 		if (i.value() <= ms) {
-			ResultHandleState state = handleResult(reader, reader->process(ms), ms);
-			if (state == ResultHandleRemove) {
-				i = _readers.erase(i);
-				continue;
-			} else if (state == ResultHandleStop) {
-				_processingInThread = nullptr;
-				return;
-			}
-			ms = crl::now();
-			if (reader->_videoPausedAtMs) {
-				i.value() = ms + 86400 * 1000ULL;
-			} else if (reader->_nextFrameWhen && reader->_started) {
-				i.value() = reader->_nextFrameWhen;
-			} else {
-				i.value() = (ms + 86400 * 1000ULL);
-			}
+			due.emplace_back(i.value(), reader);
+			++i;
+			continue;
 		} else if (checkAllReaders) {
 			QMutexLocker lock(&_readerPointersMutex);
 			auto it = constUnsafeFindReaderPointer(reader);
@@ -797,7 +804,35 @@ void Manager::process() {
 		++i;
 	}
 
+	// Frames with the earliest display time are decoded first.
+	ranges::sort(due, ranges::less(), [](const auto &pair) {
+		return pair.first;
+	});
+	for (const auto &[when, reader] : due) {
+		ResultHandleState state = handleResult(reader, reader->process(ms), ms);
+		if (state == ResultHandleRemove) {
+			_readers.remove(reader);
+			continue;
+		} else if (state == ResultHandleStop) {
+			_processingInThread = nullptr;
+			return;
+		}
+		ms = crl::now();
+		auto &next = _readers[reader];
+		if (reader->_videoPausedAtMs) {
+			next = ms + 86400 * 1000ULL;
+		} else if (reader->_nextFrameWhen && reader->_started) {
+			next = reader->_nextFrameWhen;
+		} else {
+			next = (ms + 86400 * 1000ULL);
+		}
+		if (!reader->_autoPausedGif && next < minms) {
+			minms = next;
+		}
+	}
+
 	ms = crl::now();
+	updateBusyLevel(ms - processStarted, ms);
 	if (_needReProcess || minms <= ms) {
 		_needReProcess = false;
 		_timer.start(1);
@@ -808,6 +843,22 @@ void Manager::process() {
 	_processingInThread = nullptr;
 }
 
+void Manager::updateBusyLevel(crl::time busy, crl::time now) {
+	if (_readers.isEmpty()) {
+		_busyLevel.storeRelease(0);
+		_busyWindowStart = now;
+		_busyInWindow = 0;
+		return;
+	}
+	_busyInWindow += busy;
+	const auto window = now - _busyWindowStart;
+	if (window >= kBusyLevelWindow) {
+		_busyLevel.storeRelease(int(_busyInWindow * 1000 / window));
+		_busyWindowStart = now;
+		_busyInWindow = 0;
+	}
+}
+
 void Manager::finish() {
 	_timer.stop();
 	clear();
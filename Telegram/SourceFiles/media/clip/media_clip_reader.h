@@ -228,6 +228,9 @@ public:
 	int loadLevel() const {
 		return _loadLevel;
 	}
+	int busyLevel() const {
+		return _busyLevel.loadAcquire();
+	}
 	void append(Reader *reader, const Core::FileLocation &location, const QByteArray &data);
 	void start(Reader *reader);
 	void update(Reader *reader);
@@ -239,8 +242,12 @@ private:
 	void finish();
 	void callback(Reader *reader, Notification notification);
 	void clear();
+	void updateBusyLevel(crl::time busy, crl::time now);
 
 	QAtomicInt _loadLevel;
+	QAtomicInt _busyLevel;
+	crl::time _busyWindowStart = 0;
+	crl::time _busyInWindow = 0;
 	using ReaderPointers = QMap<Reader*, QAtomicInt>;
 	ReaderPointers _readerPointers;
 	mutable QMutex _readerPointersMutex;
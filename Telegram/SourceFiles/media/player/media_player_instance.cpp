@@ -8,12 +8,14 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "media/player/media_player_instance.h"
 
 #include "data/data_document.h"
+#include "data/data_document_media.h"
 #include "data/data_session.h"
 #include "data/data_streaming.h"
 #include "media/audio/media_audio.h"
 #include "media/audio/media_audio_capture.h"
 #include "media/streaming/media_streaming_instance.h"
 #include "media/streaming/media_streaming_player.h"
+#include "media/streaming/media_streaming_reader.h"
 #include "media/view/media_view_playback_progress.h"
 #include "calls/calls_instance.h"
 #include "history/history.h"
@@ -45,6 +47,9 @@ constexpr auto kIdsPreloadAfter = 28;
 
 constexpr auto kMinLengthForSavePosition = 20 * TimeId(60); // 20 minutes.
 
+// Bytes of the next track requested once the current one has its header.
+constexpr auto kPreloadNextSize = 1024 * 1024;
+
 } // namespace
 
 struct Instance::Streamed {
@@ -373,6 +378,38 @@ bool Instance::moveInPlaylist(
 	return false;
 }
 
+void Instance::checkPreloadNext(not_null<Data*> data) {
+	if (!data->streamed
+		|| !data->streamed->instance.ready()
+		|| !data->playlistIndex
+		|| data->repeatEnabled) {
+		return;
+	}
+	const auto item = itemByIndex(data, *data->playlistIndex + 1);
+	if (!item || data->preloadedNext == item->fullId()) {
+		return;
+	}
+	data->preloadedNext = item->fullId();
+	data->preloadedNextReader = nullptr;
+	const auto media = item->media();
+	const auto document = media ? media->document() : nullptr;
+	if (!document
+		|| !(document->isAudioFile()
+			|| document->isVoiceMessage()
+			|| document->isVideoMessage())) {
+		return;
+	}
+	// The shared reader is reused by sharedDocument() when the track starts.
+	auto reader = document->owner().streaming().sharedReader(
+		document,
+		item->fullId());
+	if (!reader) {
+		return;
+	}
+	reader->preloadHead(kPreloadNextSize);
+	data->preloadedNextReader = std::move(reader);
+}
+
 bool Instance::previousAvailable(AudioMsgId::Type type) const {
 	const auto data = getData(type);
 	Assert(data != nullptr);
@@ -475,6 +512,7 @@ void Instance::playStreamed(
 		audioId,
 		std::move(shared));
 	data->streamed->instance.lockPlayer();
+	data->preloadedNextReader = nullptr;
 
 	data->streamed->instance.player().updates(
 	) | rpl::start_with_next_error([=](Streaming::Update &&update) {
@@ -721,6 +759,9 @@ void Instance::emitUpdate(AudioMsgId::Type type, CheckCallback check) {
 			}
 		}
 		_updatedNotifier.fire_copy({state});
+		if (!IsStopped(state.state)) {
+			checkPreloadNext(data);
+		}
 		if (data->isPlaying && state.state == State::StoppedAtEnd) {
 			if (data->repeatEnabled) {
 				play(data->current);
@@ -28,6 +28,7 @@ namespace Media {
 namespace Streaming {
 class Document;
 class Instance;
+class Reader;
 struct PlaybackOptions;
 struct Update;
 enum class Error;
@@ -177,6 +178,8 @@ private:
 		std::optional<SliceKey> playlistSliceKey;
 		std::optional<SliceKey> playlistRequestedKey;
 		std::optional<int> playlistIndex;
+		FullMsgId preloadedNext;
+		std::shared_ptr<Streaming::Reader> preloadedNextReader;
 		rpl::lifetime playlistLifetime;
 		rpl::lifetime sessionLifetime;
 		rpl::event_stream<> playlistChanges;
@@ -217,6 +220,7 @@ private:
 	void playlistUpdated(not_null<Data*> data);
 	bool moveInPlaylist(not_null<Data*> data, int delta, bool autonext);
 	HistoryItem *itemByIndex(not_null<Data*> data, int index);
+	void checkPreloadNext(not_null<Data*> data);
 	void stopAndClear(not_null<Data*> data);
 
 	void handleStreamingUpdate(
@@ -10,6 +10,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "media/streaming/media_streaming_loader.h"
 #include "media/streaming/media_streaming_file_delegate.h"
 #include "ffmpeg/ffmpeg_utility.h"
+#include "core/application.h"
 
 namespace Media {
 namespace Streaming {
@@ -133,7 +134,8 @@ void File::Context::logFatal(
 
 Stream File::Context::initStream(
 		not_null<AVFormatContext*> format,
-		AVMediaType type) {
+		AVMediaType type,
+		bool hwAllowed) {
 	auto result = Stream();
 	const auto index = result.index = av_find_best_stream(
 		format,
@@ -161,7 +163,10 @@ Stream File::Context::initStream(
 		}
 	}
 
-	result.codec = FFmpeg::MakeCodecPointer(info);
+	result.codec = FFmpeg::MakeCodecPointer({
+		.stream = info,
+		.hwAllowed = hwAllowed,
+	});
 	if (!result.codec) {
 		return result;
 	}
@@ -243,7 +248,7 @@ std::variant<FFmpeg::Packet, FFmpeg::AvErrorWrap> File::Context::readPacket() {
 	return error;
 }
 
-void File::Context::start(crl::time position) {
+void File::Context::start(crl::time position, bool hwAllowed) {
 	auto error = FFmpeg::AvErrorWrap();
 
 	if (unroll()) {
@@ -262,12 +267,12 @@ void File::Context::start(crl::time position) {
 		return logFatal(qstr("avformat_find_stream_info"), error);
 	}
 
-	auto video = initStream(format.get(), AVMEDIA_TYPE_VIDEO);
+	auto video = initStream(format.get(), AVMEDIA_TYPE_VIDEO, hwAllowed);
 	if (unroll()) {
 		return;
 	}
 
-	auto audio = initStream(format.get(), AVMEDIA_TYPE_AUDIO);
+	auto audio = initStream(format.get(), AVMEDIA_TYPE_AUDIO, false);
 	if (unroll()) {
 		return;
 	}
@@ -412,8 +417,9 @@ void File::start(not_null<FileDelegate*> delegate, crl::time position) {
 
 	_reader->startStreaming();
 	_context.emplace(delegate, _reader.get());
+	const auto hwAllowed = Core::App().settings().hardwareAcceleratedVideo();
 	_thread = std::thread([=, context = &*_context] {
-		context->start(position);
+		context->start(position, hwAllowed);
 		while (!context->finished()) {
 			context->readNextPacket();
 		}
@@ -446,6 +452,14 @@ void File::setLoaderPriority(int priority) {
 	_reader->setLoaderPriority(priority);
 }
 
+int File::size() const {
+	return _reader->size();
+}
+
+void File::setReadAheadPolicy(Reader::ReadAheadPolicy policy) {
+	_reader->setReadAheadPolicy(policy);
+}
+
 File::~File() {
 	stop();
 }
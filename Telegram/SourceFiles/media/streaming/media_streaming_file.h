@@ -35,6 +35,10 @@ public:
 	[[nodiscard]] bool isRemoteLoader() const;
 	void setLoaderPriority(int priority);
 
+	// Any thread.
+	[[nodiscard]] int size() const;
+	void setReadAheadPolicy(Reader::ReadAheadPolicy policy);
+
 	~File();
 
 private:
@@ -43,7 +47,7 @@ private:
 		Context(not_null<FileDelegate*> delegate, not_null<Reader*> reader);
 		~Context();
 
-		void start(crl::time position);
+		void start(crl::time position, bool hwAllowed);
 		void readNextPacket();
 
 		void interrupt();
@@ -74,7 +78,8 @@ private:
 
 		Stream initStream(
 			not_null<AVFormatContext *> format,
-			AVMediaType type);
+			AVMediaType type,
+			bool hwAllowed);
 		void seekToPosition(
 			not_null<AVFormatContext *> format,
 			const Stream &stream,
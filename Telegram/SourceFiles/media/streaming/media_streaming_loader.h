@@ -7,6 +7,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #pragma once
 
+#include "base/bytes.h"
+
 namespace Storage {
 class StreamedFileDownloader;
 } // namespace Storage
@@ -46,6 +48,12 @@ public:
 		not_null<Storage::StreamedFileDownloader*> downloader) = 0;
 	virtual void clearAttachedDownloader() = 0;
 
+	// Whole content available in memory, the Reader copies from it
+	// directly instead of requesting parts.
+	[[nodiscard]] virtual bytes::const_span mappedContent() const {
+		return {};
+	}
+
 	virtual ~Loader() = default;
 
 };
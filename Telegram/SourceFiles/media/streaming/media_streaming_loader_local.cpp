@@ -31,9 +31,25 @@ LoaderLocal::LoaderLocal(std::unique_ptr<QIODevice> device)
 
 	if (!_size || !_device->open(QIODevice::ReadOnly)) {
 		fail();
+	} else {
+		mapContent();
 	}
 }
 
+void LoaderLocal::mapContent() {
+	// Files are not mapped: if one is truncated or replaced while playing,
+	// reading through the mapping crashes with SIGBUS, while the part reads
+	// just fail with an error.
+	if (const auto buffer = qobject_cast<QBuffer*>(_device.get())) {
+		_mapped = bytes::make_span(
+			std::as_const(buffer->buffer())).subspan(0, _size);
+	}
+}
+
+bytes::const_span LoaderLocal::mappedContent() const {
+	return _mapped;
+}
+
 Storage::Cache::Key LoaderLocal::baseCacheKey() const {
 	return {};
 }
@@ -38,11 +38,15 @@ public:
 		not_null<Storage::StreamedFileDownloader*> downloader) override;
 	void clearAttachedDownloader() override;
 
+	[[nodiscard]] bytes::const_span mappedContent() const override;
+
 private:
 	void fail();
+	void mapContent();
 
 	const std::unique_ptr<QIODevice> _device;
 	const int _size = 0;
+	bytes::const_span _mapped;
 	rpl::event_stream<LoadedPart> _parts;
 
 };
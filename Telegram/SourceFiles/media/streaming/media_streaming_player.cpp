@@ -23,6 +23,11 @@ constexpr auto kLoadInAdvanceForRemote = 32 * crl::time(1000);
 constexpr auto kLoadInAdvanceForLocal = 5 * crl::time(1000);
 constexpr auto kMsFrequency = 1000; // 1000 ms per second.
 
+// Reader requests this much playback ahead of the demand
+// and keeps that much playback in memory, computed by average bitrate.
+constexpr auto kReadAheadPlayback = 2 * crl::time(1000);
+constexpr auto kReadMemoryPlayback = 16 * crl::time(1000);
+
 // If we played for 3 seconds and got stuck it looks like we're loading
 // slower than we're playing, so load full file in that case.
 constexpr auto kLoadFullIfStuckAfterPlayback = 3 * crl::time(1000);
@@ -312,9 +317,31 @@ bool Player::fileReady(int headerSize, Stream &&video, Stream &&audio) {
 		_video ? _video->streamDuration() : kTimeUnknown);
 
 	Ensures(_totalDuration > 1);
+	refreshReadAheadPolicy();
 	return true;
 }
 
+void Player::refreshReadAheadPolicy() {
+	if (!_remoteLoader
+		|| _totalDuration <= 1
+		|| _totalDuration == kDurationUnavailable) {
+		return;
+	}
+	const auto bytesPerSecond = int64(_file->size())
+		* kMsFrequency
+		/ _totalDuration;
+	const auto bytesFor = [&](crl::time playback) {
+		const auto result = bytesPerSecond * _options.speed * playback
+			/ kMsFrequency;
+		constexpr auto kMax = float64(std::numeric_limits<int>::max());
+		return int(std::min(result, kMax));
+	};
+	_file->setReadAheadPolicy({
+		.preloadAhead = bytesFor(kReadAheadPlayback),
+		.memoryBudget = bytesFor(kReadMemoryPlayback),
+	});
+}
+
 void Player::fileError(Error error) {
 	_waitingForData = false;
 
@@ -832,6 +859,7 @@ void Player::setSpeed(float64 speed) {
 	}
 	if (_options.speed != speed) {
 		_options.speed = speed;
+		refreshReadAheadPolicy();
 		if (active()) {
 			if (_audio) {
 				_audio->setSpeed(speed);
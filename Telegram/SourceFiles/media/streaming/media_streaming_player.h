@@ -128,6 +128,7 @@ private:
 		const PlaybackOptions &options,
 		crl::time previousReceivedTill);
 	[[nodiscard]] crl::time loadInAdvanceFor() const;
+	void refreshReadAheadPolicy();
 
 	template <typename Track>
 	int durationByPacket(const Track &track, const FFmpeg::Packet &packet);
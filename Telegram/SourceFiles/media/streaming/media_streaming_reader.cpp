@@ -22,11 +22,29 @@ constexpr auto kMaxPartsInHeader = 64;
 constexpr auto kMaxOnlyInHeader = 80 * kPartSize;
 constexpr auto kPartsOutsideFirstSliceGood = 8;
 constexpr auto kSlicesInMemory = 2;
+constexpr auto kMaxSlicesInMemory = 8;
 
-// 1 MB of parts are requested from cloud ahead of reading demand.
+// By default 1 MB of parts are requested from cloud ahead of reading demand.
 constexpr auto kPreloadPartsAhead = 8;
+constexpr auto kMaxPreloadPartsAhead = 32;
 constexpr auto kDownloaderRequestsLimit = 4;
 
+// Container index placed after the media data (MP4 'moov', Matroska Cues)
+// is requested together with the first parts, up to this size.
+constexpr auto kMaxIndexPrefetchParts = 16;
+
+constexpr auto kMp4FileTypeBox = uint32(0x66747970); // 'ftyp'
+constexpr auto kMp4MovieBox = uint32(0x6D6F6F76); // 'moov'
+
+constexpr auto kEbmlHeaderId = uint64(0x1A45DFA3);
+constexpr auto kEbmlVoidId = uint64(0xEC);
+constexpr auto kMatroskaSegmentId = uint64(0x18538067);
+constexpr auto kMatroskaSeekHeadId = uint64(0x114D9B74);
+constexpr auto kMatroskaSeekId = uint64(0x4DBB);
+constexpr auto kMatroskaSeekIdId = uint64(0x53AB);
+constexpr auto kMatroskaSeekPositionId = uint64(0x53AC);
+constexpr auto kMatroskaCuesId = uint64(0x1C53BB6B);
+
 using PartsMap = base::flat_map<int, QByteArray>;
 
 struct ParsedCacheEntry {
@@ -59,6 +77,211 @@ int SlicesCount(int size) {
 	return (size + kInSlice - 1) / kInSlice;
 }
 
+[[nodiscard]] uint64 ReadBigEndian(bytes::const_span data, int count) {
+	Expects(data.size() >= count);
+
+	auto result = uint64();
+	for (auto i = 0; i != count; ++i) {
+		result = (result << 8) | static_cast<uint64>(data[i]);
+	}
+	return result;
+}
+
+struct Mp4Box {
+	uint32 type = 0;
+	int64 size = 0;
+};
+
+[[nodiscard]] std::optional<Mp4Box> ReadMp4Box(bytes::const_span data) {
+	if (data.size() < 8) {
+		return std::nullopt;
+	}
+	auto result = Mp4Box{
+		.type = uint32(ReadBigEndian(data.subspan(4), 4)),
+		.size = int64(ReadBigEndian(data, 4)),
+	};
+	if (result.size == 1) {
+		if (data.size() < 16) {
+			return std::nullopt;
+		}
+		result.size = int64(ReadBigEndian(data.subspan(8), 8));
+	}
+	return (result.size >= 8) ? std::make_optional(result) : std::nullopt;
+}
+
+// The first box that starts outside the first part follows 'mdat'.
+[[nodiscard]] std::optional<int64> FindMp4Index(
+		bytes::const_span data,
+		int64 size) {
+	const auto first = ReadMp4Box(data);
+	if (!first || first->type != kMp4FileTypeBox) {
+		return std::nullopt;
+	}
+	auto offset = int64();
+	while (offset < int64(data.size())) {
+		const auto box = ReadMp4Box(data.subspan(offset));
+		if (!box || box->type == kMp4MovieBox) {
+			return std::nullopt;
+		}
+		offset += box->size;
+	}
+	return (offset < size) ? std::make_optional(offset) : std::nullopt;
+}
+
+struct EbmlElement {
+	uint64 id = 0;
+	int64 size = 0;
+	int headerSize = 0;
+};
+
+// Element ids are compared with the length marker bits kept.
+[[nodiscard]] std::optional<std::pair<uint64, int>> ReadEbmlNumber(
+		bytes::const_span data,
+		bool keepMarker) {
+	if (data.empty()) {
+		return std::nullopt;
+	}
+	const auto first = static_cast<uint64>(data[0]);
+	auto length = 1;
+	while (length <= 8 && !(first & (0x80 >> (length - 1)))) {
+		++length;
+	}
+	if (length > 8 || data.size() < length) {
+		return std::nullopt;
+	}
+	auto result = keepMarker ? first : (first & (0xFF >> length));
+	for (auto i = 1; i != length; ++i) {
+		result = (result << 8) | static_cast<uint64>(data[i]);
+	}
+	return std::make_pair(result, length);
+}
+
+// Elements of unknown size are not accepted, they can't be skipped.
+[[nodiscard]] std::optional<EbmlElement> ReadEbmlElement(
+		bytes::const_span data) {
+	const auto id = ReadEbmlNumber(data, true);
+	if (!id || id->second > 4) {
+		return std::nullopt;
+	}
+	const auto size = ReadEbmlNumber(data.subspan(id->second), false);
+	if (!size
+		|| size->first == (uint64(1) << (7 * size->second)) - 1
+		|| size->first > uint64(std::numeric_limits<int>::max())) {
+		return std::nullopt;
+	}
+	return EbmlElement{
+		.id = id->first,
+		.size = int64(size->first),
+		.headerSize = id->second + size->second,
+	};
+}
+
+[[nodiscard]] std::optional<int64> FindMatroskaCuesInSeekHead(
+		bytes::const_span data,
+		int64 segmentStart) {
+	auto offset = int64();
+	while (offset < int64(data.size())) {
+		const auto seek = ReadEbmlElement(data.subspan(offset));
+		if (!seek
+			|| offset + seek->headerSize + seek->size > int64(data.size())) {
+			return std::nullopt;
+		}
+		const auto content = data.subspan(
+			offset + seek->headerSize,
+			seek->size);
+		offset += seek->headerSize + seek->size;
+		if (seek->id != kMatroskaSeekId) {
+			continue;
+		}
+		auto id = uint64();
+		auto position = std::optional<int64>();
+		auto inner = int64();
+		while (inner < int64(content.size())) {
+			const auto element = ReadEbmlElement(content.subspan(inner));
+			const auto start = inner + (element ? element->headerSize : 0);
+			if (!element
+				|| start + element->size > int64(content.size())
+				|| element->size > 8) {
+				return std::nullopt;
+			}
+			const auto value = ReadBigEndian(
+				content.subspan(start),
+				int(element->size));
+			if (element->id == kMatroskaSeekIdId) {
+				id = value;
+			} else if (element->id == kMatroskaSeekPositionId) {
+				position = int64(value);
+			}
+			inner = start + element->size;
+		}
+		if (id == kMatroskaCuesId && position) {
+			return segmentStart + *position;
+		}
+	}
+	return std::nullopt;
+}
+
+// Cues position is listed in the SeekHead at the start of the Segment.
+[[nodiscard]] std::optional<int64> FindMatroskaIndex(
+		bytes::const_span data) {
+	const auto header = ReadEbmlElement(data);
+	if (!header || header->id != kEbmlHeaderId) {
+		return std::nullopt;
+	}
+	auto offset = int64(header->headerSize + header->size);
+	if (offset >= int64(data.size())) {
+		return std::nullopt;
+	}
+	const auto segmentId = ReadEbmlNumber(data.subspan(offset), true);
+	const auto segmentSize = segmentId
+		? ReadEbmlNumber(data.subspan(offset + segmentId->second), false)
+		: std::nullopt;
+	if (!segmentSize || segmentId->first != kMatroskaSegmentId) {
+		return std::nullopt;
+	}
+	const auto segmentStart = offset
+		+ segmentId->second
+		+ segmentSize->second;
+	offset = segmentStart;
+	while (offset < int64(data.size())) {
+		const auto element = ReadEbmlElement(data.subspan(offset));
+		if (!element
+			|| offset + element->headerSize + element->size
+				> int64(data.size())) {
+			return std::nullopt;
+		} else if (element->id == kMatroskaSeekHeadId) {
+			return FindMatroskaCuesInSeekHead(
+				data.subspan(offset + element->headerSize, element->size),
+				segmentStart);
+		} else if (element->id != kEbmlVoidId) {
+			return std::nullopt;
+		}
+		offset += element->headerSize + element->size;
+	}
+	return std::nullopt;
+}
+
+[[nodiscard]] std::optional<int64> FindContainerIndex(
+		bytes::const_span firstPart,
+		int64 size) {
+	const auto result = FindMp4Index(firstPart, size);
+	return result ? result : FindMatroskaIndex(firstPart);
+}
+
+[[nodiscard]] int64 ContainerIndexSize(bytes::const_span data) {
+	if (const auto box = ReadMp4Box(data)) {
+		if (box->type == kMp4MovieBox) {
+			return box->size;
+		}
+	}
+	if (const auto element = ReadEbmlElement(data)) {
+		if (element->id == kMatroskaCuesId) {
+			return element->headerSize + element->size;
+		}
+	}
+	return 0;
+}
+
 int MaxSliceSize(int sliceNumber, int size) {
 	return !sliceNumber
 		? size
@@ -127,6 +350,7 @@ bytes::const_span ParseCachedMap(
 		if (size > maxSize) {
 			return {};
 		}
+		result.reserve((size + kPartSize - 1) / kPartSize);
 		for (auto offset = 0; offset < size; offset += kPartSize) {
 			const auto part = data.subspan(
 				offset,
@@ -262,14 +486,14 @@ void Reader::Slice::addPart(int offset, QByteArray bytes) {
 	}
 }
 
-auto Reader::Slice::prepareFill(int from, int till) -> PrepareFillResult {
+auto Reader::Slice::prepareFill(int from, int till, int preloadParts)
+-> PrepareFillResult {
 	auto result = PrepareFillResult();
 
 	result.ready = false;
 	const auto fromOffset = (from / kPartSize) * kPartSize;
 	const auto tillPart = (till + kPartSize - 1) / kPartSize;
-	const auto preloadTillOffset = (tillPart + kPreloadPartsAhead)
-		* kPartSize;
+	const auto preloadTillOffset = (tillPart + preloadParts) * kPartSize;
 
 	const auto after = ranges::upper_bound(
 		parts,
@@ -333,7 +557,9 @@ auto Reader::Slice::offsetsFromLoader(int from, int till) const
 }
 
 Reader::Slices::Slices(int size, bool useCache)
-: _size(size) {
+: _size(size)
+, _preloadParts(kPreloadPartsAhead)
+, _slicesInMemory(kSlicesInMemory) {
 	Expects(size > 0);
 
 	if (useCache) {
@@ -350,6 +576,15 @@ bool Reader::Slices::headerModeUnknown() const {
 	return (_headerMode == HeaderMode::Unknown);
 }
 
+bool Reader::Slices::hasPart(int offset) const {
+	if (isFullInHeader()) {
+		return _header.parts.contains(offset);
+	}
+	const auto index = offset / kInSlice;
+	return (index < _data.size())
+		&& _data[index].parts.contains(offset - index * kInSlice);
+}
+
 bool Reader::Slices::isFullInHeader() const {
 	return IsFullInHeader(_size);
 }
@@ -596,9 +831,15 @@ auto Reader::Slices::fill(int offset, bytes::span buffer) -> FillResult {
 	const auto firstTill = std::min(kInSlice, till - fromSlice * kInSlice);
 	const auto secondFrom = 0;
 	const auto secondTill = till - (fromSlice + 1) * kInSlice;
-	const auto first = _data[fromSlice].prepareFill(firstFrom, firstTill);
+	const auto first = _data[fromSlice].prepareFill(
+		firstFrom,
+		firstTill,
+		preloadParts());
 	const auto second = (fromSlice + 1 < tillSlice)
-		? _data[fromSlice + 1].prepareFill(secondFrom, secondTill)
+		? _data[fromSlice + 1].prepareFill(
+			secondFrom,
+			secondTill,
+			preloadParts())
 		: Slice::PrepareFillResult();
 	handlePrepareResult(fromSlice, first);
 	if (fromSlice + 1 < tillSlice) {
@@ -636,7 +877,7 @@ auto Reader::Slices::fillFromHeader(int offset, bytes::span buffer)
 	const auto from = offset;
 	const auto till = int(offset + buffer.size());
 
-	const auto prepared = _header.prepareFill(from, till);
+	const auto prepared = _header.prepareFill(from, till, preloadParts());
 	for (const auto full : prepared.offsetsFromLoader.values()) {
 		if (full < _size) {
 			result.offsetsFromLoader.add(full);
@@ -696,6 +937,16 @@ void Reader::Slices::markSliceUsed(int sliceIndex) {
 	}
 }
 
+void Reader::Slices::setReadAhead(int preloadParts, int slicesInMemory) {
+	_preloadParts = preloadParts;
+	_slicesInMemory = slicesInMemory;
+}
+
+int Reader::Slices::preloadParts() const {
+	// Don't request more than we can keep until it is read.
+	return std::min(_preloadParts, _slicesInMemory * kPartsInSlice);
+}
+
 int Reader::Slices::maxSliceSize(int sliceNumber) const {
 	return MaxSliceSize(sliceNumber, _size);
 }
@@ -704,7 +955,7 @@ Reader::SerializedSlice Reader::Slices::serializeAndUnloadUnused() {
 	using Flag = Slice::Flag;
 
 	if (_headerMode == HeaderMode::Unknown
-		|| _usedSlices.size() <= kSlicesInMemory) {
+		|| _usedSlices.size() <= _slicesInMemory) {
 		return {};
 	}
 	const auto purgeSlice = _usedSlices.front();
@@ -849,6 +1100,7 @@ Reader::Reader(
 	std::unique_ptr<Loader> loader,
 	Storage::Cache::Database *cache)
 : _loader(std::move(loader))
+, _mapped(_loader->mappedContent())
 , _cache(cache)
 , _cacheHelper(cache ? InitCacheHelper(_loader->baseCacheKey()) : nullptr)
 , _slices(_loader->size(), _cacheHelper != nullptr) {
@@ -857,7 +1109,7 @@ Reader::Reader(
 		if (_attachedDownloader) {
 			_partsForDownloader.fire_copy(part);
 		}
-		if (_streamingActive) {
+		if (_streamingActive || _preloadingHead) {
 			_loadedParts.emplace(std::move(part));
 		}
 		if (const auto waiting = _waiting.load(std::memory_order_acquire)) {
@@ -912,6 +1164,7 @@ void Reader::stopStreaming(bool stillActive) {
 	_waiting.store(nullptr, std::memory_order_release);
 	if (!stillActive) {
 		_streamingActive = false;
+		_preloadingHead = false;
 		refreshLoaderPriority();
 		_loadingOffsets.clear();
 		processDownloaderRequests();
@@ -956,6 +1209,19 @@ void Reader::cancelForDownloader(
 	}
 }
 
+void Reader::dropCacheForDownloaded() {
+	if (!_cache || !_cacheHelper) {
+		return;
+	}
+
+	// The whole file is saved to disk, don't keep a second copy in cache.
+	_cacheDropped = true;
+	const auto count = SlicesCount(_loader->size());
+	for (auto i = 0; i <= count; ++i) {
+		_cache->remove(_cacheHelper->key(i));
+	}
+}
+
 void Reader::enqueueDownloaderOffsets() {
 	auto offsets = _downloaderOffsetRequests.take();
 	if (!empty(offsets)) {
@@ -1095,6 +1361,35 @@ void Reader::checkCacheResultsForDownloader() {
 		return;
 	}
 	processDownloaderRequests();
+	checkPreloadHead();
+}
+
+void Reader::preloadHead(int size) {
+	if (_streamingActive || !isRemoteLoader()) {
+		return;
+	}
+	_preloadHeadSize = std::clamp(size, 0, this->size());
+	processCacheResults();
+	checkPreloadHead();
+}
+
+void Reader::checkPreloadHead() {
+	if (!_preloadHeadSize
+		|| _streamingActive
+		|| _slices.waitingForHeaderCache()) {
+		return;
+	}
+	const auto till = base::take(_preloadHeadSize);
+	if (!_slices.headerModeUnknown()) {
+		// The header and the first slice were found in the cache.
+		return;
+	}
+
+	// Parts are kept in _loadedParts until the streaming thread starts.
+	_preloadingHead = true;
+	for (auto offset = 0; offset < till; offset += kPartSize) {
+		loadAtOffset(offset);
+	}
 }
 
 void Reader::setLoaderPriority(int priority) {
@@ -1188,6 +1483,9 @@ void Reader::putToCache(SerializedSlice &&slice) {
 	Expects(_cacheHelper != nullptr);
 	Expects(slice.number >= 0);
 
+	if (_cacheDropped) {
+		return;
+	}
 	_cache->put(_cacheHelper->key(slice.number), std::move(slice.data));
 }
 
@@ -1217,6 +1515,12 @@ Reader::FillState Reader::fill(
 		not_null<crl::semaphore*> notify) {
 	Expects(offset + buffer.size() <= size());
 
+	if (!_mapped.empty()) {
+		bytes::copy(buffer, _mapped.subspan(offset, buffer.size()));
+		registerFillResult(FillState::Success);
+		return FillState::Success;
+	}
+
 	const auto startWaiting = [&] {
 		if (_cacheHelper) {
 			_cacheHelper->waiting = notify.get();
@@ -1239,6 +1543,10 @@ Reader::FillState Reader::fill(
 		return FillState::Failed;
 	};
 
+	if (const auto preload = _preloadParts.load()) {
+		_slices.setReadAhead(preload, _slicesInMemory.load());
+	}
+
 	checkForSomethingMoreReceived();
 	if (_streamingError) {
 		return FillState::Failed;
@@ -1248,12 +1556,57 @@ Reader::FillState Reader::fill(
 	do {
 		lastResult = fillFromSlices(offset, buffer);
 		if (lastResult == FillState::Success) {
+			registerFillResult(lastResult);
 			return done();
 		}
 		startWaiting();
 	} while (checkForSomethingMoreReceived());
 
-	return _streamingError ? failed() : lastResult;
+	if (_streamingError) {
+		return failed();
+	}
+	registerFillResult(lastResult);
+	return lastResult;
+}
+
+void Reader::registerFillResult(FillState state) {
+	++_fillsCount;
+	switch (state) {
+	case FillState::Success:
+		if (_stalledSince) {
+			_stallTime += crl::now() - base::take(_stalledSince);
+		}
+		return;
+	case FillState::WaitingCache: ++_cacheWaits; break;
+	case FillState::WaitingRemote: ++_remoteWaits; break;
+	case FillState::Failed: return;
+	}
+	if (!_stalledSince) {
+		_stalledSince = crl::now();
+	}
+}
+
+void Reader::setReadAheadPolicy(ReadAheadPolicy policy) {
+	const auto preload = std::clamp(
+		policy.preloadAhead / kPartSize,
+		kPreloadPartsAhead,
+		kMaxPreloadPartsAhead);
+	const auto slices = std::clamp(
+		policy.memoryBudget / kInSlice,
+		kSlicesInMemory,
+		kMaxSlicesInMemory);
+	_slicesInMemory = slices;
+	_preloadParts = preload;
+}
+
+Reader::Metrics Reader::metrics() const {
+	return {
+		.fills = _fillsCount.load(),
+		.cacheHits = _cacheHits.load(),
+		.cacheWaits = _cacheWaits.load(),
+		.remoteWaits = _remoteWaits.load(),
+		.stallTime = _stallTime.load(),
+	};
 }
 
 Reader::FillState Reader::fillFromSlices(int offset, bytes::span buffer) {
@@ -1329,6 +1682,9 @@ bool Reader::processCacheResults() {
 		return false;
 	}
 	for (auto &[sliceNumber, result] : loaded) {
+		if (!result.empty()) {
+			++_cacheHits;
+		}
 		_slices.processCacheResult(sliceNumber, std::move(result));
 	}
 	if (!sizes.empty()) {
@@ -1356,6 +1712,7 @@ bool Reader::processLoadedParts() {
 		} else if (!_loadingOffsets.remove(part.offset)) {
 			continue;
 		}
+		checkIndexPrefetch(part);
 		_slices.processPart(
 			part.offset,
 			std::move(part.bytes));
@@ -1369,6 +1726,44 @@ bool Reader::checkForSomethingMoreReceived() {
 	return result1 || result2;
 }
 
+void Reader::checkIndexPrefetch(const LoadedPart &part) {
+	const auto data = bytes::make_span(part.bytes);
+	if (!part.offset && !_indexSearched) {
+		_indexSearched = true;
+
+		// Only when the header is not known from cache yet.
+		if (!_slices.headerModeUnknown() || _slices.isFullInHeader()) {
+			return;
+		}
+		const auto found = FindContainerIndex(data, size());
+		if (found && *found >= kPartSize && *found < size()) {
+			_indexOffset = int(*found);
+			prefetchIndex(_indexOffset, _indexOffset + 1);
+		}
+	} else if (_indexOffset >= part.offset
+		&& _indexOffset < part.offset + int(data.size())) {
+		const auto from = _indexOffset;
+		_indexOffset = -1;
+
+		const auto indexSize = ContainerIndexSize(
+			data.subspan(from - part.offset));
+		const auto till = from + std::min(
+			indexSize,
+			int64(kMaxIndexPrefetchParts * kPartSize));
+		prefetchIndex(part.offset + kPartSize, int(till));
+	}
+}
+
+void Reader::prefetchIndex(int from, int till) {
+	const auto last = std::min(till, size());
+	auto offset = (from / kPartSize) * kPartSize;
+	for (; offset < last; offset += kPartSize) {
+		if (!_slices.hasPart(offset)) {
+			loadAtOffset(offset);
+		}
+	}
+}
+
 void Reader::loadAtOffset(int offset) {
 	if (_loadingOffsets.add(offset)) {
 		_loader->load(offset);
@@ -1393,6 +1788,17 @@ void Reader::finalizeCache() {
 }
 
 Reader::~Reader() {
+	if (const auto metrics = this->metrics(); metrics.fills > 0) {
+		DEBUG_LOG(("Streaming Info: Reader of %1 bytes, fills: %2, "
+			"cache hits: %3, cache waits: %4, remote waits: %5, "
+			"stalled: %6 ms."
+			).arg(size()
+			).arg(metrics.fills
+			).arg(metrics.cacheHits
+			).arg(metrics.cacheWaits
+			).arg(metrics.remoteWaits
+			).arg(metrics.stallTime));
+	}
 	finalizeCache();
 }
 
@@ -38,6 +38,17 @@ public:
 		WaitingRemote,
 		Failed,
 	};
+	struct ReadAheadPolicy {
+		int preloadAhead = 0; // Bytes requested ahead of reading demand.
+		int memoryBudget = 0; // Bytes of slices kept in memory.
+	};
+	struct Metrics {
+		int fills = 0;
+		int cacheHits = 0;
+		int cacheWaits = 0;
+		int remoteWaits = 0;
+		crl::time stallTime = 0;
+	};
 
 	// Main thread.
 	explicit Reader(
@@ -49,6 +60,8 @@ public:
 	// Any thread.
 	[[nodiscard]] int size() const;
 	[[nodiscard]] bool isRemoteLoader() const;
+	void setReadAheadPolicy(ReadAheadPolicy policy);
+	[[nodiscard]] Metrics metrics() const;
 
 	// Single thread.
 	[[nodiscard]] FillState fill(
@@ -70,6 +83,7 @@ public:
 	// Main thread.
 	void startStreaming();
 	void stopStreaming(bool stillActive = false);
+	void preloadHead(int size);
 	[[nodiscard]] rpl::producer<LoadedPart> partsForDownloader() const;
 	void loadForDownloader(
 		not_null<Storage::StreamedFileDownloader*> downloader,
@@ -77,11 +91,12 @@ public:
 	void doneForDownloader(int offset);
 	void cancelForDownloader(
 		not_null<Storage::StreamedFileDownloader*> downloader);
+	void dropCacheForDownloaded();
 
 	~Reader();
 
 private:
-	static constexpr auto kLoadFromRemoteMax = 8;
+	static constexpr auto kLoadFromRemoteMax = 16;
 
 	struct CacheHelper;
 
@@ -129,7 +144,7 @@ private:
 
 		void processCacheData(PartsMap &&data);
 		void addPart(int offset, QByteArray bytes);
-		PrepareFillResult prepareFill(int from, int till);
+		PrepareFillResult prepareFill(int from, int till, int preloadParts);
 
 		// Get up to kLoadFromRemoteMax not loaded parts in from-till range.
 		StackIntVector<kLoadFromRemoteMax> offsetsFromLoader(
@@ -152,9 +167,11 @@ private:
 		[[nodiscard]] bool headerModeUnknown() const;
 		[[nodiscard]] bool isFullInHeader() const;
 		[[nodiscard]] bool isGoodHeader() const;
+		[[nodiscard]] bool hasPart(int offset) const;
 		[[nodiscard]] bool waitingForHeaderCache() const;
 
 		[[nodiscard]] int requestSliceSizesCount() const;
+		void setReadAhead(int preloadParts, int slicesInMemory);
 
 		void processCacheResult(int sliceNumber, PartsMap &&result);
 		void processCachedSizes(const std::vector<int> &sizes);
@@ -188,6 +205,7 @@ private:
 		[[nodiscard]] FillResult fillFromHeader(
 			int offset,
 			bytes::span buffer);
+		[[nodiscard]] int preloadParts() const;
 		void unloadSlice(Slice &slice) const;
 		void checkSliceFullLoaded(int sliceNumber);
 		[[nodiscard]] bool checkFullInCache() const;
@@ -198,6 +216,8 @@ private:
 		int _size = 0;
 		HeaderMode _headerMode = HeaderMode::Unknown;
 		bool _fullInCache = false;
+		int _preloadParts = 0;
+		int _slicesInMemory = 0;
 
 	};
 
@@ -212,15 +232,19 @@ private:
 	void loadAtOffset(int offset);
 	void checkLoadWillBeFirst(int offset);
 	bool processLoadedParts();
+	void checkIndexPrefetch(const LoadedPart &part);
+	void prefetchIndex(int from, int till);
 
 	bool checkForSomethingMoreReceived();
 
 	FillState fillFromSlices(int offset, bytes::span buffer);
+	void registerFillResult(FillState state);
 
 	void finalizeCache();
 
 	void processDownloaderRequests();
 	void checkCacheResultsForDownloader();
+	void checkPreloadHead();
 	void pruneDownloaderCache(int minimalOffset);
 	void pruneDoneDownloaderRequests();
 	void sendDownloaderRequests();
@@ -235,6 +259,7 @@ private:
 		Storage::Cache::Key baseKey);
 
 	const std::unique_ptr<Loader> _loader;
+	const bytes::const_span _mapped;
 	Storage::Cache::Database * const _cache = nullptr;
 
 	// shared_ptr is used to be able to have weak_ptr.
@@ -244,10 +269,27 @@ private:
 	std::atomic<crl::semaphore*> _waiting = nullptr;
 	std::atomic<crl::semaphore*> _sleeping = nullptr;
 	std::atomic<bool> _stopStreamingAsync = false;
+	std::atomic<bool> _cacheDropped = false;
 	PriorityQueue _loadingOffsets;
 
+	// Read-ahead policy can be changed from any thread.
+	std::atomic<int> _preloadParts = 0;
+	std::atomic<int> _slicesInMemory = 0;
+
+	// Metrics are written in the streaming thread, read from any thread.
+	std::atomic<int> _fillsCount = 0;
+	std::atomic<int> _cacheHits = 0;
+	std::atomic<int> _cacheWaits = 0;
+	std::atomic<int> _remoteWaits = 0;
+	std::atomic<crl::time> _stallTime = 0;
+	crl::time _stalledSince = 0;
+
 	Slices _slices;
 
+	// Container index found after the media data is prefetched early.
+	int _indexOffset = -1;
+	bool _indexSearched = false;
+
 	// Even if streaming had failed, the Reader can work for the downloader.
 	std::optional<Error> _streamingError;
 
@@ -258,6 +300,8 @@ private:
 	Storage::StreamedFileDownloader *_attachedDownloader = nullptr;
 	rpl::event_stream<LoadedPart> _partsForDownloader;
 	int _realPriority = 1;
+	int _preloadHeadSize = 0;
+	bool _preloadingHead = false;
 	bool _streamingActive = false;
 
 	// Streaming thread.
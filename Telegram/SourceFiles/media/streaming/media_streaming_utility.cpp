@@ -74,8 +74,11 @@ FFmpeg::AvErrorWrap ReadNextFrame(Stream &stream) {
 		error = avcodec_receive_frame(
 			stream.codec.get(),
 			stream.frame.get());
-		if (!error
-			|| error.code() != AVERROR(EAGAIN)
+		if (!error) {
+			return FFmpeg::TransferHwFrame(
+				stream.frame.get(),
+				stream.transferredFrame);
+		} else if (error.code() != AVERROR(EAGAIN)
 			|| stream.queue.empty()) {
 			return error;
 		}
@@ -271,6 +274,20 @@ void ApplyFrameRounding(QImage &storage, const FrameRequest &request) {
 	Images::prepareRound(storage, request.radius, request.corners);
 }
 
+void CopyFrameContent(QImage &storage, const QImage &original) {
+	Expects(storage.size() == original.size());
+	Expects(storage.format() == original.format());
+
+	const auto perLine = original.width() * FFmpeg::kPixelBytesSize;
+	auto from = original.constBits();
+	auto to = storage.bits();
+	for (auto y = 0, height = original.height(); y != height; ++y) {
+		memcpy(to, from, perLine);
+		from += original.bytesPerLine();
+		to += storage.bytesPerLine();
+	}
+}
+
 QImage PrepareByRequest(
 		const QImage &original,
 		bool alpha,
@@ -286,6 +303,18 @@ QImage PrepareByRequest(
 		storage = FFmpeg::CreateFrameStorage(outer);
 	}
 
+	// Rounded inline videos usually are already converted and scaled to
+	// the requested size, so only the corners are left to be applied.
+	if (!alpha
+		&& !rotation
+		&& (original.size() == outer)
+		&& (request.resize.isEmpty() || request.resize == outer)
+		&& (original.format() == storage.format())) {
+		CopyFrameContent(storage, original);
+		ApplyFrameRounding(storage, request);
+		return storage;
+	}
+
 	QPainter p(&storage);
 	PaintFrameContent(p, original, alpha, rotation, request);
 	p.end();
@@ -19,6 +19,10 @@ constexpr auto kDisplaySkipped = crl::time(-1);
 constexpr auto kFinishedPosition = std::numeric_limits<crl::time>::max();
 static_assert(kDisplaySkipped != kTimeUnknown);
 
+// If all frames are shown at least this many times smaller by area
+// the deblocking filter is skipped, its artifacts vanish in downscale.
+constexpr auto kSkipLoopFilterScale = 4;
+
 } // namespace
 
 class VideoTrackObject final {
@@ -78,6 +82,7 @@ private:
 	[[nodiscard]] FrameResult readFrame(not_null<Frame*> frame);
 	void fillRequests(not_null<Frame*> frame) const;
 	[[nodiscard]] QSize chooseOriginalResize() const;
+	void refreshDecodingMode();
 	void presentFrameIfNeeded();
 	void callReady();
 	[[nodiscard]] bool loopAround();
@@ -109,6 +114,7 @@ private:
 	rpl::event_stream<> _checkNextFrame;
 	rpl::event_stream<> _waitingForData;
 	base::flat_map<const Instance*, FrameRequest> _requests;
+	bool _skipLoopFilter = false;
 
 	bool _queued = false;
 	base::ConcurrentTimer _readFramesTimer;
@@ -475,10 +481,27 @@ void VideoTrackObject::updateFrameRequest(
 		const Instance *instance,
 		const FrameRequest &request) {
 	_requests.emplace(instance, request);
+	refreshDecodingMode();
 }
 
 void VideoTrackObject::removeFrameRequest(const Instance *instance) {
 	_requests.remove(instance);
+	refreshDecodingMode();
+}
+
+void VideoTrackObject::refreshDecodingMode() {
+	const auto codec = _stream.codec.get();
+	if (!codec) {
+		return;
+	}
+	const auto resize = chooseOriginalResize();
+	const auto skip = !resize.isEmpty()
+		&& (resize.width() * resize.height() * kSkipLoopFilterScale
+			<= codec->width * codec->height);
+	if (_skipLoopFilter != skip) {
+		_skipLoopFilter = skip;
+		codec->skip_loop_filter = skip ? AVDISCARD_ALL : AVDISCARD_DEFAULT;
+	}
 }
 
 bool VideoTrackObject::tryReadFirstFrame(FFmpeg::Packet &&packet) {
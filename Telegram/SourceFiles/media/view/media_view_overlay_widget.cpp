@@ -82,7 +82,9 @@ namespace Media {
 namespace View {
 namespace {
 
-constexpr auto kPreloadCount = 3;
+// Items preloaded in the direction of moving and behind the current one.
+constexpr auto kPreloadAhead = 3;
+constexpr auto kPreloadBehind = 1;
 constexpr auto kMaxZoomLevel = 7; // x8
 constexpr auto kZoomToScreenLevel = 1024;
 constexpr auto kOverlayLoaderPriority = 2;
@@ -2609,6 +2611,18 @@ QImage OverlayWidget::transformStaticContent(QPixmap content) const {
 		: content.toImage();
 }
 
+const QImage &OverlayWidget::transformedStaticContent() {
+	// Rotating a large image takes long, so don't do it on each paint.
+	const auto key = _staticContent.cacheKey();
+	if (_staticContentTransformedKey != key
+		|| _staticContentTransformedRotation != _rotation) {
+		_staticContentTransformed = transformStaticContent(_staticContent);
+		_staticContentTransformedKey = key;
+		_staticContentTransformedRotation = _rotation;
+	}
+	return _staticContentTransformed;
+}
+
 void OverlayWidget::handleStreamingUpdate(Streaming::Update &&update) {
 	using namespace Streaming;
 
@@ -3362,7 +3376,7 @@ void OverlayWidget::paintTransformedStaticContent(Painter &p) {
 			p.restore();
 		}
 	} else {
-		p.drawImage(rect, transformStaticContent(_staticContent));
+		p.drawImage(rect, transformedStaticContent());
 	}
 }
 
@@ -3838,8 +3852,9 @@ void OverlayWidget::preloadData(int delta) {
 	if (!_index) {
 		return;
 	}
-	auto from = *_index + (delta ? delta : -1);
-	auto till = *_index + (delta ? delta * kPreloadCount : 1);
+	const auto direction = (delta < 0) ? -1 : 1;
+	auto from = *_index - (delta ? direction * kPreloadBehind : 1);
+	auto till = *_index + (delta ? direction * kPreloadAhead : 1);
 	if (from > till) std::swap(from, till);
 
 	auto photos = base::flat_set<std::shared_ptr<Data::PhotoMedia>>();
@@ -3848,20 +3863,75 @@ void OverlayWidget::preloadData(int delta) {
 		auto entity = entityByIndex(index);
 		if (auto photo = std::get_if<not_null<PhotoData*>>(&entity.data)) {
 			const auto [i, ok] = photos.emplace((*photo)->createMediaView());
+			const auto wasLoading = (*photo)->loading();
 			(*i)->wanted(Data::PhotoSize::Small, fileOrigin(entity));
 			(*photo)->load(fileOrigin(entity), LoadFromCloudOrLocal, true);
+			if (!wasLoading && (*photo)->loading() && index != *_index) {
+				_preloadStartedPhotos.emplace(*photo);
+			}
 		} else if (auto document = std::get_if<not_null<DocumentData*>>(
 				&entity.data)) {
 			const auto [i, ok] = documents.emplace(
 				(*document)->createMediaView());
 			(*i)->thumbnailWanted(fileOrigin(entity));
 			if (!(*i)->canBePlayed()) {
+				const auto wasLoading = (*document)->loading();
 				(*i)->automaticLoad(fileOrigin(entity), entity.item);
+				if (!wasLoading
+					&& (*document)->loading()
+					&& index != *_index) {
+					_preloadStartedDocuments.emplace(*document);
+				}
 			}
 		}
 	}
 	_preloadPhotos = std::move(photos);
 	_preloadDocuments = std::move(documents);
+	cancelAbandonedPreloads();
+}
+
+void OverlayWidget::cancelAbandonedPreloads() {
+	// Only the loads started by preloadData() are cancelled here.
+	// They are not cancelled by the user, so the cancelled state is reset
+	// right away and the files still can be loaded automatically later.
+	const auto photoKept = [&](not_null<PhotoData*> photo) {
+		return (photo == _photo) || ranges::contains(
+			_preloadPhotos,
+			photo,
+			&Data::PhotoMedia::owner);
+	};
+	const auto documentKept = [&](not_null<DocumentData*> document) {
+		return (document == _document) || ranges::contains(
+			_preloadDocuments,
+			document,
+			&Data::DocumentMedia::owner);
+	};
+	for (auto i = begin(_preloadStartedPhotos)
+		; i != end(_preloadStartedPhotos);) {
+		const auto photo = *i;
+		if (!photo->loading()) {
+			i = _preloadStartedPhotos.erase(i);
+		} else if (!photoKept(photo)) {
+			photo->cancel();
+			photo->automaticLoadSettingsChanged();
+			i = _preloadStartedPhotos.erase(i);
+		} else {
+			++i;
+		}
+	}
+	for (auto i = begin(_preloadStartedDocuments)
+		; i != end(_preloadStartedDocuments);) {
+		const auto document = *i;
+		if (!document->loading()) {
+			i = _preloadStartedDocuments.erase(i);
+		} else if (!documentKept(document)) {
+			document->cancel();
+			document->automaticLoadSettingsChanged();
+			i = _preloadStartedDocuments.erase(i);
+		} else {
+			++i;
+		}
+	}
 }
 
 void OverlayWidget::mousePressEvent(QMouseEvent *e) {
@@ -4320,6 +4390,7 @@ void OverlayWidget::setVisibleHook(bool visible) {
 		assignMediaPointer(nullptr);
 		_preloadPhotos.clear();
 		_preloadDocuments.clear();
+		cancelAbandonedPreloads();
 		if (_menu) {
 			_menu->hideMenu(true);
 		}
@@ -4339,6 +4410,7 @@ void OverlayWidget::setVisibleHook(bool visible) {
 		destroyThemePreview();
 		_radial.stop();
 		_staticContent = QPixmap();
+		_staticContentTransformed = QImage();
 		_themePreview = nullptr;
 		_themeApply.destroyDelayed();
 		_themeCancel.destroyDelayed();
@@ -217,6 +217,7 @@ private:
 	void updateGeometry();
 	bool moveToNext(int delta);
 	void preloadData(int delta);
+	void cancelAbandonedPreloads();
 
 	void handleVisibleChanged(bool visible);
 	void handleScreenChanged(QScreen *screen);
@@ -374,6 +375,7 @@ private:
 	[[nodiscard]] QImage videoFrameForDirectPaint() const;
 	[[nodiscard]] QImage transformVideoFrame(QImage frame) const;
 	[[nodiscard]] QImage transformStaticContent(QPixmap content) const;
+	[[nodiscard]] const QImage &transformedStaticContent();
 	[[nodiscard]] bool documentContentShown() const;
 	[[nodiscard]] bool documentBubbleShown() const;
 	void paintTransformedVideoFrame(Painter &p);
@@ -393,6 +395,8 @@ private:
 	std::shared_ptr<Data::DocumentMedia> _documentMedia;
 	base::flat_set<std::shared_ptr<Data::PhotoMedia>> _preloadPhotos;
 	base::flat_set<std::shared_ptr<Data::DocumentMedia>> _preloadDocuments;
+	base::flat_set<not_null<PhotoData*>> _preloadStartedPhotos;
+	base::flat_set<not_null<DocumentData*>> _preloadStartedDocuments;
 	int _rotation = 0;
 	std::unique_ptr<SharedMedia> _sharedMedia;
 	std::optional<SharedMediaWithLastSlice> _sharedMediaData;
@@ -438,6 +442,9 @@ private:
 	bool _pressed = false;
 	int32 _dragging = 0;
 	QPixmap _staticContent;
+	QImage _staticContentTransformed;
+	qint64 _staticContentTransformedKey = 0;
+	int _staticContentTransformedRotation = 0;
 	bool _blurred = true;
 
 	std::unique_ptr<Streamed> _streamed;
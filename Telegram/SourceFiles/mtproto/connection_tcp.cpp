@@ -24,6 +24,9 @@ constexpr auto kPacketSizeMax = int(0x01000000 * sizeof(mtpPrime));
 constexpr auto kFullConnectionTimeout = 8 * crl::time(1000);
 constexpr auto kSmallBufferSize = 256 * 1024;
 constexpr auto kMinPacketBuffer = 256;
+
+// Keep the memory of the large read buffer between packets up to this size.
+constexpr auto kMaxKeptLargeBufferSize = 2 * 1024 * 1024;
 constexpr auto kConnectionStartPrefixSize = 64;
 
 } // namespace
@@ -262,14 +265,18 @@ void TcpConnection::ensureAvailableInBuffer(int amount) {
 	if (amount <= _smallBuffer.size()) {
 		if (_usingLargeBuffer) {
 			bytes::copy(_smallBuffer, read);
-			_usingLargeBuffer = false;
-			_largeBuffer.clear();
+			releaseLargeBuffer();
 		} else {
 			bytes::move(_smallBuffer, read);
 		}
 	} else if (amount <= _largeBuffer.size()) {
 		Assert(_usingLargeBuffer);
 		bytes::move(_largeBuffer, read);
+	} else if (!_usingLargeBuffer && amount <= _largeBuffer.capacity()) {
+		// Reuse the memory kept from one of the previous large packets.
+		_largeBuffer.resize(amount);
+		bytes::copy(_largeBuffer, read);
+		_usingLargeBuffer = true;
 	} else {
 		auto enough = bytes::vector(amount);
 		bytes::copy(enough, read);
@@ -279,6 +286,15 @@ void TcpConnection::ensureAvailableInBuffer(int amount) {
 	_offsetBytes = 0;
 }
 
+void TcpConnection::releaseLargeBuffer() {
+	_usingLargeBuffer = false;
+	if (_largeBuffer.capacity() > kMaxKeptLargeBufferSize) {
+		_largeBuffer = bytes::vector();
+	} else {
+		_largeBuffer.clear();
+	}
+}
+
 void TcpConnection::socketRead() {
 	Expects(_leftBytes > 0 || !_usingLargeBuffer);
 
@@ -316,8 +332,7 @@ void TcpConnection::socketRead() {
 						return;
 					}
 
-					_usingLargeBuffer = false;
-					_largeBuffer.clear();
+					releaseLargeBuffer();
 					_offsetBytes = _readBytes = 0;
 				} else {
 					TCP_LOG(("TCP Info: not enough %1 for packet! read %2"
@@ -586,7 +601,7 @@ void TcpConnection::socketPacket(bytes::const_span bytes) {
 	Expects(_socket != nullptr);
 
 	// old quickack?..
-	const auto data = parsePacket(bytes);
+	auto data = parsePacket(bytes);
 	if (data.size() == 1) {
 		if (data[0] != 0) {
 			emit error(data[0]);
@@ -596,7 +611,7 @@ void TcpConnection::socketPacket(bytes::const_span bytes) {
 	//} else if (data.size() == 2) {
 		// new quickack?..
 	} else if (_status == Status::Ready) {
-		_receivedQueue.push_back(data);
+		_receivedQueue.push_back(std::move(data));
 		emit receivedData();
 	} else if (_status == Status::Waiting) {
 		if (const auto res_pq = readPQFakeReply(data)) {
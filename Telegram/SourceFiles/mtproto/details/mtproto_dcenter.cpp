@@ -11,6 +11,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/mtproto_auth_key.h"
 #include "mtproto/mtproto_dc_options.h"
 #include "mtproto/mtp_instance.h"
+#include "mtproto/session.h"
 #include "mtproto/special_config_request.h"
 
 namespace MTP {
@@ -86,6 +87,23 @@ bool Dcenter::destroyTemporaryKey(uint64 keyId) {
 	return false;
 }
 
+void Dcenter::registerSession(not_null<SessionData*> data) {
+	QMutexLocker lock(&_sessionsMutex);
+	_sessions.push_back(data);
+}
+
+void Dcenter::unregisterSession(not_null<SessionData*> data) {
+	QMutexLocker lock(&_sessionsMutex);
+	_sessions.erase(ranges::remove(_sessions, data), end(_sessions));
+}
+
+bool Dcenter::sessionsIdle() const {
+	QMutexLocker lock(&_sessionsMutex);
+	return ranges::all_of(_sessions, [](not_null<SessionData*> data) {
+		return data->idle();
+	});
+}
+
 bool Dcenter::destroyConfirmedForgottenKey(uint64 keyId) {
 	QWriteLocker lock(&_mutex);
 	if (!_persistentKey || _persistentKey->keyId() != keyId) {
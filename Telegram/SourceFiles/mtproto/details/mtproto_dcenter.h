@@ -18,6 +18,8 @@ enum class DcType;
 
 namespace details {
 
+class SessionData;
+
 enum class TemporaryKeyType {
 	Regular,
 	MediaCluster
@@ -53,6 +55,12 @@ public:
 	[[nodiscard]] bool connectionInited() const;
 	void setConnectionInited(bool connectionInited = true);
 
+	// All sessions of this dc share its temporary keys, so a key can be
+	// replaced without breaking requests only when all of them are idle.
+	void registerSession(not_null<SessionData*> data);
+	void unregisterSession(not_null<SessionData*> data);
+	[[nodiscard]] bool sessionsIdle() const;
+
 private:
 	static constexpr auto kTemporaryKeysCount = 2;
 
@@ -64,6 +72,9 @@ private:
 	bool _connectionInited = false;
 	std::atomic<bool> _creatingKeys[kTemporaryKeysCount] = { false };
 
+	mutable QMutex _sessionsMutex;
+	std::vector<not_null<SessionData*>> _sessions;
+
 };
 
 } // namespace details
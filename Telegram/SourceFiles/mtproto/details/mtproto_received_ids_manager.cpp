@@ -10,10 +10,10 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace MTP::details {
 
 bool ReceivedIdsManager::registerMsgId(mtpMsgId msgId, bool needAck) {
-	const auto i = _idsNeedAck.find(msgId);
-	if (i == _idsNeedAck.end()) {
+	const auto i = findNotLess(msgId);
+	if (i == _idsNeedAck.end() || i->msgId != msgId) {
 		if (_idsNeedAck.size() < kIdsBufferSize || msgId > min()) {
-			_idsNeedAck.emplace(msgId, needAck);
+			_idsNeedAck.insert(i, Entry{ msgId, needAck });
 			return true;
 		}
 		MTP_LOG(-1, ("No need to handle - %1 < min = %2").arg(msgId).arg(min()));
@@ -24,26 +24,24 @@ bool ReceivedIdsManager::registerMsgId(mtpMsgId msgId, bool needAck) {
 }
 
 mtpMsgId ReceivedIdsManager::min() const {
-	return _idsNeedAck.empty() ? 0 : _idsNeedAck.begin()->first;
+	return _idsNeedAck.empty() ? 0 : _idsNeedAck.front().msgId;
 }
 
 mtpMsgId ReceivedIdsManager::max() const {
-	auto end = _idsNeedAck.end();
-	return _idsNeedAck.empty() ? 0 : (--end)->first;
+	return _idsNeedAck.empty() ? 0 : _idsNeedAck.back().msgId;
 }
 
 ReceivedIdsManager::State ReceivedIdsManager::lookup(mtpMsgId msgId) const {
-	auto i = _idsNeedAck.find(msgId);
-	if (i == _idsNeedAck.end()) {
+	const auto i = findNotLess(msgId);
+	if (i == _idsNeedAck.end() || i->msgId != msgId) {
 		return State::NotFound;
 	}
-	return i->second ? State::NeedsAck : State::NoAckNeeded;
+	return i->needAck ? State::NeedsAck : State::NoAckNeeded;
 }
 
 void ReceivedIdsManager::shrink() {
-	auto size = _idsNeedAck.size();
-	while (size-- > kIdsBufferSize) {
-		_idsNeedAck.erase(_idsNeedAck.begin());
+	while (_idsNeedAck.size() > kIdsBufferSize) {
+		_idsNeedAck.pop_front();
 	}
 }
 
@@ -51,4 +49,21 @@ void ReceivedIdsManager::clear() {
 	_idsNeedAck.clear();
 }
 
+auto ReceivedIdsManager::findNotLess(mtpMsgId msgId)
+-> std::deque<Entry>::iterator {
+	// Fast path for the usual case of a new id larger than all known.
+	if (_idsNeedAck.empty() || _idsNeedAck.back().msgId < msgId) {
+		return _idsNeedAck.end();
+	}
+	return ranges::lower_bound(_idsNeedAck, msgId, ranges::less(), &Entry::msgId);
+}
+
+auto ReceivedIdsManager::findNotLess(mtpMsgId msgId) const
+-> std::deque<Entry>::const_iterator {
+	if (_idsNeedAck.empty() || _idsNeedAck.back().msgId < msgId) {
+		return _idsNeedAck.end();
+	}
+	return ranges::lower_bound(_idsNeedAck, msgId, ranges::less(), &Entry::msgId);
+}
+
 } // namespace MTP::details
@@ -7,7 +7,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #pragma once
 
-#include "base/flat_map.h"
+#include <deque>
 
 namespace MTP::details {
 
@@ -31,7 +31,19 @@ public:
 	void clear();
 
 private:
-	base::flat_map<mtpMsgId, bool> _idsNeedAck;
+	struct Entry {
+		mtpMsgId msgId = 0;
+		bool needAck = false;
+	};
+
+	// Sorted by msgId. Ids mostly come in increasing order, so new ones
+	// are appended at the back and shrink() pops old ones from the front.
+	std::deque<Entry> _idsNeedAck;
+
+	[[nodiscard]] auto findNotLess(mtpMsgId msgId)
+		-> std::deque<Entry>::iterator;
+	[[nodiscard]] auto findNotLess(mtpMsgId msgId) const
+		-> std::deque<Entry>::const_iterator;
 
 };
 
@@ -32,6 +32,10 @@ constexpr auto kClientPartSize = 2878;
 const auto kClientPrefix = qstr("\x14\x03\x03\x00\x01\x01");
 const auto kClientHeader = qstr("\x17\x03\x03");
 
+// Consumed incoming bytes are dropped from the buffer only when they
+// take at least half of it, so that each byte is moved at most once.
+constexpr auto kMinIncomingCompactOffset = 16 * 1024;
+
 using BigNum = openssl::BigNum;
 using BigNumContext = openssl::Context;
 
@@ -509,6 +513,8 @@ void TlsSocket::plainConnected() {
 void TlsSocket::plainDisconnected() {
 	_state = State::NotConnected;
 	_incoming = QByteArray();
+	_incomingOffset = 0;
+	_outgoing.clear();
 	_serverHelloLength = 0;
 	_incomingGoodDataOffset = 0;
 	_incomingGoodDataLimit = 0;
@@ -592,6 +598,8 @@ void TlsSocket::checkHelloParts34(int parts123Size) {
 }
 
 void TlsSocket::checkHelloDigest() {
+	Expects(_incomingOffset == 0);
+
 	const auto fulldata = bytes::make_detached_span(_incoming).subspan(
 		0,
 		kHelloDigestLength + _serverHelloLength);
@@ -607,7 +615,7 @@ void TlsSocket::checkHelloDigest() {
 		return;
 	}
 	shiftIncomingBy(fulldata.size());
-	if (!_incoming.isEmpty()) {
+	if (incomingSize() > 0) {
 		InvokeQueued(this, [=] {
 			if (!checkNextPacket()) {
 				handleError();
@@ -623,6 +631,7 @@ void TlsSocket::readData() {
 	if (!isConnected()) {
 		return;
 	}
+	compactIncoming();
 	_incoming.append(_socket.readAll());
 	if (!checkNextPacket()) {
 		handleError();
@@ -633,7 +642,7 @@ void TlsSocket::readData() {
 
 bool TlsSocket::checkNextPacket() {
 	auto offset = 0;
-	const auto incoming = bytes::make_span(_incoming);
+	const auto incoming = bytes::make_span(_incoming).subspan(_incomingOffset);
 	while (!_incomingGoodDataLimit) {
 		const auto fullHeader = kServerHeader.size() + kLengthSize;
 		if (incoming.size() <= offset + fullHeader) {
@@ -663,15 +672,30 @@ void TlsSocket::shiftIncomingBy(int amount) {
 	Expects(_incomingGoodDataOffset == 0);
 	Expects(_incomingGoodDataLimit == 0);
 
-	const auto incoming = bytes::make_detached_span(_incoming);
-	if (incoming.size() > amount) {
-		bytes::move(incoming, incoming.subspan(amount));
-		_incoming.chop(amount);
-	} else {
+	_incomingOffset += amount;
+	if (_incomingOffset >= _incoming.size()) {
 		_incoming.clear();
+		_incomingOffset = 0;
+	} else if (_incomingOffset >= kMinIncomingCompactOffset
+		&& _incomingOffset * 2 >= _incoming.size()) {
+		compactIncoming();
 	}
 }
 
+void TlsSocket::compactIncoming() {
+	if (!_incomingOffset) {
+		return;
+	}
+	const auto incoming = bytes::make_detached_span(_incoming);
+	bytes::move(incoming, incoming.subspan(_incomingOffset));
+	_incoming.chop(_incomingOffset);
+	_incomingOffset = 0;
+}
+
+int TlsSocket::incomingSize() const {
+	return _incoming.size() - _incomingOffset;
+}
+
 void TlsSocket::connectToHost(const QString &address, int port) {
 	Expects(_state == State::NotConnected);
 
@@ -693,7 +717,7 @@ bool TlsSocket::isConnected() {
 
 bool TlsSocket::hasBytesAvailable() {
 	return (_incomingGoodDataLimit > 0)
-		&& (_incomingGoodDataOffset < _incoming.size());
+		&& (_incomingGoodDataOffset < incomingSize());
 }
 
 int64 TlsSocket::read(bytes::span buffer) {
@@ -701,7 +725,7 @@ int64 TlsSocket::read(bytes::span buffer) {
 	while (_incomingGoodDataLimit) {
 		const auto available = std::min(
 			_incomingGoodDataLimit,
-			_incoming.size() - _incomingGoodDataOffset);
+			incomingSize() - _incomingGoodDataOffset);
 		if (available <= 0) {
 			return written;
 		}
@@ -712,7 +736,7 @@ int64 TlsSocket::read(bytes::span buffer) {
 		bytes::copy(
 			buffer,
 			bytes::make_span(_incoming).subspan(
-				_incomingGoodDataOffset,
+				_incomingOffset + _incomingGoodDataOffset,
 				write));
 		written += write;
 		buffer = buffer.subspan(write);
@@ -738,26 +762,45 @@ void TlsSocket::write(bytes::const_span prefix, bytes::const_span buffer) {
 		return;
 	}
 	if (!prefix.empty()) {
+		flushOutgoing();
 		_socket.write(kClientPrefix.data(), kClientPrefix.size());
 	}
+
+	_outgoing.insert(end(_outgoing), prefix.begin(), prefix.end());
+	_outgoing.insert(end(_outgoing), buffer.begin(), buffer.end());
+	if (_outgoingFlushQueued) {
+		return;
+	}
+
+	// The first packet in an event loop iteration is sent right away,
+	// the following ones share TLS records in a single queued flush.
+	flushOutgoing();
+	_outgoingFlushQueued = true;
+	InvokeQueued(this, [=] {
+		_outgoingFlushQueued = false;
+		flushOutgoing();
+	});
+}
+
+void TlsSocket::flushOutgoing() {
+	if (_outgoing.empty()) {
+		return;
+	} else if (!isConnected()) {
+		_outgoing.clear();
+		return;
+	}
+	auto buffer = bytes::make_span(_outgoing);
 	while (!buffer.empty()) {
-		const auto write = std::min(
-			kClientPartSize - prefix.size(),
-			buffer.size());
+		const auto write = std::min(std::size_t(kClientPartSize), buffer.size());
 		_socket.write(kClientHeader.data(), kClientHeader.size());
-		const auto size = qToBigEndian(uint16(prefix.size() + write));
+		const auto size = qToBigEndian(uint16(write));
 		_socket.write(reinterpret_cast<const char*>(&size), sizeof(size));
-		if (!prefix.empty()) {
-			_socket.write(
-				reinterpret_cast<const char*>(prefix.data()),
-				prefix.size());
-			prefix = bytes::const_span();
-		}
 		_socket.write(
 			reinterpret_cast<const char*>(buffer.data()),
 			write);
 		buffer = buffer.subspan(write);
 	}
+	_outgoing.clear();
 }
 
 int32 TlsSocket::debugState() {
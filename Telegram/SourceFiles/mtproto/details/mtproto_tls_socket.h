@@ -52,11 +52,17 @@ private:
 	void readData();
 	[[nodiscard]] bool checkNextPacket();
 	void shiftIncomingBy(int amount);
+	void compactIncoming();
+	[[nodiscard]] int incomingSize() const;
+	void flushOutgoing();
 
 	const bytes::vector _secret;
 	QTcpSocket _socket;
 	State _state = State::NotConnected;
 	QByteArray _incoming;
+	int _incomingOffset = 0;
+	bytes::vector _outgoing;
+	bool _outgoingFlushQueued = false;
 	int _incomingGoodDataOffset = 0;
 	int _incomingGoodDataLimit = 0;
 	int16 _serverHelloLength = 0;
@@ -21,6 +21,11 @@ namespace {
 
 using namespace details;
 
+// Endpoints failing this many times in a row are not waited for.
+constexpr auto kEndpointFailingAfter = 2;
+constexpr auto kMaxStoredFailures = 16;
+constexpr auto kMaxStoredRtt = 60 * crl::time(1000);
+
 struct BuiltInDc {
 	int id;
 	const char *ip;
@@ -152,6 +157,8 @@ DcOptions::DcOptions(const DcOptions &other)
 , _publicKeys(other._publicKeys)
 , _cdnPublicKeys(other._cdnPublicKeys)
 , _immutable(other._immutable) {
+	QMutexLocker lock(&other._endpointStatsMutex);
+	_endpointStats = other._endpointStats;
 }
 
 DcOptions::~DcOptions() = default;
@@ -460,6 +467,18 @@ QByteArray DcOptions::serialize() const {
 		}
 	}
 
+	// Endpoint connection history.
+	auto endpointStats = [&] {
+		QMutexLocker lock(&_endpointStatsMutex);
+		return _endpointStats;
+	}();
+	size += sizeof(qint32);
+	for (const auto &[key, stats] : endpointStats) {
+		// ip + port + rtt + failures
+		size += sizeof(qint32) + key.first.size();
+		size += sizeof(qint32) + sizeof(qint32) + sizeof(qint32);
+	}
+
 	constexpr auto kVersion = 1;
 
 	auto result = QByteArray();
@@ -495,6 +514,16 @@ QByteArray DcOptions::serialize() const {
 				<< Serialize::bytes(key.n)
 				<< Serialize::bytes(key.e);
 		}
+
+		// Endpoint connection history.
+		stream << qint32(endpointStats.size());
+		for (const auto &[key, stats] : endpointStats) {
+			stream << qint32(key.first.size());
+			stream.writeRawData(key.first.data(), key.first.size());
+			stream << qint32(key.second)
+				<< qint32(std::min(stats.rtt, crl::time(kMaxStoredRtt)))
+				<< qint32(stats.failures);
+		}
 	}
 	return result;
 }
@@ -590,9 +619,75 @@ bool DcOptions::constructFromSerialized(const QByteArray &serialized) {
 			}
 		}
 	}
+
+	// Read endpoint connection history.
+	if (!stream.atEnd()) {
+		auto count = qint32(0);
+		stream >> count;
+		if (stream.status() != QDataStream::Ok || count < 0) {
+			LOG(("MTP Error: Bad data for endpoints in DcOptions::constructFromSerialized()"));
+			return false;
+		}
+		auto endpointStats = base::flat_map<EndpointKey, EndpointStats>();
+		for (auto i = 0; i != count; ++i) {
+			auto ipSize = qint32(0);
+			stream >> ipSize;
+			constexpr auto kMaxIpSize = 45;
+			if (ipSize <= 0 || ipSize > kMaxIpSize) {
+				LOG(("MTP Error: Bad endpoint inside DcOptions::constructFromSerialized()"));
+				return false;
+			}
+			auto ip = std::string(ipSize, ' ');
+			stream.readRawData(ip.data(), ipSize);
+			qint32 port = 0, rtt = 0, failures = 0;
+			stream >> port >> rtt >> failures;
+			if (stream.status() != QDataStream::Ok) {
+				LOG(("MTP Error: Bad endpoint inside DcOptions::constructFromSerialized()"));
+				return false;
+			}
+			endpointStats.emplace(
+				EndpointKey(std::move(ip), port),
+				EndpointStats{ .rtt = rtt, .failures = failures });
+		}
+		QMutexLocker lock(&_endpointStatsMutex);
+		_endpointStats = std::move(endpointStats);
+	}
 	return true;
 }
 
+void DcOptions::registerConnected(
+		const std::string &ip,
+		int port,
+		crl::time rtt) {
+	QMutexLocker lock(&_endpointStatsMutex);
+	auto &stats = _endpointStats[EndpointKey(ip, port)];
+	stats.rtt = stats.rtt ? ((stats.rtt + rtt) / 2) : rtt;
+	stats.failures = 0;
+}
+
+void DcOptions::registerConnectFailed(const std::string &ip, int port) {
+	QMutexLocker lock(&_endpointStatsMutex);
+	auto &stats = _endpointStats[EndpointKey(ip, port)];
+	stats.failures = std::min(stats.failures + 1, kMaxStoredFailures);
+}
+
+bool DcOptions::endpointFailing(const std::string &ip, int port) const {
+	QMutexLocker lock(&_endpointStatsMutex);
+	const auto i = _endpointStats.find(EndpointKey(ip, port));
+	return (i != end(_endpointStats))
+		&& (i->second.failures >= kEndpointFailingAfter);
+}
+
+crl::time DcOptions::endpointRtt(const std::string &ip, int port) const {
+	QMutexLocker lock(&_endpointStatsMutex);
+	const auto i = _endpointStats.find(EndpointKey(ip, port));
+	return (i != end(_endpointStats)) ? i->second.rtt : 0;
+}
+
+void DcOptions::notifyEndpointStatsChanged() {
+	_endpointStatsChanged.fire({});
+}
+
 rpl::producer<DcId> DcOptions::changed() const {
 	return _changed.events();
 }
@@ -601,6 +696,10 @@ rpl::producer<> DcOptions::cdnConfigChanged() const {
 	return _cdnConfigChanged.events();
 }
 
+rpl::producer<> DcOptions::endpointStatsChanged() const {
+	return _endpointStatsChanged.events();
+}
+
 std::vector<DcId> DcOptions::configEnumDcIds() const {
 	auto result = std::vector<DcId>();
 	{
@@ -11,6 +11,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/bytes.h"
 
 #include <QtCore/QReadWriteLock>
+#include <QtCore/QMutex>
 #include <string>
 #include <vector>
 #include <map>
@@ -81,6 +82,7 @@ public:
 
 	[[nodiscard]] rpl::producer<DcId> changed() const;
 	[[nodiscard]] rpl::producer<> cdnConfigChanged() const;
+	[[nodiscard]] rpl::producer<> endpointStatsChanged() const;
 	void setFromList(const MTPVector<MTPDcOption> &options);
 	void addFromList(const MTPVector<MTPDcOption> &options);
 	void addFromOther(DcOptions &&options);
@@ -106,6 +108,16 @@ public:
 		bool throughProxy) const;
 	[[nodiscard]] DcType dcType(ShiftedDcId shiftedDcId) const;
 
+	// Connection history, used to skip waiting for failing endpoints
+	// and to prefer endpoints that connected fast before.
+	void registerConnected(const std::string &ip, int port, crl::time rtt);
+	void registerConnectFailed(const std::string &ip, int port);
+	[[nodiscard]] bool endpointFailing(const std::string &ip, int port) const;
+	[[nodiscard]] crl::time endpointRtt(const std::string &ip, int port) const;
+
+	// Main thread, fires endpointStatsChanged() so that stats are saved.
+	void notifyEndpointStatsChanged();
+
 	void setCDNConfig(const MTPDcdnConfig &config);
 	[[nodiscard]] bool hasCDNKeysForDc(DcId dcId) const;
 	[[nodiscard]] details::RSAPublicKey getDcRSAKey(
@@ -137,6 +149,12 @@ private:
 
 	[[nodiscard]] bool hasMediaOnlyOptionsFor(DcId dcId) const;
 
+	struct EndpointStats {
+		crl::time rtt = 0;
+		int failures = 0;
+	};
+	using EndpointKey = std::pair<std::string, int>;
+
 	void processFromList(const QVector<MTPDcOption> &options, bool overwrite);
 	void computeCdnDcIds();
 
@@ -157,8 +175,12 @@ private:
 		base::flat_map<uint64, details::RSAPublicKey>> _cdnPublicKeys;
 	mutable QReadWriteLock _useThroughLockers;
 
+	base::flat_map<EndpointKey, EndpointStats> _endpointStats;
+	mutable QMutex _endpointStatsMutex;
+
 	rpl::event_stream<DcId> _changed;
 	rpl::event_stream<> _cdnConfigChanged;
+	rpl::event_stream<> _endpointStatsChanged;
 
 	// True when we have overriden options from a .tdesktop-endpoints file.
 	bool _immutable = false;
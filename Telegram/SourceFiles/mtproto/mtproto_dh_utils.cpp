@@ -7,6 +7,10 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "mtproto/mtproto_dh_utils.h"
 
+#include "base/flat_set.h"
+
+#include <QtCore/QMutex>
+
 namespace MTP {
 namespace {
 
@@ -125,7 +129,23 @@ bool IsPrimeAndGood(bytes::const_span primeBytes, int g) {
 		}
 	}
 
-	return IsPrimeAndGoodCheck(openssl::BigNum(primeBytes), g);
+	// The primality check is heavy, remember the primes already checked,
+	// so that keys for the other DCs don't repeat it.
+	static QMutex CheckedMutex;
+	static auto Checked = base::flat_set<std::pair<bytes::vector, int>>();
+	auto checked = std::make_pair(bytes::make_vector(primeBytes), g);
+	{
+		QMutexLocker lock(&CheckedMutex);
+		if (Checked.contains(checked)) {
+			return true;
+		}
+	}
+	if (!IsPrimeAndGoodCheck(openssl::BigNum(primeBytes), g)) {
+		return false;
+	}
+	QMutexLocker lock(&CheckedMutex);
+	Checked.emplace(std::move(checked));
+	return true;
 }
 
 ModExpFirst CreateModExp(
@@ -103,6 +103,11 @@ AuthKeyPtr SessionData::getTemporaryKey(TemporaryKeyType type) const {
 	return _owner ? _owner->getTemporaryKey(type) : nullptr;
 }
 
+bool SessionData::dcSessionsIdle() const {
+	QMutexLocker lock(&_ownerMutex);
+	return _owner ? _owner->dcSessionsIdle() : false;
+}
+
 AuthKeyPtr SessionData::getPersistentKey() const {
 	QMutexLocker lock(&_ownerMutex);
 	return _owner ? _owner->getPersistentKey() : nullptr;
@@ -146,6 +151,17 @@ void SessionData::destroyTemporaryKey(uint64 keyId) {
 	}
 }
 
+bool SessionData::idle() {
+	{
+		QReadLocker locker(haveSentMutex());
+		if (!_haveSent.empty()) {
+			return false;
+		}
+	}
+	QReadLocker locker(toSendMutex());
+	return _toSend.empty();
+}
+
 void SessionData::detach() {
 	QMutexLocker lock(&_ownerMutex);
 	_owner = nullptr;
@@ -162,6 +178,7 @@ Session::Session(
 , _data(std::make_shared<SessionData>(this))
 , _thread(thread)
 , _sender([=] { needToResumeAndSend(); }) {
+	_dc->registerSession(_data.get());
 	_timeouter.callEach(1000);
 	refreshOptions();
 	watchDcKeyChanges();
@@ -285,6 +302,7 @@ void Session::stop() {
 void Session::kill() {
 	stop();
 	_killed = true;
+	_dc->unregisterSession(_data.get());
 	_data->detach();
 	DEBUG_LOG(("Session Info: marked session dcWithShift %1 as killed").arg(_shiftedDcId));
 }
@@ -363,7 +381,7 @@ void Session::cancel(mtpRequestId requestId, mtpMsgId msgId) {
 	}
 	if (msgId) {
 		QWriteLocker locker(_data->haveSentMutex());
-		_data->haveSentMap().remove(msgId);
+		_data->haveSentMap().erase(msgId);
 	}
 }
 
@@ -541,6 +559,10 @@ AuthKeyPtr Session::getTemporaryKey(TemporaryKeyType type) const {
 	return _dc->getTemporaryKey(type);
 }
 
+bool Session::dcSessionsIdle() const {
+	return _dc->sessionsIdle();
+}
+
 AuthKeyPtr Session::getPersistentKey() const {
 	return _dc->getPersistentKey();
 }
@@ -53,6 +53,9 @@ struct SessionOptions {
 };
 
 class Session;
+// Sent requests are acked in arbitrary order, so we need cheap erase.
+using SentRequestsMap = std::map<mtpMsgId, SerializedRequest>;
+
 class SessionData final {
 public:
 	explicit SessionData(not_null<Session*> creator) : _owner(creator) {
@@ -81,7 +84,7 @@ public:
 	base::flat_map<mtpRequestId, SerializedRequest> &toSendMap() {
 		return _toSend;
 	}
-	base::flat_map<mtpMsgId, SerializedRequest> &haveSentMap() {
+	SentRequestsMap &haveSentMap() {
 		return _haveSent;
 	}
 	base::flat_map<mtpRequestId, mtpBuffer> &haveReceivedResponses() {
@@ -101,6 +104,7 @@ public:
 	[[nodiscard]] bool connectionInited() const;
 	[[nodiscard]] AuthKeyPtr getPersistentKey() const;
 	[[nodiscard]] AuthKeyPtr getTemporaryKey(TemporaryKeyType type) const;
+	[[nodiscard]] bool dcSessionsIdle() const;
 	[[nodiscard]] CreatingKeyType acquireKeyCreation(DcType type);
 	[[nodiscard]] bool releaseKeyCreationOnDone(
 		const AuthKeyPtr &temporaryKey,
@@ -110,6 +114,9 @@ public:
 	void releaseKeyCreationOnFail();
 	void destroyTemporaryKey(uint64 keyId);
 
+	// Nothing is sent or waiting to be sent in this session.
+	[[nodiscard]] bool idle();
+
 	void detach();
 
 private:
@@ -125,7 +132,7 @@ private:
 	base::flat_map<mtpRequestId, SerializedRequest> _toSend; // map of request_id -> request, that is waiting to be sent
 	QReadWriteLock _toSendLock;
 
-	base::flat_map<mtpMsgId, SerializedRequest> _haveSent; // map of msg_id -> request, that was sent
+	SentRequestsMap _haveSent; // map of msg_id -> request, that was sent
 	QReadWriteLock _haveSentLock;
 
 	base::flat_map<mtpRequestId, mtpBuffer> _receivedResponses; // map of request_id -> response that should be processed in the main thread
@@ -158,6 +165,7 @@ public:
 	[[nodiscard]] ShiftedDcId getDcWithShift() const;
 	[[nodiscard]] AuthKeyPtr getPersistentKey() const;
 	[[nodiscard]] AuthKeyPtr getTemporaryKey(TemporaryKeyType type) const;
+	[[nodiscard]] bool dcSessionsIdle() const;
 	[[nodiscard]] bool connectionInited() const;
 	void sendPrepared(
 		const SerializedRequest &request,
@@ -29,6 +29,7 @@ constexpr auto kIntSize = static_cast<int>(sizeof(mtpPrime));
 constexpr auto kWaitForBetterTimeout = crl::time(2000);
 constexpr auto kMinConnectedTimeout = crl::time(1000);
 constexpr auto kMaxConnectedTimeout = crl::time(8000);
+constexpr auto kFastEndpointRtt = crl::time(500);
 constexpr auto kMinReceiveTimeout = crl::time(4000);
 constexpr auto kMaxReceiveTimeout = crl::time(64000);
 constexpr auto kMarkConnectionOldTimeout = crl::time(192000);
@@ -37,6 +38,10 @@ constexpr auto kPingSendAfter = 30 * crl::time(1000);
 constexpr auto kPingSendAfterForce = 45 * crl::time(1000);
 constexpr auto kTemporaryExpiresIn = TimeId(86400);
 constexpr auto kBindKeyAdditionalExpiresTimeout = TimeId(30);
+
+// Idle connections replace their temporary key this long before it
+// expires, so that requests don't hit -404 and wait for a new key.
+constexpr auto kTemporaryKeyRenewBefore = TimeId(3600);
 constexpr auto kTestModeDcIdShift = 10000;
 constexpr auto kCheckSentRequestsEach = 1 * crl::time(1000);
 constexpr auto kKeyOldEnoughForDestroy = 60 * crl::time(1000);
@@ -49,6 +54,18 @@ constexpr auto kRequestConfigTimeout = 8 * crl::time(1000);
 // Don't try to handle messages larger than this size.
 constexpr auto kMaxMessageLength = 16 * 1024 * 1024;
 
+// Keep the decryption buffer between received messages up to this size.
+constexpr auto kMaxKeptDecryptedBufferSize = 1024 * 1024;
+
+// Received packets at least this large are decrypted on worker threads,
+// when there are several of them waiting to be handled.
+constexpr auto kParallelDecryptMinSize = 16 * 1024;
+
+constexpr auto kExternalHeaderIntsCount = 6U; // 2 auth_key_id, 4 msg_key
+constexpr auto kEncryptedHeaderIntsCount = 8U; // 2 salt, 2 session, 2 msg_id, 1 seq_no, 1 length
+constexpr auto kMinimalEncryptedIntsCount = kEncryptedHeaderIntsCount + 4U; // + 1 data + 3 padding
+constexpr auto kMinimalIntsCount = kExternalHeaderIntsCount + kMinimalEncryptedIntsCount;
+
 // How much time passed from send till we resend request or check its state.
 constexpr auto kCheckSentRequestTimeout = 10 * crl::time(1000);
 
@@ -59,6 +76,19 @@ constexpr auto kSendStateRequestWaiting = crl::time(1000);
 // How much time to wait for some more requests, when sending msg acks.
 constexpr auto kAckSendWaiting = 10 * crl::time(1000);
 
+// When this many acks are pending we flush them with the next tick,
+// so that a single msgs_ack doesn't grow without limits.
+constexpr auto kAckSendForceCount = 1024;
+
+// How often to log the sent containers and received packets statistics.
+constexpr auto kContainersStatsPeriod = 60 * crl::time(1000);
+constexpr auto kReceivedStatsPeriod = 60 * crl::time(1000);
+
+// Requests larger than this are sent wrapped in gzip_packed,
+// if that saves at least kGzipPackMinSaving bytes.
+constexpr auto kGzipPackMinSize = 1024;
+constexpr auto kGzipPackMinSaving = 256;
+
 auto SyncTimeRequestDuration = kFastRequestDuration;
 
 using namespace details;
@@ -84,7 +114,7 @@ using namespace details;
 void WrapInvokeAfter(
 		SerializedRequest &to,
 		const SerializedRequest &from,
-		const base::flat_map<mtpMsgId, SerializedRequest> &haveSent,
+		const SentRequestsMap &haveSent,
 		int32 skipBeforeRequest = 0) {
 	const auto afterId = *(mtpMsgId*)(from->after->data() + 4);
 	const auto i = afterId ? haveSent.find(afterId) : haveSent.end();
@@ -108,6 +138,76 @@ void WrapInvokeAfter(
 	}
 }
 
+[[nodiscard]] bool SkipGzipPacking(mtpTypeId type) {
+	switch (type) {
+	case mtpc_gzip_packed:
+	case mtpc_upload_saveFilePart: // File parts are compressed already.
+	case mtpc_upload_saveBigFilePart:
+		return true;
+	}
+	return false;
+}
+
+// Returns the count of bytes saved by packing the request body in place.
+int GzipPackRequest(SerializedRequest &request) {
+	const auto size = int(tl::count_length(request));
+	if (size < kGzipPackMinSize) {
+		return 0;
+	}
+	const auto body = request->constData()
+		+ SerializedRequest::kMessageBodyPosition;
+	if (SkipGzipPacking(mtpTypeId(*body))) {
+		return 0;
+	}
+
+	z_stream stream;
+	stream.zalloc = nullptr;
+	stream.zfree = nullptr;
+	stream.opaque = nullptr;
+	const auto init = deflateInit2(
+		&stream,
+		Z_BEST_SPEED,
+		Z_DEFLATED,
+		16 + MAX_WBITS,
+		8,
+		Z_DEFAULT_STRATEGY);
+	if (init != Z_OK) {
+		LOG(("RPC Error: could not init zlib deflate stream, code: %1"
+			).arg(init));
+		return 0;
+	}
+	auto packed = QByteArray(
+		int(deflateBound(&stream, size)),
+		Qt::Uninitialized);
+	stream.avail_in = size;
+	stream.next_in = reinterpret_cast<Bytef*>(const_cast<mtpPrime*>(body));
+	stream.avail_out = packed.size();
+	stream.next_out = reinterpret_cast<Bytef*>(packed.data());
+	const auto result = deflate(&stream, Z_FINISH);
+	const auto packedSize = packed.size() - int(stream.avail_out);
+	deflateEnd(&stream);
+	if (result != Z_STREAM_END) {
+		LOG(("RPC Error: could not pack request data, code: %1"
+			).arg(result));
+		return 0;
+	}
+	packed.resize(packedSize);
+
+	const auto bytes = MTP_bytes(packed);
+	const auto packedInts = 1 + (tl::count_length(bytes) >> 2);
+	const auto saved = size - int(packedInts * sizeof(mtpPrime));
+	if (saved < kGzipPackMinSaving) {
+		return 0;
+	}
+	auto &data = *request;
+	data.resize(SerializedRequest::kMessageBodyPosition);
+	data.push_back(mtpc_gzip_packed);
+	bytes.write(data);
+	data[SerializedRequest::kMessageLengthPosition] = packedInts
+		* sizeof(mtpPrime);
+	return saved;
+}
+
 [[nodiscard]] bool ConstTimeIsDifferent(
 		const void *a,
 		const void *b,
@@ -121,6 +221,99 @@ void WrapInvokeAfter(
 	return different;
 }
 
+#ifndef TDESKTOP_MTPROTO_OLD
+struct ReceivedDecrypted {
+	bytes::vector buffer;
+	bool msgKeyValid = false;
+	bool ready = false;
+};
+
+[[nodiscard]] bool GoodReceivedPacket(const mtpBuffer &packet, uint64 keyId) {
+	const auto intsCount = uint32(packet.size());
+	return (intsCount >= kMinimalIntsCount)
+		&& (intsCount <= kMaxMessageLength / kIntSize)
+		&& (*(const uint64*)packet.constData() == keyId);
+}
+
+// Decrypts a packet that passed GoodReceivedPacket to the buffer.
+// Returns true if the msg_key of the packet is valid.
+bool DecryptReceived(
+		const AuthKeyPtr &key,
+		const mtpBuffer &packet,
+		bytes::vector &buffer) {
+	const auto ints = packet.constData();
+	const auto encryptedInts = ints + kExternalHeaderIntsCount;
+	const auto encryptedIntsCount = (uint32(packet.size())
+		- kExternalHeaderIntsCount) & ~0x03U;
+	const auto encryptedBytesCount = encryptedIntsCount * kIntSize;
+	const auto msgKey = *(const MTPint128*)(ints + 2);
+	buffer.resize(encryptedBytesCount);
+	aesIgeDecrypt(
+		encryptedInts,
+		buffer.data(),
+		encryptedBytesCount,
+		key,
+		msgKey);
+
+	std::array<uchar, 32> sha256Buffer = { { 0 } };
+
+	SHA256_CTX msgKeyLargeContext;
+	SHA256_Init(&msgKeyLargeContext);
+	SHA256_Update(&msgKeyLargeContext, key->partForMsgKey(false), 32);
+	SHA256_Update(&msgKeyLargeContext, buffer.data(), encryptedBytesCount);
+	SHA256_Final(sha256Buffer.data(), &msgKeyLargeContext);
+
+	constexpr auto kMsgKeyShift = 8U;
+	return !ConstTimeIsDifferent(
+		&msgKey,
+		sha256Buffer.data() + kMsgKeyShift,
+		sizeof(msgKey));
+}
+
+// Large packets of a batch are decrypted in parallel, but they're still
+// handled one by one in the received order on the session thread.
+[[nodiscard]] std::vector<ReceivedDecrypted> DecryptReceivedInParallel(
+		const AuthKeyPtr &key,
+		uint64 keyId,
+		const std::deque<mtpBuffer> &packets) {
+	const auto large = [&](const mtpBuffer &packet) {
+		return (packet.size() * kIntSize >= kParallelDecryptMinSize)
+			&& GoodReceivedPacket(packet, keyId);
+	};
+	if (ranges::count_if(packets, large) < 2) {
+		return {};
+	}
+	const auto count = int(packets.size());
+	auto result = std::vector<ReceivedDecrypted>(count);
+	crl::semaphore semaphore;
+	auto waiting = 0;
+	auto last = -1;
+	for (auto i = 0; i != count; ++i) {
+		if (!large(packets[i])) {
+			continue;
+		} else if (last >= 0) {
+			++waiting;
+			crl::async([&, packet = &packets[last], entry = &result[last]] {
+				entry->msgKeyValid = DecryptReceived(
+					key,
+					*packet,
+					entry->buffer);
+				entry->ready = true;
+				semaphore.release();
+			});
+		}
+		last = i;
+	}
+	auto &entry = result[last];
+	entry.msgKeyValid = DecryptReceived(key, packets[last], entry.buffer);
+	entry.ready = true;
+	while (waiting--) {
+		semaphore.acquire();
+	}
+	return result;
+}
+#endif // TDESKTOP_MTPROTO_OLD
+
 } // namespace
 
 SessionPrivate::SessionPrivate(
@@ -169,9 +362,24 @@ void SessionPrivate::appendTestConnection(
 		const bytes::vector &protocolSecret) {
 	QWriteLocker lock(&_stateMutex);
 
-	const auto priority = (qthelp::is_ipv6(ip) ? 0 : 1)
-		+ (protocol == DcOptions::Variants::Tcp ? 1 : 0)
-		+ (protocolSecret.empty() ? 0 : 1);
+	const auto tracked = (_options->proxy.type == ProxyData::Type::None)
+		&& !ip.isEmpty();
+	const auto endpointIp = tracked ? ip.toStdString() : std::string();
+	const auto failing = tracked
+		&& _instance->dcOptions().endpointFailing(endpointIp, port);
+	const auto rtt = tracked
+		? _instance->dcOptions().endpointRtt(endpointIp, port)
+		: crl::time(0);
+	const auto fast = (rtt > 0) && (rtt <= kFastEndpointRtt);
+
+	// Don't wait for a better connection through a failing endpoint,
+	// wait for an endpoint that connected fast the last times instead.
+	const auto priority = failing
+		? -1
+		: ((qthelp::is_ipv6(ip) ? 0 : 1)
+			+ (protocol == DcOptions::Variants::Tcp ? 1 : 0)
+			+ (protocolSecret.empty() ? 0 : 1)
+			+ (fast ? 1 : 0));
 	_testConnections.push_back({
 		AbstractConnection::Create(
 			_instance,
@@ -179,7 +387,9 @@ void SessionPrivate::appendTestConnection(
 			thread(),
 			protocolSecret,
 			_options->proxy),
-		priority
+		priority,
+		endpointIp,
+		port,
 	});
 	const auto weak = _testConnections.back().data.get();
 	connect(weak, &AbstractConnection::error, [=](int errorCode) {
@@ -235,6 +445,9 @@ void SessionPrivate::checkSentRequests() {
 		restart();
 		return;
 	}
+	if (renewExpiringTemporaryKey()) {
+		return;
+	}
 	auto requesting = false;
 	{
 		QReadLocker locker(_sessionData->haveSentMutex());
@@ -256,6 +469,34 @@ void SessionPrivate::checkSentRequests() {
 	}
 }
 
+bool SessionPrivate::renewExpiringTemporaryKey() {
+	if (!_encryptionKey
+		|| !_keyId
+		|| _keyCreator
+		|| _instance->isKeysDestroyer()
+		|| getState() != ConnectedState) {
+		return false;
+	}
+	const auto expiresAt = _encryptionKey->expiresAt();
+	if (!expiresAt
+		|| base::unixtime::now() + kTemporaryKeyRenewBefore < expiresAt) {
+		return false;
+	}
+	if (!_sessionData->dcSessionsIdle()) {
+		// Destroying the key restarts all the sessions of this dc,
+		// wait until downloads and uploads there are finished as well.
+		return false;
+	}
+	DEBUG_LOG(("AuthKey Info: temporary key %1 in dc %2 expires at %3, "
+		"renewing while idle."
+		).arg(_keyId
+		).arg(_shiftedDcId
+		).arg(expiresAt));
+	_sessionData->destroyTemporaryKey(_keyId);
+	applyAuthKey(nullptr);
+	return true;
+}
+
 void SessionPrivate::clearOldContainers() {
 	auto resent = false;
 	const auto now = crl::now();
@@ -441,7 +682,7 @@ mtpMsgId SessionPrivate::replaceMsgId(SerializedRequest &request, mtpMsgId newId
 
 	while (_resendingIds.contains(newId)
 		|| _ackedIds.contains(newId)
-		|| haveSent.contains(newId)) {
+		|| haveSent.find(newId) != end(haveSent)) {
 		newId = base::unixtime::mtproto_msg_id();
 	}
 
@@ -689,6 +930,18 @@ void SessionPrivate::tryToSend() {
 		if (!sendAll) {
 			locker1.unlock();
 		}
+		for (auto &[requestId, request] : toSend) {
+			if (const auto saved = GzipPackRequest(request)) {
+				++_gzipPackedRequests;
+				_gzipSavedBytes += saved;
+				DEBUG_LOG(("MTP Info: gzip packed request %1, saved %2 bytes, "
+					"total %3 bytes in %4 requests."
+					).arg(requestId
+					).arg(saved
+					).arg(_gzipSavedBytes
+					).arg(_gzipPackedRequests));
+			}
+		}
 
 		uint32 toSendCount = toSend.size();
 		if (pingRequest) ++toSendCount;
@@ -921,11 +1174,37 @@ void SessionPrivate::tryToSend() {
 				bigMsgId,
 				forceNewMsgId);
 			_sentContainers.emplace(containerMsgId, std::move(sentIdsWrap));
+			registerContainerSent(toSendCount, toSendRequest->size());
 		}
 	}
 	sendSecureRequest(std::move(toSendRequest), needAnyResponse);
 }
 
+void SessionPrivate::registerContainerSent(int messages, int ints) {
+	const auto now = crl::now();
+	if (!_containersStatsStart) {
+		_containersStatsStart = now;
+	}
+	++_containersSent;
+	_containersSentMessages += messages;
+	_containersSentBytes += ints * sizeof(mtpPrime);
+
+	const auto passed = now - _containersStatsStart;
+	if (passed < kContainersStatsPeriod) {
+		return;
+	}
+	DEBUG_LOG(("MTP Info: dc %1 sent %2 containers in %3ms, "
+		"%4 containers per second, %5 messages and %6 bytes per container."
+		).arg(_shiftedDcId
+		).arg(_containersSent
+		).arg(passed
+		).arg(_containersSent * 1000. / passed, 0, 'f', 2
+		).arg(_containersSentMessages / double(_containersSent), 0, 'f', 1
+		).arg(_containersSentBytes / _containersSent));
+	_containersStatsStart = now;
+	_containersSent = _containersSentMessages = _containersSentBytes = 0;
+}
+
 void SessionPrivate::retryByTimer() {
 	if (_retryTimeout < 3) {
 		++_retryTimeout;
@@ -1190,6 +1469,9 @@ void SessionPrivate::waitBetterFailed() {
 
 void SessionPrivate::connectingTimedOut() {
 	for (const auto &connection : _testConnections) {
+		if (!connection.data->isConnected()) {
+			registerConnectFailed(connection);
+		}
 		connection.data->timedOut();
 	}
 	doDisconnect();
@@ -1211,15 +1493,25 @@ void SessionPrivate::handleReceived() {
 
 	onReceivedSome();
 
+	const auto handleStarted = crl::profile();
+
+#ifndef TDESKTOP_MTPROTO_OLD
+	auto predecrypted = DecryptReceivedInParallel(
+		_encryptionKey,
+		_keyId,
+		_connection->received());
+	auto index = 0;
+#endif // TDESKTOP_MTPROTO_OLD
+
+	_receivedStats.decrypt += crl::profile() - handleStarted;
+
 	while (!_connection->received().empty()) {
 		auto intsBuffer = std::move(_connection->received().front());
 		_connection->received().pop_front();
 
-		constexpr auto kExternalHeaderIntsCount = 6U; // 2 auth_key_id, 4 msg_key
-		constexpr auto kEncryptedHeaderIntsCount = 8U; // 2 salt, 2 session, 2 msg_id, 1 seq_no, 1 length
-		constexpr auto kMinimalEncryptedIntsCount = kEncryptedHeaderIntsCount + 4U; // + 1 data + 3 padding
-		constexpr auto kMinimalIntsCount = kExternalHeaderIntsCount + kMinimalEncryptedIntsCount;
 		auto intsCount = uint32(intsBuffer.size());
+		++_receivedStats.packets;
+		_receivedStats.bytes += intsCount * kIntSize;
 		auto ints = intsBuffer.constData();
 		if ((intsCount < kMinimalIntsCount) || (intsCount > kMaxMessageLength / kIntSize)) {
 			LOG(("TCP Error: bad message received, len %1").arg(intsCount * kIntSize));
@@ -1237,16 +1529,27 @@ void SessionPrivate::handleReceived() {
 		auto encryptedInts = ints + kExternalHeaderIntsCount;
 		auto encryptedIntsCount = (intsCount - kExternalHeaderIntsCount) & ~0x03U;
 		auto encryptedBytesCount = encryptedIntsCount * kIntSize;
-		auto decryptedBuffer = QByteArray(encryptedBytesCount, Qt::Uninitialized);
 		auto msgKey = *(MTPint128*)(ints + 2);
 
 #ifdef TDESKTOP_MTPROTO_OLD
-		aesIgeDecrypt_oldmtp(encryptedInts, decryptedBuffer.data(), encryptedBytesCount, _encryptionKey, msgKey);
+		_decryptedBuffer.resize(encryptedBytesCount);
+		aesIgeDecrypt_oldmtp(encryptedInts, _decryptedBuffer.data(), encryptedBytesCount, _encryptionKey, msgKey);
+		const auto &decrypted = _decryptedBuffer;
 #else // TDESKTOP_MTPROTO_OLD
-		aesIgeDecrypt(encryptedInts, decryptedBuffer.data(), encryptedBytesCount, _encryptionKey, msgKey);
+		const auto prepared = (index < int(predecrypted.size())
+			&& predecrypted[index].ready)
+			? &predecrypted[index]
+			: nullptr;
+		++index;
+		const auto &decrypted = prepared
+			? prepared->buffer
+			: _decryptedBuffer;
+		const auto msgKeyValid = prepared
+			? prepared->msgKeyValid
+			: DecryptReceived(_encryptionKey, intsBuffer, _decryptedBuffer);
 #endif // TDESKTOP_MTPROTO_OLD
 
-		auto decryptedInts = reinterpret_cast<const mtpPrime*>(decryptedBuffer.constData());
+		auto decryptedInts = reinterpret_cast<const mtpPrime*>(decrypted.data());
 		auto serverSalt = *(uint64*)&decryptedInts[0];
 		auto session = *(uint64*)&decryptedInts[2];
 		auto msgId = *(uint64*)&decryptedInts[4];
@@ -1286,16 +1589,7 @@ void SessionPrivate::handleReceived() {
 		constexpr auto kMaxPaddingSize = 1024U;
 		auto badMessageLength = (paddingSize < kMinPaddingSize || paddingSize > kMaxPaddingSize);
 
-		std::array<uchar, 32> sha256Buffer = { { 0 } };
-
-		SHA256_CTX msgKeyLargeContext;
-		SHA256_Init(&msgKeyLargeContext);
-		SHA256_Update(&msgKeyLargeContext, _encryptionKey->partForMsgKey(false), 32);
-		SHA256_Update(&msgKeyLargeContext, decryptedInts, encryptedBytesCount);
-		SHA256_Final(sha256Buffer.data(), &msgKeyLargeContext);
-
-		constexpr auto kMsgKeyShift = 8U;
-		if (ConstTimeIsDifferent(&msgKey, sha256Buffer.data() + kMsgKeyShift, sizeof(msgKey))) {
+		if (!msgKeyValid) {
 			LOG(("TCP Error: bad SHA256 hash after aesDecrypt in message"));
 			TCP_LOG(("TCP Error: bad message %1").arg(Logs::mb(encryptedInts, encryptedBytesCount).str()));
 
@@ -1363,14 +1657,18 @@ void SessionPrivate::handleReceived() {
 			).arg(_encryptionKey->keyId()));
 
 		if (_receivedMessageIds.registerMsgId(msgId, needAck)) {
+			const auto dispatchStarted = crl::profile();
 			res = handleOneReceived(from, end, msgId, serverTime, serverSalt, badTime);
+			_receivedStats.dispatch += crl::profile() - dispatchStarted;
 		}
 		_receivedMessageIds.shrink();
 
 		// send acks
 		if (const auto toAckSize = _ackRequestData.size()) {
 			DEBUG_LOG(("MTP Info: will send %1 acks, ids: %2").arg(toAckSize).arg(LogIdsVector(_ackRequestData)));
-			_sessionData->queueSendAnything(kAckSendWaiting);
+			_sessionData->queueSendAnything((toAckSize >= kAckSendForceCount)
+				? kSendStateRequestWaiting
+				: kAckSendWaiting);
 		}
 
 		auto lock = QReadLocker(_sessionData->haveReceivedMutex());
@@ -1401,11 +1699,44 @@ void SessionPrivate::handleReceived() {
 			}
 		}
 	}
+	if (_decryptedBuffer.capacity() > kMaxKeptDecryptedBufferSize) {
+		_decryptedBuffer = bytes::vector();
+	}
+	_receivedStats.total += crl::profile() - handleStarted;
+	logReceivedStats();
+
 	if (_connection->needHttpWait()) {
 		_sessionData->queueSendAnything();
 	}
 }
 
+void SessionPrivate::logReceivedStats() {
+	const auto now = crl::now();
+	if (!_receivedStats.started) {
+		_receivedStats.started = now;
+	}
+	const auto passed = now - _receivedStats.started;
+	if (passed < kReceivedStatsPeriod || !_receivedStats.packets) {
+		return;
+	}
+	const auto stats = base::take(_receivedStats);
+	_receivedStats.started = now;
+	const auto perPacket = [&](crl::profile_time value) {
+		return QString::number(value / double(stats.packets), 'f', 1);
+	};
+	DEBUG_LOG(("MTP Info: dc %1 received %2 packets in %3ms, "
+		"%4 packets per second, %5 MB per second, "
+		"per packet mcs: %6 predecrypt, %7 dispatch, %8 total."
+		).arg(_shiftedDcId
+		).arg(stats.packets
+		).arg(passed
+		).arg(stats.packets * 1000. / passed, 0, 'f', 1
+		).arg(stats.bytes * 1000. / (passed * 1024. * 1024.), 0, 'f', 3
+		).arg(perPacket(stats.decrypt)
+		).arg(perPacket(stats.dispatch)
+		).arg(perPacket(stats.total)));
+}
+
 SessionPrivate::HandleResult SessionPrivate::handleOneReceived(
 		const mtpPrime *from,
 		const mtpPrime *end,
@@ -2135,7 +2466,8 @@ void SessionPrivate::handleMsgsStates(const QVector<MTPlong> &ids, const QByteAr
 		const auto requestMsgId = ids[i].v;
 		{
 			QReadLocker locker(_sessionData->haveSentMutex());
-			if (!_sessionData->haveSentMap().contains(requestMsgId)) {
+			const auto &haveSent = _sessionData->haveSentMap();
+			if (haveSent.find(requestMsgId) == end(haveSent)) {
 				DEBUG_LOG(("Message Info: state was received for msgId %1, but request is not found, looking in resent requests...").arg(requestMsgId));
 				const auto reqIt = _resendingIds.find(requestMsgId);
 				if (reqIt != _resendingIds.cend()) {
@@ -2248,6 +2580,13 @@ void SessionPrivate::onConnected(
 		connection.get(),
 		[](const TestConnection &test) { return test.data.get(); });
 	Assert(i != end(_testConnections));
+	if (!i->ip.empty()) {
+		_instance->dcOptions().registerConnected(
+			i->ip,
+			i->port,
+			connection->pingTime());
+		saveEndpointStats();
+	}
 	const auto my = i->priority;
 	const auto j = ranges::find_if(
 		_testConnections,
@@ -2285,7 +2624,8 @@ void SessionPrivate::confirmBestConnection() {
 		_testConnections,
 		std::less<>(),
 		[](const TestConnection &test) {
-			return test.data->isConnected() ? test.priority : -1;
+			// Failing endpoints have priority -1, keep them usable.
+			return test.data->isConnected() ? test.priority : -2;
 		});
 	Assert(i != end(_testConnections));
 	if (!i->data->isConnected()) {
@@ -2303,6 +2643,13 @@ void SessionPrivate::confirmBestConnection() {
 
 void SessionPrivate::removeTestConnection(
 		not_null<AbstractConnection*> connection) {
+	const auto i = ranges::find(
+		_testConnections,
+		connection.get(),
+		[](const TestConnection &test) { return test.data.get(); });
+	if (i != end(_testConnections) && !connection->isConnected()) {
+		registerConnectFailed(*i);
+	}
 	_testConnections.erase(
 		ranges::remove(
 			_testConnections,
@@ -2311,6 +2658,22 @@ void SessionPrivate::removeTestConnection(
 		end(_testConnections));
 }
 
+void SessionPrivate::registerConnectFailed(const TestConnection &connection) {
+	if (connection.ip.empty()) {
+		return;
+	}
+	_instance->dcOptions().registerConnectFailed(
+		connection.ip,
+		connection.port);
+	saveEndpointStats();
+}
+
+void SessionPrivate::saveEndpointStats() {
+	InvokeQueued(_instance, [instance = _instance] {
+		instance->dcOptions().notifyEndpointStatsChanged();
+	});
+}
+
 void SessionPrivate::checkAuthKey() {
 	if (_keyId) {
 		authKeyChecked();
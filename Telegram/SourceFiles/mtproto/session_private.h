@@ -57,6 +57,8 @@ private:
 	struct TestConnection {
 		ConnectionPointer data;
 		int priority = 0;
+		std::string ip; // Empty when connecting through a proxy.
+		int port = 0;
 	};
 	struct SentContainer {
 		crl::time sent = 0;
@@ -86,8 +88,10 @@ private:
 	void onReceivedSome();
 
 	void handleReceived();
+	void logReceivedStats();
 
 	void retryByTimer();
+	void registerContainerSent(int messages, int ints);
 	void waitConnectedFailed();
 	void waitReceivedFailed();
 	void waitBetterFailed();
@@ -97,9 +101,12 @@ private:
 
 	void confirmBestConnection();
 	void removeTestConnection(not_null<AbstractConnection*> connection);
+	void registerConnectFailed(const TestConnection &connection);
+	void saveEndpointStats();
 	[[nodiscard]] int16 getProtocolDcId() const;
 
 	void checkSentRequests();
+	[[nodiscard]] bool renewExpiringTemporaryKey();
 	void clearOldContainers();
 
 	mtpMsgId placeToContainer(
@@ -217,11 +224,29 @@ private:
 	uint64 _sessionSalt = 0;
 	uint32 _messagesCounter = 0;
 	bool _sessionMarkedAsStarted = false;
+	int64 _gzipPackedRequests = 0;
+	int64 _gzipSavedBytes = 0;
+
+	struct ReceivedStats {
+		crl::time started = 0;
+		int64 packets = 0;
+		int64 bytes = 0;
+		crl::profile_time decrypt = 0;
+		crl::profile_time dispatch = 0;
+		crl::profile_time total = 0;
+	};
+	ReceivedStats _receivedStats;
+
+	crl::time _containersStatsStart = 0;
+	int64 _containersSent = 0;
+	int64 _containersSentMessages = 0;
+	int64 _containersSentBytes = 0;
 
 	QVector<MTPlong> _ackRequestData;
 	QVector<MTPlong> _resendRequestData;
 	base::flat_set<mtpMsgId> _stateRequestData;
 	ReceivedIdsManager _receivedMessageIds;
+	bytes::vector _decryptedBuffer; // Reused between received messages.
 	base::flat_map<mtpMsgId, mtpRequestId> _resendingIds;
 	base::flat_map<mtpMsgId, mtpRequestId> _ackedIds;
 	base::flat_map<mtpMsgId, SerializedRequest> _stateAndResendRequests;
@@ -12,7 +12,6 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/mtproto_auth_key.h"
 #include "base/unixtime.h"
 #include "base/openssl_help.h"
-#include "base/call_delayed.h"
 
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonArray>
@@ -193,7 +192,8 @@ SpecialConfigRequest::SpecialConfigRequest(
 : _callback(std::move(callback))
 , _timeDoneCallback(std::move(timeDoneCallback))
 , _domainString(domainString)
-, _phone(phone) {
+, _phone(phone)
+, _sendNextTimer([=] { sendNextRequest(); }) {
 	Expects((_callback == nullptr) != (_timeDoneCallback == nullptr));
 
 	_manager.setProxy(QNetworkProxy::NoProxy);
@@ -268,14 +268,13 @@ SpecialConfigRequest::SpecialConfigRequest(
 }
 
 void SpecialConfigRequest::sendNextRequest() {
-	Expects(!_attempts.empty());
-
+	if (_attempts.empty()) {
+		return;
+	}
 	const auto attempt = _attempts.back();
 	_attempts.pop_back();
 	if (!_attempts.empty()) {
-		base::call_delayed(kSendNextTimeout, this, [=] {
-			sendNextRequest();
-		});
+		_sendNextTimer.callOnce(kSendNextTimeout);
 	}
 	performRequest(attempt);
 }
@@ -378,7 +377,13 @@ void SpecialConfigRequest::requestFinished(
 		Type type,
 		not_null<QNetworkReply*> reply) {
 	handleHeaderUnixtime(reply);
+	const auto failed = (reply->error() != QNetworkReply::NoError);
 	const auto result = finalizeRequest(reply);
+	if (failed && _requests.empty()) {
+		// Everything sent so far has failed, for example a blocked
+		// network resets the connections, don't wait for the timeout.
+		sendNextRequest();
+	}
 	if (!_callback) {
 		return;
 	}
@@ -10,6 +10,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/details/mtproto_domain_resolver.h"
 #include "base/bytes.h"
 #include "base/weak_ptr.h"
+#include "base/timer.h"
 
 #include <QtCore/QPointer>
 #include <QtNetwork/QNetworkReply>
@@ -76,6 +77,7 @@ private:
 	QNetworkAccessManager _manager;
 	std::vector<Attempt> _attempts;
 	std::vector<ServiceWebRequest> _requests;
+	base::Timer _sendNextTimer;
 
 };
 
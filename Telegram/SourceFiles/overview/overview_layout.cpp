@@ -1548,6 +1548,7 @@ Link::Link(
 void Link::initDimensions() {
 	_maxw = st::linksMaxWidth;
 	_minh = 0;
+	_height = 0;
 	if (!_title.isEmpty()) {
 		_minh += st::semiboldFont->height;
 	}
@@ -1559,6 +1560,10 @@ void Link::initDimensions() {
 }
 
 int32 Link::resizeGetHeight(int32 width) {
+	if (_height > 0 && _width == qMin(width, _maxw)) {
+		// Sections are rebuilt on each slice update, skip text layout.
+		return _height;
+	}
 	_width = qMin(width, _maxw);
 	int32 w = _width - st::linksPhotoSize - st::linksPhotoPadding;
 	for (const auto &link : _links) {
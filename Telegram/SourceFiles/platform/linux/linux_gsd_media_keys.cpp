@@ -30,6 +30,7 @@ constexpr auto kObjectPath = "/org/gnome/SettingsDaemon/MediaKeys"_cs;
 constexpr auto kMATEObjectPath = "/org/mate/SettingsDaemon/MediaKeys"_cs;
 constexpr auto kInterface = kService;
 constexpr auto kMATEInterface = "org.mate.SettingsDaemon.MediaKeys"_cs;
+constexpr auto kCallTimeout = 5000;
 
 void KeyPressed(
 		GDBusConnection *connection,
@@ -66,6 +67,30 @@ void KeyPressed(
 
 } // namespace
 
+void GSDMediaKeys::GrabFinished(
+		GObject *source,
+		GAsyncResult *result,
+		gpointer user_data) {
+	const auto weak = std::unique_ptr<base::weak_ptr<GSDMediaKeys>>(
+		static_cast<base::weak_ptr<GSDMediaKeys>*>(user_data));
+
+	GError *error = nullptr;
+	auto reply = g_dbus_connection_call_finish(
+		G_DBUS_CONNECTION(source),
+		result,
+		&error);
+
+	if (!error) {
+		if (const auto strong = weak->get()) {
+			strong->_grabbed = true;
+		}
+		g_variant_unref(reply);
+	} else {
+		LOG(("GSD Media Keys Error: %1").arg(error->message));
+		g_error_free(error);
+	}
+}
+
 GSDMediaKeys::GSDMediaKeys() {
 	GError *error = nullptr;
 	const auto interface = QDBusConnection::sessionBus().interface();
@@ -101,7 +126,8 @@ GSDMediaKeys::GSDMediaKeys() {
 		return;
 	}
 
-	auto reply = g_dbus_connection_call_sync(
+	// Don't block the main thread if the settings daemon is slow.
+	g_dbus_connection_call(
 		_dbusConnection,
 		_service.toUtf8(),
 		_objectPath.toUtf8(),
@@ -113,17 +139,10 @@ GSDMediaKeys::GSDMediaKeys() {
 			0),
 		nullptr,
 		G_DBUS_CALL_FLAGS_NONE,
-		-1,
+		kCallTimeout,
 		nullptr,
-		&error);
-
-	if (!error) {
-		_grabbed = true;
-		g_variant_unref(reply);
-	} else {
-		LOG(("GSD Media Keys Error: %1").arg(error->message));
-		g_error_free(error);
-	}
+		GrabFinished,
+		new base::weak_ptr<GSDMediaKeys>(this));
 
 	_signalId = g_dbus_connection_signal_subscribe(
 		_dbusConnection,
@@ -139,8 +158,6 @@ GSDMediaKeys::GSDMediaKeys() {
 }
 
 GSDMediaKeys::~GSDMediaKeys() {
-	GError *error = nullptr;
-
 	if (_signalId != 0) {
 		g_dbus_connection_signal_unsubscribe(
 			_dbusConnection,
@@ -148,7 +165,8 @@ GSDMediaKeys::~GSDMediaKeys() {
 	}
 
 	if (_grabbed) {
-		auto reply = g_dbus_connection_call_sync(
+		// Nobody waits for the reply, the call is only sent.
+		g_dbus_connection_call(
 			_dbusConnection,
 			_service.toUtf8(),
 			_objectPath.toUtf8(),
@@ -159,17 +177,11 @@ GSDMediaKeys::~GSDMediaKeys() {
 				QCoreApplication::applicationName().toUtf8().constData()),
 			nullptr,
 			G_DBUS_CALL_FLAGS_NONE,
-			-1,
+			kCallTimeout,
 			nullptr,
-			&error);
-
-		if (!error) {
-			_grabbed = false;
-			g_variant_unref(reply);
-		} else {
-			LOG(("GSD Media Keys Error: %1").arg(error->message));
-			g_error_free(error);
-		}
+			nullptr,
+			nullptr);
+		_grabbed = false;
 	}
 
 	if (_dbusConnection) {
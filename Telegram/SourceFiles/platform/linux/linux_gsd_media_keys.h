@@ -7,12 +7,17 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #pragma once
 
+#include "base/weak_ptr.h"
+
 typedef struct _GDBusConnection GDBusConnection;
+typedef struct _GObject GObject;
+typedef struct _GAsyncResult GAsyncResult;
+typedef void* gpointer;
 
 namespace Platform {
 namespace internal {
 
-class GSDMediaKeys {
+class GSDMediaKeys final : public base::has_weak_ptr {
 public:
 	GSDMediaKeys();
 
@@ -24,6 +29,11 @@ public:
 	~GSDMediaKeys();
 
 private:
+	static void GrabFinished(
+		GObject *source,
+		GAsyncResult *result,
+		gpointer user_data);
+
 	GDBusConnection *_dbusConnection = nullptr;
 	QString _service;
 	QString _objectPath;
@@ -76,6 +76,9 @@ constexpr auto kAppMenuInterface = kAppMenuService;
 
 constexpr auto kMainMenuObjectPath = "/MenuBar"_cs;
 
+// Regenerating tray and taskbar icons is expensive, do it once a second.
+constexpr auto kIconCountersUpdateDelay = crl::time(1000);
+
 bool TrayIconMuted = true;
 int32 TrayIconCount = 0;
 base::flat_map<int, QImage> TrayIconImageBack;
@@ -521,7 +524,8 @@ void ForceDisabled(QAction *action, bool disabled) {
 } // namespace
 
 MainWindow::MainWindow(not_null<Window::Controller*> controller)
-: Window::MainWindow(controller) {
+: Window::MainWindow(controller)
+, _updateIconCountersTimer([=] { updateIconCounters(); }) {
 #ifndef DESKTOP_APP_DISABLE_DBUS_INTEGRATION
 	qDBusRegisterMetaType<ToolTip>();
 	qDBusRegisterMetaType<IconPixmap>();
@@ -849,10 +853,20 @@ void MainWindow::workmodeUpdated(DBIWorkMode mode) {
 
 void MainWindow::unreadCounterChangedHook() {
 	setWindowTitle(titleText());
-	updateIconCounters();
+
+	const auto now = crl::now();
+	const auto next = _iconCountersUpdated + kIconCountersUpdateDelay;
+	if (now >= next) {
+		updateIconCounters();
+	} else if (!_updateIconCountersTimer.isActive()) {
+		_updateIconCountersTimer.callOnce(next - now);
+	}
 }
 
 void MainWindow::updateIconCounters() {
+	_updateIconCountersTimer.cancel();
+	_iconCountersUpdated = crl::now();
+
 	const auto counter = Core::App().unreadBadge();
 	const auto muted = Core::App().unreadBadgeMuted();
 
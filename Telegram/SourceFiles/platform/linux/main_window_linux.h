@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "platform/platform_main_window.h"
 #include "base/unique_qptr.h"
+#include "base/timer.h"
 
 namespace Ui {
 class PopupMenu;
@@ -77,6 +78,8 @@ protected:
 private:
 	bool _sniAvailable = false;
 	base::unique_qptr<Ui::PopupMenu> _trayIconMenuXEmbed;
+	base::Timer _updateIconCountersTimer;
+	crl::time _iconCountersUpdated = 0;
 
 	void updateIconCounters();
 	void updateWaylandDecorationColors();
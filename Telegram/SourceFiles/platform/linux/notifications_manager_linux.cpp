@@ -24,7 +24,6 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include <QtDBus/QDBusPendingCall>
 #include <QtDBus/QDBusPendingCallWatcher>
 #include <QtDBus/QDBusPendingReply>
-#include <QtDBus/QDBusReply>
 #include <QtDBus/QDBusError>
 
 extern "C" {
@@ -51,6 +50,8 @@ struct ServerInformation {
 
 bool ServiceRegistered = false;
 bool InhibitionSupported = false;
+bool InhibitedValue = false;
+bool InhibitedRequested = false;
 std::optional<ServerInformation> CurrentServerInformation;
 QStringList CurrentCapabilities;
 
@@ -156,7 +157,8 @@ void GetInhibitionSupported(Fn<void(bool)> callback) {
 	};
 
 	const auto finished = [=](QDBusPendingCallWatcher *call) {
-		const auto error = QDBusPendingReply<QVariant>(*call).error();
+		const QDBusPendingReply<QVariant> reply = *call;
+		const auto error = reply.error();
 
 		if (!ranges::contains(DontLogErrors, error.type())) {
 			LOG(("Native Notification Error: %1: %2")
@@ -164,19 +166,24 @@ void GetInhibitionSupported(Fn<void(bool)> callback) {
 				.arg(error.message()));
 		}
 
-		crl::on_main([=] { callback(!error.isValid()); });
+		// The first Inhibited() call already has the actual value.
+		const auto supported = !error.isValid();
+		const auto value = supported && reply.value().toBool();
+		crl::on_main([=] {
+			InhibitedValue = value;
+			callback(supported);
+		});
 		call->deleteLater();
 	};
 
 	QObject::connect(watcher, &QDBusPendingCallWatcher::finished, finished);
 }
 
-bool Inhibited() {
-	if (!Supported()
-		|| !CurrentCapabilities.contains(qsl("inhibitions"))
-		|| !InhibitionSupported) {
-		return false;
+void RequestInhibited() {
+	if (InhibitedRequested) {
+		return;
 	}
+	InhibitedRequested = true;
 
 	auto message = QDBusMessage::createMethodCall(
 		kService.utf16(),
@@ -189,18 +196,39 @@ bool Inhibited() {
 		qsl("Inhibited")
 	});
 
-	const QDBusReply<QVariant> reply = QDBusConnection::sessionBus().call(
-		message);
+	const auto async = QDBusConnection::sessionBus().asyncCall(message);
+	auto watcher = new QDBusPendingCallWatcher(async);
 
-	if (reply.isValid()) {
-		return reply.value().toBool();
-	}
+	const auto finished = [=](QDBusPendingCallWatcher *call) {
+		const QDBusPendingReply<QVariant> reply = *call;
+
+		if (reply.isValid()) {
+			const auto value = reply.value().toBool();
+			crl::on_main([=] { InhibitedValue = value; });
+		} else {
+			LOG(("Native Notification Error: %1: %2")
+				.arg(reply.error().name())
+				.arg(reply.error().message()));
+		}
+		crl::on_main([] { InhibitedRequested = false; });
+
+		call->deleteLater();
+	};
 
-	LOG(("Native Notification Error: %1: %2")
-			.arg(reply.error().name())
-			.arg(reply.error().message()));
+	QObject::connect(watcher, &QDBusPendingCallWatcher::finished, finished);
+}
+
+bool Inhibited() {
+	if (!Supported()
+		|| !CurrentCapabilities.contains(qsl("inhibitions"))
+		|| !InhibitionSupported) {
+		return false;
+	}
 
-	return false;
+	// Don't wait for the daemon on each notification,
+	// use the last known value and refresh it in background.
+	RequestInhibited();
+	return InhibitedValue;
 }
 
 bool IsQualifiedDaemon() {
@@ -267,7 +295,7 @@ public:
 
 	void show();
 	void close();
-	void setImage(const QString &imagePath);
+	void setImage(const QImage &image);
 
 private:
 	GDBusConnection *_dbusConnection = nullptr;
@@ -562,12 +590,12 @@ void NotificationData::close() {
 		nullptr);
 }
 
-void NotificationData::setImage(const QString &imagePath) {
+void NotificationData::setImage(const QImage &image) {
 	if (_imageKey.isEmpty()) {
 		return;
 	}
 
-	_image = QImage(imagePath).convertToFormat(QImage::Format_RGBA8888);
+	_image = image.convertToFormat(QImage::Format_RGBA8888);
 
 	_hints.emplace(_imageKey, g_variant_new(
 		"(iiibii@ay)",
@@ -848,7 +876,7 @@ void Manager::Private::showNotification(
 	if (!hideNameAndPhoto) {
 		const auto userpicKey = peer->userpicUniqueKey(userpicView);
 		notification->setImage(
-			_cachedUserpics.get(userpicKey, peer, userpicView));
+			_cachedUserpics.image(userpicKey, peer, userpicView));
 	}
 
 	auto i = _notifications.find(key);
@@ -21,6 +21,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/application.h"
 #include "mtproto/mtp_instance.h"
 #include "mtproto/mtproto_dc_options.h"
+#include "core/core_probes.h"
 #include "core/file_utilities.h"
 #include "core/update_checker.h"
 #include "window/themes/window_theme.h"
@@ -49,6 +50,42 @@ auto GenerateCodes() {
 	codes.emplace(qsl("viewlogs"), [](SessionController *window) {
 		File::ShowInFolder(cWorkingDir() + "log.txt");
 	});
+	codes.emplace(qsl("probes"), [](SessionController *window) {
+		const auto path = cWorkingDir() + "probes.txt";
+		auto f = QFile(path);
+		if (!f.open(QIODevice::WriteOnly)) {
+			Ui::show(Box<InformBox>("Could not write " + path));
+			return;
+		}
+		f.write(Core::DumpProbes().toUtf8());
+		f.close();
+		File::ShowInFolder(path);
+	});
+	codes.emplace(qsl("memory"), [](SessionController *window) {
+		if (!window) {
+			return;
+		}
+		const auto report = window->session().data().memoryReport();
+		LOG(("Memory Report:\n%1").arg(report));
+		Ui::show(Box<InformBox>(report));
+	});
+	codes.emplace(qsl("tracing"), [](SessionController *window) {
+		if (!Core::TracingStarted()) {
+			Core::StartTracing();
+			Ui::Toast::Show("Tracing started, type 'tracing' again to stop.");
+			return;
+		}
+		const auto path = cWorkingDir() + "trace.json";
+		auto f = QFile(path);
+		const auto trace = Core::FinishTracing();
+		if (!f.open(QIODevice::WriteOnly)) {
+			Ui::show(Box<InformBox>("Could not write " + path));
+			return;
+		}
+		f.write(trace);
+		f.close();
+		File::ShowInFolder(path);
+	});
 	if (!Core::UpdaterDisabled()) {
 		codes.emplace(qsl("testupdate"), [](SessionController *window) {
 			Core::UpdateChecker().test();
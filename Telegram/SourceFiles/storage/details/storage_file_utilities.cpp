@@ -13,6 +13,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include <QtCore/QtEndian>
 #include <QtCore/QSaveFile>
+#include <atomic>
 
 namespace Storage {
 namespace details {
@@ -23,6 +24,88 @@ constexpr auto TdfMagicLen = int(sizeof(TdfMagic));
 
 constexpr auto kStrongIterationsCount = 100'000;
 
+// Files are written (and removed) in order on a background queue,
+// so that fsync-ing them doesn't block the main thread.
+std::atomic<int> PendingWrites = 0;
+
+[[nodiscard]] crl::queue &WriteQueue() {
+	static crl::queue Queue;
+	return Queue;
+}
+
+[[nodiscard]] bool OpenForWrite(
+		QFileDevice &file,
+		const QString &name,
+		const QString &basePath) {
+	file.setFileName(name);
+	const auto opened = [&] {
+		if (file.open(QIODevice::WriteOnly)) {
+			return true;
+		}
+		const auto dir = QDir(basePath);
+		if (dir.exists()) {
+			return false;
+		} else if (!QDir().mkpath(dir.absolutePath())) {
+			return false;
+		}
+		return file.open(QIODevice::WriteOnly);
+	}();
+	if (!opened) {
+		LOG(("Storage Error: Could not open '%1' for writing.").arg(name));
+		return false;
+	}
+	file.write(TdfMagic, TdfMagicLen);
+	const auto version = qint32(AppVersion);
+	file.write((const char*)&version, sizeof(version));
+	return true;
+}
+
+void WriteSafeFile(
+		const QString &base,
+		const QString &basePath,
+		const QByteArray &data,
+		const QByteArray &footer) {
+	const auto safe = base + 's';
+	const auto simple = base + '0';
+	const auto backup = base + '1';
+	QSaveFile save;
+	if (OpenForWrite(save, safe, basePath)) {
+		save.write(data);
+		save.write(footer);
+		if (save.commit()) {
+			QFile::remove(simple);
+			QFile::remove(backup);
+			return;
+		}
+		LOG(("Storage Error: Could not commit '%1'.").arg(safe));
+	}
+	QFile plain;
+	if (OpenForWrite(plain, simple, basePath)) {
+		plain.write(data);
+		plain.write(footer);
+		base::Platform::FlushFileData(plain);
+		plain.close();
+
+		QFile::remove(backup);
+		if (base::Platform::RenameWithOverwrite(simple, safe)) {
+			return;
+		}
+		QFile::remove(safe);
+		LOG(("Storage Error: Could not rename '%1' to '%2', removing."
+			).arg(simple
+			).arg(safe));
+	}
+}
+
+void RemoveKeyFiles(QString name) {
+	name.append('0');
+	QFile::remove(name);
+	name[name.size() - 1] = '1';
+	QFile::remove(name);
+	name[name.size() - 1] = 's';
+	QFile::remove(name);
+}
+
 } // namespace
 
 QString ToFilePart(FileKey val) {
@@ -69,12 +152,16 @@ FileKey GenerateKey(const QString &basePath) {
 void ClearKey(const FileKey &key, const QString &basePath) {
 	QString name;
 	name.reserve(basePath.size() + 0x11);
-	name.append(basePath).append(ToFilePart(key)).append('0');
-	QFile::remove(name);
-	name[name.size() - 1] = '1';
-	QFile::remove(name);
-	name[name.size() - 1] = 's';
-	QFile::remove(name);
+	name.append(basePath).append(ToFilePart(key));
+	if (!PendingWrites) {
+		RemoveKeyFiles(std::move(name));
+		return;
+	}
+	++PendingWrites;
+	WriteQueue().async([name = std::move(name)] {
+		RemoveKeyFiles(name);
+		--PendingWrites;
+	});
 }
 
 bool CheckStreamStatus(QDataStream &stream) {
@@ -180,42 +267,6 @@ FileWriteDescriptor::~FileWriteDescriptor() {
 	finish();
 }
 
-QString FileWriteDescriptor::path(char postfix) const {
-	return _base + postfix;
-}
-
-template <typename File>
-bool FileWriteDescriptor::open(File &file, char postfix) {
-	const auto name = path(postfix);
-	file.setFileName(name);
-	if (!writeHeader(file)) {
-		LOG(("Storage Error: Could not open '%1' for writing.").arg(name));
-		return false;
-	}
-	return true;
-}
-
-bool FileWriteDescriptor::writeHeader(QFileDevice &file) {
-	if (!file.open(QIODevice::WriteOnly)) {
-		const auto dir = QDir(_basePath);
-		if (dir.exists()) {
-			return false;
-		} else if (!QDir().mkpath(dir.absolutePath())) {
-			return false;
-		} else if (!file.open(QIODevice::WriteOnly)) {
-			return false;
-		}
-	}
-	file.write(TdfMagic, TdfMagicLen);
-	const auto version = qint32(AppVersion);
-	file.write((const char*)&version, sizeof(version));
-	return true;
-}
-
-void FileWriteDescriptor::writeFooter(QFileDevice &file) {
-	file.write((const char*)_md5.result(), 0x10);
-}
-
 void FileWriteDescriptor::init(const QString &name) {
 	_base = _basePath + name;
 	_buffer.setBuffer(&_safeData);
@@ -257,36 +308,37 @@ void FileWriteDescriptor::finish() {
 
 	_buffer.close();
 
-	const auto safe = path('s');
-	const auto simple = path('0');
-	const auto backup = path('1');
-	QSaveFile save;
-	if (open(save, 's')) {
-		save.write(_safeData);
-		writeFooter(save);
-		if (save.commit()) {
-			QFile::remove(simple);
-			QFile::remove(backup);
-			return;
-		}
-		LOG(("Storage Error: Could not commit '%1'.").arg(safe));
-	}
-	QFile plain;
-	if (open(plain, '0')) {
-		plain.write(_safeData);
-		writeFooter(plain);
-		base::Platform::FlushFileData(plain);
-		plain.close();
+	auto footer = QByteArray(
+		reinterpret_cast<const char*>(_md5.result()),
+		0x10);
+	++PendingWrites;
+	WriteQueue().async([
+			base = _base,
+			basePath = _basePath,
+			data = std::move(_safeData),
+			footer = std::move(footer)] {
+		WriteSafeFile(base, basePath, data, footer);
+		--PendingWrites;
+	});
+}
 
-		QFile::remove(backup);
-		if (base::Platform::RenameWithOverwrite(simple, safe)) {
-			return;
-		}
-		QFile::remove(safe);
-		LOG(("Storage Error: Could not rename '%1' to '%2', removing."
-			).arg(simple
-			).arg(safe));
+void WaitPendingWrites() {
+	if (!PendingWrites) {
+		return;
 	}
+	crl::semaphore semaphore;
+	WriteQueue().async([&] {
+		semaphore.release();
+	});
+	semaphore.acquire();
+}
+
+void AfterPendingWrites(Fn<void()> callback) {
+	++PendingWrites;
+	WriteQueue().async([callback = std::move(callback)] {
+		callback();
+		--PendingWrites;
+	});
 }
 
 [[nodiscard]] QByteArray PrepareEncrypted(
@@ -314,6 +366,8 @@ bool ReadFile(
 		FileReadDescriptor &result,
 		const QString &name,
 		const QString &basePath) {
+	WaitPendingWrites();
+
 	const auto base = basePath + name;
 
 	// detect order of read attempts
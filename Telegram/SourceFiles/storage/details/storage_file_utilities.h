@@ -19,6 +19,12 @@ namespace details {
 [[nodiscard]] FileKey GenerateKey(const QString &basePath);
 void ClearKey(const FileKey &key, const QString &basePath);
 
+// Blocks until all the files queued for writing are on disk.
+void WaitPendingWrites();
+
+// Runs the callback on the writing queue, after all the queued files.
+void AfterPendingWrites(Fn<void()> callback);
+
 [[nodiscard]] bool CheckStreamStatus(QDataStream &stream);
 [[nodiscard]] MTP::AuthKeyPtr CreateLocalKey(
 	const QByteArray &passcode,
@@ -69,11 +75,6 @@ public:
 
 private:
 	void init(const QString &name);
-	[[nodiscard]] QString path(char postfix) const;
-	template <typename File>
-	[[nodiscard]] bool open(File &file, char postfix);
-	[[nodiscard]] bool writeHeader(QFileDevice &file);
-	void writeFooter(QFileDevice &file);
 	void finish();
 
 	const QString _basePath;
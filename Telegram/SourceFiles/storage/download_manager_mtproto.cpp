@@ -20,6 +20,7 @@ namespace {
 constexpr auto kKillSessionTimeout = 15 * crl::time(1000);
 constexpr auto kStartWaitedInSession = 4 * kDownloadPartSize;
 constexpr auto kMaxWaitedInSession = 16 * kDownloadPartSize;
+constexpr auto kMaxBdpWaitedInSession = 64 * kDownloadPartSize;
 constexpr auto kStartSessionsCount = 1;
 constexpr auto kMaxSessionsCount = 8;
 constexpr auto kMaxTrackedSessionRemoves = 64;
@@ -30,11 +31,24 @@ constexpr auto kMaxTrackedSuccesses = kRetryAddSessionSuccesses
 constexpr auto kRemoveSessionAfterTimeouts = 4;
 constexpr auto kResetDownloadPrioritiesTimeout = crl::time(200);
 constexpr auto kBadRequestDurationThreshold = 8 * crl::time(1000);
+constexpr auto kBandwidthSampleDuration = crl::time(250);
+constexpr auto kBandwidthFilterWindow = 10 * crl::time(1000);
+constexpr auto kRttFilterWindow = 10 * crl::time(1000);
+constexpr auto kBdpGain = 2;
 
 // Each (session remove by timeouts) we wait for time:
 // kRetryAddSessionTimeout * max(removesCount, kMaxTrackedSessionRemoves)
 // and for successes in all remaining sessions:
 // kRetryAddSessionSuccesses * max(removesCount, kMaxTrackedSessionRemoves)
+//
+// The bandwidth-delay product (max recent bandwidth * min recent rtt)
+// decides how many sessions we want in a dc and how many bytes we allow
+// to be waited in each of them. Until we have a measurement we allow
+// kMaxSessionsCount sessions with kMaxWaitedInSession bytes each.
+
+[[nodiscard]] crl::time MinNonZero(crl::time a, crl::time b) {
+	return !a ? b : !b ? a : std::min(a, b);
+}
 
 } // namespace
 
@@ -66,10 +80,12 @@ void DownloadManagerMtproto::Queue::remove(not_null<Task*> task) {
 }
 
 void DownloadManagerMtproto::Queue::resetGeneration() {
+	// Tasks requested in the current generation have priority 0, older
+	// ones -1, auto downloads are put below them with negative values.
 	const auto from = ranges::find(_tasks, 0, &Enqueued::priority);
 	for (auto &task : ranges::make_subrange(from, end(_tasks))) {
 		if (task.priority) {
-			Assert(task.priority == -1);
+			Assert(task.priority < 0);
 			break;
 		}
 		task.priority = -1;
@@ -182,7 +198,7 @@ bool DownloadManagerMtproto::trySendNextPart(MTP::DcId dcId, Queue &queue) {
 		const auto proj = [](const DcSessionBalanceData &data) {
 			return (data.requested < data.maxWaitedAmount)
 				? data.requested
-				: kMaxWaitedInSession;
+				: kMaxBdpWaitedInSession;
 		};
 		const auto j = ranges::min_element(sessions, ranges::less(), proj);
 		return (j->requested + kDownloadPartSize <= j->maxWaitedAmount)
@@ -208,6 +224,12 @@ int DownloadManagerMtproto::changeRequestedAmount(
 	Assert(i != _balanceData.end());
 	Assert(index < i->second.sessions.size());
 	const auto result = (i->second.sessions[index].requested += delta);
+	if (delta > 0 && i->second.totalRequested <= 0) {
+		// Don't count the idle time in the bandwidth sample.
+		auto &bandwidth = i->second.bandwidth;
+		bandwidth.sampleStart = 0;
+		bandwidth.sampleBytes = 0;
+	}
 	i->second.totalRequested += delta;
 	const auto findNonEmptySession = [](const DcBalanceData &data) {
 		using namespace rpl::mappers;
@@ -228,7 +250,8 @@ void DownloadManagerMtproto::requestSucceeded(
 		MTP::DcId dcId,
 		int index,
 		int amountAtRequestStart,
-		crl::time timeAtRequestStart) {
+		crl::time timeAtRequestStart,
+		int receivedBytes) {
 	using namespace rpl::mappers;
 
 	const auto i = _balanceData.find(dcId);
@@ -246,6 +269,7 @@ void DownloadManagerMtproto::requestSucceeded(
 		).arg(duration
 		).arg(parts
 		).arg(overloaded ? " (overloaded)" : ""));
+	updateBandwidth(dcId, dc, duration, receivedBytes);
 	if (overloaded) {
 		return;
 	}
@@ -257,11 +281,14 @@ void DownloadManagerMtproto::requestSucceeded(
 		});
 		return;
 	}
+	const auto maxWaitedInSession = dc.bandwidth.waitedInSession
+		? dc.bandwidth.waitedInSession
+		: kMaxWaitedInSession;
 	if (amountAtRequestStart == data.maxWaitedAmount
-		&& data.maxWaitedAmount < kMaxWaitedInSession) {
+		&& data.maxWaitedAmount < maxWaitedInSession) {
 		data.maxWaitedAmount = std::min(
 			data.maxWaitedAmount + kDownloadPartSize,
-			kMaxWaitedInSession);
+			maxWaitedInSession);
 		DEBUG_LOG(("Download (%1,%2) increased max waited amount %3."
 			).arg(dcId
 			).arg(index
@@ -281,7 +308,9 @@ void DownloadManagerMtproto::requestSucceeded(
 	if (dc.timeouts > 0) {
 		--dc.timeouts;
 		return;
-	} else if (dc.sessions.size() == kMaxSessionsCount) {
+	} else if (dc.sessions.size() >= (dc.bandwidth.desiredSessions
+		? dc.bandwidth.desiredSessions
+		: kMaxSessionsCount)) {
 		return;
 	}
 	const auto now = crl::now();
@@ -296,6 +325,75 @@ void DownloadManagerMtproto::requestSucceeded(
 		).arg(dc.sessions.size()));
 }
 
+void DownloadManagerMtproto::updateBandwidth(
+		MTP::DcId dcId,
+		DcBalanceData &dc,
+		crl::time duration,
+		int receivedBytes) {
+	auto &data = dc.bandwidth;
+	const auto now = crl::now();
+	if (!data.rttWindowStart || now - data.rttWindowStart >= kRttFilterWindow) {
+		data.rttPrevious = data.rtt;
+		data.rtt = 0;
+		data.rttWindowStart = now;
+	}
+	data.rtt = MinNonZero(data.rtt, std::max(duration, crl::time(1)));
+
+	if (!data.sampleStart) {
+		data.sampleStart = now - duration;
+	}
+	data.sampleBytes += receivedBytes;
+	const auto elapsed = now - data.sampleStart;
+	if (elapsed < kBandwidthSampleDuration) {
+		return;
+	}
+	const auto sample = data.sampleBytes * 1000 / elapsed;
+	data.sampleStart = now;
+	data.sampleBytes = 0;
+	if (!data.bandwidthWindowStart
+		|| now - data.bandwidthWindowStart >= kBandwidthFilterWindow) {
+		data.bandwidthPrevious = data.bandwidth;
+		data.bandwidth = 0;
+		data.bandwidthWindowStart = now;
+	}
+	data.bandwidth = std::max(data.bandwidth, sample);
+
+	const auto bandwidth = std::max(data.bandwidth, data.bandwidthPrevious);
+	const auto rtt = MinNonZero(data.rtt, data.rttPrevious);
+	const auto bdp = kBdpGain * bandwidth * rtt / 1000;
+	const auto desiredSessions = std::clamp(
+		int((bdp + kMaxWaitedInSession - 1) / kMaxWaitedInSession),
+		kStartSessionsCount,
+		kMaxSessionsCount);
+	const auto sessionsCount = std::max(
+		int(dc.sessions.size()),
+		desiredSessions);
+	const auto parts = (bdp / sessionsCount + kDownloadPartSize - 1)
+		/ kDownloadPartSize;
+	const auto waitedInSession = std::clamp(
+		int(parts * kDownloadPartSize),
+		kMaxWaitedInSession,
+		kMaxBdpWaitedInSession);
+	if (data.desiredSessions == desiredSessions
+		&& data.waitedInSession == waitedInSession) {
+		return;
+	}
+	data.desiredSessions = desiredSessions;
+	data.waitedInSession = waitedInSession;
+	for (auto &session : dc.sessions) {
+		session.maxWaitedAmount = std::min(
+			session.maxWaitedAmount,
+			waitedInSession);
+	}
+	DEBUG_LOG(("Download (%1) window: %2 sessions, %3 parts each, "
+		"bandwidth: %4 KB/s, rtt: %5"
+		).arg(dcId
+		).arg(desiredSessions
+		).arg(waitedInSession / kDownloadPartSize
+		).arg(bandwidth / 1024
+		).arg(rtt));
+}
+
 int DownloadManagerMtproto::chooseSessionIndex(MTP::DcId dcId) const {
 	const auto i = _balanceData.find(dcId);
 	Assert(i != end(_balanceData));
@@ -348,9 +446,9 @@ void DownloadManagerMtproto::removeSession(MTP::DcId dcId) {
 	auto &session = dc.sessions.back();
 
 	// Make sure we don't send anything to that session while redirecting.
-	session.requested += kMaxWaitedInSession * kMaxSessionsCount;
+	session.requested += kMaxBdpWaitedInSession * kMaxSessionsCount;
 	queue.removeSession(index);
-	Assert(session.requested == kMaxWaitedInSession * kMaxSessionsCount);
+	Assert(session.requested == kMaxBdpWaitedInSession * kMaxSessionsCount);
 
 	dc.sessions.pop_back();
 	api().instance().killSession(MTP::downloadDcId(dcId, index));
@@ -578,10 +676,15 @@ bool DownloadMtprotoTask::setWebFileSizeHook(int size) {
 
 void DownloadMtprotoTask::makeRequest(const RequestData &requestData) {
 	placeSentRequest(sendRequest(requestData), requestData);
+	if (_cdnDcId) {
+		prefetchCdnFileHashes(requestData);
+	}
 }
 
 void DownloadMtprotoTask::requestMoreCdnFileHashes() {
-	if (_cdnHashesRequestId || _cdnUncheckedParts.empty()) {
+	if (_cdnHashesRequestId
+		|| _cdnHashesPrefetchRequestId
+		|| _cdnUncheckedParts.empty()) {
 		return;
 	}
 
@@ -600,12 +703,46 @@ void DownloadMtprotoTask::requestMoreCdnFileHashes() {
 	placeSentRequest(_cdnHashesRequestId, requestData);
 }
 
+void DownloadMtprotoTask::prefetchCdnFileHashes(
+		const RequestData &requestData) {
+	// Ask for the hashes together with the part itself, so that the part
+	// doesn't wait in _cdnUncheckedParts for a separate hashes request.
+	if (_cdnHashesRequestId
+		|| _cdnHashesPrefetchRequestId
+		|| _cdnFileHashes.contains(requestData.offset)) {
+		return;
+	}
+	const auto shiftedDcId = MTP::downloadDcId(
+		dcId(),
+		requestData.sessionIndex);
+	_cdnHashesPrefetchRequestId = api().request(MTPupload_GetCdnFileHashes(
+		MTP_bytes(_cdnToken),
+		MTP_int(requestData.offset)
+	)).done([=](const MTPVector<MTPFileHash> &result) {
+		_cdnHashesPrefetchRequestId = 0;
+		addCdnHashes(result.v);
+		if (feedCheckedCdnParts()) {
+			requestMoreCdnFileHashes();
+		}
+	}).fail([=](const RPCError &error) {
+		_cdnHashesPrefetchRequestId = 0;
+		requestMoreCdnFileHashes();
+	}).toDC(shiftedDcId).send();
+}
+
 void DownloadMtprotoTask::normalPartLoaded(
 		const MTPupload_File &result,
 		mtpRequestId requestId) {
+	const auto receivedBytes = result.match([](
+			const MTPDupload_fileCdnRedirect &data) {
+		return 0;
+	}, [](const MTPDupload_file &data) {
+		return int(data.vbytes().v.size());
+	});
 	const auto requestData = finishSentRequest(
 		requestId,
-		FinishRequestReason::Success);
+		FinishRequestReason::Success,
+		receivedBytes);
 	const auto owner = _owner;
 	const auto dcId = this->dcId();
 	result.match([&](const MTPDupload_fileCdnRedirect &data) {
@@ -621,9 +758,14 @@ void DownloadMtprotoTask::normalPartLoaded(
 void DownloadMtprotoTask::webPartLoaded(
 		const MTPupload_WebFile &result,
 		mtpRequestId requestId) {
+	const auto receivedBytes = result.match([](
+			const MTPDupload_webFile &data) {
+		return int(data.vbytes().v.size());
+	});
 	const auto requestData = finishSentRequest(
 		requestId,
-		FinishRequestReason::Success);
+		FinishRequestReason::Success,
+		receivedBytes);
 	const auto owner = _owner;
 	const auto dcId = this->dcId();
 	result.match([&](const MTPDupload_webFile &data) {
@@ -656,7 +798,8 @@ void DownloadMtprotoTask::cdnPartLoaded(const MTPupload_CdnFile &result, mtpRequ
 	}, [&](const MTPDupload_cdnFile &data) {
 		const auto requestData = finishSentRequest(
 			requestId,
-			FinishRequestReason::Success);
+			FinishRequestReason::Success,
+			int(data.vbytes().v.size()));
 		const auto owner = _owner;
 		const auto dcId = this->dcId();
 		const auto guard = gsl::finally([=] {
@@ -737,7 +880,19 @@ void DownloadMtprotoTask::getCdnFileHashesDone(
 		requestId,
 		FinishRequestReason::Redirect);
 	addCdnHashes(result.v);
-	auto someMoreChecked = false;
+	if (!_cdnFileHashes.contains(requestData.offset)) {
+		LOG(("API Error: "
+			"Could not find cdnFileHash for offset %1 "
+			"after getCdnFileHashes request."
+			).arg(requestData.offset));
+		cancelOnFail();
+		return;
+	} else if (feedCheckedCdnParts()) {
+		requestMoreCdnFileHashes();
+	}
+}
+
+bool DownloadMtprotoTask::feedCheckedCdnParts() {
 	for (auto i = _cdnUncheckedParts.begin(); i != _cdnUncheckedParts.cend();) {
 		const auto uncheckedData = i->first;
 		const auto uncheckedBytes = bytes::make_span(i->second);
@@ -751,32 +906,23 @@ void DownloadMtprotoTask::getCdnFileHashesDone(
 			LOG(("API Error: Wrong cdnFileHash for offset %1."
 				).arg(uncheckedData.offset));
 			cancelOnFail();
-			return;
+			return false;
 		} break;
 
 		case CheckCdnHashResult::Good: {
-			someMoreChecked = true;
 			const auto goodOffset = uncheckedData.offset;
 			const auto goodBytes = std::move(i->second);
 			const auto weak = base::make_weak(this);
 			i = _cdnUncheckedParts.erase(i);
 			if (!feedPart(goodOffset, goodBytes) || !weak) {
-				return;
+				return false;
 			}
 		} break;
 
 		default: Unexpected("Result of checkCdnFileHash()");
 		}
 	}
-	if (!someMoreChecked) {
-		LOG(("API Error: "
-			"Could not find cdnFileHash for offset %1 "
-			"after getCdnFileHashes request."
-			).arg(requestData.offset));
-		cancelOnFail();
-		return;
-	}
-	requestMoreCdnFileHashes();
+	return true;
 }
 
 void DownloadMtprotoTask::placeSentRequest(
@@ -799,7 +945,8 @@ void DownloadMtprotoTask::placeSentRequest(
 
 auto DownloadMtprotoTask::finishSentRequest(
 	mtpRequestId requestId,
-	FinishRequestReason reason)
+	FinishRequestReason reason,
+	int receivedBytes)
 -> RequestData {
 	auto it = _sentRequests.find(requestId);
 	Assert(it != _sentRequests.cend());
@@ -820,7 +967,8 @@ auto DownloadMtprotoTask::finishSentRequest(
 			dcId(),
 			result.sessionIndex,
 			result.requestedInSession,
-			result.sent);
+			result.sent,
+			receivedBytes);
 	}
 
 	Ensures(ok);
@@ -840,6 +988,9 @@ void DownloadMtprotoTask::cancelAllRequests() {
 	while (!_sentRequests.empty()) {
 		cancelRequest(_sentRequests.begin()->first);
 	}
+	if (_cdnHashesPrefetchRequestId) {
+		api().request(base::take(_cdnHashesPrefetchRequestId)).cancel();
+	}
 	_cdnUncheckedParts.clear();
 }
 
@@ -865,13 +1016,19 @@ void DownloadMtprotoTask::cancelRequest(mtpRequestId requestId) {
 }
 
 void DownloadMtprotoTask::addToQueue(int priority) {
+	_queued = true;
 	_owner->enqueue(this, priority);
 }
 
 void DownloadMtprotoTask::removeFromQueue() {
+	_queued = false;
 	_owner->remove(this);
 }
 
+bool DownloadMtprotoTask::queued() const {
+	return _queued;
+}
+
 void DownloadMtprotoTask::partLoaded(
 		int offset,
 		const QByteArray &bytes) {
@@ -50,7 +50,8 @@ public:
 		MTP::DcId dcId,
 		int index,
 		int amountAtRequestStart,
-		crl::time timeAtRequestStart);
+		crl::time timeAtRequestStart,
+		int receivedBytes);
 	void checkSendNextAfterSuccess(MTP::DcId dcId);
 	[[nodiscard]] int chooseSessionIndex(MTP::DcId dcId) const;
 
@@ -79,10 +80,26 @@ private:
 		int successes = 0; // Since last timeout in this dc in any session.
 		int maxWaitedAmount = 0;
 	};
+	struct DcBandwidthData {
+		// Bottleneck bandwidth is the maximum of the recent samples,
+		// round trip time is the minimum of the recent requests.
+		crl::time sampleStart = 0;
+		int64 sampleBytes = 0;
+		int64 bandwidth = 0;
+		int64 bandwidthPrevious = 0;
+		crl::time bandwidthWindowStart = 0;
+		crl::time rtt = 0;
+		crl::time rttPrevious = 0;
+		crl::time rttWindowStart = 0;
+
+		int desiredSessions = 0;
+		int waitedInSession = 0;
+	};
 	struct DcBalanceData {
 		DcBalanceData();
 
 		std::vector<DcSessionBalanceData> sessions;
+		DcBandwidthData bandwidth;
 		crl::time lastSessionRemove = 0;
 		int sessionRemoveIndex = 0;
 		int sessionRemoveTimes = 0;
@@ -102,6 +119,11 @@ private:
 	void resetGeneration();
 	void sessionTimedOut(MTP::DcId dcId, int index);
 	void removeSession(MTP::DcId dcId);
+	void updateBandwidth(
+		MTP::DcId dcId,
+		DcBalanceData &dc,
+		crl::time duration,
+		int receivedBytes);
 
 	const not_null<ApiWrap*> _api;
 
@@ -159,6 +181,7 @@ protected:
 
 	void addToQueue(int priority = 0);
 	void removeFromQueue();
+	[[nodiscard]] bool queued() const;
 
 	[[nodiscard]] ApiWrap &api() const {
 		return _owner->api();
@@ -213,9 +236,11 @@ private:
 		const MTPVector<MTPFileHash> &result,
 		mtpRequestId requestId);
 	void requestMoreCdnFileHashes();
+	void prefetchCdnFileHashes(const RequestData &requestData);
 	void getCdnFileHashesDone(
 		const MTPVector<MTPFileHash> &result,
 		mtpRequestId requestId);
+	[[nodiscard]] bool feedCheckedCdnParts();
 
 	void partLoaded(int offset, const QByteArray &bytes);
 
@@ -232,7 +257,8 @@ private:
 		const RequestData &requestData);
 	[[nodiscard]] RequestData finishSentRequest(
 		mtpRequestId requestId,
-		FinishRequestReason reason);
+		FinishRequestReason reason,
+		int receivedBytes = 0);
 	void switchToCDN(
 		const RequestData &requestData,
 		const MTPDupload_fileCdnRedirect &redirect);
@@ -258,6 +284,7 @@ private:
 
 	base::flat_map<mtpRequestId, RequestData> _sentRequests;
 	base::flat_map<int, mtpRequestId> _requestByOffset;
+	bool _queued = false;
 
 	MTP::DcId _cdnDcId = 0;
 	QByteArray _cdnToken;
@@ -266,6 +293,7 @@ private:
 	base::flat_map<int, CdnFileHash> _cdnFileHashes;
 	base::flat_map<RequestData, QByteArray> _cdnUncheckedParts;
 	mtpRequestId _cdnHashesRequestId = 0;
+	mtpRequestId _cdnHashesPrefetchRequestId = 0;
 
 };
 
@@ -10,11 +10,13 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_document.h"
 #include "data/data_session.h"
 #include "data/data_file_origin.h"
+#include "data/data_auto_download.h"
 #include "mainwidget.h"
 #include "mainwindow.h"
 #include "core/application.h"
 #include "core/file_location.h"
 #include "storage/storage_account.h"
+#include "storage/storage_memory_cache.h"
 #include "storage/file_download_mtproto.h"
 #include "storage/file_download_web.h"
 #include "platform/platform_file_utilities.h"
@@ -147,9 +149,7 @@ void FileLoader::finishWithBytes(const QByteArray &data) {
 		Platform::File::PostprocessDownloaded(
 			QFileInfo(_file).absoluteFilePath());
 	}
-	const auto session = _session;
-	_updates.fire_done();
-	session->notifyDownloaderTaskFinished();
+	notifyFinished();
 }
 
 QImage FileLoader::imageData(int progressiveSizeLimit) const {
@@ -159,6 +159,20 @@ QImage FileLoader::imageData(int progressiveSizeLimit) const {
 	return _imageData;
 }
 
+QImage FileLoader::loadedPartImage(int size) const {
+	if (_fileIsOpen
+		|| _skippedBytes != 0
+		|| _data.size() < size
+		|| _locationType != UnknownFileLocation) {
+		return QImage();
+	}
+	auto format = QByteArray();
+	return App::readImage(
+		QByteArray::fromRawData(_data.data(), size),
+		&format,
+		false);
+}
+
 void FileLoader::readImage(int progressiveSizeLimit) const {
 	const auto buffer = progressiveSizeLimit
 		? QByteArray::fromRawData(_data.data(), progressiveSizeLimit)
@@ -201,13 +215,53 @@ void FileLoader::increaseLoadSize(int size, bool autoLoading) {
 	Expects(size <= _fullSize);
 
 	_loadSize = size;
-	_autoLoading = autoLoading;
+	if (!autoLoading) {
+		stopAutoLoading();
+	} else {
+		_autoLoading = true;
+	}
+}
+
+void FileLoader::stopAutoLoading() {
+	if (_autoLoading) {
+		_autoLoading = false;
+		autoLoadingStopped();
+	}
 }
 
 void FileLoader::notifyAboutProgress() {
 	_updates.fire({});
 }
 
+void FileLoader::notifyFinished() {
+	if (!_imageData.isNull()
+		|| _locationType != UnknownFileLocation
+		|| _data.isEmpty()) {
+		const auto session = _session;
+		_updates.fire_done();
+		session->notifyDownloaderTaskFinished();
+		return;
+	}
+
+	// Decode the image before notifying, so that the imageData() call
+	// from the finish handler doesn't do it on the main thread.
+	crl::async([=, weak = base::make_weak(this), data = _data] {
+		auto format = QByteArray();
+		auto image = App::readImage(data, &format, false);
+		crl::on_main(weak, [=, image = std::move(image)]() mutable {
+			if (_cancelled) {
+				return;
+			} else if (_imageData.isNull() && !image.isNull()) {
+				_imageData = std::move(image);
+				_imageFormat = format;
+			}
+			const auto session = _session;
+			_updates.fire_done();
+			session->notifyDownloaderTaskFinished();
+		});
+	});
+}
+
 void FileLoader::localLoaded(
 		const StorageImageSaved &result,
 		const QByteArray &imageFormat,
@@ -222,7 +276,9 @@ void FileLoader::localLoaded(
 	constexpr auto kPrefix = 8;
 	if (partial	&& result.data.size() < _loadSize + kPrefix) {
 		_localStatus = LocalStatus::NotFound;
-		if (checkForOpen()) {
+		if (!autoDownloadBudgetAllows()) {
+			cancel();
+		} else if (checkForOpen()) {
 			startLoadingWithPartial(result.data);
 		}
 		return;
@@ -241,7 +297,8 @@ void FileLoader::localLoaded(
 void FileLoader::start() {
 	if (_finished || tryLoadLocal()) {
 		return;
-	} else if (_fromCloud == LoadFromLocalOnly) {
+	} else if (_fromCloud == LoadFromLocalOnly
+		|| !autoDownloadBudgetAllows()) {
 		cancel();
 		return;
 	}
@@ -251,6 +308,18 @@ void FileLoader::start() {
 	}
 }
 
+bool FileLoader::autoDownloadBudgetAllows() {
+	// Charged only here, when nothing was found locally and the file
+	// is really going to be loaded from the cloud.
+	if (!_autoLoading || _autoDownloadBudgetCharged) {
+		return true;
+	} else if (!_session->data().autoDownloadBudget().consume(_fullSize)) {
+		return false;
+	}
+	_autoDownloadBudgetCharged = true;
+	return true;
+}
+
 bool FileLoader::checkForOpen() {
 	if (_filename.isEmpty()
 		|| (_toCache != LoadToFileOnly)
@@ -277,13 +346,16 @@ void FileLoader::loadLocal(const Storage::Cache::Key &key) {
 			image = std::move(image),
 			format = std::move(format)
 		]() mutable {
+			if (!value.isEmpty() && !value.startsWith("partial:")) {
+				_session->data().cacheMemory().put(key, value);
+			}
 			localLoaded(
 				StorageImageSaved(std::move(value)),
 				format,
 				std::move(image));
 		});
 	};
-	_session->data().cache().get(key, [=, callback = std::move(done)](
+	auto process = [=, callback = std::move(done)](
 			QByteArray &&value) mutable {
 		if (readImage && !value.startsWith("partial:")) {
 			crl::async([
@@ -304,7 +376,12 @@ void FileLoader::loadLocal(const Storage::Cache::Key &key) {
 		} else {
 			callback(std::move(value), {}, {});
 		}
-	});
+	};
+	if (auto value = _session->data().cacheMemory().get(key)) {
+		process(*base::take(value));
+		return;
+	}
+	_session->data().cache().get(key, std::move(process));
 }
 
 bool FileLoader::tryLoadLocal() {
@@ -386,7 +463,9 @@ bool FileLoader::writeResultPart(int offset, bytes::const_span buffer) {
 		}
 		return true;
 	}
-	_data.reserve(offset + buffer.size());
+	// Reserve the whole expected size at once, so that appending parts
+	// one by one doesn't reallocate and copy the loaded data each time.
+	_data.reserve(std::max(offset + int(buffer.size()), _loadSize));
 	if (offset > _data.size()) {
 		_skippedBytes += offset - _data.size();
 		_data.resize(offset);
@@ -406,6 +485,19 @@ bool FileLoader::writeResultPart(int offset, bytes::const_span buffer) {
 	return true;
 }
 
+bool FileLoader::preallocateFile(int size) {
+	Expects(size > 0);
+
+	if (!_fileIsOpen || _file.size() != 0 || !_file.resize(size)) {
+		return false;
+	}
+
+	// All the preallocated bytes are not loaded yet, writeResultPart
+	// will decrease _skippedBytes when writing inside the file.
+	_skippedBytes += size;
+	return true;
+}
+
 QByteArray FileLoader::readLoadedPartBack(int offset, int size) {
 	Expects(offset >= 0 && size > 0);
 
@@ -471,9 +563,7 @@ bool FileLoader::finalizeResult() {
 					_cacheTag));
 		}
 	}
-	const auto session = _session;
-	_updates.fire_done();
-	session->notifyDownloaderTaskFinished();
+	notifyFinished();
 	return true;
 }
 
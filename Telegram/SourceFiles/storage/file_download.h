@@ -82,6 +82,9 @@ public:
 		return 0;
 	}
 	[[nodiscard]] QImage imageData(int progressiveSizeLimit = 0) const;
+
+	// Decodes the loaded beginning of the file without caching the result.
+	[[nodiscard]] QImage loadedPartImage(int size) const;
 	[[nodiscard]] QString fileName() const {
 		return _filename;
 	}
@@ -99,6 +102,7 @@ public:
 	bool setFileName(const QString &filename); // set filename for loaders to cache
 	void permitLoadFromCloud();
 	void increaseLoadSize(int size, bool autoLoading);
+	void stopAutoLoading();
 
 	void start();
 	void cancel();
@@ -132,9 +136,11 @@ protected:
 	};
 
 	void readImage(int progressiveSizeLimit) const;
+	void notifyFinished();
 
 	bool checkForOpen();
 	bool tryLoadLocal();
+	[[nodiscard]] bool autoDownloadBudgetAllows();
 	void loadLocal(const Storage::Cache::Key &key);
 	virtual Storage::Cache::Key cacheKey() const = 0;
 	virtual std::optional<MediaKey> fileLocationKey() const = 0;
@@ -143,18 +149,22 @@ protected:
 	virtual void startLoadingWithPartial(const QByteArray &data) {
 		startLoading();
 	}
+	virtual void autoLoadingStopped() {
+	}
 
 	void cancel(bool failed);
 
 	void notifyAboutProgress();
 
 	bool writeResultPart(int offset, bytes::const_span buffer);
+	bool preallocateFile(int size);
 	bool finalizeResult();
 	[[nodiscard]] QByteArray readLoadedPartBack(int offset, int size);
 
 	const not_null<Main::Session*> _session;
 
 	bool _autoLoading = false;
+	bool _autoDownloadBudgetCharged = false;
 	uint8 _cacheTag = 0;
 	bool _finished = false;
 	bool _cancelled = false;
@@ -17,6 +17,16 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/mtproto_auth_key.h"
 #include "base/openssl_help.h"
 
+namespace {
+
+constexpr auto kRangesMinFileSize = 64 * 1024 * 1024;
+constexpr auto kRangesCount = 8;
+
+// Auto downloads wait for all the files requested by the user.
+constexpr auto kAutoLoadingPriority = -2;
+
+} // namespace
+
 mtpFileLoader::mtpFileLoader(
 	not_null<Main::Session*> session,
 	const StorageFileLocation &location,
@@ -105,6 +115,9 @@ uint64 mtpFileLoader::objId() const {
 }
 
 bool mtpFileLoader::readyToRequest() const {
+	if (!_ranges.empty()) {
+		return !_finished && !rangesFinished();
+	}
 	return !_finished
 		&& !_lastComplete
 		&& (_fullSize != 0 || !haveSentRequests())
@@ -114,11 +127,52 @@ bool mtpFileLoader::readyToRequest() const {
 int mtpFileLoader::takeNextRequestOffset() {
 	Expects(readyToRequest());
 
+	if (!_ranges.empty()) {
+		const auto count = int(_ranges.size());
+		for (auto i = 0; i != count; ++i) {
+			auto &range = _ranges[(_nextRange + i) % count];
+			if (range.next < range.till) {
+				_nextRange = (_nextRange + i + 1) % count;
+				const auto result = range.next;
+				range.next += Storage::kDownloadPartSize;
+				return result;
+			}
+		}
+		Unexpected("Ranges in mtpFileLoader::takeNextRequestOffset.");
+	}
 	const auto result = _nextRequestOffset;
 	_nextRequestOffset += Storage::kDownloadPartSize;
 	return result;
 }
 
+void mtpFileLoader::initRanges() {
+	if (!_fileIsOpen
+		|| _nextRequestOffset != 0
+		|| _loadSize != _fullSize
+		|| _fullSize < kRangesMinFileSize
+		|| !preallocateFile(_fullSize)) {
+		return;
+	}
+	const auto parts = (_fullSize + Storage::kDownloadPartSize - 1)
+		/ Storage::kDownloadPartSize;
+	const auto partsInRange = (parts + kRangesCount - 1) / kRangesCount;
+	const auto rangeSize = partsInRange * Storage::kDownloadPartSize;
+	_ranges.reserve(kRangesCount);
+	for (auto from = 0; from < _fullSize; from += rangeSize) {
+		_ranges.push_back({
+			.next = from,
+			.till = std::min(from + rangeSize, _fullSize),
+		});
+	}
+	_nextRequestOffset = _fullSize;
+}
+
+bool mtpFileLoader::rangesFinished() const {
+	return ranges::none_of(_ranges, [](const Range &range) {
+		return (range.next < range.till);
+	});
+}
+
 bool mtpFileLoader::feedPart(int offset, const QByteArray &bytes) {
 	const auto buffer = bytes::make_span(bytes);
 	if (!writeResultPart(offset, buffer)) {
@@ -128,7 +182,10 @@ bool mtpFileLoader::feedPart(int offset, const QByteArray &bytes) {
 		_lastComplete = true;
 	}
 	const auto finished = !haveSentRequests()
-		&& (_lastComplete || (_fullSize && _nextRequestOffset >= _loadSize));
+		&& (_ranges.empty()
+			? (_lastComplete
+				|| (_fullSize && _nextRequestOffset >= _loadSize))
+			: rangesFinished());
 	if (finished) {
 		removeFromQueue();
 		if (!finalizeResult()) {
@@ -158,7 +215,14 @@ bool mtpFileLoader::setWebFileSizeHook(int size) {
 }
 
 void mtpFileLoader::startLoading() {
-	addToQueue();
+	initRanges();
+	addToQueue(_autoLoading ? kAutoLoadingPriority : 0);
+}
+
+void mtpFileLoader::autoLoadingStopped() {
+	if (queued() && !_finished) {
+		addToQueue();
+	}
 }
 
 void mtpFileLoader::startLoadingWithPartial(const QByteArray &data) {
@@ -53,6 +53,7 @@ private:
 	void startLoading() override;
 	void startLoadingWithPartial(const QByteArray &data) override;
 	void cancelHook() override;
+	void autoLoadingStopped() override;
 
 	bool readyToRequest() const override;
 	int takeNextRequestOffset() override;
@@ -60,7 +61,21 @@ private:
 	void cancelOnFail() override;
 	bool setWebFileSizeHook(int size) override;
 
+	struct Range {
+		int next = 0;
+		int till = 0;
+	};
+
+	void initRanges();
+	[[nodiscard]] bool rangesFinished() const;
+
 	bool _lastComplete = false;
 	int32 _nextRequestOffset = 0;
 
+	// Large files written directly to disk are split in several ranges
+	// that are requested in turns, so parts from different ranges go to
+	// different download sessions and land in the preallocated file.
+	std::vector<Range> _ranges;
+	int _nextRange = 0;
+
 };
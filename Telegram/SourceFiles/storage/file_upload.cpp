@@ -11,6 +11,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "api/api_send_progress.h"
 #include "storage/localimageloader.h"
 #include "storage/file_download.h"
+#include "storage/file_upload_reader.h"
 #include "data/data_document.h"
 #include "data/data_document_media.h"
 #include "data/data_photo.h"
@@ -26,8 +27,17 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace Storage {
 namespace {
 
-// max 512kb uploaded at the same time in each session
-constexpr auto kMaxUploadFileParallelSize = MTP::kUploadSessionsCount * 512 * 1024;
+// Each session starts with 512kb uploaded at the same time and the window
+// grows while the parts are acknowledged fast and shrinks when they are not.
+constexpr auto kStartUploadWindowInSession = 512 * 1024;
+constexpr auto kMaxUploadWindowInSession = 4 * 1024 * 1024;
+
+// Read from local files at most that much ahead of the sent parts.
+constexpr auto kUploadReadAheadSize = 2 * 1024 * 1024;
+
+// Acks faster than this grow the window, slower than that shrink it.
+constexpr auto kFastUploadAckLatency = crl::time(1000);
+constexpr auto kSlowUploadAckLatency = 4 * crl::time(1000);
 
 constexpr auto kDocumentMaxPartsCount = 3000;
 
@@ -77,7 +87,7 @@ struct Uploader::File {
 
 	HashMd5 md5Hash;
 
-	std::unique_ptr<QFile> docFile;
+	std::unique_ptr<UploadFileReader> docReader;
 	int32 docSentParts = 0;
 	int32 docSize = 0;
 	int32 docPartSize = 0;
@@ -154,6 +164,9 @@ const QString &Uploader::File::filename() const {
 
 Uploader::Uploader(not_null<ApiWrap*> api)
 : _api(api) {
+	for (auto &window : sentWindows) {
+		window = kStartUploadWindowInSession;
+	}
 	nextTimer.setSingleShot(true);
 	connect(&nextTimer, SIGNAL(timeout()), this, SLOT(sendNext()));
 	stopSessionsTimer.setSingleShot(true);
@@ -403,6 +416,7 @@ void Uploader::currentFailed() {
 	requestsSent.clear();
 	docRequestsSent.clear();
 	dcMap.clear();
+	sentTimes.clear();
 	uploadingId = FullMsgId();
 	sentSize = 0;
 	for (int i = 0; i < MTP::kUploadSessionsCount; ++i) {
@@ -418,9 +432,31 @@ void Uploader::stopSessions() {
 	}
 }
 
+void Uploader::updateSessionWindow(
+		int dc,
+		crl::time sent,
+		uint32 sentPartSize) {
+	const auto latency = crl::now() - sent;
+	auto &window = sentWindows[dc];
+	if (latency >= kSlowUploadAckLatency) {
+		window = std::max(window / 2, uint32(kStartUploadWindowInSession));
+	} else if (latency < kFastUploadAckLatency
+		&& sentSizes[dc] + sentPartSize > window) {
+		// The window was full when this part was acknowledged.
+		window = std::min(
+			window + sentPartSize,
+			uint32(kMaxUploadWindowInSession));
+	}
+}
+
 void Uploader::sendNext() {
-	if (sentSize >= kMaxUploadFileParallelSize || _pausedId.msg) {
-		return;
+	while (sendNextPart()) {
+	}
+}
+
+bool Uploader::sendNextPart() {
+	if (_pausedId.msg) {
+		return false;
 	}
 
 	bool stopping = stopSessionsTimer.isActive();
@@ -428,7 +464,7 @@ void Uploader::sendNext() {
 		if (!stopping) {
 			stopSessionsTimer.start(kKillSessionTimeout);
 		}
-		return;
+		return false;
 	}
 
 	if (stopping) {
@@ -445,7 +481,8 @@ void Uploader::sendNext() {
 
 	auto todc = 0;
 	for (auto dc = 1; dc != MTP::kUploadSessionsCount; ++dc) {
-		if (sentSizes[dc] < sentSizes[todc]) {
+		const auto free = int64(sentWindows[dc]) - sentSizes[dc];
+		if (free > int64(sentWindows[todc]) - sentSizes[todc]) {
 			todc = dc;
 		}
 	}
@@ -462,6 +499,12 @@ void Uploader::sendNext() {
 			? uploadingData.file->id
 			: uploadingData.file->thumbId)
 		: uploadingData.media.thumbId;
+	const auto partSize = parts.isEmpty()
+		? uploadingData.docPartSize
+		: parts.begin().value().size();
+	if (sentSize > 0 && sentSizes[todc] + partSize > sentWindows[todc]) {
+		return false;
+	}
 	if (parts.isEmpty()) {
 		if (uploadingData.docSentParts >= uploadingData.docPartsCount) {
 			if (requestsSent.empty() && docRequestsSent.empty()) {
@@ -490,8 +533,15 @@ void Uploader::sendNext() {
 				} else if (uploadingData.type() == SendMediaType::File
 					|| uploadingData.type() == SendMediaType::ThemeFile
 					|| uploadingData.type() == SendMediaType::Audio) {
-					QByteArray docMd5(32, Qt::Uninitialized);
-					hashMd5Hex(uploadingData.md5Hash.result(), docMd5.data());
+					auto docMd5 = QByteArray();
+					if (uploadingData.docReader) {
+						docMd5 = uploadingData.docReader->md5Hex();
+					} else {
+						docMd5.resize(32);
+						hashMd5Hex(
+							uploadingData.md5Hash.result(),
+							docMd5.data());
+					}
 
 					const auto file = (uploadingData.docSize > kUseBigFilesFrom)
 						? MTP_inputFileBig(
@@ -536,9 +586,9 @@ void Uploader::sendNext() {
 				}
 				queue.erase(uploadingId);
 				uploadingId = FullMsgId();
-				sendNext();
+				return true;
 			}
-			return;
+			return false;
 		}
 
 		auto &content = uploadingData.file
@@ -546,24 +596,42 @@ void Uploader::sendNext() {
 			: uploadingData.media.data;
 		QByteArray toSend;
 		if (content.isEmpty()) {
-			if (!uploadingData.docFile) {
+			if (!uploadingData.docReader) {
 				const auto filepath = uploadingData.file
 					? uploadingData.file->filepath
 					: uploadingData.media.file;
-				uploadingData.docFile = std::make_unique<QFile>(filepath);
-				if (!uploadingData.docFile->open(QIODevice::ReadOnly)) {
-					currentFailed();
-					return;
-				}
+				const auto readAhead = std::max(
+					kUploadReadAheadSize / uploadingData.docPartSize,
+					1);
+				uploadingData.docReader = std::make_unique<UploadFileReader>(
+					filepath,
+					uploadingData.docPartSize,
+					uploadingData.docPartsCount,
+					readAhead,
+					(uploadingData.docSize <= kUseBigFilesFrom),
+					[=] { sendNext(); });
 			}
-			toSend = uploadingData.docFile->read(uploadingData.docPartSize);
-			if (uploadingData.docSize <= kUseBigFilesFrom) {
-				uploadingData.md5Hash.feed(toSend.constData(), toSend.size());
+			if (uploadingData.docReader->failed()) {
+				currentFailed();
+				return false;
+			}
+			auto part = uploadingData.docReader->takeNextPart();
+			if (!part) {
+				return false;
 			}
+			toSend = std::move(*part);
 		} else {
 			const auto offset = uploadingData.docSentParts
 				* uploadingData.docPartSize;
-			toSend = content.mid(offset, uploadingData.docPartSize);
+			// The part is serialized into the request right away, while
+			// the content is still held by the uploading data.
+			const auto size = std::clamp(
+				content.size() - offset,
+				0,
+				uploadingData.docPartSize);
+			toSend = size
+				? QByteArray::fromRawData(content.constData() + offset, size)
+				: QByteArray();
 			if ((uploadingData.type() == SendMediaType::File
 				|| uploadingData.type() == SendMediaType::ThemeFile
 				|| uploadingData.type() == SendMediaType::Audio)
@@ -575,7 +643,7 @@ void Uploader::sendNext() {
 			|| ((toSend.size() < uploadingData.docPartSize
 				&& uploadingData.docSentParts + 1 != uploadingData.docPartsCount))) {
 			currentFailed();
-			return;
+			return false;
 		}
 		mtpRequestId requestId;
 		if (uploadingData.docSize > kUseBigFilesFrom) {
@@ -602,6 +670,7 @@ void Uploader::sendNext() {
 		}
 		docRequestsSent.emplace(requestId, uploadingData.docSentParts);
 		dcMap.emplace(requestId, todc);
+		sentTimes.emplace(requestId, crl::now());
 		sentSize += uploadingData.docPartSize;
 		sentSizes[todc] += uploadingData.docPartSize;
 
@@ -620,12 +689,14 @@ void Uploader::sendNext() {
 		}).toDC(MTP::uploadDcId(todc)).send();
 		requestsSent.emplace(requestId, part.value());
 		dcMap.emplace(requestId, todc);
+		sentTimes.emplace(requestId, crl::now());
 		sentSize += part.value().size();
 		sentSizes[todc] += part.value().size();
 
 		parts.erase(part);
 	}
 	nextTimer.start(kUploadRequestInterval);
+	return true;
 }
 
 void Uploader::cancel(const FullMsgId &msgId) {
@@ -661,6 +732,7 @@ void Uploader::clear() {
 	}
 	docRequestsSent.clear();
 	dcMap.clear();
+	sentTimes.clear();
 	sentSize = 0;
 	for (int i = 0; i < MTP::kUploadSessionsCount; ++i) {
 		_api->instance().stopSession(MTP::uploadDcId(i));
@@ -699,6 +771,9 @@ void Uploader::partLoaded(const MTPBool &result, mtpRequestId requestId) {
 				sentPartSize = file.docPartSize;
 				docRequestsSent.erase(j);
 			}
+			if (const auto sent = sentTimes.take(requestId)) {
+				updateSessionWindow(dc, *sent, sentPartSize);
+			}
 			sentSize -= sentPartSize;
 			sentSizes[dc] -= sentPartSize;
 			if (file.type() == SendMediaType::Photo) {
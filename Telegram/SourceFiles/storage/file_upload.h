@@ -122,6 +122,9 @@ public slots:
 private:
 	struct File;
 
+	bool sendNextPart();
+	void updateSessionWindow(int dc, crl::time sent, uint32 sentPartSize);
+
 	void partLoaded(const MTPBool &result, mtpRequestId requestId);
 	void partFailed(const RPCError &error, mtpRequestId requestId);
 
@@ -141,8 +144,10 @@ private:
 	base::flat_map<mtpRequestId, QByteArray> requestsSent;
 	base::flat_map<mtpRequestId, int32> docRequestsSent;
 	base::flat_map<mtpRequestId, int32> dcMap;
+	base::flat_map<mtpRequestId, crl::time> sentTimes;
 	uint32 sentSize = 0;
 	uint32 sentSizes[MTP::kUploadSessionsCount] = { 0 };
+	uint32 sentWindows[MTP::kUploadSessionsCount] = { 0 };
 
 	FullMsgId uploadingId;
 	FullMsgId _pausedId;
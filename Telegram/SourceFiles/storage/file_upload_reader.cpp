@@ -0,0 +1,148 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "storage/file_upload_reader.h"
+
+namespace Storage {
+
+class UploadFileReader::Inner final {
+public:
+	Inner(
+		crl::weak_on_queue<Inner> weak,
+		base::weak_ptr<UploadFileReader> owner,
+		const QString &path,
+		int partSize,
+		int partsCount,
+		bool computeMd5);
+
+	void read(int count);
+
+private:
+	void fail();
+
+	const base::weak_ptr<UploadFileReader> _owner;
+	const int _partSize = 0;
+	const int _partsCount = 0;
+	const bool _computeMd5 = false;
+
+	QFile _file;
+	HashMd5 _md5;
+	int _partsRead = 0;
+	bool _failed = false;
+
+};
+
+UploadFileReader::Inner::Inner(
+	crl::weak_on_queue<Inner> weak,
+	base::weak_ptr<UploadFileReader> owner,
+	const QString &path,
+	int partSize,
+	int partsCount,
+	bool computeMd5)
+: _owner(std::move(owner))
+, _partSize(partSize)
+, _partsCount(partsCount)
+, _computeMd5(computeMd5)
+, _file(path) {
+}
+
+void UploadFileReader::Inner::read(int count) {
+	if (_failed) {
+		return;
+	} else if (!_file.isOpen() && !_file.open(QIODevice::ReadOnly)) {
+		fail();
+		return;
+	}
+	for (; count > 0 && _partsRead < _partsCount; --count) {
+		auto bytes = _file.read(_partSize);
+		if (bytes.isEmpty()) {
+			fail();
+			return;
+		}
+		if (_computeMd5) {
+			_md5.feed(bytes.constData(), bytes.size());
+		}
+		auto md5Hex = QByteArray();
+		if (++_partsRead == _partsCount) {
+			_file.close();
+			if (_computeMd5) {
+				md5Hex.resize(32);
+				hashMd5Hex(_md5.result(), md5Hex.data());
+			}
+		}
+		crl::on_main(_owner, [
+			owner = _owner,
+			bytes = std::move(bytes),
+			md5Hex = std::move(md5Hex)
+		]() mutable {
+			owner.get()->partRead(std::move(bytes), std::move(md5Hex));
+		});
+	}
+}
+
+void UploadFileReader::Inner::fail() {
+	_failed = true;
+	crl::on_main(_owner, [owner = _owner] {
+		owner.get()->readFailed();
+	});
+}
+
+UploadFileReader::UploadFileReader(
+	const QString &path,
+	int partSize,
+	int partsCount,
+	int readAhead,
+	bool computeMd5,
+	Fn<void()> partReady)
+: _partReady(std::move(partReady))
+, _inner(
+	base::make_weak(this),
+	path,
+	partSize,
+	partsCount,
+	computeMd5) {
+	_inner.with([=](Inner &inner) {
+		inner.read(readAhead);
+	});
+}
+
+UploadFileReader::~UploadFileReader() = default;
+
+std::optional<QByteArray> UploadFileReader::takeNextPart() {
+	if (_parts.empty()) {
+		return std::nullopt;
+	}
+	auto result = std::move(_parts.front());
+	_parts.pop_front();
+	_inner.with([](Inner &inner) {
+		inner.read(1);
+	});
+	return result;
+}
+
+bool UploadFileReader::failed() const {
+	return _failed;
+}
+
+QByteArray UploadFileReader::md5Hex() const {
+	return _md5Hex;
+}
+
+void UploadFileReader::partRead(QByteArray &&bytes, QByteArray &&md5Hex) {
+	_parts.push_back(std::move(bytes));
+	if (!md5Hex.isEmpty()) {
+		_md5Hex = std::move(md5Hex);
+	}
+	_partReady();
+}
+
+void UploadFileReader::readFailed() {
+	_failed = true;
+	_partReady();
+}
+
+} // namespace Storage
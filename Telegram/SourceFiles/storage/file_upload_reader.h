@@ -0,0 +1,53 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "base/weak_ptr.h"
+
+#include <crl/crl_object_on_queue.h>
+
+namespace Storage {
+
+// Reads parts of a local file for uploading on a background queue.
+// Only a fixed amount of parts is kept read ahead in memory, so the
+// resident memory doesn't depend on the file size.
+class UploadFileReader final : public base::has_weak_ptr {
+public:
+	UploadFileReader(
+		const QString &path,
+		int partSize,
+		int partsCount,
+		int readAhead,
+		bool computeMd5,
+		Fn<void()> partReady);
+	~UploadFileReader();
+
+	// Returns std::nullopt if the next part was not read yet.
+	[[nodiscard]] std::optional<QByteArray> takeNextPart();
+	[[nodiscard]] bool failed() const;
+
+	// Hex md5 of the whole file, ready when the last part is read.
+	[[nodiscard]] QByteArray md5Hex() const;
+
+private:
+	class Inner;
+	friend class Inner;
+
+	void partRead(QByteArray &&bytes, QByteArray &&md5Hex);
+	void readFailed();
+
+	const Fn<void()> _partReady;
+	std::deque<QByteArray> _parts;
+	QByteArray _md5Hex;
+	bool _failed = false;
+
+	crl::object_on_queue<Inner> _inner;
+
+};
+
+} // namespace Storage
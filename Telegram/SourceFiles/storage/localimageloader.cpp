@@ -41,6 +41,11 @@ constexpr auto kThumbnailQuality = 87;
 constexpr auto kThumbnailSize = 320;
 constexpr auto kPhotoUploadPartSize = 32 * 1024;
 
+// Maps to zlib compression level 1 in the Qt PNG writer. Pasted
+// screenshots compress almost as well as with the default level 6,
+// while big hi-DPI ones are encoded several times faster.
+constexpr auto kPastedImagePngQuality = 85;
+
 using Ui::ValidateThumbDimensions;
 
 struct PreparedFileThumbnail {
@@ -254,8 +259,9 @@ SendMediaReady PreparePeerPhoto(MTP::DcId dcId, PeerId peerId, QImage &&image) {
 		0);
 }
 
-TaskQueue::TaskQueue(crl::time stopTimeoutMs) {
-	if (stopTimeoutMs > 0) {
+TaskQueue::TaskQueue(crl::time stopTimeoutMs, int parallel)
+: _parallel(std::max(parallel, 1)) {
+	if (stopTimeoutMs > 0 && _parallel == 1) {
 		_stopTimer = new QTimer(this);
 		connect(_stopTimer, SIGNAL(timeout()), this, SLOT(stop()));
 		_stopTimer->setSingleShot(true);
@@ -287,7 +293,10 @@ void TaskQueue::addTasks(std::vector<std::unique_ptr<Task>> &&tasks) {
 }
 
 void TaskQueue::wakeThread() {
-	if (!_thread) {
+	if (_parallel > 1) {
+		processParallel();
+		return;
+	} else if (!_thread) {
 		_thread = new QThread();
 
 		_worker = new TaskQueueWorker(this);
@@ -302,6 +311,45 @@ void TaskQueue::wakeThread() {
 	emit taskAdded();
 }
 
+void TaskQueue::processParallel() {
+	while (_parallelProcessing < _parallel) {
+		auto task = std::unique_ptr<Task>();
+		{
+			QMutexLocker lock(&_tasksToProcessMutex);
+			if (_tasksToProcess.empty()) {
+				return;
+			}
+			task = std::move(_tasksToProcess.front());
+			_tasksToProcess.pop_front();
+		}
+		_tasksInParallel.push_back({ task->id() });
+		++_parallelProcessing;
+		crl::async([=, task = std::move(task)]() mutable {
+			task->process();
+			crl::on_main(this, [=, task = std::move(task)]() mutable {
+				parallelProcessed(std::move(task));
+			});
+		});
+	}
+}
+
+void TaskQueue::parallelProcessed(std::unique_ptr<Task> task) {
+	--_parallelProcessing;
+	const auto i = ranges::find(
+		_tasksInParallel,
+		task->id(),
+		&ParallelTask::id);
+	if (i != end(_tasksInParallel)) {
+		i->processed = std::move(task);
+	}
+	while (!_tasksInParallel.empty() && _tasksInParallel.front().processed) {
+		auto ready = std::move(_tasksInParallel.front().processed);
+		_tasksInParallel.pop_front();
+		ready->finish();
+	}
+	processParallel();
+}
+
 void TaskQueue::cancelTask(TaskId id) {
 	const auto removeFrom = [&](std::deque<std::unique_ptr<Task>> &queue) {
 		const auto proj = [](const std::unique_ptr<Task> &task) {
@@ -319,6 +367,9 @@ void TaskQueue::cancelTask(TaskId id) {
 			_taskInProcessId = TaskId();
 		}
 	}
+	_tasksInParallel.erase(
+		ranges::remove(_tasksInParallel, id, &ParallelTask::id),
+		end(_tasksInParallel));
 	QMutexLocker lock(&_tasksToFinishMutex);
 	removeFrom(_tasksToFinish);
 }
@@ -354,6 +405,7 @@ void TaskQueue::stop() {
 	}
 	_tasksToProcess.clear();
 	_tasksToFinish.clear();
+	_tasksInParallel.clear();
 	_taskInProcessId = TaskId();
 }
 
@@ -781,7 +833,7 @@ void FileLoadTask::process(Args &&args) {
 				filename = filedialogDefaultName(qsl("image"), qsl(".png"), QString(), true);
 				{
 					QBuffer buffer(&_content);
-					fullimage.save(&buffer, "PNG");
+					fullimage.save(&buffer, "PNG", kPastedImagePngQuality);
 				}
 				filesize = _content.size();
 			}
@@ -136,7 +136,10 @@ class TaskQueue : public QObject {
 	Q_OBJECT
 
 public:
-	explicit TaskQueue(crl::time stopTimeoutMs = 0); // <= 0 - never stop worker
+	// stopTimeoutMs <= 0 - never stop worker.
+	// parallel > 1 - process() up to that many tasks at the same time
+	// in the thread pool, but still finish() them in the added order.
+	explicit TaskQueue(crl::time stopTimeoutMs = 0, int parallel = 1);
 
 	TaskId addTask(std::unique_ptr<Task> &&task);
 	void addTasks(std::vector<std::unique_ptr<Task>> &&tasks);
@@ -154,7 +157,18 @@ public slots:
 private:
 	friend class TaskQueueWorker;
 
+	struct ParallelTask {
+		TaskId id = TaskId();
+		std::unique_ptr<Task> processed;
+	};
+
 	void wakeThread();
+	void processParallel();
+	void parallelProcessed(std::unique_ptr<Task> task);
+
+	const int _parallel = 1;
+	std::deque<ParallelTask> _tasksInParallel;
+	int _parallelProcessing = 0;
 
 	std::deque<std::unique_ptr<Task>> _tasksToProcess;
 	std::deque<std::unique_ptr<Task>> _tasksToFinish;
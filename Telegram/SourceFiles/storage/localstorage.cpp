@@ -30,6 +30,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "facades.h"
 
 #include <QtCore/QDirIterator>
+#include <QtCore/QThread>
 
 #ifndef Q_OS_WIN
 #include <unistd.h>
@@ -340,6 +341,7 @@ bool _readOldMtpData(bool remove, ReadSettingsContext &context) {
 
 void finish() {
 	delete base::take(_localLoader);
+	WaitPendingWrites();
 }
 
 void InitialLoadTheme();
@@ -349,7 +351,10 @@ void readLangPack();
 void start() {
 	Expects(_basePath.isEmpty());
 
-	_localLoader = new TaskQueue(kFileLoaderQueueStopTimeout);
+	// Voice waveforms of a whole chat screen are counted at once.
+	_localLoader = new TaskQueue(
+		kFileLoaderQueueStopTimeout,
+		std::max(QThread::idealThreadCount() - 1, 1));
 
 	_basePath = cWorkingDir() + qsl("tdata/");
 	if (!QDir().exists(_basePath)) QDir().mkpath(_basePath);
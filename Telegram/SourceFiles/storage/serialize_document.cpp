@@ -83,7 +83,9 @@ DocumentData *Document::readFromStreamHelper(
 	stream >> width >> height;
 	stream >> type;
 
+	// Filename, type (sticker / animated) and size (video / image) at most.
 	QVector<MTPDocumentAttribute> attributes;
+	attributes.reserve(3);
 	if (!name.isEmpty()) {
 		attributes.push_back(MTP_documentAttributeFilename(MTP_string(name)));
 	}
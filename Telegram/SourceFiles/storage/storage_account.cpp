@@ -41,6 +41,13 @@ using Database = Cache::Database;
 
 constexpr auto kDelayedWriteTimeout = crl::time(1000);
 
+// Changed locations are appended to a small journal file until there are
+// that many of them, only then the whole locations file is rewritten.
+constexpr auto kLocationsJournalLimit = 256;
+
+// Hot cache keys read back from disk, the rest of the file is ignored.
+constexpr auto kCacheHotKeysLimit = 512;
+
 constexpr auto kStickersVersionTag = quint32(-1);
 constexpr auto kStickersSerializeVersion = 1;
 constexpr auto kMaxSavedStickerSetsCount = 1000;
@@ -76,6 +83,8 @@ enum { // Local Storage Keys
 	lskExportSettings = 0x13, // no data
 	lskBackgroundOld = 0x14, // no data
 	lskSelfSerialized = 0x15, // serialized self
+	lskDialogsSlice = 0x16, // no data
+	lskCacheHotKeys = 0x17, // no data
 };
 
 [[nodiscard]] FileKey ComputeDataNameKey(const QString &dataName) {
@@ -125,6 +134,7 @@ Account::~Account() {
 	if (_localKey && _mapChanged) {
 		writeMap();
 	}
+	WaitPendingWrites();
 }
 
 QString Account::tempDirectory() const {
@@ -171,6 +181,7 @@ void Account::clearLegacyFiles() {
 base::flat_set<QString> Account::collectGoodNames() const {
 	const auto keys = {
 		_locationsKey,
+		_locationsJournalKey,
 		_settingsKey,
 		_installedStickersKey,
 		_featuredStickersKey,
@@ -184,6 +195,8 @@ base::flat_set<QString> Account::collectGoodNames() const {
 		_recentHashtagsAndBotsKey,
 		_exportSettingsKey,
 		_trustedBotsKey,
+		_dialogsSliceKey,
+		_cacheHotKeysKey,
 	};
 	auto result = base::flat_set<QString>{
 		"map0",
@@ -267,6 +280,8 @@ Account::ReadMapResult Account::readMapWith(
 	quint64 savedGifsKey = 0;
 	quint64 legacyBackgroundKeyDay = 0, legacyBackgroundKeyNight = 0;
 	quint64 userSettingsKey = 0, recentHashtagsAndBotsKey = 0, exportSettingsKey = 0;
+	quint64 dialogsSliceKey = 0;
+	quint64 cacheHotKeysKey = 0;
 	while (!map.stream.atEnd()) {
 		quint32 keyType;
 		map.stream >> keyType;
@@ -358,6 +373,12 @@ Account::ReadMapResult Account::readMapWith(
 		case lskExportSettings: {
 			map.stream >> exportSettingsKey;
 		} break;
+		case lskDialogsSlice: {
+			map.stream >> dialogsSliceKey;
+		} break;
+		case lskCacheHotKeys: {
+			map.stream >> cacheHotKeysKey;
+		} break;
 		default:
 			LOG(("App Error: unknown key type in encrypted map: %1").arg(keyType));
 			return ReadMapResult::Failed;
@@ -387,6 +408,8 @@ Account::ReadMapResult Account::readMapWith(
 	_settingsKey = userSettingsKey;
 	_recentHashtagsAndBotsKey = recentHashtagsAndBotsKey;
 	_exportSettingsKey = exportSettingsKey;
+	_dialogsSliceKey = dialogsSliceKey;
+	_cacheHotKeysKey = cacheHotKeysKey;
 	_oldMapVersion = mapData.version;
 
 	if (_oldMapVersion < AppVersion) {
@@ -486,6 +509,8 @@ void Account::writeMap() {
 	if (_settingsKey) mapSize += sizeof(quint32) + sizeof(quint64);
 	if (_recentHashtagsAndBotsKey) mapSize += sizeof(quint32) + sizeof(quint64);
 	if (_exportSettingsKey) mapSize += sizeof(quint32) + sizeof(quint64);
+	if (_dialogsSliceKey) mapSize += sizeof(quint32) + sizeof(quint64);
+	if (_cacheHotKeysKey) mapSize += sizeof(quint32) + sizeof(quint64);
 
 	EncryptedDescriptor mapData(mapSize);
 	if (!self.isEmpty()) {
@@ -531,6 +556,12 @@ void Account::writeMap() {
 	if (_exportSettingsKey) {
 		mapData.stream << quint32(lskExportSettings) << quint64(_exportSettingsKey);
 	}
+	if (_dialogsSliceKey) {
+		mapData.stream << quint32(lskDialogsSlice) << quint64(_dialogsSliceKey);
+	}
+	if (_cacheHotKeysKey) {
+		mapData.stream << quint32(lskCacheHotKeys) << quint64(_cacheHotKeysKey);
+	}
 	map.writeEncrypted(mapData, _localKey);
 
 	_mapChanged = false;
@@ -541,7 +572,7 @@ void Account::reset() {
 	_draftsMap.clear();
 	_draftCursorsMap.clear();
 	_draftsNotReadMap.clear();
-	_locationsKey = _trustedBotsKey = 0;
+	_locationsKey = _locationsJournalKey = _trustedBotsKey = 0;
 	_recentStickersKeyOld = 0;
 	_installedStickersKey = 0;
 	_featuredStickersKey = 0;
@@ -551,10 +582,14 @@ void Account::reset() {
 	_savedGifsKey = 0;
 	_legacyBackgroundKeyDay = _legacyBackgroundKeyNight = 0;
 	_settingsKey = _recentHashtagsAndBotsKey = _exportSettingsKey = 0;
+	_dialogsSliceKey = 0;
+	_cacheHotKeysKey = 0;
 	_oldMapVersion = 0;
 	_fileLocations.clear();
 	_fileLocationPairs.clear();
 	_fileLocationAliases.clear();
+	_locationsJournal.clear();
+	_locationAliasesJournal.clear();
 	_cacheTotalSizeLimit = Database::Settings().totalSizeLimit;
 	_cacheTotalTimeLimit = Database::Settings().totalTimeLimit;
 	_cacheBigFileTotalSizeLimit = Database::Settings().totalSizeLimit;
@@ -563,7 +598,12 @@ void Account::reset() {
 	writeMap();
 	writeMtpData();
 
-	crl::async([base = _basePath, temp = _tempPath, names = std::move(names)] {
+	// On the writing queue, so that files queued before the reset
+	// are not written again after they are removed.
+	AfterPendingWrites([
+			base = _basePath,
+			temp = _tempPath,
+			names = std::move(names)] {
 		for (const auto &name : names) {
 			if (!name.endsWith(qstr("map0"))
 				&& !name.endsWith(qstr("map1"))
@@ -590,60 +630,139 @@ void Account::writeLocations() {
 			_locationsKey = 0;
 			writeMapDelayed();
 		}
-	} else {
-		if (!_locationsKey) {
-			_locationsKey = GenerateKey(_basePath);
-			writeMapQueued();
-		}
-		quint32 size = 0;
-		for (auto i = _fileLocations.cbegin(), e = _fileLocations.cend(); i != e; ++i) {
-			// location + type + namelen + name
-			size += sizeof(quint64) * 2 + sizeof(quint32) + Serialize::stringSize(i.value().name());
-			if (AppVersion > 9013) {
-				// bookmark
-				size += Serialize::bytearraySize(i.value().bookmark());
-			}
-			// date + size
-			size += Serialize::dateTimeSize() + sizeof(quint32);
+		if (_locationsJournalKey) {
+			ClearKey(_locationsJournalKey, _basePath);
+			_locationsJournalKey = 0;
 		}
+		_locationsJournal.clear();
+		_locationAliasesJournal.clear();
+		return;
+	}
+	const auto journalSize = _locationsJournal.size()
+		+ _locationAliasesJournal.size();
+	if (_locationsKey
+		&& _locationsJournalKey
+		&& journalSize <= kLocationsJournalLimit) {
+		writeLocationsJournal();
+		return;
+	}
+	if (!_locationsKey) {
+		_locationsKey = GenerateKey(_basePath);
+		writeMapQueued();
+	}
+	if (!_locationsJournalKey) {
+		_locationsJournalKey = GenerateKey(_basePath);
+	}
+
+	// Empty the journal before the full rewrite, so that a stale journal
+	// is never applied over a newer locations file.
+	_locationsJournal.clear();
+	_locationAliasesJournal.clear();
+	writeLocationsJournal();
 
-		//end mark
-		size += sizeof(quint64) * 2 + sizeof(quint32) + Serialize::stringSize(QString());
+	quint32 size = 0;
+	for (auto i = _fileLocations.cbegin(), e = _fileLocations.cend(); i != e; ++i) {
+		// location + type + namelen + name
+		size += sizeof(quint64) * 2 + sizeof(quint32) + Serialize::stringSize(i.value().name());
 		if (AppVersion > 9013) {
-			size += Serialize::bytearraySize(QByteArray());
+			// bookmark
+			size += Serialize::bytearraySize(i.value().bookmark());
 		}
+		// date + size
 		size += Serialize::dateTimeSize() + sizeof(quint32);
+	}
 
-		size += sizeof(quint32); // aliases count
-		for (auto i = _fileLocationAliases.cbegin(), e = _fileLocationAliases.cend(); i != e; ++i) {
-			// alias + location
-			size += sizeof(quint64) * 2 + sizeof(quint64) * 2;
-		}
+	//end mark
+	size += sizeof(quint64) * 2 + sizeof(quint32) + Serialize::stringSize(QString());
+	if (AppVersion > 9013) {
+		size += Serialize::bytearraySize(QByteArray());
+	}
+	size += Serialize::dateTimeSize() + sizeof(quint32);
 
-		EncryptedDescriptor data(size);
-		auto legacyTypeField = 0;
-		for (auto i = _fileLocations.cbegin(); i != _fileLocations.cend(); ++i) {
-			data.stream << quint64(i.key().first) << quint64(i.key().second) << quint32(legacyTypeField) << i.value().name();
-			if (AppVersion > 9013) {
-				data.stream << i.value().bookmark();
-			}
-			data.stream << i.value().modified << quint32(i.value().size);
-		}
+	size += sizeof(quint32); // aliases count
+	for (auto i = _fileLocationAliases.cbegin(), e = _fileLocationAliases.cend(); i != e; ++i) {
+		// alias + location
+		size += sizeof(quint64) * 2 + sizeof(quint64) * 2;
+	}
 
-		data.stream << quint64(0) << quint64(0) << quint32(0) << QString();
+	// legacy web locations count + journal key
+	size += sizeof(quint32) + sizeof(quint64);
+
+	EncryptedDescriptor data(size);
+	auto legacyTypeField = 0;
+	for (auto i = _fileLocations.cbegin(); i != _fileLocations.cend(); ++i) {
+		data.stream << quint64(i.key().first) << quint64(i.key().second) << quint32(legacyTypeField) << i.value().name();
 		if (AppVersion > 9013) {
-			data.stream << QByteArray();
+			data.stream << i.value().bookmark();
 		}
-		data.stream << QDateTime::currentDateTime() << quint32(0);
+		data.stream << i.value().modified << quint32(i.value().size);
+	}
 
-		data.stream << quint32(_fileLocationAliases.size());
-		for (auto i = _fileLocationAliases.cbegin(), e = _fileLocationAliases.cend(); i != e; ++i) {
-			data.stream << quint64(i.key().first) << quint64(i.key().second) << quint64(i.value().first) << quint64(i.value().second);
+	data.stream << quint64(0) << quint64(0) << quint32(0) << QString();
+	if (AppVersion > 9013) {
+		data.stream << QByteArray();
+	}
+	data.stream << QDateTime::currentDateTime() << quint32(0);
+
+	data.stream << quint32(_fileLocationAliases.size());
+	for (auto i = _fileLocationAliases.cbegin(), e = _fileLocationAliases.cend(); i != e; ++i) {
+		data.stream << quint64(i.key().first) << quint64(i.key().second) << quint64(i.value().first) << quint64(i.value().second);
+	}
+
+	// Older versions read the legacy web locations count here
+	// and ignore everything after it.
+	data.stream << quint32(0) << quint64(_locationsJournalKey);
+
+	FileWriteDescriptor file(_locationsKey, _basePath);
+	file.writeEncrypted(data, _localKey);
+}
+
+void Account::writeLocationsJournal() {
+	Expects(_locationsJournalKey != 0);
+
+	quint32 size = sizeof(quint32); // locations count
+	for (const auto &location : _locationsJournal) {
+		// location + entries count
+		size += sizeof(quint64) * 2 + sizeof(quint32);
+		for (auto i = _fileLocations.constFind(location); (i != _fileLocations.cend()) && (i.key() == location); ++i) {
+			// name + bookmark + date + size
+			size += Serialize::stringSize(i.value().name())
+				+ Serialize::bytearraySize(i.value().bookmark())
+				+ Serialize::dateTimeSize()
+				+ sizeof(quint32);
 		}
+	}
+	size += sizeof(quint32); // aliases count
+	size += _locationAliasesJournal.size() * sizeof(quint64) * 4;
 
-		FileWriteDescriptor file(_locationsKey, _basePath);
-		file.writeEncrypted(data, _localKey);
+	EncryptedDescriptor data(size);
+	data.stream << quint32(_locationsJournal.size());
+	for (const auto &location : _locationsJournal) {
+		const auto count = _fileLocations.count(location);
+		data.stream
+			<< quint64(location.first)
+			<< quint64(location.second)
+			<< quint32(count);
+		for (auto i = _fileLocations.constFind(location); (i != _fileLocations.cend()) && (i.key() == location); ++i) {
+			data.stream
+				<< i.value().name()
+				<< i.value().bookmark()
+				<< i.value().modified
+				<< quint32(i.value().size);
+		}
+	}
+	data.stream << quint32(_locationAliasesJournal.size());
+	for (const auto &alias : _locationAliasesJournal) {
+		const auto location = _fileLocationAliases.value(alias);
+		data.stream
+			<< quint64(alias.first)
+			<< quint64(alias.second)
+			<< quint64(location.first)
+			<< quint64(location.second);
 	}
+
+	FileWriteDescriptor file(_locationsJournalKey, _basePath);
+	file.writeEncrypted(data, _localKey);
 }
 
 void Account::writeLocationsQueued() {
@@ -713,6 +832,64 @@ void Account::readLocations() {
 				ClearKey(key, _basePath);
 			}
 		}
+
+		if (!locations.stream.atEnd()) {
+			quint64 journalKey = 0;
+			locations.stream >> journalKey;
+			if (CheckStreamStatus(locations.stream)) {
+				_locationsJournalKey = journalKey;
+			}
+		}
+	}
+	if (_locationsJournalKey) {
+		readLocationsJournal();
+	}
+}
+
+void Account::readLocationsJournal() {
+	FileReadDescriptor journal;
+	if (!ReadEncryptedFile(journal, _locationsJournalKey, _basePath, _localKey)) {
+		return;
+	}
+
+	quint32 count = 0;
+	journal.stream >> count;
+	for (quint32 i = 0; i != count && CheckStreamStatus(journal.stream); ++i) {
+		quint64 first = 0, second = 0;
+		quint32 entries = 0;
+		journal.stream >> first >> second >> entries;
+		const auto key = MediaKey(first, second);
+		for (auto j = _fileLocations.find(key); (j != _fileLocations.end()) && (j.key() == key);) {
+			const auto pair = _fileLocationPairs.constFind(j.value().fname);
+			if (pair != _fileLocationPairs.cend() && pair.value().first == key) {
+				_fileLocationPairs.erase(pair);
+			}
+			j = _fileLocations.erase(j);
+		}
+		for (quint32 j = 0; j != entries; ++j) {
+			QByteArray bookmark;
+			Core::FileLocation loc;
+			journal.stream >> loc.fname >> bookmark >> loc.modified >> loc.size;
+			if (!CheckStreamStatus(journal.stream)) {
+				return;
+			}
+			loc.setBookmark(bookmark);
+
+			_fileLocations.insert(key, loc);
+			if (!loc.inMediaCache()) {
+				_fileLocationPairs.insert(loc.fname, { key, loc });
+			}
+		}
+		_locationsJournal.emplace(key);
+	}
+
+	journal.stream >> count;
+	for (quint32 i = 0; i != count && CheckStreamStatus(journal.stream); ++i) {
+		quint64 kfirst = 0, ksecond = 0, vfirst = 0, vsecond = 0;
+		journal.stream >> kfirst >> ksecond >> vfirst >> vsecond;
+		const auto alias = MediaKey(kfirst, ksecond);
+		_fileLocationAliases.insert(alias, MediaKey(vfirst, vsecond));
+		_locationAliasesJournal.emplace(alias);
 	}
 }
 
@@ -1362,6 +1539,7 @@ void Account::writeFileLocation(MediaKey location, const Core::FileLocation &loc
 			if (i.value().second == local) {
 				if (i.value().first != location) {
 					_fileLocationAliases.insert(location, i.value().first);
+					_locationAliasesJournal.emplace(location);
 					writeLocationsQueued();
 				}
 				return;
@@ -1373,6 +1551,7 @@ void Account::writeFileLocation(MediaKey location, const Core::FileLocation &loc
 						break;
 					}
 				}
+				_locationsJournal.emplace(i.value().first);
 				_fileLocationPairs.erase(i);
 			}
 		}
@@ -1386,6 +1565,7 @@ void Account::writeFileLocation(MediaKey location, const Core::FileLocation &loc
 		}
 	}
 	_fileLocations.insert(location, local);
+	_locationsJournal.emplace(location);
 	writeLocationsQueued();
 }
 
@@ -1397,6 +1577,7 @@ void Account::removeFileLocation(MediaKey location) {
 	while (i != _fileLocations.end() && (i.key() == location)) {
 		i = _fileLocations.erase(i);
 	}
+	_locationsJournal.emplace(location);
 	writeLocationsQueued();
 }
 
@@ -1410,6 +1591,7 @@ Core::FileLocation Account::readFileLocation(MediaKey location) {
 		if (!i.value().inMediaCache() && !i.value().check()) {
 			_fileLocationPairs.remove(i.value().fname);
 			i = _fileLocations.erase(i);
+			_locationsJournal.emplace(location);
 			writeLocationsDelayed();
 			continue;
 		}
@@ -2320,6 +2502,114 @@ void Account::saveRecentSearchHashtags(const QString &text) {
 	}
 }
 
+void Account::writeDialogsSlice(const MTPmessages_Dialogs &slice) {
+	auto buffer = mtpBuffer();
+	slice.write(buffer);
+	const auto bytes = QByteArray::fromRawData(
+		reinterpret_cast<const char*>(buffer.constData()),
+		buffer.size() * sizeof(mtpPrime));
+
+	if (!_dialogsSliceKey) {
+		_dialogsSliceKey = GenerateKey(_basePath);
+		writeMapQueued();
+	}
+	EncryptedDescriptor data(Serialize::bytearraySize(bytes));
+	data.stream << bytes;
+	FileWriteDescriptor file(_dialogsSliceKey, _basePath);
+	file.writeEncrypted(data, _localKey);
+}
+
+std::optional<MTPmessages_Dialogs> Account::readDialogsSlice() {
+	if (!_dialogsSliceKey) {
+		return std::nullopt;
+	}
+
+	const auto failed = [&] {
+		ClearKey(_dialogsSliceKey, _basePath);
+		_dialogsSliceKey = 0;
+		writeMapDelayed();
+		return std::nullopt;
+	};
+	FileReadDescriptor dialogs;
+	if (!ReadEncryptedFile(dialogs, _dialogsSliceKey, _basePath, _localKey)) {
+		return failed();
+	} else if (dialogs.version != AppVersion) {
+		// The slice is stored in the API layer of the version that wrote it.
+		return failed();
+	}
+	auto bytes = QByteArray();
+	dialogs.stream >> bytes;
+	if (!CheckStreamStatus(dialogs.stream)
+		|| (bytes.size() % sizeof(mtpPrime)) != 0) {
+		return failed();
+	}
+	auto from = reinterpret_cast<const mtpPrime*>(bytes.constData());
+	const auto till = from + (bytes.size() / sizeof(mtpPrime));
+	auto result = MTPmessages_Dialogs();
+	if (!result.read(from, till)) {
+		return failed();
+	}
+	return result;
+}
+
+void Account::writeCacheHotKeys(const std::vector<Cache::Key> &keys) {
+	if (keys.empty()) {
+		if (_cacheHotKeysKey) {
+			ClearKey(_cacheHotKeysKey, _basePath);
+			_cacheHotKeysKey = 0;
+			writeMapDelayed();
+		}
+		return;
+	}
+	if (!_cacheHotKeysKey) {
+		_cacheHotKeysKey = GenerateKey(_basePath);
+		writeMapQueued();
+	}
+	EncryptedDescriptor data(
+		sizeof(quint32) + keys.size() * sizeof(quint64) * 2);
+	data.stream << quint32(keys.size());
+	for (const auto &key : keys) {
+		data.stream << quint64(key.high) << quint64(key.low);
+	}
+	FileWriteDescriptor file(_cacheHotKeysKey, _basePath);
+	file.writeEncrypted(data, _localKey);
+}
+
+std::vector<Cache::Key> Account::readCacheHotKeys() {
+	if (!_cacheHotKeysKey) {
+		return {};
+	}
+
+	const auto failed = [&] {
+		ClearKey(_cacheHotKeysKey, _basePath);
+		_cacheHotKeysKey = 0;
+		writeMapDelayed();
+		return std::vector<Cache::Key>();
+	};
+	FileReadDescriptor hot;
+	if (!ReadEncryptedFile(hot, _cacheHotKeysKey, _basePath, _localKey)) {
+		return failed();
+	}
+	auto count = quint32();
+	hot.stream >> count;
+	if (!CheckStreamStatus(hot.stream)) {
+		return failed();
+	}
+	count = std::min(count, quint32(kCacheHotKeysLimit));
+	auto result = std::vector<Cache::Key>();
+	result.reserve(count);
+	for (auto i = 0; i != count; ++i) {
+		auto high = quint64();
+		auto low = quint64();
+		hot.stream >> high >> low;
+		result.push_back({ high, low });
+	}
+	if (!CheckStreamStatus(hot.stream)) {
+		return failed();
+	}
+	return result;
+}
+
 void Account::writeExportSettings(const Export::Settings &settings) {
 	const auto check = Export::Settings();
 	if (settings.types == check.types
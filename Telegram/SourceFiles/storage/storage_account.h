@@ -123,6 +123,12 @@ public:
 	void saveRecentSentHashtags(const QString &text);
 	void saveRecentSearchHashtags(const QString &text);
 
+	void writeDialogsSlice(const MTPmessages_Dialogs &slice);
+	[[nodiscard]] std::optional<MTPmessages_Dialogs> readDialogsSlice();
+
+	void writeCacheHotKeys(const std::vector<Cache::Key> &keys);
+	[[nodiscard]] std::vector<Cache::Key> readCacheHotKeys();
+
 	void writeExportSettings(const Export::Settings &settings);
 	[[nodiscard]] Export::Settings readExportSettings();
 
@@ -171,7 +177,9 @@ private:
 	void writeMap();
 
 	void readLocations();
+	void readLocationsJournal();
 	void writeLocations();
+	void writeLocationsJournal();
 	void writeLocationsQueued();
 	void writeLocationsDelayed();
 
@@ -232,8 +240,11 @@ private:
 	QMultiMap<MediaKey, Core::FileLocation> _fileLocations;
 	QMap<QString, QPair<MediaKey, Core::FileLocation>> _fileLocationPairs;
 	QMap<MediaKey, MediaKey> _fileLocationAliases;
+	base::flat_set<MediaKey> _locationsJournal;
+	base::flat_set<MediaKey> _locationAliasesJournal;
 
 	FileKey _locationsKey = 0;
+	FileKey _locationsJournalKey = 0;
 	FileKey _trustedBotsKey = 0;
 	FileKey _installedStickersKey = 0;
 	FileKey _featuredStickersKey = 0;
@@ -247,6 +258,8 @@ private:
 	FileKey _settingsKey = 0;
 	FileKey _recentHashtagsAndBotsKey = 0;
 	FileKey _exportSettingsKey = 0;
+	FileKey _dialogsSliceKey = 0;
+	FileKey _cacheHotKeysKey = 0;
 
 	qint64 _cacheTotalSizeLimit = 0;
 	qint64 _cacheBigFileTotalSizeLimit = 0;
@@ -254,6 +254,20 @@ bool Domain::checkPasscode(const QByteArray &passcode) const {
 	return checkKey->equals(_passcodeKey);
 }
 
+void Domain::checkPasscodeAsync(
+		const QByteArray &passcode,
+		Fn<void(bool correct)> done) const {
+	Expects(!_passcodeKeySalt.isEmpty());
+	Expects(_passcodeKey != nullptr);
+
+	crl::async([=, salt = _passcodeKeySalt, key = _passcodeKey] {
+		const auto correct = CreateLocalKey(passcode, salt)->equals(key);
+		crl::on_main([=] {
+			done(correct);
+		});
+	});
+}
+
 void Domain::setPasscode(const QByteArray &passcode) {
 	Expects(!_passcodeKeySalt.isEmpty());
 	Expects(_localKey != nullptr);
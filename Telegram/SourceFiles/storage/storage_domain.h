@@ -39,6 +39,11 @@ public:
 	void startFromScratch();
 
 	[[nodiscard]] bool checkPasscode(const QByteArray &passcode) const;
+
+	// Derives the key on a background thread, calls done on main.
+	void checkPasscodeAsync(
+		const QByteArray &passcode,
+		Fn<void(bool correct)> done) const;
 	void setPasscode(const QByteArray &passcode);
 
 	[[nodiscard]] int oldVersion() const;
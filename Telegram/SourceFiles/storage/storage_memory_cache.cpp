@@ -0,0 +1,125 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "storage/storage_memory_cache.h"
+
+#include "core/core_probes.h"
+
+namespace Storage {
+namespace {
+
+constexpr auto kAdmitRequestsCount = 2;
+constexpr auto kMaxRequestsTracked = 4096;
+
+} // namespace
+
+MemoryCache::MemoryCache(int64 sizeLimit) : _sizeLimit(sizeLimit) {
+}
+
+std::optional<QByteArray> MemoryCache::get(const Cache::Key &key) {
+	static auto hits = Core::Probe("cache.memory_hit_bytes");
+	static auto misses = Core::Probe("cache.memory_miss");
+
+	const auto i = _entries.find(key);
+	if (i != end(_entries)) {
+		i->second.used = ++_useCounter;
+		hits.add(i->second.value.size());
+		return i->second.value;
+	}
+	misses.add(1);
+	if (_requests.size() >= kMaxRequestsTracked) {
+		_requests.clear();
+	}
+	++_requests[key];
+	return std::nullopt;
+}
+
+void MemoryCache::put(const Cache::Key &key, const QByteArray &value) {
+	const auto i = _requests.find(key);
+	if (i == end(_requests)
+		|| i->second < kAdmitRequestsCount
+		|| value.size() > _sizeLimit / 4) {
+		return;
+	}
+	_requests.erase(i);
+	remove(key);
+	_entries.emplace(key, Entry{ value, ++_useCounter });
+	_size += value.size();
+	shrinkToLimit();
+}
+
+void MemoryCache::remove(const Cache::Key &key) {
+	const auto i = _entries.find(key);
+	if (i != end(_entries)) {
+		_size -= i->second.value.size();
+		_entries.erase(i);
+	}
+}
+
+void MemoryCache::clear() {
+	_entries.clear();
+	_requests.clear();
+	_size = 0;
+}
+
+std::vector<Cache::Key> MemoryCache::hotKeys(int limit) const {
+	auto used = std::vector<std::pair<uint64, Cache::Key>>();
+	used.reserve(_entries.size());
+	for (const auto &[key, entry] : _entries) {
+		used.emplace_back(entry.used, key);
+	}
+	ranges::sort(used, ranges::greater());
+	if (int(used.size()) > limit) {
+		used.resize(limit);
+	}
+	return used | ranges::views::transform([](const auto &pair) {
+		return pair.second;
+	}) | ranges::to_vector;
+}
+
+void MemoryCache::warmUp(const Cache::Key &key, const QByteArray &value) {
+	if (value.isEmpty()
+		|| _entries.contains(key)
+		|| _size + value.size() > _sizeLimit) {
+		return;
+	}
+	_entries.emplace(key, Entry{ value, ++_useCounter });
+	_size += value.size();
+}
+
+void MemoryCache::shrinkToLimit() {
+	if (_size <= _sizeLimit) {
+		return;
+	}
+
+	// Drop the least recently used values until a quarter is free.
+	auto used = std::vector<std::pair<uint64, int>>();
+	used.reserve(_entries.size());
+	for (const auto &[key, entry] : _entries) {
+		used.emplace_back(entry.used, entry.value.size());
+	}
+	ranges::sort(used);
+	auto size = _size;
+	auto border = uint64(0);
+	for (const auto &[value, bytes] : used) {
+		if (size <= _sizeLimit * 3 / 4) {
+			break;
+		}
+		border = value;
+		size -= bytes;
+	}
+	for (auto i = begin(_entries); i != end(_entries);) {
+		if (i->second.used <= border) {
+			_size -= i->second.value.size();
+			i = _entries.erase(i);
+		} else {
+			++i;
+		}
+	}
+}
+
+} // namespace Storage
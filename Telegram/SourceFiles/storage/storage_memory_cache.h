@@ -0,0 +1,54 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "storage/cache/storage_cache_types.h"
+
+namespace Storage {
+
+// Recently read values of the local cache database, so that scrolling
+// back over the same media doesn't read and decrypt them from disk again.
+// Only values requested more than once are kept, least recently used
+// ones are dropped when the total size goes over the limit.
+class MemoryCache final {
+public:
+	explicit MemoryCache(int64 sizeLimit);
+
+	[[nodiscard]] std::optional<QByteArray> get(const Cache::Key &key);
+	void put(const Cache::Key &key, const QByteArray &value);
+	void remove(const Cache::Key &key);
+	void clear();
+
+	[[nodiscard]] int count() const {
+		return int(_entries.size());
+	}
+	[[nodiscard]] int64 size() const {
+		return _size;
+	}
+
+	// For restoring the values used in the previous launch.
+	[[nodiscard]] std::vector<Cache::Key> hotKeys(int limit) const;
+	void warmUp(const Cache::Key &key, const QByteArray &value);
+
+private:
+	struct Entry {
+		QByteArray value;
+		uint64 used = 0;
+	};
+
+	void shrinkToLimit();
+
+	const int64 _sizeLimit = 0;
+	base::flat_map<Cache::Key, Entry> _entries;
+	base::flat_map<Cache::Key, int> _requests;
+	int64 _size = 0;
+	uint64 _useCounter = 0;
+
+};
+
+} // namespace Storage
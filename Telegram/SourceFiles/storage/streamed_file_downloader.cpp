@@ -161,7 +161,12 @@ void StreamedFileDownloader::savePart(const LoadedPart &part) {
 	}
 	_reader->doneForDownloader(offset);
 	if (_partsSaved == _partsCount) {
-		finalizeResult();
+		// We may be destroyed while notifying about the finish.
+		const auto reader = _reader;
+		const auto toFile = !_filename.isEmpty();
+		if (finalizeResult() && toFile) {
+			reader->dropCacheForDownloaded();
+		}
 	} else {
 		requestParts();
 		notifyAboutProgress();
@@ -7,11 +7,15 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "support/support_helper.h"
 
+#include "support/support_common.h"
 #include "dialogs/dialogs_key.h"
+#include "dialogs/dialogs_main_list.h"
 #include "data/data_drafts.h"
 #include "data/data_user.h"
 #include "data/data_session.h"
 #include "data/data_changes.h"
+#include "data/data_channel.h"
+#include "data/data_histories.h"
 #include "api/api_text_entities.h"
 #include "history/history.h"
 #include "boxes/abstract_box.h"
@@ -32,6 +36,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/application.h"
 #include "core/core_settings.h"
 #include "main/main_session.h"
+#include "main/main_session_settings.h"
 #include "apiwrap.h"
 #include "facades.h"
 #include "styles/style_layers.h"
@@ -47,6 +52,7 @@ namespace {
 constexpr auto kOccupyFor = TimeId(60);
 constexpr auto kReoccupyEach = 30 * crl::time(1000);
 constexpr auto kMaxSupportInfoLength = MaxMessageSize * 4;
+constexpr auto kPreloadMessagesCount = 30;
 
 class EditInfoBox : public Ui::BoxContent {
 public:
@@ -302,6 +308,111 @@ void Helper::registerWindow(not_null<Window::SessionController*> controller) {
 	) | rpl::start_with_next([=](History *history) {
 		updateOccupiedHistory(controller, history);
 	}, controller->lifetime());
+
+	controller->activeChatValue(
+	) | rpl::map([](Dialogs::Key key) {
+		return key.history();
+	}) | rpl::distinct_until_changed(
+	) | rpl::start_with_next([=](History *history) {
+		preloadSwitchTarget(history);
+	}, controller->lifetime());
+}
+
+void Helper::preloadSwitchTarget(History *history) {
+	if (history && history == _preloadHistory) {
+		// HistoryWidget requests this history itself now.
+		cancelPreload();
+	}
+	if (!history) {
+		return;
+	}
+	const auto list = _session->data().chatsList()->indexed();
+	const auto row = list->getRow(history);
+	if (!row) {
+		return;
+	}
+	const auto i = list->cfind(row);
+	const auto target = [&]() -> History* {
+		switch (_session->settings().supportSwitch()) {
+		case SwitchSettings::Next:
+			return (i + 1 != list->cend()) ? (*(i + 1))->history() : nullptr;
+		case SwitchSettings::Previous:
+			return (i != list->cbegin()) ? (*(i - 1))->history() : nullptr;
+		}
+		return nullptr;
+	}();
+	if (target) {
+		preloadHistory(target);
+	}
+}
+
+void Helper::preloadHistory(not_null<History*> history) {
+	if (history == _preloadHistory
+		|| history->peer->migrateFrom()
+		|| history->isReadyFor(ShowAtUnreadMsgId)) {
+		return;
+	}
+	const auto around = history->loadAroundId();
+	if (history->unreadCount() && !around) {
+		return;
+	}
+	cancelPreload();
+
+	// Same request as HistoryWidget::firstLoadMessages() sends,
+	// so that switching to this chat finds it ready to be shown.
+	const auto offsetId = around;
+	const auto offset = around ? (-kPreloadMessagesCount / 2) : 0;
+
+	_preloadHistory = history;
+	const auto type = Data::Histories::RequestType::History;
+	auto &histories = history->owner().histories();
+	_preloadRequestId = histories.sendRequest(history, type, [=](
+			Fn<void()> finish) {
+		return _session->api().request(MTPmessages_GetHistory(
+			history->peer->input,
+			MTP_int(offsetId),
+			MTP_int(0), // offset_date
+			MTP_int(offset),
+			MTP_int(kPreloadMessagesCount),
+			MTP_int(0), // max_id
+			MTP_int(0), // min_id
+			MTP_int(0) // hash
+		)).done([=](const MTPmessages_Messages &result) {
+			_preloadHistory = nullptr;
+			_preloadRequestId = 0;
+			finish();
+
+			result.match([&](const MTPDmessages_channelMessages &data) {
+				if (const auto channel = history->peer->asChannel()) {
+					channel->ptsReceived(data.vpts().v);
+				}
+			}, [](const auto &) {
+			});
+			const auto list = result.match([&](
+					const MTPDmessages_messagesNotModified &) {
+				return QVector<MTPMessage>();
+			}, [&](const auto &data) {
+				_session->data().processUsers(data.vusers());
+				_session->data().processChats(data.vchats());
+				return data.vmessages().v;
+			});
+			if (!history->isReadyFor(ShowAtUnreadMsgId)) {
+				history->getReadyFor(ShowAtUnreadMsgId);
+				history->addOlderSlice(list);
+			}
+		}).fail([=](const RPCError &error) {
+			_preloadHistory = nullptr;
+			_preloadRequestId = 0;
+			finish();
+		}).send();
+	});
+}
+
+void Helper::cancelPreload() {
+	if (const auto history = base::take(_preloadHistory)) {
+		history->owner().histories().cancelRequest(
+			base::take(_preloadRequestId));
+	}
 }
 
 void Helper::cloudDraftChanged(not_null<History*> history) {
@@ -79,6 +79,10 @@ private:
 	void occupyInDraft();
 	void reoccupy();
 
+	void preloadSwitchTarget(History *history);
+	void preloadHistory(not_null<History*> history);
+	void cancelPreload();
+
 	void applyInfo(
 		not_null<UserData*> user,
 		const MTPhelp_UserInfo &result);
@@ -101,6 +105,9 @@ private:
 	base::Timer _checkOccupiedTimer;
 	base::flat_map<not_null<History*>, TimeId> _occupiedChats;
 
+	History *_preloadHistory = nullptr;
+	int _preloadRequestId = 0;
+
 	base::flat_map<not_null<UserData*>, UserInfo> _userInformation;
 	base::flat_map<
 		not_null<UserData*>,
@@ -274,7 +274,7 @@ TemplatesIndex ComputeIndex(const TemplatesData &data) {
 	using Id = TemplatesIndex::Id;
 	using Term = TemplatesIndex::Term;
 
-	auto uniqueFirst = std::map<QChar, base::flat_set<Id>>();
+	auto uniqueWords = std::map<QString, base::flat_set<Id>>();
 	auto uniqueFull = std::map<Id, base::flat_set<Term>>();
 	const auto pushString = [&](
 			const Id &id,
@@ -282,7 +282,7 @@ TemplatesIndex ComputeIndex(const TemplatesData &data) {
 			int weight) {
 		const auto list = TextUtilities::PrepareSearchWords(string);
 		for (const auto &word : list) {
-			uniqueFirst[word[0]].emplace(id);
+			uniqueWords[word].emplace(id);
 			uniqueFull[id].emplace(std::make_pair(word, weight));
 		}
 	};
@@ -298,8 +298,8 @@ TemplatesIndex ComputeIndex(const TemplatesData &data) {
 	}
 
 	auto result = TemplatesIndex();
-	for (const auto &[ch, unique] : uniqueFirst) {
-		result.first.emplace(ch, unique | ranges::to_vector);
+	for (const auto &[word, unique] : uniqueWords) {
+		result.words.emplace(word, unique | ranges::to_vector);
 	}
 	for (const auto &[id, unique] : uniqueFull) {
 		result.full.emplace(id, unique | ranges::to_vector);
@@ -323,17 +323,23 @@ void ReplaceFileIndex(
 	}
 
 	using Id = TemplatesIndex::Id;
-	for (auto &[ch, list] : result.first) {
-		auto i = ranges::lower_bound(
+	for (auto i = begin(result.words); i != end(result.words);) {
+		auto &list = i->second;
+		auto from = ranges::lower_bound(
 			list,
 			std::make_pair(path, QString()));
-		auto j = std::find_if(i, end(list), [&](const Id &id) {
+		auto till = std::find_if(from, end(list), [&](const Id &id) {
 			return id.first != path;
 		});
-		list.erase(i, j);
+		list.erase(from, till);
+		if (list.empty()) {
+			i = result.words.erase(i);
+		} else {
+			++i;
+		}
 	}
-	for (auto &[ch, list] : source.first) {
-		auto &to = result.first[ch];
+	for (auto &[word, list] : source.words) {
+		auto &to = result.words[word];
 		to.insert(
 			end(to),
 			std::make_move_iterator(begin(list)),
@@ -665,21 +671,39 @@ auto Templates::matchFromEnd(QString query) const
 Templates::~Templates() = default;
 
 auto Templates::query(const QString &text) const -> std::vector<Question> {
+	using Id = TemplatesIndex::Id;
+	using Term = TemplatesIndex::Term;
+
 	const auto words = TextUtilities::PrepareSearchWords(text);
-	const auto questions = [&](const QString &word) {
-		const auto i = _index.first.find(word[0]);
-		return (i == end(_index.first)) ? 0 : i->second.size();
-	};
-	const auto best = ranges::min_element(words, std::less<>(), questions);
-	if (best == std::end(words)) {
+	if (words.isEmpty()) {
 		return {};
 	}
-	const auto narrowed = _index.first.find((*best)[0]);
-	if (narrowed == end(_index.first)) {
+	const auto withPrefix = [&](const QString &word) {
+		auto result = std::vector<Id>();
+		for (auto i = _index.words.lower_bound(word)
+			; (i != end(_index.words)) && i->first.startsWith(word)
+			; ++i) {
+			result.insert(end(result), begin(i->second), end(i->second));
+		}
+		ranges::sort(result);
+		result.erase(ranges::unique(result), end(result));
+		return result;
+	};
+	auto narrowed = withPrefix(words.front());
+	for (const auto &word : words.mid(1)) {
+		if (narrowed.empty()) {
+			break;
+		}
+		auto both = std::vector<Id>();
+		ranges::set_intersection(
+			narrowed,
+			withPrefix(word),
+			ranges::back_inserter(both));
+		narrowed = std::move(both);
+	}
+	if (narrowed.empty()) {
 		return {};
 	}
-	using Id = TemplatesIndex::Id;
-	using Term = TemplatesIndex::Term;
 	const auto questionById = [&](const Id &id) {
 		return _data.files.at(id.first).questions.at(id.second);
 	};
@@ -730,7 +754,7 @@ auto Templates::query(const QString &text) const -> std::vector<Question> {
 			return (a.first.second < b.first.second);
 		}
 	};
-	const auto good = narrowed->second | ranges::view::transform(
+	const auto good = narrowed | ranges::view::transform(
 		pairById
 	) | ranges::view::filter([](const Pair &pair) {
 		return pair.second > 0;
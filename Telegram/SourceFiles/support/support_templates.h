@@ -38,7 +38,7 @@ struct TemplatesIndex {
 	using Id = std::pair<QString, QString>; // filename, normalized question
 	using Term = std::pair<QString, int>; // search term, weight
 
-	std::map<QChar, std::vector<Id>> first;
+	std::map<QString, std::vector<Id>> words; // sorted ids by search term
 	std::map<Id, std::vector<Term>> full;
 };
 
@@ -10,6 +10,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace Ui {
 namespace {
 
+constexpr auto kMaxCachedLayouts = 256;
+
 int Round(float64 value) {
 	return int(std::round(value));
 }
@@ -572,7 +574,32 @@ std::vector<GroupMediaLayout> LayoutMediaGroup(
 		int maxWidth,
 		int minWidth,
 		int spacing) {
-	return Layouter(sizes, maxWidth, minWidth, spacing).layout();
+	// Views of the same album are created again each time its history
+	// block is laid out, so remember the recent results by their input.
+	// Albums are laid out only on the main thread.
+	static auto Cache = base::flat_map<
+		std::vector<int>,
+		std::vector<GroupMediaLayout>>();
+
+	auto key = std::vector<int>();
+	key.reserve(3 + sizes.size() * 2);
+	key.push_back(maxWidth);
+	key.push_back(minWidth);
+	key.push_back(spacing);
+	for (const auto &size : sizes) {
+		key.push_back(size.width());
+		key.push_back(size.height());
+	}
+	const auto i = Cache.find(key);
+	if (i != end(Cache)) {
+		return i->second;
+	}
+	auto result = Layouter(sizes, maxWidth, minWidth, spacing).layout();
+	if (Cache.size() >= kMaxCachedLayouts) {
+		Cache.clear();
+	}
+	Cache.emplace(std::move(key), result);
+	return result;
 }
 
 RectParts GetCornersFromSides(RectParts sides) {
@@ -17,6 +17,29 @@ using namespace Images;
 namespace Images {
 namespace {
 
+// Scaled pixmaps of all images together are trimmed to this size.
+constexpr auto kCacheLimit = int64(64 * 1024 * 1024);
+
+struct CacheState {
+	base::flat_set<not_null<const Image*>> images;
+	int64 bytes = 0;
+	uint64 usage = 0;
+	uint64 requests = 0;
+	uint64 misses = 0;
+	bool trimScheduled = false;
+};
+
+[[nodiscard]] CacheState &GlobalCache() {
+	// Leaked, because static Image::Empty() and others unregister
+	// themselves in ~Image, possibly after this would've been destroyed.
+	static const auto result = new CacheState();
+	return *result;
+}
+
+[[nodiscard]] int64 PixmapBytes(const QPixmap &pixmap) {
+	return int64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+}
+
 [[nodiscard]] uint64 PixKey(int width, int height, Options options) {
 	return static_cast<uint64>(width)
 		| (static_cast<uint64>(height) << 24)
@@ -116,6 +139,13 @@ Image::Image(QImage &&data)
 	Expects(!_data.isNull());
 }
 
+Image::~Image() {
+	auto &cache = GlobalCache();
+	if (cache.images.remove(this)) {
+		cache.bytes -= _cacheBytes;
+	}
+}
+
 not_null<Image*> Image::Empty() {
 	static auto result = Image([] {
 		const auto factor = cIntRetinaFactor();
@@ -161,9 +191,9 @@ const QPixmap &Image::pix(int w, int h) const {
 	if (i == _cache.cend()) {
 		auto p = pixNoCache(w, h, options);
 		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
+		i = remember(k, std::move(p));
 	}
-	return i->second;
+	return used(i);
 }
 
 const QPixmap &Image::pixRounded(
@@ -196,9 +226,9 @@ const QPixmap &Image::pixRounded(
 	if (i == _cache.cend()) {
 		auto p = pixNoCache(w, h, options);
 		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
+		i = remember(k, std::move(p));
 	}
-	return i->second;
+	return used(i);
 }
 
 const QPixmap &Image::pixCircled(int w, int h) const {
@@ -214,9 +244,9 @@ const QPixmap &Image::pixCircled(int w, int h) const {
 	if (i == _cache.cend()) {
 		auto p = pixNoCache(w, h, options);
 		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
+		i = remember(k, std::move(p));
 	}
-	return i->second;
+	return used(i);
 }
 
 const QPixmap &Image::pixBlurredCircled(int w, int h) const {
@@ -232,9 +262,9 @@ const QPixmap &Image::pixBlurredCircled(int w, int h) const {
 	if (i == _cache.cend()) {
 		auto p = pixNoCache(w, h, options);
 		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
+		i = remember(k, std::move(p));
 	}
-	return i->second;
+	return used(i);
 }
 
 const QPixmap &Image::pixBlurred(int w, int h) const {
@@ -250,9 +280,9 @@ const QPixmap &Image::pixBlurred(int w, int h) const {
 	if (i == _cache.cend()) {
 		auto p = pixNoCache(w, h, options);
 		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
+		i = remember(k, std::move(p));
 	}
-	return i->second;
+	return used(i);
 }
 
 const QPixmap &Image::pixColored(style::color add, int w, int h) const {
@@ -268,9 +298,9 @@ const QPixmap &Image::pixColored(style::color add, int w, int h) const {
 	if (i == _cache.cend()) {
 		auto p = pixColoredNoCache(add, w, h, true);
 		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
+		i = remember(k, std::move(p));
 	}
-	return i->second;
+	return used(i);
 }
 
 const QPixmap &Image::pixBlurredColored(
@@ -289,9 +319,9 @@ const QPixmap &Image::pixBlurredColored(
 	if (i == _cache.cend()) {
 		auto p = pixBlurredColoredNoCache(add, w, h);
 		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
+		i = remember(k, std::move(p));
 	}
-	return i->second;
+	return used(i);
 }
 
 const QPixmap &Image::pixSingle(
@@ -332,9 +362,9 @@ const QPixmap &Image::pixSingle(
 	if (i == _cache.cend() || i->second.width() != (outerw * cIntRetinaFactor()) || i->second.height() != (outerh * cIntRetinaFactor())) {
 		auto p = pixNoCache(w, h, options, outerw, outerh, colored);
 		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
+		i = remember(k, std::move(p));
 	}
-	return i->second;
+	return used(i);
 }
 
 const QPixmap &Image::pixBlurredSingle(
@@ -375,11 +405,75 @@ const QPixmap &Image::pixBlurredSingle(
 	if (i == _cache.cend() || i->second.width() != (outerw * cIntRetinaFactor()) || i->second.height() != (outerh * cIntRetinaFactor())) {
 		auto p = pixNoCache(w, h, options, outerw, outerh, colored);
 		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
+		i = remember(k, std::move(p));
 	}
+	return used(i);
+}
+
+Image::Cache::iterator Image::remember(
+		uint64 key,
+		QPixmap &&pixmap) const {
+	auto &cache = GlobalCache();
+	const auto bytes = PixmapBytes(pixmap);
+	const auto i = _cache.find(key);
+	const auto replaced = (i != end(_cache)) ? PixmapBytes(i->second) : 0;
+	_cacheBytes += bytes - replaced;
+	cache.bytes += bytes - replaced;
+	cache.images.emplace(this);
+	++cache.misses;
+	if (cache.bytes > kCacheLimit && !cache.trimScheduled) {
+		// Pixmap references returned from the pix*() methods are used
+		// right away by the painting code, so we don't trim until it ends.
+		cache.trimScheduled = true;
+		crl::on_main(TrimCache);
+	}
+	return _cache.emplace_or_assign(key, std::move(pixmap)).first;
+}
+
+const QPixmap &Image::used(Cache::iterator i) const {
+	auto &cache = GlobalCache();
+	_cacheUsage = ++cache.usage;
+	++cache.requests;
 	return i->second;
 }
 
+void Image::clearCache() const {
+	auto &cache = GlobalCache();
+	cache.bytes -= _cacheBytes;
+	cache.images.remove(this);
+	_cacheBytes = 0;
+	_cache.clear();
+}
+
+void Image::TrimCache() {
+	auto &cache = GlobalCache();
+	cache.trimScheduled = false;
+	if (cache.bytes <= kCacheLimit) {
+		return;
+	}
+	const auto was = cache.bytes;
+	auto images = cache.images | ranges::to_vector;
+	ranges::sort(images, ranges::less(), [](not_null<const Image*> image) {
+		return image->_cacheUsage;
+	});
+
+	// Leave some space, so that we don't trim on each new pixmap.
+	const auto target = kCacheLimit * 3 / 4;
+	for (const auto image : images) {
+		if (cache.bytes <= target) {
+			break;
+		}
+		image->clearCache();
+	}
+	DEBUG_LOG(("Image Cache: Trimmed %1 -> %2 bytes, %3 images left, "
+		"%4 requests, %5 misses."
+		).arg(was
+		).arg(cache.bytes
+		).arg(cache.images.size()
+		).arg(cache.requests
+		).arg(cache.misses));
+}
+
 QPixmap Image::pixNoCache(
 		int w,
 		int h,
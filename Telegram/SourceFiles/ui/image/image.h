@@ -24,6 +24,7 @@ public:
 	explicit Image(const QString &path);
 	explicit Image(const QByteArray &content);
 	explicit Image(QImage &&data);
+	~Image();
 
 	[[nodiscard]] static not_null<Image*> Empty(); // 1x1 transparent
 	[[nodiscard]] static not_null<Image*> BlankMedia(); // 1x1 black
@@ -92,7 +93,17 @@ public:
 		int h = 0) const;
 
 private:
+	using Cache = base::flat_map<uint64, QPixmap>;
+
+	Cache::iterator remember(uint64 key, QPixmap &&pixmap) const;
+	const QPixmap &used(Cache::iterator i) const;
+	void clearCache() const;
+
+	static void TrimCache();
+
 	const QImage _data;
-	mutable base::flat_map<uint64, QPixmap> _cache;
+	mutable Cache _cache;
+	mutable int64 _cacheBytes = 0;
+	mutable uint64 _cacheUsage = 0;
 
 };
@@ -41,6 +41,10 @@ namespace {
 constexpr auto kMinimalAlertDelay = crl::time(500);
 constexpr auto kWaitingForAllGroupedDelay = crl::time(1000);
 
+// not more than five notifications in a second, the rest wait
+constexpr auto kMaxNotificationsInBurst = 5;
+constexpr auto kNotificationsBurstDuration = crl::time(1000);
+
 #ifdef Q_OS_MAC
 constexpr auto kSystemAlertDuration = crl::time(1000);
 #else // !Q_OS_MAC
@@ -452,6 +456,15 @@ void System::showNext() {
 			++i;
 		}
 		if (notifyItem) {
+			if (ms - _burstStarted >= kNotificationsBurstDuration) {
+				_burstStarted = ms;
+				_burstCount = 0;
+			}
+			if (_burstCount >= kMaxNotificationsInBurst) {
+				next = std::max(
+					next,
+					_burstStarted + kNotificationsBurstDuration);
+			}
 			if (next > ms) {
 				if (nextAlert && nextAlert < next) {
 					next = nextAlert;
@@ -460,6 +473,7 @@ void System::showNext() {
 				_waitTimer.callOnce(next - ms);
 				break;
 			} else {
+				++_burstCount;
 				const auto isForwarded = notifyItem->Has<HistoryMessageForwarded>();
 				const auto isAlbum = notifyItem->groupId();
 
@@ -124,6 +124,8 @@ private:
 	base::flat_map<not_null<History*>, Waiter> _settingWaiters;
 	base::Timer _waitTimer;
 	base::Timer _waitForAllGroupedTimer;
+	crl::time _burstStarted = 0;
+	int _burstCount = 0;
 
 	base::flat_map<not_null<History*>, base::flat_map<crl::time, PeerData*>> _whenAlerts;
 
@@ -88,6 +88,19 @@ QString CachedUserpics::get(
 	return i->path;
 }
 
+QImage CachedUserpics::image(
+		const InMemoryKey &key,
+		not_null<PeerData*> peer,
+		std::shared_ptr<Data::CloudImageView> &view) {
+	const auto path = get(key, peer, view);
+	const auto i = _images.find(key);
+	Assert(i != _images.end());
+	if (i->image.isNull()) {
+		i->image = QImage(path);
+	}
+	return i->image;
+}
+
 crl::time CachedUserpics::clear(crl::time ms) {
 	crl::time result = 0;
 	for (auto i = _images.begin(); i != _images.end();) {
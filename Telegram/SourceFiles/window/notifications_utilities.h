@@ -32,6 +32,12 @@ public:
 		not_null<PeerData*> peer,
 		std::shared_ptr<Data::CloudImageView> &view);
 
+	// Same as get(), but returns the decoded image, read only once.
+	[[nodiscard]] QImage image(
+		const InMemoryKey &key,
+		not_null<PeerData*> peer,
+		std::shared_ptr<Data::CloudImageView> &view);
+
 private:
 	void clear();
 	void clearInMs(int ms);
@@ -41,6 +47,7 @@ private:
 	struct Image {
 		crl::time until = 0;
 		QString path;
+		QImage image;
 	};
 	using Images = QMap<InMemoryKey, Image>;
 	Images _images;
@@ -24,6 +24,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "boxes/filters/edit_filter_box.h"
 #include "settings/settings_common.h"
 #include "api/api_chat_filters.h"
+#include "base/weak_ptr.h"
 #include "apiwrap.h"
 #include "styles/style_widgets.h"
 #include "styles/style_window.h"
@@ -33,11 +34,28 @@ namespace {
 
 [[nodiscard]] rpl::producer<Dialogs::UnreadState> MainListUnreadState(
 		not_null<Dialogs::MainList*> list) {
-	return rpl::single(rpl::empty_value()) | rpl::then(
-		list->unreadStateChanges() | rpl::to_empty
-	) | rpl::map([=] {
-		return list->unreadState();
-	});
+	// Applying a dialogs slice changes the unread state once per entry,
+	// publish only the state after the whole slice is applied.
+	struct State : base::has_weak_ptr {
+		bool scheduled = false;
+	};
+	return [=](auto consumer) {
+		auto result = rpl::lifetime();
+		const auto state = result.make_state<State>();
+		consumer.put_next(list->unreadState());
+		list->unreadStateChanges(
+		) | rpl::start_with_next([=] {
+			if (state->scheduled) {
+				return;
+			}
+			state->scheduled = true;
+			crl::on_main(state, [=] {
+				state->scheduled = false;
+				consumer.put_next(list->unreadState());
+			});
+		}, result);
+		return result;
+	};
 }
 
 [[nodiscard]] rpl::producer<Dialogs::UnreadState> UnreadStateValue(
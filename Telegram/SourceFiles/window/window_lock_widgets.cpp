@@ -139,7 +139,9 @@ void PasscodeLockWidget::paintContent(Painter &p) {
 }
 
 void PasscodeLockWidget::submit() {
-	if (_passcode->text().isEmpty()) {
+	if (_checkingPasscode) {
+		return;
+	} else if (_passcode->text().isEmpty()) {
 		_passcode->showError();
 		return;
 	}
@@ -151,18 +153,26 @@ void PasscodeLockWidget::submit() {
 	}
 
 	const auto passcode = _passcode->text().toUtf8();
+	const auto done = [=](bool correct) {
+		if (!correct) {
+			cSetPasscodeBadTries(cPasscodeBadTries() + 1);
+			cSetPasscodeLastTry(crl::now());
+			error();
+			return;
+		}
+		Core::App().unlockPasscode(); // Destroys this widget.
+	};
 	auto &domain = Core::App().domain();
-	const auto correct = domain.started()
-		? domain.local().checkPasscode(passcode)
-		: (domain.start(passcode) == Storage::StartResult::Success);
-	if (!correct) {
-		cSetPasscodeBadTries(cPasscodeBadTries() + 1);
-		cSetPasscodeLastTry(crl::now());
-		error();
+	if (!domain.started()) {
+		done(domain.start(passcode) == Storage::StartResult::Success);
 		return;
 	}
-
-	Core::App().unlockPasscode(); // Destroys this widget.
+	_checkingPasscode = true;
+	domain.local().checkPasscodeAsync(passcode, crl::guard(this, [=](
+			bool correct) {
+		_checkingPasscode = false;
+		done(correct);
+	}));
 }
 
 void PasscodeLockWidget::error() {
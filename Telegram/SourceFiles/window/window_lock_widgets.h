@@ -71,6 +71,7 @@ private:
 	object_ptr<Ui::RoundButton> _submit;
 	object_ptr<Ui::LinkButton> _logout;
 	QString _error;
+	bool _checkingPasscode = false;
 
 };
 